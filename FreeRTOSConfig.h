@@ -66,6 +66,8 @@
  // todo need this for lwip FreeRTOS sys_arch to compile
  #define configENABLE_BACKWARD_COMPATIBILITY     1
  #define configNUM_THREAD_LOCAL_STORAGE_POINTERS 5
+ /* Índices: 0 = uso geral, 1 = fim de DMA do SPI do W5500, 2 = INTn do W5500, 3 = fim de transação I2C */
+ #define configTASK_NOTIFICATION_ARRAY_ENTRIES   4
  
  /* System */
  #define configSTACK_DEPTH_TYPE                  uint32_t
@@ -109,7 +111,7 @@
  #define configNUM_CORES                         2
  #define configTICK_CORE                         0
  #define configRUN_MULTIPLE_PRIORITIES           1
- #define configUSE_CORE_AFFINITY                 0
+ #define configUSE_CORE_AFFINITY                 1
  #endif
  
  /* RP2040 specific */
@@ -1,20 +1,162 @@
 # --- Timeout Configs ---
 set(HTTP_TIMEOUT_MS 5000)
-set(ADC_CONNECTION_CHECK_TIMEOUT_MS 10)
 set(SYSTEM_WATCHDOG_TIMEOUT_MS 10000)
 set(MAIN_TASK_CYCLE_INTERVAL_MS 1000)
 
+# --- HTTP Configs ---
+# 1 mantém a conexão TCP aberta entre ciclos (Connection: keep-alive).
+set(HTTP_KEEP_ALIVE 1)
+# Rajadas SPI para o W5500 a partir deste tamanho (bytes) são feitas por DMA.
+set(W5500_SPI_DMA_THRESHOLD 32)
+# GPIO ligado ao pino INTn do W5500 (eventos de socket).
+set(W5500_INT_PIN 21)
+# Memória TX e RX (KB) de cada um dos 8 sockets do W5500. Valores válidos:
+# 0, 1, 2, 4, 8 ou 16; cada lista soma no máximo 16. Sockets com 0 ficam
+# fora do pool. Os dois primeiros servem o envio ao vivo e a drenagem da flash.
+set(W5500_SOCKET_TX_KB 4 4 2 2 2 2 0 0)
+set(W5500_SOCKET_RX_KB 4 4 2 2 2 2 0 0)
+
+# --- SNTP Configs ---
+# Servidor que dá a hora de parede às leituras (IPv4, sem DNS; ex: o gateway
+# da rede, se servir NTP). As leituras são datadas no relógio monotónico e
+# convertidas para tempo Unix com a diferença medida na última consulta.
+set(SNTP_SERVER_IP 162 159 200 1)
+set(SNTP_SERVER_PORT 123)
+# Intervalo entre consultas (ms): o cristal (±30 ppm) deriva até ~27 ms em 15 min.
+set(SNTP_SYNC_INTERVAL_MS 900000)
+# Espera máxima pela resposta e nova tentativa (ms) após uma consulta falhada.
+set(SNTP_TIMEOUT_MS 1000)
+set(SNTP_RETRY_MS 10000)
+
+# --- Retry Configs ---
+# Após uma falha transitória o envio seguinte espera entre metade e o total
+# de RETRY_BASE_MS * 2^(falhas-1), até RETRY_MAX_MS. O Retry-After do
+# servidor é respeitado até RETRY_MAX_AFTER_S segundos.
+set(RETRY_BASE_MS 2000)
+set(RETRY_MAX_MS 300000)
+set(RETRY_MAX_AFTER_S 3600)
+# Falhas consecutivas que abrem o disjuntor e a pausa (ms) antes da tentativa de prova.
+set(RETRY_BREAKER_THRESHOLD 5)
+set(RETRY_BREAKER_OPEN_MS 600000)
+
+# --- Log Configs ---
+# Nível máximo compilado: ERROR, WARN, INFO ou DEBUG (inclui os [DADOS] de cada ciclo).
+set(LOG_LEVEL INFO)
+# Saída da tarefa de registo: TEXT (formatada no dispositivo) ou BINARY
+# (registos compactos, descodificados no host com tools/log_decode.py).
+set(LOG_OUTPUT TEXT)
+# Registos em espera no anel partilhado pelos dois núcleos (potência de 2).
+set(LOG_RING_SIZE 128)
+
+# --- Trace Configs ---
+# Histogramas de latência das fases do ciclo: 1 ativa, 0 remove do firmware.
+set(TRACE_ENABLED 1)
+# Intervalo (ms) entre resumos [TRACE] com p50/p99/máximo de cada fase.
+set(TRACE_SUMMARY_INTERVAL_MS 60000)
+
+# --- Batch Configs ---
+# O lote é enviado ao atingir o número máximo de leituras ou a idade máxima
+# da leitura mais antiga, o que ocorrer primeiro.
+set(BATCH_MAX_READINGS 10)
+set(BATCH_MAX_AGE_MS 10000)
+# Formato do corpo enviado ao servidor: JSON (legível) ou CBOR (binário compacto).
+set(PAYLOAD_FORMAT JSON)
+
+# --- Store-and-forward Configs ---
+# Região no fim da flash reservada às leituras não enviadas (múltiplo de 4 KB).
+set(FLASH_STORE_SIZE_KB 256)
+# Região imediatamente antes, com a configuração alterável pelo servidor
+# (múltiplo de 4 KB, pelo menos 8).
+set(CONFIG_STORE_SIZE_KB 8)
+
+# --- ADC Configs ---
+# Conversores ADS1115 no barramento I2C (1 a 4). O conversor N responde no
+# endereço 0x48 + N (pino ADDR ligado a GND, VDD, SDA ou SCL, por esta ordem).
+set(ADC_DEVICE_COUNT 1)
+# Frequência do SCL do barramento I2C, em Hz (até 1000000). Acima de 400 kHz
+# (Fast-mode) o barramento passa a Fast-mode Plus, que o ADS1115 suporta mas
+# que exige pull-ups mais fortes (ex: 2.2 kΩ) do que os internos do RP2040.
+set(ADC_I2C_BAUDRATE_HZ 1000000)
+# Taxa da conversão contínua de cada ADS1115 (128, 250, 475 ou 860 SPS),
+# repartida entre os canais desse conversor em round-robin. Os conversores
+# trabalham em paralelo: o débito total cresce com o seu número. A troca
+# de canal só vale a partir da conversão seguinte, pelo que a conversão
+# iniciada antes da troca é descartada. Com N > 1 canais num conversor,
+# cada canal recebe ADC_DATA_RATE_SPS / (2 * N) amostras por segundo.
+# Exemplo: 143 SPS por canal com 3 canais a 860 SPS.
+set(ADC_DATA_RATE_SPS 860)
+# GPIO ligado ao pino ALERT/RDY de cada ADS1115, do conversor 0 ao 3 (só os
+# primeiros ADC_DEVICE_COUNT são usados).
+set(ADC_ALERT_RDY_PINS 2 3 6 7)
+# Mede no arranque os ciclos por conversão de sensor (ponto fixo vs float): 1 ativa, 0 desativa.
+set(ANALOG_SENSOR_BENCHMARK 0)
+
+# --- Sensor Configs ---
+# Registo dos sensores: cada nome em SENSORS ganha uma entrada na tabela
+# gerada no build (sensor_table.h, ver firmware.cmake), pela ordem da lista,
+# que é também a ordem dos campos no CBOR. Acrescentar um sensor (ex: pH) é
+# acrescentar o nome à lista e o bloco SENSOR_<NOME>_* correspondente; o
+# nome é o usado no JSON e nas chaves do X-Config.
+#
+#   DEVICE       conversor ADS1115 (0 a ADC_DEVICE_COUNT - 1)
+#   CHANNEL      entrada single-ended desse conversor (0 a 3)
+#   UNIT         unidade de engenharia (registos e documentação)
+#   CONVERSION   LINEAR: MIN_VALUE a 0 V e MAX_VALUE a MAX_VOLTAGE
+#   FILTER       decimação do fluxo de amostras: NONE, BOXCAR,
+#                MOVING_AVERAGE ou MEDIAN (estes dois com FILTER_WINDOW amostras)
+#
+# Cada sensor tem ainda um período de amostragem (SAMPLE) e uma espera
+# máxima até ao envio (REPORT), em ms. Envio por exceção: um valor só é
+# enviado se se afastar do último enviado mais do que DEADBAND (nas unidades
+# do sensor; 0 envia todos) ou se o sensor estiver há HEARTBEAT ms sem
+# enviar. Estes quatro são os valores iniciais: o servidor pode alterá-los
+# em execução com o cabeçalho X-Config (ver config_store.h).
+set(SENSORS temperature conductivity flow)
+
 # -- Temperature --
+# Varia devagar: média de todas as amostras do período de amostragem.
+set(SENSOR_TEMPERATURE_DEVICE 0)
+set(SENSOR_TEMPERATURE_CHANNEL 0)
+set(SENSOR_TEMPERATURE_UNIT "C")
+set(SENSOR_TEMPERATURE_CONVERSION LINEAR)
 set(SENSOR_TEMPERATURE_MAX_VOLTAGE 3.3)
 set(SENSOR_TEMPERATURE_MAX_VALUE 100.0)
 set(SENSOR_TEMPERATURE_MIN_VALUE 0.0)
+set(SENSOR_TEMPERATURE_FILTER BOXCAR)
+set(SENSOR_TEMPERATURE_FILTER_WINDOW 0)
+set(SENSOR_TEMPERATURE_SAMPLE_INTERVAL_MS 10000)
+set(SENSOR_TEMPERATURE_REPORT_INTERVAL_MS 60000)
+set(SENSOR_TEMPERATURE_DEADBAND 0.2)
+set(SENSOR_TEMPERATURE_HEARTBEAT_MS 600000)
 
 # -- Conductivity --
+# Sonda ruidosa e com picos: a mediana rejeita os valores aberrantes.
+set(SENSOR_CONDUCTIVITY_DEVICE 0)
+set(SENSOR_CONDUCTIVITY_CHANNEL 1)
+set(SENSOR_CONDUCTIVITY_UNIT "uS/cm")
+set(SENSOR_CONDUCTIVITY_CONVERSION LINEAR)
 set(SENSOR_CONDUCTIVITY_MAX_VOLTAGE 3.3)
 set(SENSOR_CONDUCTIVITY_MAX_VALUE 15.0)
 set(SENSOR_CONDUCTIVITY_MIN_VALUE 0.0)
+set(SENSOR_CONDUCTIVITY_FILTER MEDIAN)
+set(SENSOR_CONDUCTIVITY_FILTER_WINDOW 9)
+set(SENSOR_CONDUCTIVITY_SAMPLE_INTERVAL_MS ${MAIN_TASK_CYCLE_INTERVAL_MS})
+set(SENSOR_CONDUCTIVITY_REPORT_INTERVAL_MS ${BATCH_MAX_AGE_MS})
+set(SENSOR_CONDUCTIVITY_DEADBAND 0.05)
+set(SENSOR_CONDUCTIVITY_HEARTBEAT_MS 300000)
 
 # -- Flow --
+# Deve seguir variações rápidas: uma média móvel curta mantém o atraso baixo.
+set(SENSOR_FLOW_DEVICE 0)
+set(SENSOR_FLOW_CHANNEL 2)
+set(SENSOR_FLOW_UNIT "L/min")
+set(SENSOR_FLOW_CONVERSION LINEAR)
 set(SENSOR_FLOW_MAX_VOLTAGE 3.3)
 set(SENSOR_FLOW_MAX_VALUE 100.0)
-set(SENSOR_FLOW_MIN_VALUE 0.0)
\ No newline at end of file
+set(SENSOR_FLOW_MIN_VALUE 0.0)
+set(SENSOR_FLOW_FILTER MOVING_AVERAGE)
+set(SENSOR_FLOW_FILTER_WINDOW 8)
+set(SENSOR_FLOW_SAMPLE_INTERVAL_MS ${MAIN_TASK_CYCLE_INTERVAL_MS})
+set(SENSOR_FLOW_REPORT_INTERVAL_MS ${BATCH_MAX_AGE_MS})
+set(SENSOR_FLOW_DEADBAND 0.5)
+set(SENSOR_FLOW_HEARTBEAT_MS 300000)
@@ -0,0 +1,171 @@
+# Fontes e definições partilhadas pelo build da placa e pelo build host
+# (CIP_PLATFORM=host). Os módulos aqui listados não dependem do W5500 nem da
+# flash do RP2040; ethernet_manager e o acesso à flash ficam em cada build.
+
+set(FIRMWARE_MODULE_SOURCES
+    ${CMAKE_CURRENT_LIST_DIR}/modules/http_client/http_client.c
+    ${CMAKE_CURRENT_LIST_DIR}/modules/http_parser/http_parser.c
+    ${CMAKE_CURRENT_LIST_DIR}/modules/sntp_client/sntp_client.c
+    ${CMAKE_CURRENT_LIST_DIR}/modules/retry_scheduler/retry_scheduler.c
+    ${CMAKE_CURRENT_LIST_DIR}/modules/trace/trace.c
+    ${CMAKE_CURRENT_LIST_DIR}/modules/logger/logger.c
+    ${CMAKE_CURRENT_LIST_DIR}/modules/batch_manager/batch_manager.c
+    ${CMAKE_CURRENT_LIST_DIR}/modules/payload_encoder/payload_encoder.c
+    ${CMAKE_CURRENT_LIST_DIR}/modules/flash_store/flash_store.c
+    ${CMAKE_CURRENT_LIST_DIR}/modules/config_store/config_store.c
+    ${CMAKE_CURRENT_LIST_DIR}/modules/report_filter/report_filter.c
+    ${CMAKE_CURRENT_LIST_DIR}/modules/sensor_manager/sensor_manager.c
+    ${CMAKE_CURRENT_LIST_DIR}/modules/i2c_bus/i2c_bus.c
+    ${CMAKE_CURRENT_LIST_DIR}/modules/adc_manager/adc_manager.c
+    ${CMAKE_CURRENT_LIST_DIR}/modules/analog_sensor/analog_sensor.c
+    ${CMAKE_CURRENT_LIST_DIR}/modules/analog_filter/analog_filter.c
+    ${CMAKE_CURRENT_LIST_DIR}/modules/fixed_point/fixed_point.c
+)
+
+# Tabela de sensores (sensor_table.h) gerada a partir da lista SENSORS do
+# config.cmake: uma entrada X(...) por sensor, expandida pelos módulos em
+# tabelas constantes (ver sensor_manager.h).
+set(FIRMWARE_SOURCE_DIR ${CMAKE_CURRENT_LIST_DIR})
+set(FIRMWARE_GENERATED_DIR ${CMAKE_BINARY_DIR}/generated)
+set(FIRMWARE_SENSOR_CONVERSIONS LINEAR)
+set(FIRMWARE_SENSOR_FILTERS NONE BOXCAR MOVING_AVERAGE MEDIAN)
+# Limite da máscara de canais de sensors_reading_t: 4 ADS1115 de 4 entradas
+set(FIRMWARE_MAX_SENSORS 16)
+
+function(firmware_generate_sensor_table)
+    if(NOT ADC_DEVICE_COUNT MATCHES "^[1-4]$")
+        message(FATAL_ERROR "ADC_DEVICE_COUNT deve ser 1 a 4")
+    endif()
+    if(NOT ADC_I2C_BAUDRATE_HZ MATCHES "^[0-9]+$" OR ADC_I2C_BAUDRATE_HZ GREATER 1000000)
+        message(FATAL_ERROR "ADC_I2C_BAUDRATE_HZ deve ser no máximo 1000000 (Fast-mode Plus)")
+    endif()
+    list(LENGTH ADC_ALERT_RDY_PINS pin_count)
+    if(NOT pin_count EQUAL 4)
+        message(FATAL_ERROR "ADC_ALERT_RDY_PINS deve ter 4 pinos, um por endereço do ADS1115")
+    endif()
+    math(EXPR last_device "${ADC_DEVICE_COUNT} - 1")
+
+    list(LENGTH SENSORS count)
+    if(count EQUAL 0 OR count GREATER FIRMWARE_MAX_SENSORS)
+        message(FATAL_ERROR "SENSORS deve ter entre 1 e ${FIRMWARE_MAX_SENSORS} sensores")
+    endif()
+
+    set(entries "")
+    foreach(name ${SENSORS})
+        string(LENGTH ${name} name_len)
+        if(NOT name MATCHES "^[a-z][a-z0-9_]*$" OR name_len GREATER 24)
+            message(FATAL_ERROR "Nome de sensor inválido: '${name}' (até 24 minúsculas, dígitos e _)")
+        endif()
+        string(TOUPPER ${name} id)
+        set(prefix SENSOR_${id})
+
+        foreach(field DEVICE CHANNEL UNIT CONVERSION MAX_VOLTAGE MAX_VALUE MIN_VALUE FILTER FILTER_WINDOW
+                      SAMPLE_INTERVAL_MS REPORT_INTERVAL_MS DEADBAND HEARTBEAT_MS)
+            if(NOT DEFINED ${prefix}_${field})
+                message(FATAL_ERROR "Sensor '${name}': falta ${prefix}_${field} no config.cmake")
+            endif()
+        endforeach()
+        if(NOT ${prefix}_DEVICE MATCHES "^[0-3]$" OR ${prefix}_DEVICE GREATER last_device)
+            message(FATAL_ERROR "Sensor '${name}': ${prefix}_DEVICE deve ser 0 a ${last_device}")
+        endif()
+        if(NOT ${prefix}_CHANNEL MATCHES "^[0-3]$")
+            message(FATAL_ERROR "Sensor '${name}': ${prefix}_CHANNEL deve ser 0 a 3")
+        endif()
+        if(NOT ${prefix}_CONVERSION IN_LIST FIRMWARE_SENSOR_CONVERSIONS)
+            message(FATAL_ERROR "Sensor '${name}': conversão '${${prefix}_CONVERSION}' desconhecida "
+                                "(${FIRMWARE_SENSOR_CONVERSIONS})")
+        endif()
+        if(NOT ${prefix}_FILTER IN_LIST FIRMWARE_SENSOR_FILTERS)
+            message(FATAL_ERROR "Sensor '${name}': filtro '${${prefix}_FILTER}' desconhecido "
+                                "(${FIRMWARE_SENSOR_FILTERS})")
+        endif()
+
+        string(APPEND entries
+            "    X(${id}, \"${name}\", \"${${prefix}_UNIT}\", ${${prefix}_DEVICE}, ${${prefix}_CHANNEL}, "
+            "${${prefix}_CONVERSION}, ${${prefix}_MAX_VOLTAGE}, ${${prefix}_MAX_VALUE}, "
+            "${${prefix}_MIN_VALUE}, ${${prefix}_FILTER}, ${${prefix}_FILTER_WINDOW}, "
+            "${${prefix}_SAMPLE_INTERVAL_MS}, ${${prefix}_REPORT_INTERVAL_MS}, "
+            "${${prefix}_DEADBAND}, ${${prefix}_HEARTBEAT_MS}) \\\n")
+    endforeach()
+
+    set(SENSOR_TABLE_ENTRIES "${entries}")
+    configure_file(${FIRMWARE_SOURCE_DIR}/modules/sensor_manager/sensor_table.h.in
+                   ${FIRMWARE_GENERATED_DIR}/sensor_table.h @ONLY)
+endfunction()
+
+firmware_generate_sensor_table()
+
+# Macros de pré-processador (-D) durante a compilação.
+function(firmware_compile_definitions target)
+    target_compile_definitions(${target} PRIVATE
+        TARGET_SERVER_IP="${TARGET_SERVER_IP}"
+        TARGET_PORT=${TARGET_PORT}
+        TARGET_PATH="${TARGET_PATH}"
+        HTTP_TIMEOUT_MS=${HTTP_TIMEOUT_MS}
+        HTTP_KEEP_ALIVE=${HTTP_KEEP_ALIVE}
+        W5500_SPI_DMA_THRESHOLD=${W5500_SPI_DMA_THRESHOLD}
+        W5500_INT_PIN=${W5500_INT_PIN}
+        SNTP_SERVER_PORT=${SNTP_SERVER_PORT}
+        SNTP_SYNC_INTERVAL_MS=${SNTP_SYNC_INTERVAL_MS}
+        SNTP_TIMEOUT_MS=${SNTP_TIMEOUT_MS}
+        SNTP_RETRY_MS=${SNTP_RETRY_MS}
+        RETRY_BASE_MS=${RETRY_BASE_MS}
+        RETRY_MAX_MS=${RETRY_MAX_MS}
+        RETRY_MAX_AFTER_S=${RETRY_MAX_AFTER_S}
+        RETRY_BREAKER_THRESHOLD=${RETRY_BREAKER_THRESHOLD}
+        RETRY_BREAKER_OPEN_MS=${RETRY_BREAKER_OPEN_MS}
+        LOG_LEVEL=LOG_LEVEL_${LOG_LEVEL}
+        LOG_OUTPUT=LOG_OUTPUT_${LOG_OUTPUT}
+        LOG_RING_SIZE=${LOG_RING_SIZE}
+        TRACE_ENABLED=${TRACE_ENABLED}
+        TRACE_SUMMARY_INTERVAL_MS=${TRACE_SUMMARY_INTERVAL_MS}
+        BATCH_MAX_READINGS=${BATCH_MAX_READINGS}
+        BATCH_MAX_AGE_MS=${BATCH_MAX_AGE_MS}
+        PAYLOAD_FORMAT=PAYLOAD_FORMAT_${PAYLOAD_FORMAT}
+        FLASH_STORE_SIZE_KB=${FLASH_STORE_SIZE_KB}
+        CONFIG_STORE_SIZE_KB=${CONFIG_STORE_SIZE_KB}
+        CYCLE_INTERVAL_MS=${MAIN_TASK_CYCLE_INTERVAL_MS}
+        WATCHDOG_TIMEOUT_MS=${SYSTEM_WATCHDOG_TIMEOUT_MS}
+        ADC_DATA_RATE_SPS=${ADC_DATA_RATE_SPS}
+        ADC_DEVICE_COUNT=${ADC_DEVICE_COUNT}
+        ADC_I2C_BAUDRATE_HZ=${ADC_I2C_BAUDRATE_HZ}
+        ANALOG_SENSOR_BENCHMARK=${ANALOG_SENSOR_BENCHMARK}
+        "BEARER_TOKEN=\"${BEARER_TOKEN}\""
+    )
+
+    # sensor_table.h, gerado por firmware_generate_sensor_table()
+    target_include_directories(${target} PRIVATE ${FIRMWARE_GENERATED_DIR})
+
+    # Itera sobre as listas de rede para criar as definições C necessárias
+    foreach(INDEX RANGE 5)
+        list(GET ETHERNET_MAC ${INDEX} VALUE)
+        target_compile_definitions(${target} PRIVATE "ETHERNET_MAC_${INDEX}=${VALUE}")
+    endforeach()
+
+    # Pino ALERT/RDY de cada um dos 4 endereços possíveis do ADS1115
+    foreach(INDEX RANGE 3)
+        list(GET ADC_ALERT_RDY_PINS ${INDEX} VALUE)
+        target_compile_definitions(${target} PRIVATE "ADC_ALERT_RDY_PIN_${INDEX}=${VALUE}")
+    endforeach()
+
+    # Repartição da memória do W5500 pelos 8 sockets
+    foreach(INDEX RANGE 7)
+        list(GET W5500_SOCKET_TX_KB ${INDEX} VALUE)
+        target_compile_definitions(${target} PRIVATE "W5500_SOCKET_TX_KB_${INDEX}=${VALUE}")
+        list(GET W5500_SOCKET_RX_KB ${INDEX} VALUE)
+        target_compile_definitions(${target} PRIVATE "W5500_SOCKET_RX_KB_${INDEX}=${VALUE}")
+    endforeach()
+
+    foreach(INDEX RANGE 3)
+        list(GET DEVICE_IP ${INDEX} IP_VAL)
+        list(GET GATEWAY_IP ${INDEX} GW_VAL)
+        list(GET SUBNET_MASK ${INDEX} SN_VAL)
+        list(GET SNTP_SERVER_IP ${INDEX} NTP_VAL)
+        target_compile_definitions(${target} PRIVATE
+            "DEVICE_IP_${INDEX}=${IP_VAL}"
+            "GATEWAY_IP_${INDEX}=${GW_VAL}"
+            "SUBNET_MASK_${INDEX}=${SN_VAL}"
+            "SNTP_SERVER_IP_${INDEX}=${NTP_VAL}"
+        )
+    endforeach()
+endfunction()
@@ -0,0 +1,372 @@
+/**
+ * @file ads1115_sim.c
+ * @brief Implementação do ADS1115 simulado.
+ *
+ * Uma thread por dispositivo cumpre o ritmo da conversão contínua e aciona
+ * o pino ALERT/RDY no fim de cada conversão; a conversão single-shot é
+ * concluída de imediato, durante a escrita no registo de configuração.
+ *
+ * Como no ADS1115, cada conversão contínua usa a configuração em vigor
+ * quando começou: uma escrita durante a conversão (ex: troca de MUX) só
+ * vale a partir da seguinte. Só a passagem de single-shot a contínuo
+ * inicia uma conversão nova.
+ */
+
+#include "ads1115_sim.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <time.h>
+
+// --- Registos do ADS1115 ---
+#define ADS1115_REG_CONVERSION 0x00
+#define ADS1115_REG_CONFIG     0x01
+#define ADS1115_REG_LO_THRESH  0x02
+#define ADS1115_REG_HI_THRESH  0x03
+
+#define CONFIG_OS          0x8000
+#define CONFIG_MODE_SINGLE 0x0100
+#define CONFIG_COMP_POL    0x0008
+#define CONFIG_COMP_QUE    0x0003
+#define CONFIG_RESET       0x8583
+#define CONFIG_MUX(c)      (((c) >> 12) & 0x7)
+#define CONFIG_PGA(c)      (((c) >> 9) & 0x7)
+#define CONFIG_DR(c)       (((c) >> 5) & 0x7)
+
+// Atraso acumulado a partir do qual a conversão contínua deixa de recuperar o ritmo
+#define SIM_MAX_LAG_NS 100000000LL
+
+static const uint16_t data_rates_sps[8] = { 8, 16, 32, 64, 128, 250, 475, 860 };
+static const float full_scales_v[8] = { 6.144f, 4.096f, 2.048f, 1.024f, 0.512f, 0.256f, 0.256f, 0.256f };
+
+// Entradas (positiva, negativa) dos modos diferenciais, MUX 000 a 011
+static const uint8_t diff_inputs[4][2] = { {0, 1}, {0, 3}, {1, 3}, {2, 3} };
+
+typedef struct {
+    ads1115_sim_waveform_t waveform;
+    float* script;
+    size_t script_len;
+    size_t script_pos;
+} ads1115_sim_input_t;
+
+struct ads1115_sim {
+    pthread_mutex_t lock;
+    pthread_cond_t mode_changed;
+    uint rdy_pin;
+    uint8_t pointer;
+    uint16_t conversion;
+    uint16_t config;
+    uint16_t lo_thresh;
+    uint16_t hi_thresh;
+    ads1115_sim_input_t inputs[ADS1115_SIM_INPUTS];
+    float speed;
+    uint16_t converting;   /**< Configuração da conversão contínua em curso. */
+    bool restarted;        /**< Passagem a modo contínuo desde a última conversão. */
+    struct timespec restart_at;
+    double time_s;         /**< Tempo simulado: 1/DR por conversão. */
+    uint64_t conversions;
+    uint32_t noise_state;
+};
+
+static float sim_noise(ads1115_sim_t* sim) {
+    // xorshift32: determinístico, para que uma execução seja reprodutível.
+    uint32_t x = sim->noise_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim->noise_state = x;
+    return (float)x / 2147483648.0f - 1.0f;
+}
+
+static float sim_input_volts(ads1115_sim_t* sim, uint index) {
+    ads1115_sim_input_t* input = &sim->inputs[index];
+
+    if (input->script != NULL) {
+        float v = input->script[input->script_pos];
+        input->script_pos = (input->script_pos + 1) % input->script_len;
+        return v;
+    }
+
+    const ads1115_sim_waveform_t* wave = &input->waveform;
+    double phase = 0.0;
+    if (wave->period_ms > 0) {
+        phase = fmod(sim->time_s * 1000.0 / wave->period_ms, 1.0);
+    }
+
+    float v = wave->offset_v;
+    switch (wave->kind) {
+    case ADS1115_SIM_SINE:
+        v += wave->amplitude_v * (float)sin(2.0 * M_PI * phase);
+        break;
+    case ADS1115_SIM_SQUARE:
+        v += (phase < 0.5) ? wave->amplitude_v : -wave->amplitude_v;
+        break;
+    case ADS1115_SIM_SAWTOOTH:
+        v += wave->amplitude_v * (float)(2.0 * phase - 1.0);
+        break;
+    case ADS1115_SIM_CONSTANT:
+    default:
+        break;
+    }
+
+    if (wave->noise_v > 0.0f) {
+        v += wave->noise_v * sim_noise(sim);
+    }
+    return v;
+}
+
+/**
+ * @brief Converte a entrada selecionada pelo MUX de `config`. Chamar com o trinco do dispositivo.
+ * @return true se o pino ALERT/RDY deve sinalizar o fim da conversão.
+ */
+static bool sim_convert(ads1115_sim_t* sim, uint16_t config) {
+    uint mux = CONFIG_MUX(config);
+    float v;
+    if (mux >= 4) {
+        v = sim_input_volts(sim, mux - 4);
+    } else {
+        v = sim_input_volts(sim, diff_inputs[mux][0]);
+        v -= sim_input_volts(sim, diff_inputs[mux][1]);
+    }
+
+    long code = lroundf(v / full_scales_v[CONFIG_PGA(config)] * 32768.0f);
+    if (code > INT16_MAX) {
+        code = INT16_MAX;
+    } else if (code < INT16_MIN) {
+        code = INT16_MIN;
+    }
+    sim->conversion = (uint16_t)(int16_t)code;
+    sim->time_s += 1.0 / data_rates_sps[CONFIG_DR(config)];
+    sim->conversions++;
+
+    // Hi_thresh com MSB a 1 e Lo_thresh com MSB a 0 põem o pino em modo RDY.
+    return (sim->hi_thresh & 0x8000) && !(sim->lo_thresh & 0x8000) &&
+           (sim->config & CONFIG_COMP_QUE) != CONFIG_COMP_QUE;
+}
+
+static void sim_pulse_rdy(const ads1115_sim_t* sim, bool active_high) {
+    host_gpio_drive(sim->rdy_pin, active_high);
+    host_gpio_drive(sim->rdy_pin, !active_high);
+}
+
+static void timespec_add_ns(struct timespec* ts, int64_t ns) {
+    ts->tv_sec += (time_t)(ns / 1000000000LL);
+    ts->tv_nsec += (long)(ns % 1000000000LL);
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+static int64_t timespec_diff_ns(const struct timespec* a, const struct timespec* b) {
+    return (int64_t)(a->tv_sec - b->tv_sec) * 1000000000LL + (a->tv_nsec - b->tv_nsec);
+}
+
+/**
+ * @brief Thread da conversão contínua, ao ritmo de DR multiplicado pela velocidade.
+ */
+static void* sim_continuous_thread(void* arg) {
+    ads1115_sim_t* sim = arg;
+    struct timespec next;
+
+    // Sem folga nos temporizadores, para ritmos de dezenas de kHz.
+    prctl(PR_SET_TIMERSLACK, 1UL);
+
+    pthread_mutex_lock(&sim->lock);
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while (1) {
+        while (sim->config & CONFIG_MODE_SINGLE) {
+            pthread_cond_wait(&sim->mode_changed, &sim->lock);
+            clock_gettime(CLOCK_MONOTONIC, &next);
+        }
+
+        // A passagem a modo contínuo inicia uma conversão no instante da
+        // escrita; as seguintes encadeiam-se sem pausa.
+        if (sim->restarted) {
+            next = sim->restart_at;
+            sim->restarted = false;
+        }
+
+        // A conversão que começa agora fica com a configuração atual até ao
+        // fim, mesmo que o registo seja reescrito entretanto.
+        sim->converting = sim->config;
+        double rate = data_rates_sps[CONFIG_DR(sim->converting)] * (double)sim->speed;
+        timespec_add_ns(&next, (int64_t)(1e9 / rate));
+
+        pthread_mutex_unlock(&sim->lock);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+        pthread_mutex_lock(&sim->lock);
+
+        if ((sim->config & CONFIG_MODE_SINGLE) || sim->restarted) {
+            continue;
+        }
+
+        bool pulse = sim_convert(sim, sim->converting);
+        bool active_high = (sim->config & CONFIG_COMP_POL) != 0;
+
+        // Como na placa, uma conversão não lida a tempo é substituída pela
+        // seguinte; um atraso grande apenas reinicia o ritmo.
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (timespec_diff_ns(&now, &next) > SIM_MAX_LAG_NS) {
+            next = now;
+        }
+
+        pthread_mutex_unlock(&sim->lock);
+        if (pulse) {
+            sim_pulse_rdy(sim, active_high);
+        }
+        pthread_mutex_lock(&sim->lock);
+    }
+
+    return NULL;
+}
+
+static int sim_i2c_write(void* context, const uint8_t* src, size_t len, __unused bool nostop) {
+    ads1115_sim_t* sim = context;
+    bool pulse = false;
+    bool active_high = false;
+
+    if (len == 0) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&sim->lock);
+    sim->pointer = src[0] & 0x3;
+
+    if (len >= 3) {
+        uint16_t value = (uint16_t)((src[1] << 8) | src[2]);
+        switch (sim->pointer) {
+        case ADS1115_REG_CONFIG:
+            // O bit OS lê-se sempre a 1: as conversões single-shot são instantâneas.
+            if ((value & CONFIG_MODE_SINGLE) && (value & CONFIG_OS)) {
+                pulse = sim_convert(sim, value);
+                active_high = (value & CONFIG_COMP_POL) != 0;
+            } else if (!(value & CONFIG_MODE_SINGLE) && (sim->config & CONFIG_MODE_SINGLE)) {
+                clock_gettime(CLOCK_MONOTONIC, &sim->restart_at);
+                sim->restarted = true;
+            }
+            sim->config = value | CONFIG_OS;
+            pthread_cond_signal(&sim->mode_changed);
+            break;
+        case ADS1115_REG_LO_THRESH:
+            sim->lo_thresh = value;
+            break;
+        case ADS1115_REG_HI_THRESH:
+            sim->hi_thresh = value;
+            break;
+        default:
+            // O registo de conversão é só de leitura.
+            break;
+        }
+    }
+    pthread_mutex_unlock(&sim->lock);
+
+    if (pulse) {
+        sim_pulse_rdy(sim, active_high);
+    }
+    return (int)len;
+}
+
+static int sim_i2c_read(void* context, uint8_t* dst, size_t len, __unused bool nostop) {
+    ads1115_sim_t* sim = context;
+    uint16_t value;
+
+    pthread_mutex_lock(&sim->lock);
+    switch (sim->pointer) {
+    case ADS1115_REG_CONVERSION: value = sim->conversion; break;
+    case ADS1115_REG_CONFIG:     value = sim->config; break;
+    case ADS1115_REG_LO_THRESH:  value = sim->lo_thresh; break;
+    default:                     value = sim->hi_thresh; break;
+    }
+    pthread_mutex_unlock(&sim->lock);
+
+    // Leituras além dos dois bytes repetem o registo, como no dispositivo.
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = (i % 2 == 0) ? (uint8_t)(value >> 8) : (uint8_t)value;
+    }
+    return (int)len;
+}
+
+ads1115_sim_t* ads1115_sim_create(i2c_inst_t* i2c, uint8_t addr, uint rdy_pin) {
+    ads1115_sim_t* sim = calloc(1, sizeof(*sim));
+    if (sim == NULL) {
+        return NULL;
+    }
+
+    pthread_mutex_init(&sim->lock, NULL);
+    pthread_cond_init(&sim->mode_changed, NULL);
+    sim->rdy_pin = rdy_pin;
+    sim->config = CONFIG_RESET;
+    sim->lo_thresh = 0x8000;
+    sim->hi_thresh = 0x7FFF;
+    sim->speed = 1.0f;
+    sim->noise_state = 0x2545F491u ^ addr;
+
+    const host_i2c_device_t device = {
+        .write = sim_i2c_write,
+        .read = sim_i2c_read,
+        .context = sim
+    };
+    if (!host_i2c_attach(i2c, addr, &device)) {
+        free(sim);
+        return NULL;
+    }
+
+    // ALERT/RDY é open-drain: em repouso o pull-up mantém-no alto.
+    host_gpio_drive(rdy_pin, true);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, sim_continuous_thread, sim) == 0) {
+        pthread_detach(thread);
+    }
+    return sim;
+}
+
+void ads1115_sim_set_speed(ads1115_sim_t* sim, float speed) {
+    pthread_mutex_lock(&sim->lock);
+    sim->speed = (speed > 0.0f) ? speed : 1.0f;
+    pthread_mutex_unlock(&sim->lock);
+}
+
+void ads1115_sim_set_waveform(ads1115_sim_t* sim, uint input, const ads1115_sim_waveform_t* waveform) {
+    if (input >= ADS1115_SIM_INPUTS) {
+        return;
+    }
+
+    pthread_mutex_lock(&sim->lock);
+    free(sim->inputs[input].script);
+    sim->inputs[input].script = NULL;
+    sim->inputs[input].waveform = *waveform;
+    pthread_mutex_unlock(&sim->lock);
+}
+
+bool ads1115_sim_set_script(ads1115_sim_t* sim, uint input, const float* volts, size_t count) {
+    if (input >= ADS1115_SIM_INPUTS || count == 0) {
+        return false;
+    }
+
+    float* script = malloc(count * sizeof(*script));
+    if (script == NULL) {
+        return false;
+    }
+    memcpy(script, volts, count * sizeof(*script));
+
+    pthread_mutex_lock(&sim->lock);
+    free(sim->inputs[input].script);
+    sim->inputs[input].script = script;
+    sim->inputs[input].script_len = count;
+    sim->inputs[input].script_pos = 0;
+    pthread_mutex_unlock(&sim->lock);
+    return true;
+}
+
+uint64_t ads1115_sim_conversions(ads1115_sim_t* sim) {
+    pthread_mutex_lock(&sim->lock);
+    uint64_t conversions = sim->conversions;
+    pthread_mutex_unlock(&sim->lock);
+    return conversions;
+}
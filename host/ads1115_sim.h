@@ -0,0 +1,88 @@
+/**
+ * @file ads1115_sim.h
+ * @brief ADS1115 simulado no barramento I2C do build host.
+ *
+ * Reproduz os registos do conversor (ponteiro, conversão, configuração e
+ * limiares), a conversão single-shot e a contínua ao ritmo do campo DR e o
+ * pino ALERT/RDY em modo de fim de conversão. A tensão de cada entrada
+ * AIN0..AIN3 vem de uma forma de onda ou de uma sequência de amostras.
+ */
+#ifndef ADS1115_SIM_H
+#define ADS1115_SIM_H
+
+#include "host_platform.h"
+
+/**
+ * @brief Número de entradas analógicas do ADS1115.
+ */
+#define ADS1115_SIM_INPUTS 4
+
+/**
+ * @enum ads1115_sim_wave_t
+ * @brief Formas de onda disponíveis para uma entrada.
+ */
+typedef enum {
+    ADS1115_SIM_CONSTANT,  /**< Tensão fixa em `offset_v`. */
+    ADS1115_SIM_SINE,      /**< Sinusoide em torno de `offset_v`. */
+    ADS1115_SIM_SQUARE,    /**< Alterna entre `offset_v` ± `amplitude_v`. */
+    ADS1115_SIM_SAWTOOTH   /**< Rampa de `offset_v` - `amplitude_v` a `offset_v` + `amplitude_v`. */
+} ads1115_sim_wave_t;
+
+/**
+ * @struct ads1115_sim_waveform_t
+ * @brief Sinal aplicado a uma entrada, em função do tempo simulado.
+ */
+typedef struct {
+    ads1115_sim_wave_t kind;
+    float offset_v;
+    float amplitude_v;
+    uint32_t period_ms;
+    float noise_v;         /**< Ruído uniforme somado a cada amostra, de ±noise_v. */
+} ads1115_sim_waveform_t;
+
+typedef struct ads1115_sim ads1115_sim_t;
+
+/**
+ * @brief Cria um ADS1115 simulado e liga-o ao barramento.
+ *
+ * Todas as entradas começam a 0 V.
+ *
+ * @param i2c O barramento I2C.
+ * @param addr O endereço I2C do dispositivo (0x48 a 0x4B).
+ * @param rdy_pin O GPIO ligado ao pino ALERT/RDY.
+ * @return O dispositivo, ou NULL se o endereço estiver ocupado.
+ */
+ads1115_sim_t* ads1115_sim_create(i2c_inst_t* i2c, uint8_t addr, uint rdy_pin);
+
+/**
+ * @brief Multiplica o ritmo da conversão contínua em relação ao campo DR.
+ *
+ * O tempo simulado das formas de onda avança 1/DR por conversão, pelo que
+ * o sinal amostrado é o mesmo a qualquer velocidade.
+ *
+ * @param speed O fator de aceleração (1 = tempo real).
+ */
+void ads1115_sim_set_speed(ads1115_sim_t* sim, float speed);
+
+/**
+ * @brief Aplica uma forma de onda a uma entrada.
+ */
+void ads1115_sim_set_waveform(ads1115_sim_t* sim, uint input, const ads1115_sim_waveform_t* waveform);
+
+/**
+ * @brief Aplica a uma entrada uma sequência de tensões, repetida em ciclo.
+ *
+ * Cada conversão que envolve a entrada consome a amostra seguinte.
+ *
+ * @param volts As tensões, copiadas pelo simulador.
+ * @param count O número de tensões.
+ * @return true em caso de sucesso, false sem memória ou com `count` nulo.
+ */
+bool ads1115_sim_set_script(ads1115_sim_t* sim, uint input, const float* volts, size_t count);
+
+/**
+ * @brief Número de conversões concluídas desde a criação.
+ */
+uint64_t ads1115_sim_conversions(ads1115_sim_t* sim);
+
+#endif // ADS1115_SIM_H
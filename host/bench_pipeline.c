@@ -0,0 +1,385 @@
+/**
+ * @file bench_pipeline.c
+ * @brief Benchmark de débito e latência do pipeline leitura→lote→codificação→envio no host.
+ *
+ * Para cada tamanho de lote e cada taxa de amostragem pedidos, lê os
+ * sensores (sensor_manager sobre o ADS1115 simulado) ao ritmo indicado,
+ * acumula as leituras com o batch_manager e envia cada lote com o
+ * http_client para o servidor de ingestão em loopback (ingest_server.h),
+ * que conta o que recebe. Por caso são medidos:
+ * - amostras/s entregues: leituras contadas pelo servidor por segundo;
+ * - bytes por amostra: HTTP recebido pelo servidor e uma estimativa em
+ *   Ethernet (tramas de BENCH_TCP_MSS bytes com BENCH_FRAME_OVERHEAD de
+ *   cabeçalhos), sem ACKs nem respostas;
+ * - latência ponta a ponta: da aquisição de cada leitura à confirmação
+ *   (200) do lote que a transportou, em percentis.
+ *
+ * O formato do corpo é fixado na compilação: há um executável por formato
+ * (bench_pipeline_json e bench_pipeline_cbor).
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "ads1115_sim.h"
+#include "ingest_server.h"
+#include "modules/adc_manager/adc_manager.h"
+#include "modules/ethernet_manager/ethernet_manager.h"
+#include "modules/sensor_manager/sensor_manager.h"
+#include "modules/batch_manager/batch_manager.h"
+#include "modules/payload_encoder/payload_encoder.h"
+#include "modules/logger/logger.h"
+
+#define BENCH_MAX_CASES        16
+#define BENCH_DEFAULT_RATES    "100,500,1000,2000,5000"
+#define BENCH_DEFAULT_DURATION_MS 2000
+// Estimativa dos bytes em Ethernet: MSS do TCP e cabeçalhos por trama
+// (Ethernet 14 + FCS 4 + IPv4 20 + TCP 20).
+#define BENCH_TCP_MSS          1460
+#define BENCH_FRAME_OVERHEAD   58
+// Conversões por leitura de cada canal: com menos, o filtro de um sensor
+// pode não ter amostras novas quando é lido.
+#define BENCH_ADC_OVERSAMPLE   2
+
+/**
+ * @struct bench_options_t
+ * @brief Opções da linha de comandos.
+ */
+typedef struct {
+    uint32_t rates[BENCH_MAX_CASES];
+    size_t rate_count;
+    uint32_t batches[BENCH_MAX_CASES];
+    size_t batch_count;
+    uint32_t duration_ms;
+    const char* record_path;
+    bool csv;
+} bench_options_t;
+
+/**
+ * @struct bench_result_t
+ * @brief Medições de um caso (taxa, tamanho de lote).
+ */
+typedef struct {
+    uint32_t samples;         /**< Leituras acrescentadas ao lote. */
+    uint32_t read_failures;
+    uint32_t uploads;
+    uint32_t upload_failures;
+    uint32_t lost;            /**< Leituras de envios não confirmados. */
+    uint64_t elapsed_us;
+    uint32_t* latencies_us;
+    size_t latency_count;
+    ingest_server_stats_t server;
+} bench_result_t;
+
+static void bench_usage(const char* program) {
+    fprintf(stderr,
+            "Uso: %s [opções]\n"
+            "  -r, --rates LISTA       taxas de amostragem em Hz (padrão " BENCH_DEFAULT_RATES ")\n"
+            "  -b, --batches LISTA     leituras por lote, até %d (padrão 1,10,%d)\n"
+            "  -d, --duration MS       duração de cada caso (padrão %d)\n"
+            "  -o, --record FICHEIRO   grava as requisições recebidas pelo servidor\n"
+            "  -c, --csv               resultados em CSV\n",
+            program, BATCH_MAX_READINGS, BATCH_MAX_READINGS, BENCH_DEFAULT_DURATION_MS);
+}
+
+static size_t bench_parse_list(const char* text, uint32_t* values) {
+    size_t count = 0;
+    char* end;
+
+    while (count < BENCH_MAX_CASES) {
+        unsigned long value = strtoul(text, &end, 10);
+        if (end == text || value == 0) {
+            return 0;
+        }
+        values[count++] = (uint32_t)value;
+        if (*end != ',') {
+            return (*end == '\0') ? count : 0;
+        }
+        text = end + 1;
+    }
+    return 0;
+}
+
+static bool bench_parse_options(int argc, char** argv, bench_options_t* options) {
+    static const struct option long_options[] = {
+        { "rates", required_argument, NULL, 'r' },
+        { "batches", required_argument, NULL, 'b' },
+        { "duration", required_argument, NULL, 'd' },
+        { "record", required_argument, NULL, 'o' },
+        { "csv", no_argument, NULL, 'c' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+
+    options->rate_count = bench_parse_list(BENCH_DEFAULT_RATES, options->rates);
+    options->batches[0] = 1;
+    options->batches[1] = 10;
+    options->batches[2] = BATCH_MAX_READINGS;
+    options->batch_count = 3;
+    options->duration_ms = BENCH_DEFAULT_DURATION_MS;
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "r:b:d:o:ch", long_options, NULL)) != -1) {
+        switch (opt) {
+        case 'r':
+            options->rate_count = bench_parse_list(optarg, options->rates);
+            break;
+        case 'b':
+            options->batch_count = bench_parse_list(optarg, options->batches);
+            break;
+        case 'd':
+            options->duration_ms = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'o':
+            options->record_path = optarg;
+            break;
+        case 'c':
+            options->csv = true;
+            break;
+        default:
+            bench_usage(argv[0]);
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < options->batch_count; i++) {
+        if (options->batches[i] > BATCH_MAX_READINGS) {
+            options->batch_count = 0;
+        }
+    }
+    if (options->rate_count == 0 || options->batch_count == 0 || options->duration_ms == 0) {
+        bench_usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+static int bench_compare_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Percentil por ordem (nearest-rank) de um vetor ordenado, em ms.
+ */
+static double bench_percentile_ms(const uint32_t* sorted, size_t count, uint32_t percent) {
+    if (count == 0) {
+        return 0.0;
+    }
+    size_t rank = (count * percent + 99) / 100;
+    return sorted[(rank > 0 ? rank : 1) - 1] / 1000.0;
+}
+
+/**
+ * @brief Envia o lote e, se confirmado, regista a latência das suas leituras.
+ */
+static void bench_flush(uint32_t now_ms, const uint64_t* acquired_us, bench_result_t* result) {
+    size_t count = batch_count();
+    batch_status_t status = batch_flush(now_ms, NULL);
+
+    result->uploads++;
+    if (status != BATCH_STATUS_OK) {
+        result->upload_failures++;
+        result->lost += (uint32_t)count;
+        return;
+    }
+
+    uint64_t confirmed_us = time_us_64();
+    for (size_t i = 0; i < count; i++) {
+        result->latencies_us[result->latency_count++] = (uint32_t)(confirmed_us - acquired_us[i]);
+    }
+}
+
+/**
+ * @brief Executa um caso: amostragem a `rate_hz` com lotes de `batch_size` leituras.
+ */
+static void bench_run_case(ads1115_sim_t* const adc_sims[ADC_DEVICE_COUNT], uint32_t rate_hz,
+                           uint32_t batch_size, uint32_t duration_ms, bench_result_t* result) {
+    static uint64_t acquired_us[BATCH_MAX_READINGS];
+    sensors_reading_t reading;
+    ingest_server_stats_t server_before, server_after;
+
+    // Os ADS1115 simulados são acelerados para acompanhar a taxa pedida;
+    // cada um percorre apenas as suas entradas.
+    float speed = (float)rate_hz * ADS1115_SIM_INPUTS * BENCH_ADC_OVERSAMPLE / ADC_DATA_RATE_SPS;
+    for (uint8_t d = 0; d < ADC_DEVICE_COUNT; d++) {
+        ads1115_sim_set_speed(adc_sims[d], speed > 1.0f ? speed : 1.0f);
+    }
+    sleep_ms(10);
+    sensors_read_all(&reading);
+
+    // Uma latência por leitura: o caso termina antes de exceder a capacidade.
+    size_t capacity = (size_t)rate_hz * duration_ms / 1000u + batch_size;
+    memset(result, 0, sizeof(*result));
+    result->latencies_us = malloc(capacity * sizeof(uint32_t));
+
+    ingest_server_get_stats(&server_before);
+    uint64_t period_us = 1000000u / rate_hz;
+    uint64_t start_us = time_us_64();
+    uint64_t next_us = start_us;
+
+    while (time_us_64() - start_us < (uint64_t)duration_ms * 1000u &&
+           result->latency_count + result->lost + batch_count() < capacity) {
+        uint64_t acquired = time_us_64();
+        uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+
+        if (sensors_read_all(&reading) != 0) {
+            result->read_failures++;
+        } else if (batch_add(&reading, now_ms) == BATCH_STATUS_OK) {
+            acquired_us[batch_count() - 1] = acquired;
+            result->samples++;
+        }
+
+        if (batch_count() >= batch_size || batch_should_flush(now_ms)) {
+            bench_flush(to_ms_since_boot(get_absolute_time()), acquired_us, result);
+        }
+
+        // Sem recuperação em rajada dos ciclos perdidos durante um envio.
+        uint64_t now_us = time_us_64();
+        next_us += period_us;
+        if (next_us > now_us) {
+            sleep_us(next_us - now_us);
+        } else {
+            next_us = now_us;
+        }
+    }
+
+    if (batch_count() > 0) {
+        bench_flush(to_ms_since_boot(get_absolute_time()), acquired_us, result);
+    }
+    result->elapsed_us = time_us_64() - start_us;
+
+    ingest_server_get_stats(&server_after);
+    result->server.requests = server_after.requests - server_before.requests;
+    result->server.request_bytes = server_after.request_bytes - server_before.request_bytes;
+    result->server.body_bytes = server_after.body_bytes - server_before.body_bytes;
+    result->server.readings = server_after.readings - server_before.readings;
+    result->server.rejected = server_after.rejected - server_before.rejected;
+
+    qsort(result->latencies_us, result->latency_count, sizeof(uint32_t), bench_compare_u32);
+}
+
+static void bench_print_header(const bench_options_t* options) {
+    if (options->csv) {
+        printf("format,batch,rate_hz,samples_per_s,http_bytes_per_sample,eth_bytes_per_sample,"
+               "body_bytes_per_sample,p50_ms,p95_ms,p99_ms,max_ms,uploads,upload_failures,"
+               "read_failures,lost\n");
+        return;
+    }
+
+    printf("Formato %s, lotes até %d leituras, %u ms por caso.\n", payload_content_type(),
+           BATCH_MAX_READINGS, (unsigned)options->duration_ms);
+    printf("%5s %7s %11s %10s %10s %10s %8s %8s %8s %8s %7s %6s %6s\n",
+           "lote", "taxa Hz", "amostras/s", "HTTP B/am", "Eth B/am", "corpo B/am",
+           "p50 ms", "p95 ms", "p99 ms", "max ms", "envios", "falhas", "ADC");
+}
+
+static void bench_print_result(const bench_options_t* options, uint32_t rate_hz,
+                               uint32_t batch_size, const bench_result_t* result) {
+    const ingest_server_stats_t* server = &result->server;
+    double readings = server->readings ? (double)server->readings : 1.0;
+    double per_second = result->elapsed_us ? server->readings * 1e6 / result->elapsed_us : 0.0;
+
+    uint64_t frames = 0;
+    if (server->requests > 0) {
+        uint64_t request_avg = server->request_bytes / server->requests;
+        frames = server->requests * ((request_avg + BENCH_TCP_MSS - 1) / BENCH_TCP_MSS);
+    }
+    double http_per_sample = server->request_bytes / readings;
+    double eth_per_sample = (server->request_bytes + frames * BENCH_FRAME_OVERHEAD) / readings;
+    double body_per_sample = server->body_bytes / readings;
+
+    const uint32_t* lat = result->latencies_us;
+    size_t n = result->latency_count;
+    double max_ms = n ? lat[n - 1] / 1000.0 : 0.0;
+    uint32_t failures = result->upload_failures;
+
+    if (options->csv) {
+        printf("%s,%u,%u,%.1f,%.1f,%.1f,%.1f,%.3f,%.3f,%.3f,%.3f,%u,%u,%u,%u\n",
+               payload_content_type(), (unsigned)batch_size, (unsigned)rate_hz, per_second,
+               http_per_sample, eth_per_sample, body_per_sample,
+               bench_percentile_ms(lat, n, 50), bench_percentile_ms(lat, n, 95),
+               bench_percentile_ms(lat, n, 99), max_ms, (unsigned)result->uploads,
+               (unsigned)failures, (unsigned)result->read_failures, (unsigned)result->lost);
+    } else {
+        printf("%5u %7u %11.1f %10.1f %10.1f %10.1f %8.2f %8.2f %8.2f %8.2f %7u %6u %6u\n",
+               (unsigned)batch_size, (unsigned)rate_hz, per_second,
+               http_per_sample, eth_per_sample, body_per_sample,
+               bench_percentile_ms(lat, n, 50), bench_percentile_ms(lat, n, 95),
+               bench_percentile_ms(lat, n, 99), max_ms, (unsigned)result->uploads,
+               (unsigned)failures, (unsigned)result->read_failures);
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    bench_options_t options = { 0 };
+    if (!bench_parse_options(argc, argv, &options)) {
+        return 2;
+    }
+
+    FILE* record = NULL;
+    if (options.record_path != NULL && (record = fopen(options.record_path, "wb")) == NULL) {
+        perror(options.record_path);
+        return 1;
+    }
+    if (!ingest_server_start(TARGET_SERVER_IP, TARGET_PORT, record)) {
+        fprintf(stderr, "Não foi possível escutar em %s:%d.\n", TARGET_SERVER_IP, TARGET_PORT);
+        return 1;
+    }
+
+    stdio_init_all();
+    logger_init();
+    xTaskCreate(logger_task, "LoggerTask", 1024, NULL, tskIDLE_PRIORITY, NULL);
+
+    // Tensões constantes a meio da escala de cada sensor: o benchmark mede o
+    // pipeline, não os valores.
+    static const uint8_t rdy_pins[ADC_MAX_DEVICES] = ADC_ALERT_RDY_PINS;
+    ads1115_sim_t* adc_sims[ADC_DEVICE_COUNT];
+    for (uint8_t d = 0; d < ADC_DEVICE_COUNT; d++) {
+        adc_sims[d] = ads1115_sim_create(i2c0, ADC_DEVICE_I2C_ADDR(d), rdy_pins[d]);
+        if (adc_sims[d] == NULL) {
+            return 1;
+        }
+        for (uint input = 0; input < ADS1115_SIM_INPUTS; input++) {
+            const ads1115_sim_waveform_t wave = { ADS1115_SIM_CONSTANT, 1.65f, 0.0f, 0, 0.01f };
+            ads1115_sim_set_waveform(adc_sims[d], input, &wave);
+        }
+    }
+
+    if (sensors_init() != 0) {
+        fprintf(stderr, "Falha na inicialização dos sensores.\n");
+        return 1;
+    }
+
+    ethernet_config_t eth_config = {
+        .mac = {ETHERNET_MAC_0, ETHERNET_MAC_1, ETHERNET_MAC_2,
+                ETHERNET_MAC_3, ETHERNET_MAC_4, ETHERNET_MAC_5},
+        .ip = {DEVICE_IP_0, DEVICE_IP_1, DEVICE_IP_2, DEVICE_IP_3},
+        .subnet = {SUBNET_MASK_0, SUBNET_MASK_1, SUBNET_MASK_2, SUBNET_MASK_3},
+        .gateway = {GATEWAY_IP_0, GATEWAY_IP_1, GATEWAY_IP_2, GATEWAY_IP_3},
+        .dns = {8, 8, 8, 8},
+        .dhcp = NETINFO_STATIC
+    };
+    ethernet_init(&eth_config);
+
+    bench_print_header(&options);
+    for (size_t b = 0; b < options.batch_count; b++) {
+        for (size_t r = 0; r < options.rate_count; r++) {
+            bench_result_t result;
+            bench_run_case(adc_sims, options.rates[r], options.batches[b], options.duration_ms, &result);
+            bench_print_result(&options, options.rates[r], options.batches[b], &result);
+            free(result.latencies_us);
+        }
+    }
+
+    if (record != NULL) {
+        fclose(record);
+    }
+    return 0;
+}
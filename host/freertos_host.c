@@ -0,0 +1,262 @@
+/**
+ * @file freertos_host.c
+ * @brief Implementação POSIX do subconjunto do FreeRTOS usado pelo firmware.
+ *
+ * Cada tarefa é uma thread e cada notificação um valor (contador ou bits)
+ * protegido por um mutex, com uma variável de condição para as esperas com
+ * timeout. As
+ * threads que não foram criadas por xTaskCreate() (ex: main) recebem um
+ * handle na primeira utilização, para poderem esperar por notificações.
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "host_platform.h"
+#include "pico/stdlib.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+struct host_task {
+    pthread_t thread;
+    TaskFunction_t function;
+    void* params;
+    const char* name;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t notify_value[configTASK_NOTIFICATION_ARRAY_ENTRIES];
+    bool notify_pending[configTASK_NOTIFICATION_ARRAY_ENTRIES];
+};
+
+static __thread struct host_task* current_task;
+
+static struct host_task* host_task_new(const char* name) {
+    struct host_task* task = calloc(1, sizeof(*task));
+    if (task == NULL) {
+        return NULL;
+    }
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&task->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&task->lock, NULL);
+    task->name = name;
+    return task;
+}
+
+static void* host_task_entry(void* arg) {
+    struct host_task* task = arg;
+    current_task = task;
+    task->function(task->params);
+
+    // Uma tarefa do FreeRTOS não pode retornar; termina como vTaskDelete(NULL).
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, __unused uint32_t stack_depth,
+                       void* params, __unused UBaseType_t priority, TaskHandle_t* created_task) {
+    struct host_task* task = host_task_new(name);
+    if (task == NULL) {
+        return pdFAIL;
+    }
+    task->function = function;
+    task->params = params;
+
+    // O handle é publicado antes de a tarefa correr, como no FreeRTOS.
+    if (created_task != NULL) {
+        *created_task = task;
+    }
+
+    if (pthread_create(&task->thread, NULL, host_task_entry, task) != 0) {
+        if (created_task != NULL) {
+            *created_task = NULL;
+        }
+        free(task);
+        return pdFAIL;
+    }
+    pthread_detach(task->thread);
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == NULL || task == current_task) {
+        pthread_exit(NULL);
+    }
+    pthread_cancel(task->thread);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    if (current_task == NULL) {
+        current_task = host_task_new("host");
+        if (current_task == NULL) {
+            abort();
+        }
+        current_task->thread = pthread_self();
+    }
+    return current_task;
+}
+
+// Cada tarefa arranca logo em xTaskCreate(): não há um arranque do escalonador a esperar.
+BaseType_t xTaskGetSchedulerState(void) {
+    return taskSCHEDULER_RUNNING;
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(time_us_64() / (1000000u / configTICK_RATE_HZ));
+}
+
+void vTaskDelay(TickType_t ticks) {
+    sleep_us((uint64_t)ticks * (1000000u / configTICK_RATE_HZ));
+}
+
+void vTaskDelayUntil(TickType_t* previous_wake, TickType_t period) {
+    *previous_wake += period;
+    int32_t remaining = (int32_t)(*previous_wake - xTaskGetTickCount());
+    if (remaining > 0) {
+        vTaskDelay((TickType_t)remaining);
+    }
+}
+
+static struct timespec host_deadline(TickType_t ticks_to_wait) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    uint64_t wait_ns = (uint64_t)ticks_to_wait * (1000000000u / configTICK_RATE_HZ);
+    deadline.tv_sec += (time_t)(wait_ns / 1000000000u);
+    deadline.tv_nsec += (long)(wait_ns % 1000000000u);
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    return deadline;
+}
+
+uint32_t ulTaskNotifyTakeIndexed(UBaseType_t index, BaseType_t clear_on_exit, TickType_t ticks_to_wait) {
+    struct host_task* task = xTaskGetCurrentTaskHandle();
+    uint32_t* value = &task->notify_value[index];
+    struct timespec deadline = host_deadline(ticks_to_wait);
+
+    pthread_mutex_lock(&task->lock);
+    while (*value == 0 && ticks_to_wait > 0) {
+        if (ticks_to_wait == portMAX_DELAY) {
+            pthread_cond_wait(&task->cond, &task->lock);
+        } else if (pthread_cond_timedwait(&task->cond, &task->lock, &deadline) != 0) {
+            break;
+        }
+    }
+
+    uint32_t taken = *value;
+    if (taken > 0) {
+        *value = clear_on_exit ? 0 : taken - 1;
+    }
+    task->notify_pending[index] = false;
+    pthread_mutex_unlock(&task->lock);
+
+    return taken;
+}
+
+BaseType_t xTaskNotifyWaitIndexed(UBaseType_t index, uint32_t clear_on_entry, uint32_t clear_on_exit,
+                                  uint32_t* value_out, TickType_t ticks_to_wait) {
+    struct host_task* task = xTaskGetCurrentTaskHandle();
+    struct timespec deadline = host_deadline(ticks_to_wait);
+
+    pthread_mutex_lock(&task->lock);
+    if (!task->notify_pending[index]) {
+        task->notify_value[index] &= ~clear_on_entry;
+    }
+    while (!task->notify_pending[index] && ticks_to_wait > 0) {
+        if (ticks_to_wait == portMAX_DELAY) {
+            pthread_cond_wait(&task->cond, &task->lock);
+        } else if (pthread_cond_timedwait(&task->cond, &task->lock, &deadline) != 0) {
+            break;
+        }
+    }
+
+    BaseType_t notified = task->notify_pending[index] ? pdTRUE : pdFALSE;
+    if (value_out != NULL) {
+        *value_out = task->notify_value[index];
+    }
+    if (notified) {
+        task->notify_value[index] &= ~clear_on_exit;
+        task->notify_pending[index] = false;
+    }
+    pthread_mutex_unlock(&task->lock);
+
+    return notified;
+}
+
+BaseType_t xTaskNotifyGiveIndexed(TaskHandle_t task, UBaseType_t index) {
+    return xTaskNotifyIndexed(task, index, 0, eIncrement);
+}
+
+BaseType_t xTaskNotifyIndexed(TaskHandle_t task, UBaseType_t index, uint32_t value, eNotifyAction action) {
+    pthread_mutex_lock(&task->lock);
+    switch (action) {
+    case eSetBits:
+        task->notify_value[index] |= value;
+        break;
+    case eIncrement:
+        task->notify_value[index]++;
+        break;
+    case eSetValueWithOverwrite:
+        task->notify_value[index] = value;
+        break;
+    case eNoAction:
+    default:
+        break;
+    }
+    task->notify_pending[index] = true;
+    pthread_cond_signal(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyIndexedFromISR(TaskHandle_t task, UBaseType_t index, uint32_t value,
+                                     eNotifyAction action, BaseType_t* higher_priority_woken) {
+    BaseType_t result = xTaskNotifyIndexed(task, index, value, action);
+    if (higher_priority_woken != NULL) {
+        *higher_priority_woken = pdFALSE;
+    }
+    return result;
+}
+
+void vTaskNotifyGiveIndexedFromISR(TaskHandle_t task, UBaseType_t index, BaseType_t* higher_priority_woken) {
+    xTaskNotifyGiveIndexed(task, index);
+    if (higher_priority_woken != NULL) {
+        *higher_priority_woken = pdFALSE;
+    }
+}
+
+struct host_mutex {
+    pthread_mutex_t lock;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    struct host_mutex* mutex = calloc(1, sizeof(*mutex));
+    if (mutex != NULL) {
+        pthread_mutex_init(&mutex->lock, NULL);
+    }
+    return mutex;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks_to_wait) {
+    if (ticks_to_wait == portMAX_DELAY) {
+        return pthread_mutex_lock(&mutex->lock) == 0 ? pdTRUE : pdFALSE;
+    }
+    struct timespec deadline = host_deadline(ticks_to_wait);
+    return pthread_mutex_clocklock(&mutex->lock, CLOCK_MONOTONIC, &deadline) == 0 ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+    return pthread_mutex_unlock(&mutex->lock) == 0 ? pdTRUE : pdFALSE;
+}
+
+void vTaskEnterCritical(void) {
+    host_irq_lock();
+}
+
+void vTaskExitCritical(void) {
+    host_irq_unlock();
+}
@@ -0,0 +1,154 @@
+# Build host (CIP_PLATFORM=host): o firmware compilado para Linux.
+#
+# host/include substitui os cabeçalhos do Pico SDK, do FreeRTOS e do
+# ioLibrary usados pelos módulos; host_platform implementa-os sobre POSIX.
+# Os módulos e a biblioteca pico-ads1115 compilam sem alterações. O
+# secrets.cmake não é necessário: o servidor e a rede vêm dos valores
+# abaixo, alteráveis com -D na configuração.
+
+if(NOT CMAKE_BUILD_TYPE)
+    set(CMAKE_BUILD_TYPE RelWithDebInfo CACHE STRING "Tipo de build" FORCE)
+endif()
+
+set(TARGET_SERVER_IP 127.0.0.1 CACHE STRING "Servidor de ingestão no build host")
+set(TARGET_PORT 8080 CACHE STRING "Porta do servidor de ingestão no build host")
+set(TARGET_PATH /ingest CACHE STRING "Caminho do pedido POST no build host")
+set(BEARER_TOKEN host CACHE STRING "Token enviado no build host")
+
+# Usadas apenas para o registo de arranque: os sockets são do sistema.
+set(ETHERNET_MAC 0x02 0x00 0x00 0x00 0x00 0x01)
+set(DEVICE_IP 127 0 0 1)
+set(GATEWAY_IP 127 0 0 1)
+set(SUBNET_MASK 255 0 0 0)
+
+include(${CMAKE_SOURCE_DIR}/config.cmake)
+
+# O servidor SNTP do host é o de host/ntp_server.c (main_host --ntp), numa
+# porta sem privilégios.
+set(SNTP_SERVER_IP 127 0 0 1)
+set(SNTP_SERVER_PORT 12300 CACHE STRING "Porta do servidor SNTP no build host")
+
+include(${CMAKE_SOURCE_DIR}/firmware.cmake)
+
+find_package(Threads REQUIRED)
+
+# Pico SDK, FreeRTOS e W5500 sobre POSIX, e os servidores de ingestão e SNTP em loopback
+add_library(host_platform STATIC
+    ${CMAKE_CURRENT_LIST_DIR}/pico_host.c
+    ${CMAKE_CURRENT_LIST_DIR}/freertos_host.c
+    ${CMAKE_CURRENT_LIST_DIR}/ads1115_sim.c
+    ${CMAKE_CURRENT_LIST_DIR}/w5500_posix.c
+    ${CMAKE_CURRENT_LIST_DIR}/ingest_server.c
+    ${CMAKE_CURRENT_LIST_DIR}/ntp_server.c
+)
+
+target_include_directories(host_platform PUBLIC
+    ${CMAKE_CURRENT_LIST_DIR}/include
+    ${CMAKE_CURRENT_LIST_DIR}
+    ${CMAKE_SOURCE_DIR}
+    ${CMAKE_SOURCE_DIR}/modules/ethernet_manager
+)
+
+target_compile_definitions(host_platform PRIVATE _GNU_SOURCE)
+firmware_compile_definitions(host_platform)
+target_link_libraries(host_platform PUBLIC Threads::Threads m)
+
+# Nomes das bibliotecas do SDK de que a pico-ads1115 depende
+add_library(pico_stdlib INTERFACE)
+target_link_libraries(pico_stdlib INTERFACE host_platform)
+add_library(hardware_i2c INTERFACE)
+target_link_libraries(hardware_i2c INTERFACE host_platform)
+
+set(pico-ads1115_SOURCE_DIR ${CMAKE_SOURCE_DIR}/drivers/pico-ads1115)
+add_subdirectory(${pico-ads1115_SOURCE_DIR}/lib pico-ads1115-lib)
+
+add_executable(main_host
+    ${CMAKE_CURRENT_LIST_DIR}/main_host.c
+    ${CMAKE_SOURCE_DIR}/modules/flash_store/flash_io_file.c
+    ${CMAKE_SOURCE_DIR}/modules/i2c_bus/i2c_bus_blocking.c
+    ${FIRMWARE_MODULE_SOURCES}
+)
+
+firmware_compile_definitions(main_host)
+target_compile_options(main_host PRIVATE -Wall -fno-omit-frame-pointer)
+target_link_libraries(main_host host_platform pico-ads1115)
+
+# Benchmark do pipeline (host/bench_pipeline.c): um executável por formato
+# do corpo, com lotes até HOST_BENCH_MAX_BATCH leituras e só avisos e erros
+# no registo. `cmake --build <dir> --target bench` executa os dois.
+set(HOST_BENCH_MAX_BATCH 50 CACHE STRING "Leituras por lote máximas no benchmark")
+
+function(host_add_bench format)
+    string(TOLOWER ${format} suffix)
+    set(PAYLOAD_FORMAT ${format})
+    set(BATCH_MAX_READINGS ${HOST_BENCH_MAX_BATCH})
+    set(LOG_LEVEL WARN)
+
+    add_executable(bench_pipeline_${suffix}
+        ${CMAKE_SOURCE_DIR}/host/bench_pipeline.c
+        ${CMAKE_SOURCE_DIR}/modules/i2c_bus/i2c_bus_blocking.c
+        ${FIRMWARE_MODULE_SOURCES}
+    )
+    firmware_compile_definitions(bench_pipeline_${suffix})
+    target_compile_options(bench_pipeline_${suffix} PRIVATE -Wall -fno-omit-frame-pointer)
+    target_link_libraries(bench_pipeline_${suffix} host_platform pico-ads1115)
+endfunction()
+
+host_add_bench(JSON)
+host_add_bench(CBOR)
+
+add_custom_target(bench
+    COMMAND bench_pipeline_json
+    COMMAND bench_pipeline_cbor
+    DEPENDS bench_pipeline_json bench_pipeline_cbor
+    USES_TERMINAL
+)
+
+# Testes do host (host/tests): um executável por ficheiro, com os módulos do
+# firmware e a plataforma host, executados pelo ctest.
+enable_testing()
+
+function(host_add_test name)
+    add_executable(${name}
+        ${CMAKE_SOURCE_DIR}/host/tests/${name}.c
+        ${CMAKE_SOURCE_DIR}/modules/flash_store/flash_io_file.c
+        ${CMAKE_SOURCE_DIR}/modules/i2c_bus/i2c_bus_blocking.c
+        ${FIRMWARE_MODULE_SOURCES}
+    )
+    firmware_compile_definitions(${name})
+    target_compile_options(${name} PRIVATE -Wall)
+    target_link_libraries(${name} host_platform pico-ads1115)
+    add_test(NAME ${name} COMMAND ${name} ${ARGN})
+endfunction()
+
+host_add_test(test_adc_channels)
+host_add_test(test_flash_store ${CMAKE_CURRENT_BINARY_DIR}/test_flash_store.bin)
+host_add_test(test_http_parser ${CMAKE_SOURCE_DIR}/host/tests/http_corpus)
+host_add_test(test_retry_scheduler)
+
+# Ida e volta do corpo de telemetria: test_payload_encode codifica leituras
+# de teste num dos formatos e test_payload_decode.py descodifica-as com
+# tools/payload_decode.py, comparando valor a valor.
+find_package(Python3 COMPONENTS Interpreter)
+
+function(host_add_payload_test format)
+    string(TOLOWER ${format} suffix)
+    set(PAYLOAD_FORMAT ${format})
+
+    add_executable(test_payload_encode_${suffix}
+        ${CMAKE_SOURCE_DIR}/host/tests/test_payload_encode.c
+        ${CMAKE_SOURCE_DIR}/modules/i2c_bus/i2c_bus_blocking.c
+        ${FIRMWARE_MODULE_SOURCES}
+    )
+    firmware_compile_definitions(test_payload_encode_${suffix})
+    target_compile_options(test_payload_encode_${suffix} PRIVATE -Wall)
+    target_link_libraries(test_payload_encode_${suffix} host_platform pico-ads1115)
+    add_test(NAME test_payload_decode_${suffix}
+        COMMAND ${Python3_EXECUTABLE} ${CMAKE_SOURCE_DIR}/host/tests/test_payload_decode.py
+                $<TARGET_FILE:test_payload_encode_${suffix}> ${CMAKE_CURRENT_BINARY_DIR}/test_payload_${suffix})
+endfunction()
+
+if(Python3_Interpreter_FOUND)
+    host_add_payload_test(JSON)
+    host_add_payload_test(CBOR)
+endif()
@@ -0,0 +1,59 @@
+/**
+ * @file host_platform.h
+ * @brief Ligação dos dispositivos simulados ao Pico SDK do build host.
+ *
+ * Os módulos do firmware não usam este cabeçalho: apenas os simuladores
+ * (ex: ads1115_sim.h) e o ponto de entrada do host, que acionam pinos e
+ * respondem a transações I2C do lado do dispositivo.
+ */
+#ifndef HOST_PLATFORM_H
+#define HOST_PLATFORM_H
+
+#include "pico.h"
+#include "hardware/i2c.h"
+
+/**
+ * @brief Número de pinos GPIO do RP2040.
+ */
+#define HOST_GPIO_COUNT 30
+
+/**
+ * @brief Um dispositivo no barramento I2C, visto do lado do escravo.
+ *
+ * Cada função recebe uma transação completa dirigida ao endereço do
+ * dispositivo e retorna o número de bytes transferidos, ou
+ * PICO_ERROR_GENERIC para responder com NACK.
+ */
+typedef struct {
+    int (*write)(void* context, const uint8_t* src, size_t len, bool nostop);
+    int (*read)(void* context, uint8_t* dst, size_t len, bool nostop);
+    void* context;
+} host_i2c_device_t;
+
+/**
+ * @brief Liga um dispositivo simulado a um endereço do barramento.
+ * @return true em caso de sucesso, false se o endereço já estiver ocupado.
+ */
+bool host_i2c_attach(i2c_inst_t* i2c, uint8_t addr, const host_i2c_device_t* device);
+
+/**
+ * @brief Aciona o nível de um pino a partir de um dispositivo externo.
+ *
+ * Gera as interrupções de flanco e de nível ativas no pino, executando o
+ * tratador registado com gpio_add_raw_irq_handler() na thread que chama,
+ * como se fosse uma ISR (ver host_irq_lock()). Se outra thread tiver as
+ * "interrupções" desativadas, o flanco fica registado e o tratador corre
+ * nessa thread quando ela as reativar.
+ */
+void host_gpio_drive(uint gpio, bool level);
+
+/**
+ * @brief Exclui as "interrupções" simuladas, como o mascaramento de IRQs na placa.
+ *
+ * Trinco recursivo tomado durante os tratadores de GPIO, pelas secções
+ * críticas do FreeRTOS e por save_and_disable_interrupts().
+ */
+void host_irq_lock(void);
+void host_irq_unlock(void);
+
+#endif // HOST_PLATFORM_H
@@ -0,0 +1,38 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Tipos e configuração do FreeRTOS, para o build host.
+ *
+ * Cada tarefa é uma thread POSIX e um tick vale 1 ms. O host executa como
+ * um único núcleo, sem afinidade de tarefas.
+ */
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE  ((BaseType_t)1)
+#define pdFAIL  pdFALSE
+#define pdPASS  pdTRUE
+
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+
+#define configTICK_RATE_HZ                    ((TickType_t)1000)
+#define configMAX_PRIORITIES                  32
+#define configMINIMAL_STACK_SIZE              256
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES 4
+#define configNUM_CORES                       1
+#define configUSE_CORE_AFFINITY               0
+
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000u))
+
+// Os tratadores de interrupção simulados correm noutra thread: não há
+// troca de contexto a pedir no fim da ISR.
+#define portYIELD_FROM_ISR(x) ((void)(x))
+
+#endif // INC_FREERTOS_H
@@ -0,0 +1,21 @@
+/**
+ * @file clocks.h
+ * @brief Relógios do RP2040, para o build host.
+ *
+ * Reporta a frequência nominal do sistema, para que as medidas em ciclos
+ * (ex: ANALOG_SENSOR_BENCHMARK) tenham a mesma escala que na placa.
+ */
+#ifndef _HARDWARE_CLOCKS_H
+#define _HARDWARE_CLOCKS_H
+
+#include "pico.h"
+
+enum clock_index {
+    clk_sys = 5
+};
+
+static inline uint32_t clock_get_hz(__unused enum clock_index clk_index) {
+    return 125000000u;
+}
+
+#endif // _HARDWARE_CLOCKS_H
@@ -0,0 +1,16 @@
+/**
+ * @file irq.h
+ * @brief Controlo de interrupções do RP2040, para o build host.
+ */
+#ifndef _HARDWARE_IRQ_H
+#define _HARDWARE_IRQ_H
+
+#include "pico.h"
+
+#define IO_IRQ_BANK0 13
+
+typedef void (*irq_handler_t)(void);
+
+void irq_set_enabled(uint num, bool enabled);
+
+#endif // _HARDWARE_IRQ_H
@@ -0,0 +1,28 @@
+/**
+ * @file sync.h
+ * @brief Spinlocks, barreiras e interrupções do RP2040, para o build host.
+ *
+ * "Desativar as interrupções" toma o mesmo trinco recursivo sob o qual os
+ * dispositivos simulados chamam os tratadores de GPIO (ver host_platform.h).
+ */
+#ifndef _HARDWARE_SYNC_H
+#define _HARDWARE_SYNC_H
+
+#include "pico.h"
+#include <stdatomic.h>
+
+typedef struct host_spin_lock spin_lock_t;
+
+static inline void __dmb(void) {
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+int spin_lock_claim_unused(bool required);
+spin_lock_t* spin_lock_instance(uint lock_num);
+uint32_t spin_lock_blocking(spin_lock_t* lock);
+void spin_unlock(spin_lock_t* lock, uint32_t saved_irq);
+
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+#endif // _HARDWARE_SYNC_H
@@ -0,0 +1,45 @@
+/**
+ * @file pico.h
+ * @brief Tipos e macros base do Pico SDK, para o build host.
+ *
+ * Os cabeçalhos em host/include reproduzem apenas o subconjunto do Pico SDK,
+ * do FreeRTOS e da ioLibrary usado pelos módulos; as implementações estão
+ * nos ficheiros .c de host/.
+ */
+#ifndef _PICO_H
+#define _PICO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+#ifndef __unused
+#define __unused __attribute__((unused))
+#endif
+
+// No host todo o código corre da RAM.
+#define __not_in_flash_func(func_name) func_name
+
+enum pico_error_codes {
+    PICO_OK = 0,
+    PICO_ERROR_NONE = 0,
+    PICO_ERROR_TIMEOUT = -1,
+    PICO_ERROR_GENERIC = -2,
+    PICO_ERROR_NO_DATA = -3
+};
+
+/**
+ * @brief Corpo de uma espera ativa; no host cede o processador às outras threads.
+ */
+void tight_loop_contents(void);
+
+/**
+ * @brief Número do núcleo atual; o host executa como um único núcleo.
+ */
+static inline uint get_core_num(void) {
+    return 0;
+}
+
+#endif // _PICO_H
@@ -0,0 +1,12 @@
+/**
+ * @file rand.h
+ * @brief Números aleatórios do Pico SDK, para o build host.
+ */
+#ifndef _PICO_RAND_H
+#define _PICO_RAND_H
+
+#include "pico.h"
+
+uint32_t get_rand_32(void);
+
+#endif // _PICO_RAND_H
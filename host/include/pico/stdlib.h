@@ -0,0 +1,34 @@
+/**
+ * @file stdlib.h
+ * @brief Tempo, pausas e stdio do Pico SDK sobre POSIX, para o build host.
+ *
+ * O relógio é o CLOCK_MONOTONIC, contado a partir do arranque do processo.
+ */
+#ifndef _PICO_STDLIB_H
+#define _PICO_STDLIB_H
+
+#include "pico.h"
+
+typedef uint64_t absolute_time_t;
+
+uint64_t time_us_64(void);
+
+static inline uint32_t time_us_32(void) {
+    return (uint32_t)time_us_64();
+}
+
+static inline absolute_time_t get_absolute_time(void) {
+    return time_us_64();
+}
+
+static inline uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)(t / 1000u);
+}
+
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+bool stdio_init_all(void);
+int putchar_raw(int c);
+
+#endif // _PICO_STDLIB_H
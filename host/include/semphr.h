@@ -0,0 +1,19 @@
+/**
+ * @file semphr.h
+ * @brief Mutexes do FreeRTOS, para o build host.
+ *
+ * Cada mutex é um pthread_mutex_t; sem herança de prioridade, que as
+ * threads do sistema operativo não têm.
+ */
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+
+#include "FreeRTOS.h"
+
+typedef struct host_mutex* SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks_to_wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex);
+
+#endif // SEMAPHORE_H
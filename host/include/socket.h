@@ -0,0 +1,50 @@
+/**
+ * @file socket.h
+ * @brief API de sockets da ioLibrary, para o build host.
+ *
+ * Os nomes socket(), connect(), close(), sendto() e recvfrom() da ioLibrary
+ * colidem com os da API POSIX que os implementa: no host as funções têm o
+ * prefixo wiz_ e os nomes originais são macros, exceto em host/w5500_posix.c.
+ */
+#ifndef _SOCKET_H_
+#define _SOCKET_H_
+
+#include "wizchip_conf.h"
+
+#define SOCK_OK   1
+#define SOCK_BUSY 0
+#define SOCK_ERROR 0
+
+#define SOCKERR_SOCKNUM    (SOCK_ERROR - 1)
+#define SOCKERR_SOCKMODE   (SOCK_ERROR - 5)
+#define SOCKERR_SOCKSTATUS (SOCK_ERROR - 7)
+#define SOCKERR_ARG        (SOCK_ERROR - 10)
+#define SOCKERR_TIMEOUT    (SOCK_ERROR - 13)
+
+#define SOCK_IO_BLOCK    0
+#define SOCK_IO_NONBLOCK 1
+
+typedef enum {
+    CS_SET_IOMODE,
+    CS_GET_IOMODE
+} ctlsock_type;
+
+int8_t wiz_socket(uint8_t sn, uint8_t protocol, uint16_t port, uint8_t flag);
+int8_t wiz_close(uint8_t sn);
+int8_t wiz_connect(uint8_t sn, uint8_t* addr, uint16_t port);
+int8_t wiz_disconnect(uint8_t sn);
+int8_t wiz_ctlsocket(uint8_t sn, ctlsock_type cstype, void* arg);
+int32_t wiz_sendto(uint8_t sn, uint8_t* buf, uint16_t len, uint8_t* addr, uint16_t port);
+int32_t wiz_recvfrom(uint8_t sn, uint8_t* buf, uint16_t len, uint8_t* addr, uint16_t* port);
+
+#ifndef WIZ_SOCKET_NO_ALIASES
+#define socket(sn, protocol, port, flag) wiz_socket((sn), (protocol), (port), (flag))
+#define close(sn) wiz_close(sn)
+#define connect(sn, addr, port) wiz_connect((sn), (addr), (port))
+#define disconnect(sn) wiz_disconnect(sn)
+#define ctlsocket(sn, cstype, arg) wiz_ctlsocket((sn), (cstype), (arg))
+#define sendto(sn, buf, len, addr, port) wiz_sendto((sn), (buf), (len), (addr), (port))
+#define recvfrom(sn, buf, len, addr, port) wiz_recvfrom((sn), (buf), (len), (addr), (port))
+#endif
+
+#endif // _SOCKET_H_
@@ -0,0 +1,64 @@
+/**
+ * @file task.h
+ * @brief Tarefas, notificações e secções críticas do FreeRTOS, para o build host.
+ *
+ * As prioridades e a pilha indicadas são ignoradas: o escalonador do
+ * sistema operativo reparte o tempo entre as threads. As secções críticas
+ * excluem as outras tarefas e os tratadores de interrupção simulados.
+ */
+#ifndef INC_TASK_H
+#define INC_TASK_H
+
+#include "FreeRTOS.h"
+
+#define tskIDLE_PRIORITY ((UBaseType_t)0)
+
+#define taskSCHEDULER_SUSPENDED   ((BaseType_t)0)
+#define taskSCHEDULER_NOT_STARTED ((BaseType_t)1)
+#define taskSCHEDULER_RUNNING     ((BaseType_t)2)
+
+typedef struct host_task* TaskHandle_t;
+
+typedef enum {
+    eNoAction = 0,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite
+} eNotifyAction;
+typedef void (*TaskFunction_t)(void* params);
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char* name, uint32_t stack_depth,
+                       void* params, UBaseType_t priority, TaskHandle_t* created_task);
+void vTaskDelete(TaskHandle_t task);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+BaseType_t xTaskGetSchedulerState(void);
+
+TickType_t xTaskGetTickCount(void);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* previous_wake, TickType_t period);
+
+uint32_t ulTaskNotifyTakeIndexed(UBaseType_t index, BaseType_t clear_on_exit, TickType_t ticks_to_wait);
+BaseType_t xTaskNotifyGiveIndexed(TaskHandle_t task, UBaseType_t index);
+void vTaskNotifyGiveIndexedFromISR(TaskHandle_t task, UBaseType_t index, BaseType_t* higher_priority_woken);
+BaseType_t xTaskNotifyIndexed(TaskHandle_t task, UBaseType_t index, uint32_t value, eNotifyAction action);
+BaseType_t xTaskNotifyIndexedFromISR(TaskHandle_t task, UBaseType_t index, uint32_t value,
+                                     eNotifyAction action, BaseType_t* higher_priority_woken);
+BaseType_t xTaskNotifyWaitIndexed(UBaseType_t index, uint32_t clear_on_entry, uint32_t clear_on_exit,
+                                  uint32_t* value_out, TickType_t ticks_to_wait);
+
+#define ulTaskNotifyTake(clear, ticks) ulTaskNotifyTakeIndexed(0, (clear), (ticks))
+#define xTaskNotifyGive(task) xTaskNotifyGiveIndexed((task), 0)
+#define vTaskNotifyGiveFromISR(task, woken) vTaskNotifyGiveIndexedFromISR((task), 0, (woken))
+#define xTaskNotify(task, value, action) xTaskNotifyIndexed((task), 0, (value), (action))
+#define xTaskNotifyFromISR(task, value, action, woken) \
+    xTaskNotifyIndexedFromISR((task), 0, (value), (action), (woken))
+#define xTaskNotifyWait(clear_entry, clear_exit, value_out, ticks) \
+    xTaskNotifyWaitIndexed(0, (clear_entry), (clear_exit), (value_out), (ticks))
+
+void vTaskEnterCritical(void);
+void vTaskExitCritical(void);
+
+#define taskENTER_CRITICAL() vTaskEnterCritical()
+#define taskEXIT_CRITICAL()  vTaskExitCritical()
+
+#endif // INC_TASK_H
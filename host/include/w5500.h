@@ -0,0 +1,63 @@
+/**
+ * @file w5500.h
+ * @brief Registos dos sockets do W5500, para o build host.
+ *
+ * Os acessores leem e escrevem o estado de um socket TCP ou UDP do sistema com a
+ * semântica dos registos do chip: ponteiros de 16 bits na memória TX/RX de
+ * cada socket, comandos em Sn_CR e eventos em Sn_IR.
+ */
+#ifndef _W5500_H_
+#define _W5500_H_
+
+#include <stdint.h>
+
+#define Sn_MR_TCP 0x01
+#define Sn_MR_UDP 0x02
+
+#define Sn_CR_OPEN    0x01
+#define Sn_CR_CONNECT 0x04
+#define Sn_CR_DISCON  0x08
+#define Sn_CR_CLOSE   0x10
+#define Sn_CR_SEND    0x20
+#define Sn_CR_RECV    0x40
+
+#define Sn_IR_CON     0x01
+#define Sn_IR_DISCON  0x02
+#define Sn_IR_RECV    0x04
+#define Sn_IR_TIMEOUT 0x08
+#define Sn_IR_SENDOK  0x10
+
+#define SOCK_CLOSED      0x00
+#define SOCK_INIT        0x13
+#define SOCK_SYNSENT     0x15
+#define SOCK_ESTABLISHED 0x17
+#define SOCK_FIN_WAIT    0x18
+#define SOCK_CLOSE_WAIT  0x1C
+#define SOCK_UDP         0x22
+
+#define WIZCHIP_TXBUF_BLOCK(N) (2 + 4 * (N))
+#define WIZCHIP_RXBUF_BLOCK(N) (3 + 4 * (N))
+
+uint8_t getSn_SR(uint8_t sn);
+uint8_t getSn_IR(uint8_t sn);
+void setSn_IR(uint8_t sn, uint8_t ir);
+uint8_t getSn_IMR(uint8_t sn);
+void setSn_IMR(uint8_t sn, uint8_t imr);
+uint8_t getSn_CR(uint8_t sn);
+void setSn_CR(uint8_t sn, uint8_t cr);
+uint8_t getSIMR(void);
+void setSIMR(uint8_t simr);
+
+uint16_t getSn_TX_FSR(uint8_t sn);
+uint16_t getSn_TX_WR(uint8_t sn);
+void setSn_TX_WR(uint8_t sn, uint16_t wr);
+uint16_t getSn_RX_RSR(uint8_t sn);
+
+void wiz_send_data(uint8_t sn, uint8_t* wizdata, uint16_t len);
+void wiz_recv_data(uint8_t sn, uint8_t* wizdata, uint16_t len);
+void wiz_recv_ignore(uint8_t sn, uint16_t len);
+
+void WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
+void WIZCHIP_READ_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len);
+
+#endif // _W5500_H_
@@ -0,0 +1,32 @@
+/**
+ * @file wizchip_conf.h
+ * @brief Tipos de configuração da ioLibrary, para o build host.
+ *
+ * No host o W5500 é substituído pela pilha TCP/IP do sistema (ver
+ * host/w5500_posix.c); só os tipos usados pelos módulos são definidos.
+ */
+#ifndef _WIZCHIP_CONF_H_
+#define _WIZCHIP_CONF_H_
+
+#include <stdint.h>
+
+#define PHY_LINK_OFF 0
+#define PHY_LINK_ON  1
+
+typedef enum {
+    NETINFO_STATIC = 1,
+    NETINFO_DHCP
+} dhcp_mode;
+
+typedef struct wiz_NetInfo_t {
+    uint8_t mac[6];
+    uint8_t ip[4];
+    uint8_t sn[4];
+    uint8_t gw[4];
+    uint8_t dns[4];
+    dhcp_mode dhcp;
+} wiz_NetInfo;
+
+#include "w5500.h"
+
+#endif // _WIZCHIP_CONF_H_
@@ -0,0 +1,251 @@
+/**
+ * @file ingest_server.c
+ * @brief Implementação do servidor HTTP de ingestão em loopback.
+ *
+ * Só o necessário para os POSTs do firmware: pedidos com Content-Length,
+ * keep-alive e respostas 200 sem corpo.
+ */
+
+#include "ingest_server.h"
+#include "pico/stdlib.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Cabeçalhos e corpo de uma requisição têm de caber neste buffer.
+#define INGEST_BUFFER_SIZE (64 * 1024)
+#define INGEST_CONTENT_TYPE_MAX 64
+
+static const char ingest_response_ok[] = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+static const char ingest_response_bad[] =
+    "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static ingest_server_stats_t stats;
+static FILE* record_file;
+static int listen_fd = -1;
+
+/**
+ * @brief Conta as leituras de um corpo no formato indicado pelo Content-Type.
+ *
+ * JSON: um objeto por leitura. CBOR: o tamanho do array exterior.
+ */
+static uint32_t ingest_count_readings(const char* content_type, const uint8_t* body, size_t len) {
+    if (strstr(content_type, "json") != NULL) {
+        uint32_t count = 0;
+        for (size_t i = 0; i < len; i++) {
+            count += (body[i] == '{');
+        }
+        return count;
+    }
+
+    if (strstr(content_type, "cbor") != NULL && len > 0 && (body[0] >> 5) == 4) {
+        uint8_t info = body[0] & 0x1F;
+        if (info < 24) {
+            return info;
+        }
+        if (info == 24 && len >= 2) {
+            return body[1];
+        }
+        if (info == 25 && len >= 3) {
+            return ((uint32_t)body[1] << 8) | body[2];
+        }
+        if (info == 26 && len >= 5) {
+            return ((uint32_t)body[1] << 24) | ((uint32_t)body[2] << 16) |
+                   ((uint32_t)body[3] << 8) | body[4];
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Procura um cabeçalho (sem distinguir maiúsculas) e devolve o início do valor.
+ */
+static const char* ingest_find_header(const char* headers, const char* name) {
+    size_t name_len = strlen(name);
+
+    for (const char* line = strstr(headers, "\r\n"); line != NULL; line = strstr(line, "\r\n")) {
+        line += 2;
+        if (strncasecmp(line, name, name_len) == 0 && line[name_len] == ':') {
+            const char* value = line + name_len + 1;
+            return value + strspn(value, " \t");
+        }
+    }
+    return NULL;
+}
+
+static void ingest_record(uint64_t arrival_us, const char* content_type, const uint8_t* body,
+                          size_t len, uint32_t readings) {
+    pthread_mutex_lock(&stats_lock);
+    stats.requests++;
+    stats.body_bytes += len;
+    stats.readings += readings;
+    if (record_file != NULL) {
+        fprintf(record_file, "%llu %s %zu %u\n", (unsigned long long)arrival_us, content_type,
+                len, (unsigned)readings);
+        fwrite(body, 1, len, record_file);
+        fputc('\n', record_file);
+    }
+    pthread_mutex_unlock(&stats_lock);
+}
+
+static bool ingest_send_all(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t sent = send(fd, data, len, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        len -= (size_t)sent;
+    }
+    return true;
+}
+
+/**
+ * @brief Serve as requisições de uma conexão até o cliente a fechar.
+ */
+static void* ingest_connection_thread(void* arg) {
+    int fd = (int)(intptr_t)arg;
+    char* buffer = malloc(INGEST_BUFFER_SIZE);
+    size_t used = 0;
+    int one = 1;
+
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    while (buffer != NULL) {
+        // Cabeçalhos completos? O corpo CBOR pode conter bytes nulos.
+        char* headers_end = memmem(buffer, used, "\r\n\r\n", 4);
+        if (headers_end == NULL) {
+            if (used == INGEST_BUFFER_SIZE) {
+                break;
+            }
+            ssize_t received = recv(fd, buffer + used, INGEST_BUFFER_SIZE - used, 0);
+            if (received <= 0) {
+                break;
+            }
+            pthread_mutex_lock(&stats_lock);
+            stats.request_bytes += (uint64_t)received;
+            pthread_mutex_unlock(&stats_lock);
+            used += (size_t)received;
+            continue;
+        }
+
+        size_t header_len = (size_t)(headers_end - buffer) + 4;
+        headers_end[2] = '\0';
+        const char* length_value = ingest_find_header(buffer, "Content-Length");
+        const char* type_value = ingest_find_header(buffer, "Content-Type");
+        size_t body_len = length_value ? strtoul(length_value, NULL, 10) : 0;
+
+        if (length_value == NULL || header_len + body_len > INGEST_BUFFER_SIZE) {
+            pthread_mutex_lock(&stats_lock);
+            stats.rejected++;
+            pthread_mutex_unlock(&stats_lock);
+            ingest_send_all(fd, ingest_response_bad, sizeof(ingest_response_bad) - 1);
+            break;
+        }
+
+        char content_type[INGEST_CONTENT_TYPE_MAX] = "-";
+        if (type_value != NULL) {
+            size_t type_len = strcspn(type_value, ";\r\n");
+            if (type_len >= sizeof(content_type)) {
+                type_len = sizeof(content_type) - 1;
+            }
+            memcpy(content_type, type_value, type_len);
+            content_type[type_len] = '\0';
+        }
+
+        // Corpo completo?
+        bool closed = false;
+        while (used < header_len + body_len) {
+            ssize_t received = recv(fd, buffer + used, INGEST_BUFFER_SIZE - used, 0);
+            if (received <= 0) {
+                closed = true;
+                break;
+            }
+            pthread_mutex_lock(&stats_lock);
+            stats.request_bytes += (uint64_t)received;
+            pthread_mutex_unlock(&stats_lock);
+            used += (size_t)received;
+        }
+        if (closed) {
+            break;
+        }
+
+        const uint8_t* body = (const uint8_t*)buffer + header_len;
+        ingest_record(time_us_64(), content_type, body, body_len,
+                      ingest_count_readings(content_type, body, body_len));
+        if (!ingest_send_all(fd, ingest_response_ok, sizeof(ingest_response_ok) - 1)) {
+            break;
+        }
+
+        // Bytes já recebidos da requisição seguinte.
+        size_t consumed = header_len + body_len;
+        memmove(buffer, buffer + consumed, used - consumed);
+        used -= consumed;
+    }
+
+    free(buffer);
+    close(fd);
+    return NULL;
+}
+
+static void* ingest_accept_thread(__unused void* arg) {
+    while (1) {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, ingest_connection_thread, (void*)(intptr_t)fd) == 0) {
+            pthread_detach(thread);
+        } else {
+            close(fd);
+        }
+    }
+    return NULL;
+}
+
+bool ingest_server_start(const char* ip, uint16_t port, FILE* record) {
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(port) };
+    int one = 1;
+
+    if (listen_fd >= 0 || inet_pton(AF_INET, ip, &addr.sin_addr) != 1) {
+        return false;
+    }
+
+    listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        return false;
+    }
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(listen_fd, (const struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+        listen(listen_fd, 8) != 0) {
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+
+    record_file = record;
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, ingest_accept_thread, NULL) != 0) {
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+    pthread_detach(thread);
+    return true;
+}
+
+void ingest_server_get_stats(ingest_server_stats_t* out) {
+    pthread_mutex_lock(&stats_lock);
+    *out = stats;
+    pthread_mutex_unlock(&stats_lock);
+}
@@ -0,0 +1,46 @@
+/**
+ * @file ingest_server.h
+ * @brief Servidor HTTP de ingestão em loopback, substituto do servidor real no host.
+ *
+ * Aceita POSTs HTTP/1.1 com keep-alive, responde 200 a cada um e regista o
+ * que recebe: requisições, bytes HTTP (linha de pedido, cabeçalhos e corpo)
+ * e leituras por corpo, contadas no formato indicado pelo Content-Type
+ * (JSON ou CBOR, ver payload_encoder.h). Cada conexão é servida numa
+ * thread própria, como as conexões ao vivo e de drenagem do firmware.
+ */
+#ifndef INGEST_SERVER_H
+#define INGEST_SERVER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @struct ingest_server_stats_t
+ * @brief Totais acumulados desde o arranque do servidor.
+ */
+typedef struct {
+    uint64_t requests;      /**< Requisições respondidas com 200. */
+    uint64_t request_bytes; /**< Bytes HTTP recebidos: linha de pedido, cabeçalhos e corpo. */
+    uint64_t body_bytes;    /**< Bytes dos corpos. */
+    uint64_t readings;      /**< Leituras contadas nos corpos. */
+    uint64_t rejected;      /**< Requisições malformadas, respondidas com 400. */
+} ingest_server_stats_t;
+
+/**
+ * @brief Abre o socket de escuta e inicia a thread que aceita conexões.
+ *
+ * @param ip O endereço IPv4 de escuta (ex: "127.0.0.1").
+ * @param port A porta TCP.
+ * @param record Ficheiro opcional onde cada requisição é gravada: uma linha
+ * "<instante_us> <content-type> <bytes do corpo> <leituras>" seguida do corpo.
+ * @return true se o servidor ficou à escuta.
+ */
+bool ingest_server_start(const char* ip, uint16_t port, FILE* record);
+
+/**
+ * @brief Copia os totais acumulados.
+ */
+void ingest_server_get_stats(ingest_server_stats_t* stats);
+
+#endif // INGEST_SERVER_H
@@ -0,0 +1,464 @@
+/**
+ * @file main_host.c
+ * @brief Ponto de entrada do build host: o ciclo amostragem→codificação→envio em Linux.
+ *
+ * Os módulos do firmware são os mesmos da placa. Os ADS1115 são simulados no
+ * barramento I2C, os sockets do W5500 são sockets TCP do sistema e a
+ * região de store-and-forward é um ficheiro. Com --ntp o servidor SNTP é
+ * host/ntp_server.c, em loopback. As tarefas de amostragem e de
+ * rede de src/main.c são aqui um único ciclo, com ritmo configurável (até
+ * milhares de ciclos por segundo com o ADS1115 acelerado), para que o
+ * pipeline possa ser medido com ferramentas comuns (perf, valgrind).
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "ads1115_sim.h"
+#include "ntp_server.h"
+#include "modules/adc_manager/adc_manager.h"
+#include "modules/ethernet_manager/ethernet_manager.h"
+#include "modules/sensor_manager/sensor_manager.h"
+#include "modules/batch_manager/batch_manager.h"
+#include "modules/sntp_client/sntp_client.h"
+#include "modules/flash_store/flash_store.h"
+#include "modules/config_store/config_store.h"
+#include "modules/report_filter/report_filter.h"
+#include "modules/trace/trace.h"
+#include "modules/logger/logger.h"
+
+// Entradas analógicas de todos os conversores: a entrada N é a AIN(N % 4) do conversor N / 4
+#define HOST_ADC_INPUTS       (ADC_DEVICE_COUNT * ADS1115_SIM_INPUTS)
+#define HOST_FLASH_FILE       "host_flash.bin"
+#define HOST_CONFIG_FILE      "host_config.bin"
+// Tempo dado à tarefa de registo para esvaziar o anel antes de sair
+#define HOST_LOG_DRAIN_MS     100
+// Conversões aguardadas antes do primeiro ciclo: duas voltas do round-robin de
+// cada conversor, com a conversão descartada depois de cada troca de canal
+#define HOST_WARMUP_CONVERSIONS (4 * HOST_ADC_INPUTS)
+#define HOST_WARMUP_TIMEOUT_MS  1000
+
+/**
+ * @struct host_options_t
+ * @brief Opções da linha de comandos.
+ */
+typedef struct {
+    uint32_t cycles;          /**< Ciclos a executar; 0 = até SIGINT. */
+    uint32_t rate_hz;         /**< Ciclos por segundo; 0 = ciclos seguidos. */
+    const char* flash_path;
+    const char* config_path;
+    bool schedule;            /**< Amostrar cada sensor no seu período (config_store) em vez de a `rate_hz`. */
+    float adc_speed;
+    const char* adc_script;
+    bool ntp_server;          /**< Servir o SNTP em loopback (host/ntp_server.c). */
+    ads1115_sim_waveform_t waves[HOST_ADC_INPUTS];
+} host_options_t;
+
+static volatile sig_atomic_t stop_requested;
+
+static void host_on_signal(__unused int signum) {
+    stop_requested = 1;
+}
+
+static void host_usage(const char* program) {
+    fprintf(stderr,
+            "Uso: %s [opções]\n"
+            "  -n, --cycles N          ciclos a executar (0 = até Ctrl+C; padrão 0)\n"
+            "  -r, --rate HZ           ciclos por segundo (padrão %d; 0 = ciclos seguidos)\n"
+            "  -f, --flash FICHEIRO    região de store-and-forward (padrão " HOST_FLASH_FILE ")\n"
+            "  -c, --config FICHEIRO   região de configuração (padrão " HOST_CONFIG_FILE ")\n"
+            "  -p, --schedule          cada sensor no seu período de amostragem, como na placa\n"
+            "                          (os ciclos passam a ser os instantes com sensores devidos)\n"
+            "  -s, --adc-speed X       fator de aceleração dos ADS1115 simulados (padrão 1)\n"
+            "  -w, --adc-wave ESPEC    forma de onda de uma entrada:\n"
+            "                          AIN:FORMA:OFFSET_V[:AMPLITUDE_V[:PERIODO_MS[:RUIDO_V]]]\n"
+            "                          AIN: 0 a %d (4 x conversor + entrada do conversor)\n"
+            "                          FORMA: const, sine, square ou saw\n"
+            "  -S, --adc-script FICH   tensões por conversão, uma coluna por entrada (AIN0..AIN%d)\n"
+            "  -t, --ntp               servidor SNTP local com o relógio do sistema, na porta %d\n"
+            "                          (sem ele as leituras levam a idade em vez do tempo Unix)\n",
+            program, 1000 / CYCLE_INTERVAL_MS, HOST_ADC_INPUTS - 1, HOST_ADC_INPUTS - 1,
+            SNTP_SERVER_PORT);
+}
+
+static bool host_parse_wave(const char* spec, host_options_t* options) {
+    static const char* const kinds[] = { "const", "sine", "square", "saw" };
+    char kind[16];
+    unsigned input;
+    ads1115_sim_waveform_t wave = { 0 };
+
+    int fields = sscanf(spec, "%u:%15[a-z]:%f:%f:%u:%f", &input, kind, &wave.offset_v,
+                        &wave.amplitude_v, &wave.period_ms, &wave.noise_v);
+    if (fields < 3 || input >= HOST_ADC_INPUTS) {
+        return false;
+    }
+
+    for (size_t i = 0; i < sizeof(kinds) / sizeof(kinds[0]); i++) {
+        if (strcmp(kind, kinds[i]) == 0) {
+            wave.kind = (ads1115_sim_wave_t)i;
+            options->waves[input] = wave;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Carrega a sequência de tensões de cada entrada a partir de um ficheiro.
+ *
+ * Cada linha tem até HOST_ADC_INPUTS tensões, separadas por espaços,
+ * vírgulas ou ponto e vírgula; linhas vazias e começadas por '#' são ignoradas.
+ */
+static bool host_load_script(ads1115_sim_t* const sims[ADC_DEVICE_COUNT], const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Não foi possível abrir %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    float* volts[HOST_ADC_INPUTS] = { 0 };
+    size_t counts[HOST_ADC_INPUTS] = { 0 };
+    size_t capacity = 0;
+    char line[256];
+    bool ok = true;
+
+    while (ok && fgets(line, sizeof(line), file) != NULL) {
+        char* cursor = line + strspn(line, " \t");
+        if (*cursor == '#' || *cursor == '\n' || *cursor == '\0') {
+            continue;
+        }
+
+        // As colunas só crescem uma amostra por linha: a primeira é a mais longa.
+        if (counts[0] + 1 > capacity) {
+            capacity = capacity ? capacity * 2 : 256;
+            for (uint input = 0; input < HOST_ADC_INPUTS && ok; input++) {
+                float* grown = realloc(volts[input], capacity * sizeof(float));
+                ok = (grown != NULL);
+                if (ok) {
+                    volts[input] = grown;
+                }
+            }
+        }
+
+        for (uint input = 0; input < HOST_ADC_INPUTS && ok; input++) {
+            char* end;
+            float v = strtof(cursor, &end);
+            if (end == cursor) {
+                break;
+            }
+            volts[input][counts[input]++] = v;
+            cursor = end + strspn(end, " \t,;");
+        }
+    }
+    fclose(file);
+
+    for (uint input = 0; input < HOST_ADC_INPUTS; input++) {
+        if (ok && counts[input] > 0) {
+            ok = ads1115_sim_set_script(sims[input / ADS1115_SIM_INPUTS], input % ADS1115_SIM_INPUTS,
+                                        volts[input], counts[input]);
+        }
+        free(volts[input]);
+    }
+    return ok;
+}
+
+static bool host_parse_options(int argc, char** argv, host_options_t* options) {
+    static const struct option long_options[] = {
+        { "cycles", required_argument, NULL, 'n' },
+        { "rate", required_argument, NULL, 'r' },
+        { "flash", required_argument, NULL, 'f' },
+        { "config", required_argument, NULL, 'c' },
+        { "schedule", no_argument, NULL, 'p' },
+        { "adc-speed", required_argument, NULL, 's' },
+        { "adc-wave", required_argument, NULL, 'w' },
+        { "adc-script", required_argument, NULL, 'S' },
+        { "ntp", no_argument, NULL, 't' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "n:r:f:c:ps:w:S:th", long_options, NULL)) != -1) {
+        switch (opt) {
+        case 'n':
+            options->cycles = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'r':
+            options->rate_hz = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'f':
+            options->flash_path = optarg;
+            break;
+        case 'c':
+            options->config_path = optarg;
+            break;
+        case 'p':
+            options->schedule = true;
+            break;
+        case 's':
+            options->adc_speed = strtof(optarg, NULL);
+            break;
+        case 'w':
+            if (!host_parse_wave(optarg, options)) {
+                fprintf(stderr, "Forma de onda inválida: %s\n", optarg);
+                return false;
+            }
+            break;
+        case 'S':
+            options->adc_script = optarg;
+            break;
+        case 't':
+            options->ntp_server = true;
+            break;
+        default:
+            host_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Aplica a configuração em vigor: intervalos de envio do lote, envio
+ * por exceção e calendário de amostragem.
+ */
+static void host_apply_config(sensors_schedule_t* schedule, report_filter_t* filter, uint32_t now_ms) {
+    device_config_t config;
+    uint32_t interval_ms[SENSOR_COUNT];
+
+    config_store_get(&config);
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        batch_set_report_interval(i, config.sensors[i].report_interval_ms);
+        report_filter_set(filter, i, q16_from_centi((int32_t)config.sensors[i].deadband_centi),
+                          config.sensors[i].heartbeat_ms);
+        interval_ms[i] = config.sensors[i].sample_interval_ms;
+    }
+    sensors_schedule_init(schedule, interval_ms, now_ms);
+}
+
+/**
+ * @brief Conversões concluídas pelo conjunto dos ADS1115 simulados.
+ */
+static uint64_t host_adc_conversions(ads1115_sim_t* const sims[ADC_DEVICE_COUNT]) {
+    uint64_t conversions = 0;
+    for (uint8_t d = 0; d < ADC_DEVICE_COUNT; d++) {
+        conversions += ads1115_sim_conversions(sims[d]);
+    }
+    return conversions;
+}
+
+static void host_on_response_header(const char* name, const char* value, __unused void* context) {
+    if (strcmp(name, "x-config") == 0) {
+        config_store_apply(value);
+    }
+}
+
+int main(int argc, char** argv) {
+    // Sinais próximos dos sensores reais: temperatura a variar lentamente em
+    // torno de 25 °C, condutividade com ruído e caudal em rampa.
+    host_options_t options = {
+        .cycles = 0,
+        .rate_hz = 1000 / CYCLE_INTERVAL_MS,
+        .flash_path = HOST_FLASH_FILE,
+        .config_path = HOST_CONFIG_FILE,
+        .adc_speed = 1.0f,
+        .waves = {
+            { ADS1115_SIM_SINE, 0.825f, 0.1f, 60000, 0.002f },
+            { ADS1115_SIM_CONSTANT, 1.1f, 0.0f, 0, 0.05f },
+            { ADS1115_SIM_SAWTOOTH, 1.65f, 0.5f, 10000, 0.01f },
+            { ADS1115_SIM_CONSTANT, 0.0f, 0.0f, 0, 0.0f }
+        }
+    };
+    if (!host_parse_options(argc, argv, &options)) {
+        return 2;
+    }
+
+    stdio_init_all();
+    logger_init();
+    xTaskCreate(logger_task, "LoggerTask", 1024, NULL, tskIDLE_PRIORITY, NULL);
+
+    static const uint8_t rdy_pins[ADC_MAX_DEVICES] = ADC_ALERT_RDY_PINS;
+    ads1115_sim_t* adc_sims[ADC_DEVICE_COUNT];
+    for (uint8_t d = 0; d < ADC_DEVICE_COUNT; d++) {
+        adc_sims[d] = ads1115_sim_create(i2c0, ADC_DEVICE_I2C_ADDR(d), rdy_pins[d]);
+        if (adc_sims[d] == NULL) {
+            return 1;
+        }
+        ads1115_sim_set_speed(adc_sims[d], options.adc_speed);
+        for (uint input = 0; input < ADS1115_SIM_INPUTS; input++) {
+            ads1115_sim_set_waveform(adc_sims[d], input, &options.waves[d * ADS1115_SIM_INPUTS + input]);
+        }
+    }
+    if (options.adc_script && !host_load_script(adc_sims, options.adc_script)) {
+        return 1;
+    }
+
+    if (sensors_init() != 0) {
+        LOG_ERROR("[ERRO] Falha na inicializacao dos sensores.\n");
+        sleep_ms(HOST_LOG_DRAIN_MS);
+        return 1;
+    }
+
+    // Na placa o primeiro ciclo chega um período depois do arranque; aqui
+    // espera-se que cada canal tenha pelo menos uma conversão publicada.
+    uint64_t warmup_target = host_adc_conversions(adc_sims) + HOST_WARMUP_CONVERSIONS;
+    uint32_t warmup_start_ms = to_ms_since_boot(get_absolute_time());
+    while (host_adc_conversions(adc_sims) < warmup_target &&
+           (to_ms_since_boot(get_absolute_time()) - warmup_start_ms) < HOST_WARMUP_TIMEOUT_MS) {
+        sleep_ms(1);
+    }
+
+    ethernet_config_t eth_config = {
+        .mac = {ETHERNET_MAC_0, ETHERNET_MAC_1, ETHERNET_MAC_2,
+                ETHERNET_MAC_3, ETHERNET_MAC_4, ETHERNET_MAC_5},
+        .ip = {DEVICE_IP_0, DEVICE_IP_1, DEVICE_IP_2, DEVICE_IP_3},
+        .subnet = {SUBNET_MASK_0, SUBNET_MASK_1, SUBNET_MASK_2, SUBNET_MASK_3},
+        .gateway = {GATEWAY_IP_0, GATEWAY_IP_1, GATEWAY_IP_2, GATEWAY_IP_3},
+        .dns = {8, 8, 8, 8},
+        .dhcp = NETINFO_STATIC
+    };
+    ethernet_init(&eth_config);
+
+    if (options.ntp_server) {
+        char ntp_ip[16];
+        snprintf(ntp_ip, sizeof(ntp_ip), "%d.%d.%d.%d",
+                 SNTP_SERVER_IP_0, SNTP_SERVER_IP_1, SNTP_SERVER_IP_2, SNTP_SERVER_IP_3);
+        if (!ntp_server_start(ntp_ip, SNTP_SERVER_PORT)) {
+            fprintf(stderr, "Falha ao iniciar o servidor SNTP em %s:%d: %s\n",
+                    ntp_ip, SNTP_SERVER_PORT, strerror(errno));
+            return 1;
+        }
+    }
+
+    if (flash_store_init(flash_io_file(options.flash_path)) != FLASH_STORE_OK) {
+        LOG_WARN("[AVISO] Armazenamento em flash indisponível. Leituras não enviadas serão perdidas.\n");
+    }
+    if (config_store_init(flash_io_file_config(options.config_path)) != CONFIG_STORE_OK) {
+        LOG_WARN("[AVISO] Região de configuração inválida. Alterações não serão persistidas.\n");
+        config_store_init(NULL);
+    }
+    http_set_response_header_handler(host_on_response_header, NULL);
+
+    signal(SIGINT, host_on_signal);
+    signal(SIGTERM, host_on_signal);
+
+    LOG_INFO("[INFO] Servidor %s:%d, %lu ciclos/s (lotes de ate %d leituras ou %d ms).\n",
+             TARGET_SERVER_IP, TARGET_PORT, (unsigned long)options.rate_hz,
+             BATCH_MAX_READINGS, BATCH_MAX_AGE_MS);
+
+    batch_entry_t sample;
+    sensors_schedule_t schedule;
+    report_filter_t filter;
+    uint32_t config_generation = config_store_generation();
+    bool link_ok = true;
+    uint32_t cycles = 0, readings = 0, read_failures = 0, uploads = 0, upload_failures = 0;
+    uint64_t start_us = time_us_64();
+    uint32_t last_trace_summary_ms = to_ms_since_boot(get_absolute_time());
+    uint64_t period_us = options.rate_hz ? 1000000u / options.rate_hz : 0;
+    uint64_t next_cycle_us = start_us;
+
+    report_filter_init(&filter);
+    host_apply_config(&schedule, &filter, last_trace_summary_ms);
+
+    while (!stop_requested && (options.cycles == 0 || cycles < options.cycles)) {
+        uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+
+        if (config_store_generation() != config_generation) {
+            config_generation = config_store_generation();
+            host_apply_config(&schedule, &filter, now_ms);
+        }
+
+        // Com --schedule espera-se pelo próximo sensor devido.
+        sensor_mask_t due = SENSOR_CHANNELS_ALL;
+        if (options.schedule) {
+            sleep_ms(sensors_schedule_wait_ms(&schedule, now_ms));
+            now_ms = to_ms_since_boot(get_absolute_time());
+            due = sensors_schedule_due(&schedule, now_ms);
+            if (due == 0) {
+                continue;
+            }
+        }
+
+        // Passo 1: Ler os dados (tarefa de amostragem na placa).
+        uint64_t read_start_us = trace_begin();
+        int read_result = sensors_read(&sample.reading, due);
+        trace_end(TRACE_SENSOR_READ, read_start_us);
+
+        // Passo 2: Acumular e enviar (tarefa de rede na placa).
+        if (read_result != 0) {
+            read_failures++;
+        } else {
+            readings++;
+            sample.timestamp_ms = (uint32_t)(sample.reading.timestamp_us / 1000u);
+            flash_store_sync();
+            config_store_sync();
+            // Na placa o envio por exceção é feito antes da fila de amostras.
+            if (report_filter_apply(&filter, &sample.reading, now_ms) != 0 &&
+                batch_add(&sample.reading, sample.timestamp_ms) != BATCH_STATUS_OK) {
+                LOG_WARN("[AVISO] Lote cheio. Leitura descartada.\n");
+            }
+        }
+
+        now_ms = to_ms_since_boot(get_absolute_time());
+        sntp_client_poll(now_ms);
+        bool drain = link_ok && flash_store_pending() > 0;
+        if (batch_should_flush(now_ms) || drain) {
+            uint64_t upload_start_us = trace_begin();
+            batch_status_t upload_status = batch_upload(now_ms, drain);
+            trace_end(TRACE_UPLOAD, upload_start_us);
+            link_ok = (upload_status == BATCH_STATUS_OK || upload_status == BATCH_STATUS_EMPTY);
+            uploads++;
+            upload_failures += link_ok ? 0 : 1;
+        }
+
+        if ((now_ms - last_trace_summary_ms) >= TRACE_SUMMARY_INTERVAL_MS) {
+            trace_print_summary();
+            last_trace_summary_ms = now_ms;
+        }
+
+        // Passo 3: Aguardar o próximo ciclo. Ao contrário de vTaskDelayUntil,
+        // os ciclos perdidos (ex.: um envio lento) não são recuperados em
+        // rajada: leituras seguidas esvaziariam os filtros antes de haver
+        // amostras novas.
+        cycles++;
+        if (period_us > 0 && !options.schedule) {
+            uint64_t now_us = time_us_64();
+            next_cycle_us += period_us;
+            if (next_cycle_us > now_us) {
+                sleep_us(next_cycle_us - now_us);
+            } else {
+                next_cycle_us = now_us;
+            }
+        }
+    }
+
+    uint64_t elapsed_us = time_us_64() - start_us;
+
+    // Com ciclos seguidos o anel pode estar cheio: o resumo final não deve perder-se.
+    sleep_ms(HOST_LOG_DRAIN_MS);
+    trace_print_summary();
+    // Um ciclo mais rápido que o ADC falha a leitura (o filtro ainda não tem
+    // amostras novas): o débito útil é o das leituras, não o dos ciclos.
+    LOG_INFO("[INFO] %lu ciclos em %lu ms: %lu leituras (%lu/s), %lu falhadas.\n",
+             (unsigned long)cycles, (unsigned long)(elapsed_us / 1000u), (unsigned long)readings,
+             (unsigned long)(elapsed_us ? (uint64_t)readings * 1000000u / elapsed_us : 0),
+             (unsigned long)read_failures);
+    LOG_INFO("[INFO] %lu envios (%lu falhados).\n",
+             (unsigned long)uploads, (unsigned long)upload_failures);
+    LOG_INFO("[INFO] Envio por exceção: %lu de %lu valores enviados.\n",
+             (unsigned long)filter.passed, (unsigned long)filter.offered);
+    LOG_INFO("[INFO] ADS1115 simulados: %lu conversões.\n",
+             (unsigned long)host_adc_conversions(adc_sims));
+    LOG_INFO("[INFO] Relógio SNTP %s (%lu pedidos ao servidor local).\n",
+             sntp_client_is_synced() ? "sincronizado" : "não sincronizado",
+             (unsigned long)ntp_server_requests());
+
+    sleep_ms(HOST_LOG_DRAIN_MS);
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file ntp_server.c
+ * @brief Implementação do servidor SNTP em loopback.
+ */
+
+#include "ntp_server.h"
+#include "pico/stdlib.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define NTP_PACKET_SIZE 48
+#define NTP_UNIX_EPOCH_OFFSET_S 2208988800ull
+
+// Primeiro byte da resposta: LI = 0, VN = 4, Mode = 4 (servidor)
+#define NTP_REPLY_FLAGS ((4u << 3) | 4u)
+
+static int server_fd = -1;
+static atomic_uint_fast64_t requests;
+
+/**
+ * @brief O relógio do sistema como timestamp NTP (32.32 s desde 1900).
+ */
+static uint64_t ntp_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    uint64_t fraction = ((uint64_t)ts.tv_nsec << 32) / 1000000000u;
+    return (((uint64_t)ts.tv_sec + NTP_UNIX_EPOCH_OFFSET_S) << 32) | fraction;
+}
+
+static void ntp_put_u64(uint8_t* p, uint64_t value) {
+    for (int i = 7; i >= 0; i--) {
+        p[i] = (uint8_t)value;
+        value >>= 8;
+    }
+}
+
+static void* ntp_server_thread(__unused void* arg) {
+    uint8_t packet[NTP_PACKET_SIZE];
+
+    while (1) {
+        struct sockaddr_in client;
+        socklen_t client_len = sizeof(client);
+        ssize_t len = recvfrom(server_fd, packet, sizeof(packet), 0, (struct sockaddr*)&client, &client_len);
+        uint64_t receive = ntp_now();
+
+        if (len < NTP_PACKET_SIZE || (packet[0] & 0x07) != 3) {
+            continue;
+        }
+
+        uint8_t reply[NTP_PACKET_SIZE] = { NTP_REPLY_FLAGS, 1 };
+        reply[2] = packet[2];                    // Poll
+        reply[3] = (uint8_t)-20;                 // Precision: ~1 us
+        memcpy(&reply[12], "LOCL", 4);           // Reference ID
+        ntp_put_u64(&reply[16], receive);        // Reference
+        memcpy(&reply[24], &packet[40], 8);      // Originate = Transmit do pedido
+        ntp_put_u64(&reply[32], receive);        // Receive
+        ntp_put_u64(&reply[40], ntp_now());      // Transmit
+
+        sendto(server_fd, reply, sizeof(reply), 0, (const struct sockaddr*)&client, client_len);
+        atomic_fetch_add(&requests, 1);
+    }
+    return NULL;
+}
+
+bool ntp_server_start(const char* ip, uint16_t port) {
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(port) };
+
+    if (server_fd >= 0 || inet_pton(AF_INET, ip, &addr.sin_addr) != 1) {
+        return false;
+    }
+
+    server_fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (server_fd < 0) {
+        return false;
+    }
+    if (bind(server_fd, (const struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(server_fd);
+        server_fd = -1;
+        return false;
+    }
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, ntp_server_thread, NULL) != 0) {
+        close(server_fd);
+        server_fd = -1;
+        return false;
+    }
+    pthread_detach(thread);
+    return true;
+}
+
+uint64_t ntp_server_requests(void) {
+    return atomic_load(&requests);
+}
@@ -0,0 +1,29 @@
+/**
+ * @file ntp_server.h
+ * @brief Servidor SNTP em loopback, substituto do servidor de tempo real no host.
+ *
+ * Responde aos pedidos de modo 3 com o relógio do sistema (CLOCK_REALTIME)
+ * como servidor de estrato 1, numa thread própria. Serve o sntp_client do
+ * main_host sem acesso à rede nem privilégios para a porta 123.
+ */
+#ifndef NTP_SERVER_H
+#define NTP_SERVER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Abre o socket UDP e inicia a thread que responde aos pedidos.
+ *
+ * @param ip O endereço IPv4 de escuta (ex: "127.0.0.1").
+ * @param port A porta UDP.
+ * @return true se o servidor ficou à escuta.
+ */
+bool ntp_server_start(const char* ip, uint16_t port);
+
+/**
+ * @brief Retorna o número de pedidos respondidos.
+ */
+uint64_t ntp_server_requests(void);
+
+#endif // NTP_SERVER_H
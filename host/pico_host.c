@@ -0,0 +1,413 @@
+/**
+ * @file pico_host.c
+ * @brief Implementação POSIX do subconjunto do Pico SDK usado pelo firmware.
+ *
+ * Tempo e pausas sobre CLOCK_MONOTONIC, spinlocks sobre mutexes, GPIO e
+ * interrupções em memória e um barramento I2C que encaminha as transações
+ * para os dispositivos simulados.
+ */
+
+#include "host_platform.h"
+#include "pico/stdlib.h"
+#include "pico/rand.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/random.h>
+#include <time.h>
+
+#define HOST_SPIN_LOCK_COUNT 32
+#define HOST_I2C_MAX_DEVICES 8
+
+// --- Tempo ---
+
+static uint64_t boot_time_us;
+
+static uint64_t host_monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+// O relógio conta a partir do arranque do processo, como na placa.
+__attribute__((constructor)) static void host_time_init(void) {
+    boot_time_us = host_monotonic_us();
+}
+
+uint64_t time_us_64(void) {
+    return host_monotonic_us() - boot_time_us;
+}
+
+void sleep_us(uint64_t us) {
+    struct timespec ts = {
+        .tv_sec = (time_t)(us / 1000000u),
+        .tv_nsec = (long)(us % 1000000u) * 1000
+    };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_us((uint64_t)ms * 1000u);
+}
+
+void tight_loop_contents(void) {
+    sched_yield();
+}
+
+// --- stdio ---
+
+bool stdio_init_all(void) {
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    return true;
+}
+
+int putchar_raw(int c) {
+    return putchar(c);
+}
+
+// --- Números aleatórios ---
+
+uint32_t get_rand_32(void) {
+    uint32_t value;
+    if (getrandom(&value, sizeof(value), 0) != (ssize_t)sizeof(value)) {
+        value = (uint32_t)host_monotonic_us() * 2654435761u;
+    }
+    return value;
+}
+
+// --- Interrupções e sincronização ---
+
+static pthread_mutex_t irq_mutex;
+
+// Profundidade do trinco de IRQ na thread: acima de 0 as "interrupções"
+// estão desativadas nela.
+static __thread unsigned irq_depth;
+
+static void host_gpio_dispatch_pending(void);
+
+__attribute__((constructor)) static void host_irq_init(void) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&irq_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+void host_irq_lock(void) {
+    pthread_mutex_lock(&irq_mutex);
+    irq_depth++;
+}
+
+void host_irq_unlock(void) {
+    bool outermost = (--irq_depth == 0);
+    pthread_mutex_unlock(&irq_mutex);
+    // Como o NVIC, entrega as interrupções que ficaram pendentes.
+    if (outermost) {
+        host_gpio_dispatch_pending();
+    }
+}
+
+uint32_t save_and_disable_interrupts(void) {
+    host_irq_lock();
+    return 0;
+}
+
+void restore_interrupts(__unused uint32_t status) {
+    host_irq_unlock();
+}
+
+struct host_spin_lock {
+    pthread_mutex_t mutex;
+};
+
+static spin_lock_t spin_locks[HOST_SPIN_LOCK_COUNT] = {
+    [0 ... HOST_SPIN_LOCK_COUNT - 1] = { PTHREAD_MUTEX_INITIALIZER }
+};
+static uint32_t spin_locks_claimed;
+
+int spin_lock_claim_unused(bool required) {
+    int lock_num = -1;
+
+    host_irq_lock();
+    for (int i = 0; i < HOST_SPIN_LOCK_COUNT; i++) {
+        if ((spin_locks_claimed & (1u << i)) == 0) {
+            spin_locks_claimed |= 1u << i;
+            lock_num = i;
+            break;
+        }
+    }
+    host_irq_unlock();
+
+    if (lock_num < 0 && required) {
+        fprintf(stderr, "Nenhum spinlock livre\n");
+        abort();
+    }
+    return lock_num;
+}
+
+spin_lock_t* spin_lock_instance(uint lock_num) {
+    return &spin_locks[lock_num % HOST_SPIN_LOCK_COUNT];
+}
+
+uint32_t spin_lock_blocking(spin_lock_t* lock) {
+    pthread_mutex_lock(&lock->mutex);
+    return 0;
+}
+
+void spin_unlock(spin_lock_t* lock, __unused uint32_t saved_irq) {
+    pthread_mutex_unlock(&lock->mutex);
+}
+
+// --- GPIO ---
+
+typedef struct {
+    bool level;
+    bool out;
+    bool driven;            /**< O nível é imposto por um dispositivo externo. */
+    uint32_t irq_enabled;   /**< Eventos GPIO_IRQ_* ativos. */
+    uint32_t edges;         /**< Flancos ocorridos e ainda não reconhecidos. */
+    irq_handler_t handler;
+} host_gpio_t;
+
+// O estado dos pinos tem um trinco próprio: um flanco fica registado mesmo
+// com as "interrupções" desativadas noutra thread, como no banco de GPIO.
+static pthread_mutex_t gpio_mutex = PTHREAD_MUTEX_INITIALIZER;
+static host_gpio_t gpios[HOST_GPIO_COUNT];
+static bool bank0_irq_enabled;
+static atomic_bool irq_pending;
+
+/**
+ * @brief Eventos pendentes e ativos no pino: os flancos registados e o nível atual.
+ */
+static uint32_t host_gpio_events(const host_gpio_t* pin) {
+    uint32_t events = pin->edges | (pin->level ? GPIO_IRQ_LEVEL_HIGH : GPIO_IRQ_LEVEL_LOW);
+    return events & pin->irq_enabled;
+}
+
+/**
+ * @brief Executa os tratadores dos pinos com eventos ativos, se as "interrupções" o permitirem.
+ *
+ * Com o trinco de IRQ noutra thread, o pedido fica pendente e é a thread
+ * que o detém que os executa ao libertá-lo; na própria thread, espera pelo
+ * seu host_irq_unlock() mais exterior.
+ */
+static void host_gpio_dispatch_pending(void) {
+    while (atomic_load(&irq_pending) && irq_depth == 0 && pthread_mutex_trylock(&irq_mutex) == 0) {
+        irq_depth++;
+        atomic_store(&irq_pending, false);
+        for (uint gpio = 0; gpio < HOST_GPIO_COUNT; gpio++) {
+            pthread_mutex_lock(&gpio_mutex);
+            host_gpio_t* pin = &gpios[gpio];
+            irq_handler_t handler = (bank0_irq_enabled && host_gpio_events(pin) != 0) ? pin->handler : NULL;
+            pthread_mutex_unlock(&gpio_mutex);
+            if (handler != NULL) {
+                handler();
+            }
+        }
+        irq_depth--;
+        pthread_mutex_unlock(&irq_mutex);
+    }
+}
+
+/**
+ * @brief Assinala uma interrupção de GPIO e entrega-a se as "interrupções" estiverem ativas.
+ */
+static void host_gpio_raise(void) {
+    atomic_store(&irq_pending, true);
+    host_gpio_dispatch_pending();
+}
+
+/**
+ * @brief Altera o nível do pino, registando o flanco e gerando as interrupções.
+ */
+static void host_gpio_set_level(uint gpio, bool level) {
+    host_gpio_t* pin = &gpios[gpio];
+
+    pthread_mutex_lock(&gpio_mutex);
+    if (pin->level != level) {
+        pin->edges |= level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+        pin->level = level;
+    }
+    pthread_mutex_unlock(&gpio_mutex);
+    host_gpio_raise();
+}
+
+void host_gpio_drive(uint gpio, bool level) {
+    if (gpio >= HOST_GPIO_COUNT) {
+        return;
+    }
+    gpios[gpio].driven = true;
+    host_gpio_set_level(gpio, level);
+}
+
+void gpio_init(uint gpio) {
+    if (gpio < HOST_GPIO_COUNT) {
+        gpios[gpio].out = false;
+    }
+}
+
+void gpio_set_function(__unused uint gpio, __unused enum gpio_function fn) {
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    if (gpio < HOST_GPIO_COUNT) {
+        gpios[gpio].out = out;
+    }
+}
+
+void gpio_pull_up(uint gpio) {
+    if (gpio < HOST_GPIO_COUNT && !gpios[gpio].driven && !gpios[gpio].out) {
+        host_gpio_set_level(gpio, true);
+    }
+}
+
+void gpio_put(uint gpio, bool value) {
+    if (gpio < HOST_GPIO_COUNT && gpios[gpio].out) {
+        host_gpio_set_level(gpio, value);
+    }
+}
+
+bool gpio_get(uint gpio) {
+    return gpio < HOST_GPIO_COUNT && gpios[gpio].level;
+}
+
+void gpio_add_raw_irq_handler(uint gpio, irq_handler_t handler) {
+    if (gpio < HOST_GPIO_COUNT) {
+        pthread_mutex_lock(&gpio_mutex);
+        gpios[gpio].handler = handler;
+        pthread_mutex_unlock(&gpio_mutex);
+    }
+}
+
+void gpio_add_raw_irq_handler_masked(uint32_t gpio_mask, irq_handler_t handler) {
+    for (uint gpio = 0; gpio < HOST_GPIO_COUNT; gpio++) {
+        if (gpio_mask & (1u << gpio)) {
+            gpio_add_raw_irq_handler(gpio, handler);
+        }
+    }
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled) {
+    if (gpio >= HOST_GPIO_COUNT) {
+        return;
+    }
+
+    pthread_mutex_lock(&gpio_mutex);
+    if (enabled) {
+        gpios[gpio].irq_enabled |= event_mask;
+    } else {
+        gpios[gpio].irq_enabled &= ~event_mask;
+    }
+    pthread_mutex_unlock(&gpio_mutex);
+    // Um nível já ativo dispara logo, como no RP2040.
+    if (enabled) {
+        host_gpio_raise();
+    }
+}
+
+uint32_t gpio_get_irq_event_mask(uint gpio) {
+    if (gpio >= HOST_GPIO_COUNT) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&gpio_mutex);
+    uint32_t events = host_gpio_events(&gpios[gpio]);
+    pthread_mutex_unlock(&gpio_mutex);
+    return events;
+}
+
+void gpio_acknowledge_irq(uint gpio, uint32_t event_mask) {
+    if (gpio < HOST_GPIO_COUNT) {
+        pthread_mutex_lock(&gpio_mutex);
+        gpios[gpio].edges &= ~event_mask;
+        pthread_mutex_unlock(&gpio_mutex);
+    }
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    if (num == IO_IRQ_BANK0) {
+        pthread_mutex_lock(&gpio_mutex);
+        bank0_irq_enabled = enabled;
+        pthread_mutex_unlock(&gpio_mutex);
+    }
+}
+
+// --- I2C ---
+
+struct i2c_inst {
+    pthread_mutex_t bus;
+    uint8_t addrs[HOST_I2C_MAX_DEVICES];
+    host_i2c_device_t devices[HOST_I2C_MAX_DEVICES];
+    size_t device_count;
+};
+
+i2c_inst_t i2c0_inst = { .bus = PTHREAD_MUTEX_INITIALIZER };
+i2c_inst_t i2c1_inst = { .bus = PTHREAD_MUTEX_INITIALIZER };
+
+bool host_i2c_attach(i2c_inst_t* i2c, uint8_t addr, const host_i2c_device_t* device) {
+    bool attached = false;
+
+    pthread_mutex_lock(&i2c->bus);
+    bool in_use = false;
+    for (size_t i = 0; i < i2c->device_count; i++) {
+        in_use |= (i2c->addrs[i] == addr);
+    }
+    if (!in_use && i2c->device_count < HOST_I2C_MAX_DEVICES) {
+        i2c->addrs[i2c->device_count] = addr;
+        i2c->devices[i2c->device_count] = *device;
+        i2c->device_count++;
+        attached = true;
+    }
+    pthread_mutex_unlock(&i2c->bus);
+
+    return attached;
+}
+
+static const host_i2c_device_t* host_i2c_find(const i2c_inst_t* i2c, uint8_t addr) {
+    for (size_t i = 0; i < i2c->device_count; i++) {
+        if (i2c->addrs[i] == addr) {
+            return &i2c->devices[i];
+        }
+    }
+    return NULL;
+}
+
+uint i2c_init(__unused i2c_inst_t* i2c, uint baudrate) {
+    return baudrate;
+}
+
+void i2c_deinit(__unused i2c_inst_t* i2c) {
+}
+
+int i2c_write_blocking(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t len, bool nostop) {
+    pthread_mutex_lock(&i2c->bus);
+    const host_i2c_device_t* device = host_i2c_find(i2c, addr);
+    int result = device ? device->write(device->context, src, len, nostop) : PICO_ERROR_GENERIC;
+    pthread_mutex_unlock(&i2c->bus);
+    return result;
+}
+
+int i2c_read_blocking(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst, size_t len, bool nostop) {
+    pthread_mutex_lock(&i2c->bus);
+    const host_i2c_device_t* device = host_i2c_find(i2c, addr);
+    int result = device ? device->read(device->context, dst, len, nostop) : PICO_ERROR_GENERIC;
+    pthread_mutex_unlock(&i2c->bus);
+    return result;
+}
+
+int i2c_write_timeout_us(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t len, bool nostop,
+                         __unused uint timeout_us) {
+    return i2c_write_blocking(i2c, addr, src, len, nostop);
+}
+
+int i2c_read_timeout_us(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst, size_t len, bool nostop,
+                        __unused uint timeout_us) {
+    return i2c_read_blocking(i2c, addr, dst, len, nostop);
+}
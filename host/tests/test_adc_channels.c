@@ -0,0 +1,143 @@
+/**
+ * @file test_adc_channels.c
+ * @brief Verifica que cada canal da aquisição contínua recebe o seu próprio sinal.
+ *
+ * Cada entrada de cada ADS1115 simulado tem uma tensão constante diferente.
+ * Com todos os canais em round-robin, todas as amostras entregues à
+ * callback e todas as leituras do buffer por canal têm de corresponder à
+ * tensão da entrada do canal: uma conversão iniciada antes da troca do
+ * multiplexador, atribuída ao canal novo, aparece como o valor de outra
+ * entrada. O teste retém periodicamente o núcleo da aquisição, como nas
+ * escritas na flash, e verifica que a amostragem não para: entre amostras
+ * seguidas de um conversor nunca passa mais de TEST_MAX_GAP_US, também
+ * através das retenções, e os canais continuam certos.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "ads1115_sim.h"
+#include "modules/adc_manager/adc_manager.h"
+
+#define TEST_INPUTS         (ADC_DEVICE_COUNT * ADS1115_SIM_INPUTS)
+#define TEST_DURATION_MS    1000
+#define TEST_POLL_MS        2
+// Uma retenção de TEST_HOLD_MS a cada TEST_HOLD_EVERY_MS, como o apagamento de um setor
+#define TEST_HOLD_EVERY_MS  200
+#define TEST_HOLD_MS        100
+// Maior intervalo entre os instantes de amostras seguidas de um conversor: uma
+// retenção que parasse a amostragem deixava um de TEST_HOLD_MS
+#define TEST_MAX_GAP_US     (TEST_HOLD_MS * 1000 / 2)
+// Códigos de tolerância: sem ruído, só o arredondamento da conversão
+#define TEST_TOLERANCE      2
+
+static const enum ads1115_mux_t channels[ADS1115_SIM_INPUTS] = {
+    ADS1115_MUX_SINGLE_0, ADS1115_MUX_SINGLE_1, ADS1115_MUX_SINGLE_2, ADS1115_MUX_SINGLE_3
+};
+
+static int16_t expected[TEST_INPUTS];
+static volatile uint32_t samples[TEST_INPUTS];
+static volatile uint32_t mismatches;
+static uint64_t last_sample_us[ADC_DEVICE_COUNT];
+static volatile uint64_t max_gap_us;
+
+static float test_input_volts(uint input) {
+    // Entradas bem separadas: 0,2 V a 3,2 V em passos de 0,2 V.
+    return 0.2f * (float)(input + 1);
+}
+
+static uint test_input_index(uint8_t device, enum ads1115_mux_t channel) {
+    return device * ADS1115_SIM_INPUTS + (((uint)channel >> 12) & 0x3);
+}
+
+static bool test_matches(uint input, int16_t raw) {
+    return abs(raw - expected[input]) <= TEST_TOLERANCE;
+}
+
+static void test_on_sample(uint8_t device, enum ads1115_mux_t channel, int16_t raw, __unused void* context) {
+    uint input = test_input_index(device, channel);
+    samples[input]++;
+
+    // A amostra já está no buffer do canal, com o instante da leitura.
+    uint64_t timestamp_us;
+    int16_t latest;
+    if (adc_module_read_latest(device, channel, &latest, &timestamp_us) == ADC_STATUS_OK) {
+        if (last_sample_us[device] != 0 && timestamp_us - last_sample_us[device] > max_gap_us) {
+            max_gap_us = timestamp_us - last_sample_us[device];
+        }
+        last_sample_us[device] = timestamp_us;
+    }
+    if (!test_matches(input, raw)) {
+        mismatches++;
+        fprintf(stderr, "Amostra do ADS1115 %u AIN%u: %d, esperado %d\n",
+                (unsigned)device, input % ADS1115_SIM_INPUTS, raw, expected[input]);
+    }
+}
+
+int main(void) {
+    stdio_init_all();
+
+    static const uint8_t rdy_pins[ADC_MAX_DEVICES] = ADC_ALERT_RDY_PINS;
+    adc_input_t inputs[TEST_INPUTS];
+    for (uint8_t d = 0; d < ADC_DEVICE_COUNT; d++) {
+        ads1115_sim_t* sim = ads1115_sim_create(i2c0, ADC_DEVICE_I2C_ADDR(d), rdy_pins[d]);
+        if (sim == NULL) {
+            return 1;
+        }
+        for (uint i = 0; i < ADS1115_SIM_INPUTS; i++) {
+            uint input = d * ADS1115_SIM_INPUTS + i;
+            const ads1115_sim_waveform_t wave = { ADS1115_SIM_CONSTANT, test_input_volts(input), 0.0f, 0, 0.0f };
+            ads1115_sim_set_waveform(sim, i, &wave);
+            expected[input] = (int16_t)lroundf(test_input_volts(input) / ADC_FULL_SCALE_VOLTS * 32768.0f);
+            inputs[input] = (adc_input_t){ .device = d, .channel = channels[i] };
+        }
+    }
+
+    if (adc_module_init() != ADC_STATUS_OK) {
+        fprintf(stderr, "Falha ao inicializar o adc_manager.\n");
+        return 1;
+    }
+    adc_module_set_sample_callback(test_on_sample, NULL);
+    if (adc_module_start_acquisition(inputs, TEST_INPUTS) != ADC_STATUS_OK) {
+        fprintf(stderr, "Falha ao iniciar a aquisição contínua.\n");
+        return 1;
+    }
+
+    // O buffer de cada canal é lido ao longo do teste, não só no fim.
+    uint32_t reads = 0, holds = 0;
+    bool hold_failed = false;
+    for (uint32_t elapsed_ms = 0; elapsed_ms < TEST_DURATION_MS; elapsed_ms += TEST_POLL_MS) {
+        sleep_ms(TEST_POLL_MS);
+
+        if (elapsed_ms % TEST_HOLD_EVERY_MS == TEST_HOLD_EVERY_MS / 2) {
+            hold_failed |= (adc_module_hold() != ADC_STATUS_OK);
+            sleep_ms(TEST_HOLD_MS);
+            adc_module_release();
+            holds++;
+        }
+        for (uint input = 0; input < TEST_INPUTS; input++) {
+            int16_t raw;
+            if (adc_module_read_latest(inputs[input].device, inputs[input].channel, &raw, NULL) != ADC_STATUS_OK) {
+                continue;
+            }
+            reads++;
+            if (!test_matches(input, raw)) {
+                mismatches++;
+                fprintf(stderr, "Buffer do ADS1115 %u AIN%u: %d, esperado %d\n",
+                        (unsigned)inputs[input].device, input % ADS1115_SIM_INPUTS, raw, expected[input]);
+            }
+        }
+    }
+
+    bool ok = (mismatches == 0 && reads > 0 && !hold_failed && max_gap_us <= TEST_MAX_GAP_US);
+    for (uint input = 0; input < TEST_INPUTS; input++) {
+        printf("ADS1115 %u AIN%u: %lu amostras\n", input / ADS1115_SIM_INPUTS, input % ADS1115_SIM_INPUTS,
+               (unsigned long)samples[input]);
+        ok &= (samples[input] > 0);
+    }
+    printf("%lu leituras do buffer, %lu valores de outro canal\n", (unsigned long)reads, (unsigned long)mismatches);
+    printf("%lu retenções%s, maior intervalo entre amostras de um conversor: %llu us\n", (unsigned long)holds,
+           hold_failed ? " (alguma não confirmada)" : "", (unsigned long long)max_gap_us);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,312 @@
+/**
+ * @file test_flash_store.c
+ * @brief Testa o flash_store sobre a flash em ficheiro (flash_io_file.c).
+ *
+ * Cobre o ciclo de vida do log: acrescentar e ler pela ordem de chegada,
+ * reiniciar (novo flash_store_init() sobre o mesmo ficheiro), drenar com
+ * as marcações de envio persistidas, dar a volta à região descartando os
+ * registos mais antigos, adiar escritas (FLASH_IO_BUSY) sem perder leituras
+ * nem marcações e recuperar de um corte de energia a meio de uma escrita,
+ * com um registo parcialmente programado na cabeça.
+ *
+ * Uso: test_flash_store [ficheiro]; o ficheiro é recriado a cada execução.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "modules/flash_store/flash_store.h"
+
+#define TEST_DEFAULT_PATH  "test_flash_store.bin"
+#define TEST_PEEK_CHUNK    16
+// Registos acrescentados para dar a volta à região: o dobro do que cabe com
+// registos de 32 bytes, o menor tamanho possível.
+#define TEST_WRAP_COUNT    (FLASH_STORE_SIZE_KB * 1024u / 32u * 2u)
+// Registos inteiros antes do corte de energia, e bytes do registo seguinte
+#define TEST_TORN_WHOLE    2
+#define TEST_TORN_BYTES    10
+// Leituras gravadas com uma escrita adiada a meio, em várias páginas
+#define TEST_BUSY_COUNT    40
+#define TEST_EPOCH_BASE_MS 1700000000000ull
+
+static const char* path;
+static int failures;
+
+#define CHECK(cond, ...)                                   \
+    do {                                                   \
+        if (!(cond)) {                                     \
+            fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); \
+            fprintf(stderr, __VA_ARGS__);                  \
+            fprintf(stderr, "\n");                         \
+            failures++;                                    \
+        }                                                  \
+    } while (0)
+
+// --- Leituras de teste: tudo deriva do índice, guardado em timestamp_ms ---
+
+static int32_t test_centi(uint32_t index, sensor_id_t id) {
+    return (int32_t)((index * (id + 1u)) % 5000u) - 2500;
+}
+
+static void test_entry(uint32_t index, batch_entry_t* entry) {
+    memset(entry, 0, sizeof(*entry));
+    entry->timestamp_ms = index;
+    entry->epoch_ms = (index % 2) ? TEST_EPOCH_BASE_MS + index : 0;
+    entry->reading.channels = SENSOR_CHANNELS_ALL;
+    if (index % 3 == 0) {
+        entry->reading.channels &= (sensor_mask_t)~SENSOR_CHANNEL(0);
+    }
+    for (sensor_id_t id = 0; id < SENSOR_COUNT; id++) {
+        if (entry->reading.channels & SENSOR_CHANNEL(id)) {
+            entry->reading.values[id] = q16_from_centi(test_centi(index, id));
+        }
+    }
+}
+
+static bool test_entry_matches(const batch_entry_t* entry, uint32_t index, bool same_boot) {
+    batch_entry_t expected;
+    test_entry(index, &expected);
+
+    if (entry->timestamp_ms != index || entry->epoch_ms != expected.epoch_ms ||
+        entry->reading.channels != expected.reading.channels || entry->timestamp_unknown == same_boot) {
+        return false;
+    }
+    for (sensor_id_t id = 0; id < SENSOR_COUNT; id++) {
+        if ((expected.reading.channels & SENSOR_CHANNEL(id)) &&
+            q16_to_centi(entry->reading.values[id]) != test_centi(index, id)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_append(uint32_t first, uint32_t count) {
+    for (uint32_t i = first; i < first + count; i++) {
+        batch_entry_t entry;
+        test_entry(i, &entry);
+        CHECK(flash_store_append(&entry) == FLASH_STORE_OK, "append %u", i);
+    }
+    CHECK(flash_store_sync() == FLASH_STORE_OK, "sync após %u leituras", first + count);
+}
+
+/**
+ * @brief Reinicia o armazenamento sobre o mesmo ficheiro, como um arranque da placa.
+ */
+static void test_reboot(void) {
+    const flash_io_t* io = flash_io_file(path);
+    CHECK(io != NULL, "abrir %s", path);
+    CHECK(flash_store_init(io) == FLASH_STORE_OK, "flash_store_init");
+}
+
+/**
+ * @brief Verifica que as leituras pendentes são `first`..`first + count - 1`, por ordem.
+ */
+static void test_expect_pending(uint32_t first, uint32_t count, bool same_boot) {
+    CHECK(flash_store_pending() == count, "pendentes %zu, esperado %u", flash_store_pending(), count);
+
+    // peek não remove: a primeira leitura é sempre a mais antiga.
+    batch_entry_t entries[TEST_PEEK_CHUNK];
+    size_t peeked = flash_store_peek(entries, TEST_PEEK_CHUNK);
+    CHECK(peeked == (count < TEST_PEEK_CHUNK ? count : TEST_PEEK_CHUNK), "peek %zu", peeked);
+    for (size_t i = 0; i < peeked; i++) {
+        CHECK(test_entry_matches(&entries[i], first + (uint32_t)i, same_boot),
+              "leitura %zu: timestamp %u, esperado %u", i, entries[i].timestamp_ms, first + (uint32_t)i);
+    }
+}
+
+/**
+ * @brief Drena até `count` leituras pendentes, verificando a ordem a partir de `first`.
+ * @return O número de leituras drenadas.
+ */
+static uint32_t test_drain(uint32_t first, uint32_t count, bool same_boot) {
+    uint32_t drained = 0;
+    batch_entry_t entries[TEST_PEEK_CHUNK];
+    size_t peeked;
+
+    while (drained < count &&
+           (peeked = flash_store_peek(entries, (count - drained < TEST_PEEK_CHUNK) ? count - drained
+                                                                                   : TEST_PEEK_CHUNK)) > 0) {
+        for (size_t i = 0; i < peeked; i++) {
+            if (!test_entry_matches(&entries[i], first + drained + (uint32_t)i, same_boot)) {
+                CHECK(false, "drenagem: timestamp %u, esperado %u", entries[i].timestamp_ms,
+                      first + drained + (uint32_t)i);
+                return drained;
+            }
+        }
+        CHECK(flash_store_consume(peeked) == FLASH_STORE_OK, "consume %zu", peeked);
+        CHECK(flash_store_sync() == FLASH_STORE_OK, "sync das marcações");
+        drained += (uint32_t)peeked;
+    }
+    return drained;
+}
+
+// --- Escrita adiada: a flash responde FLASH_IO_BUSY depois de `busy_after` escritas ---
+
+static const flash_io_t* busy_backing;  /**< A flash em ficheiro. */
+static uint32_t busy_after;
+static bool busy_pending;
+
+static bool busy_now(void) {
+    if (!busy_pending) {
+        return false;
+    }
+    if (busy_after > 0) {
+        busy_after--;
+        return false;
+    }
+    busy_pending = false;
+    return true;
+}
+
+static int busy_program(uint32_t offset, const void* buf, size_t len) {
+    return busy_now() ? FLASH_IO_BUSY : busy_backing->program(offset, buf, len);
+}
+
+static int busy_erase_sector(uint32_t offset) {
+    return busy_now() ? FLASH_IO_BUSY : busy_backing->erase_sector(offset);
+}
+
+// --- Corte de energia: a flash deixa de responder a meio de uma programação ---
+
+static const flash_io_t* cut_backing;   /**< A flash em ficheiro. */
+static size_t cut_budget;
+static bool cut_happened;
+
+static int cut_read(uint32_t offset, void* buf, size_t len) {
+    return cut_happened ? -1 : cut_backing->read(offset, buf, len);
+}
+
+static int cut_program(uint32_t offset, const void* buf, size_t len) {
+    if (cut_happened) {
+        return -1;
+    }
+    if (len <= cut_budget) {
+        cut_budget -= len;
+        return cut_backing->program(offset, buf, len);
+    }
+    // Só os primeiros bytes chegam à flash.
+    cut_backing->program(offset, buf, cut_budget);
+    cut_happened = true;
+    return -1;
+}
+
+static int cut_erase_sector(uint32_t offset) {
+    return cut_happened ? -1 : cut_backing->erase_sector(offset);
+}
+
+int main(int argc, char** argv) {
+    stdio_init_all();
+    path = (argc > 1) ? argv[1] : TEST_DEFAULT_PATH;
+    remove(path);
+
+    // Acrescentar e ler no mesmo arranque.
+    test_reboot();
+    CHECK(flash_store_pending() == 0, "região nova com %zu pendentes", flash_store_pending());
+    test_append(0, 100);
+    test_expect_pending(0, 100, true);
+
+    // Depois de reiniciar, as mesmas leituras, agora de um arranque anterior.
+    test_reboot();
+    test_expect_pending(0, 100, false);
+
+    // Drenagem: as marcações de envio sobrevivem a um reinício.
+    CHECK(test_drain(0, 100, false) == 100, "drenagem incompleta");
+    test_reboot();
+    CHECK(flash_store_pending() == 0, "%zu pendentes após a drenagem", flash_store_pending());
+
+    // Volta à região: ficam as leituras mais recentes, por ordem, sem lacunas.
+    uint32_t next = 100;
+    test_append(next, TEST_WRAP_COUNT);
+    next += TEST_WRAP_COUNT;
+    uint32_t kept = (uint32_t)flash_store_pending();
+    CHECK(kept > 0 && kept < TEST_WRAP_COUNT, "%u pendentes após %u leituras", kept, TEST_WRAP_COUNT);
+    test_expect_pending(next - kept, kept, true);
+    test_reboot();
+    test_expect_pending(next - kept, kept, false);
+    CHECK(test_drain(next - kept, kept, false) == kept, "drenagem após a volta incompleta");
+
+    // Escrita adiada a meio da sincronização: o que ficou por gravar segue na
+    // próxima, pela ordem, e as marcações de envio também esperam.
+    static flash_io_t busy_io;
+    busy_backing = flash_io_file(path);
+    busy_io = *busy_backing;
+    busy_io.program = busy_program;
+    busy_io.erase_sector = busy_erase_sector;
+    CHECK(flash_store_init(&busy_io) == FLASH_STORE_OK, "init com escritas adiadas");
+    for (uint32_t i = next; i < next + TEST_BUSY_COUNT; i++) {
+        batch_entry_t entry;
+        test_entry(i, &entry);
+        CHECK(flash_store_append(&entry) == FLASH_STORE_OK, "append %u", i);
+    }
+    busy_after = 1;
+    busy_pending = true;
+    CHECK(flash_store_sync() == FLASH_STORE_BUSY, "a escrita adiada não foi reportada");
+    CHECK(flash_store_pending() < TEST_BUSY_COUNT, "%zu pendentes com a escrita adiada", flash_store_pending());
+    CHECK(flash_store_sync() == FLASH_STORE_OK, "sync depois da escrita adiada");
+    test_expect_pending(next, TEST_BUSY_COUNT, true);
+
+    batch_entry_t busy_entries[TEST_PEEK_CHUNK];
+    size_t busy_peeked = flash_store_peek(busy_entries, TEST_PEEK_CHUNK);
+    CHECK(flash_store_consume(busy_peeked) == FLASH_STORE_OK, "consume %zu", busy_peeked);
+    busy_after = 0;
+    busy_pending = true;
+    CHECK(flash_store_sync() == FLASH_STORE_BUSY, "a marcação adiada não foi reportada");
+    CHECK(flash_store_sync() == FLASH_STORE_OK, "sync das marcações adiadas");
+    test_reboot();
+    test_expect_pending(next + (uint32_t)busy_peeked, TEST_BUSY_COUNT - (uint32_t)busy_peeked, false);
+    CHECK(test_drain(next + (uint32_t)busy_peeked, TEST_BUSY_COUNT - (uint32_t)busy_peeked, false) ==
+              TEST_BUSY_COUNT - busy_peeked,
+          "drenagem após as escritas adiadas incompleta");
+    next += TEST_BUSY_COUNT;
+
+    // Corte de energia: a flash é a mesma, vista por cut_program(). A
+    // dimensão do registo deduz-se da escrita de um registo só.
+    static flash_io_t cut_io;
+    cut_backing = flash_io_file(path);
+    cut_io = *cut_backing;
+    cut_io.read = cut_read;
+    cut_io.program = cut_program;
+    cut_io.erase_sector = cut_erase_sector;
+    cut_budget = SIZE_MAX;
+    cut_happened = false;
+    CHECK(flash_store_init(&cut_io) == FLASH_STORE_OK, "init com corte");
+    test_append(next, 1);
+    size_t record_size = SIZE_MAX - cut_budget;
+    CHECK(record_size == 32 || record_size == 64, "registo de %zu bytes", record_size);
+
+    // TEST_TORN_WHOLE registos inteiros e TEST_TORN_BYTES do seguinte.
+    cut_budget = TEST_TORN_WHOLE * record_size + TEST_TORN_BYTES;
+    for (uint32_t i = 1; i <= TEST_TORN_WHOLE + 1; i++) {
+        batch_entry_t entry;
+        test_entry(next + i, &entry);
+        flash_store_append(&entry);
+    }
+    CHECK(flash_store_sync() != FLASH_STORE_OK, "a escrita cortada não falhou");
+    CHECK(cut_happened, "o corte não ocorreu");
+
+    // No arranque seguinte os registos inteiros contam, o parcial não, e a
+    // escrita continua depois dele.
+    test_reboot();
+    uint32_t before_cut = 1 + TEST_TORN_WHOLE;
+    CHECK(flash_store_pending() == before_cut, "%zu pendentes após o corte, esperado %u",
+          flash_store_pending(), before_cut);
+
+    uint32_t after_cut = next + before_cut + 1;
+    test_append(after_cut, 5);
+    test_reboot();
+
+    // Todas as leituras pendentes, saltando apenas a do registo parcial.
+    CHECK(test_drain(next, before_cut, false) == before_cut, "drenagem antes do corte incompleta");
+    CHECK(test_drain(after_cut, 5, false) == 5, "drenagem depois do corte incompleta");
+    CHECK(flash_store_pending() == 0, "%zu pendentes no fim", flash_store_pending());
+
+    remove(path);
+    if (failures > 0) {
+        fprintf(stderr, "%d verificações falharam\n", failures);
+        return 1;
+    }
+    printf("flash_store: volta à região (%u pendentes de %u), registos de %zu bytes, escrita adiada e corte recuperados\n",
+           kept, TEST_WRAP_COUNT, record_size);
+    return 0;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file test_http_parser.c
+ * @brief Testa o http_parser com o corpus de respostas em host/tests/http_corpus.
+ *
+ * Cada resposta do corpus é dada ao analisador de uma vez, partida em dois
+ * em cada byte e um byte de cada vez; o resultado tem de ser o mesmo em
+ * todas as fragmentações e igual ao esperado na tabela abaixo. Depois dos
+ * bytes, as respostas marcadas com `finish` recebem http_parser_finish(),
+ * como quando o servidor fecha a conexão.
+ *
+ * Uso: test_http_parser <diretório do corpus>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "modules/http_parser/http_parser.h"
+
+#define TEST_RESPONSE_MAX 1024
+#define TEST_HEADERS_MAX  4
+
+static int failures;
+
+#define CHECK(cond, ...)                                   \
+    do {                                                   \
+        if (!(cond)) {                                     \
+            fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); \
+            fprintf(stderr, __VA_ARGS__);                  \
+            fprintf(stderr, "\n");                         \
+            failures++;                                    \
+        }                                                  \
+    } while (0)
+
+/**
+ * @brief Resultado esperado de uma resposta do corpus.
+ */
+typedef struct {
+    const char* file;
+    bool finish;               /**< Chamar http_parser_finish() depois dos bytes. */
+    bool error;                /**< A resposta termina em erro; os campos seguintes são ignorados. */
+    uint16_t status_code;
+    bool keep_alive;
+    bool chunked;
+    uint32_t content_length;   /**< 0 sem Content-Length. */
+    uint32_t retry_after_s;
+    size_t unconsumed;         /**< Bytes no fim, da resposta seguinte. */
+    const char* header_value;  /**< Último X-Config entregue, ou NULL. */
+    uint8_t header_count;      /**< Cabeçalhos entregues à função registada. */
+} test_case_t;
+
+static const test_case_t cases[] = {
+    // Os valores mantêm as maiúsculas; os nomes chegam em minúsculas.
+    { "no_content.http", false, false, 204, true, false, 0, HTTP_PARSER_NO_RETRY_AFTER, 0,
+      "Flow.sample_ms=100,temperature.report_ms=600000", 2 },
+    // O Connection é um token: Keep-Alive reconhecido em HTTP/1.0.
+    { "content_length_keep_alive.http", false, false, 200, true, false, 11, HTTP_PARSER_NO_RETRY_AFTER,
+      sizeof("HTTP/1.0 204 No Content\r\n\r\n") - 1, NULL, 0 },
+    { "content_length_lf_only.http", false, false, 201, true, false, 2, HTTP_PARSER_NO_RETRY_AFTER, 0,
+      NULL, 1 },
+    // Os trailers não são entregues.
+    { "chunked_extensions_trailers.http", false, false, 200, true, true, 0, HTTP_PARSER_NO_RETRY_AFTER, 0,
+      "Temperature.Deadband=0.25", 1 },
+    // Só os cabeçalhos da resposta final são entregues.
+    { "informational.http", false, false, 200, true, false, 2, HTTP_PARSER_NO_RETRY_AFTER, 0,
+      "flow.sample_ms=250", 1 },
+    { "duplicate_content_length.http", false, false, 200, true, false, 4, HTTP_PARSER_NO_RETRY_AFTER, 0,
+      NULL, 0 },
+    { "conflicting_content_length.http", false, true },
+    { "oversized_content_length.http", false, true },
+    { "overlong_content_length.http", false, true },
+    { "retry_after_close.http", false, false, 503, false, false, 0, 120, 0, NULL, 0 },
+    { "body_until_close.http", true, false, 200, false, false, 0, HTTP_PARSER_NO_RETRY_AFTER, 0, NULL, 1 },
+    { "truncated_headers.http", true, true },
+    { "truncated_body.http", true, true },
+    { "truncated_chunk.http", true, true },
+    { "truncated_trailers.http", true, true },
+    { "bad_status_line.http", false, true },
+};
+
+/**
+ * @brief Cabeçalhos entregues pelo analisador.
+ */
+typedef struct {
+    uint8_t count;
+    char config[HTTP_PARSER_VALUE_MAX];
+    bool name_lowercase;
+} test_headers_t;
+
+static void test_on_header(const char* name, const char* value, void* context) {
+    test_headers_t* headers = context;
+
+    headers->count++;
+    for (const char* c = name; *c != '\0'; c++) {
+        if (*c >= 'A' && *c <= 'Z') {
+            headers->name_lowercase = false;
+        }
+    }
+    if (strcmp(name, "x-config") == 0) {
+        snprintf(headers->config, sizeof(headers->config), "%s", value);
+    }
+}
+
+/**
+ * @brief Resultado de uma fragmentação, comparado entre todas.
+ */
+typedef struct {
+    http_parser_t parser;
+    test_headers_t headers;
+    size_t consumed;
+} test_run_t;
+
+/**
+ * @brief Dá a resposta ao analisador em pedaços de `step` bytes, com um primeiro de `split`.
+ */
+static void test_feed(const uint8_t* data, size_t len, size_t split, size_t step, bool finish, test_run_t* run) {
+    memset(run, 0, sizeof(*run));
+    run->headers.name_lowercase = true;
+    http_parser_init(&run->parser);
+    http_parser_set_header_handler(&run->parser, test_on_header, &run->headers);
+
+    size_t pos = 0;
+    size_t chunk = split;
+    while (pos < len) {
+        if (chunk > len - pos) {
+            chunk = len - pos;
+        }
+        run->consumed += http_parser_feed(&run->parser, data + pos, chunk);
+        pos += chunk;
+        chunk = step;
+    }
+    if (finish) {
+        http_parser_finish(&run->parser);
+    }
+}
+
+static bool test_same_run(const test_run_t* a, const test_run_t* b) {
+    return a->parser.state == b->parser.state && a->parser.status_code == b->parser.status_code &&
+           a->parser.keep_alive == b->parser.keep_alive && a->parser.chunked == b->parser.chunked &&
+           a->parser.content_length == b->parser.content_length &&
+           a->parser.retry_after_s == b->parser.retry_after_s && a->consumed == b->consumed &&
+           a->headers.count == b->headers.count && strcmp(a->headers.config, b->headers.config) == 0;
+}
+
+static void test_check_expected(const test_case_t* tc, const test_run_t* run, size_t len) {
+    const http_parser_t* p = &run->parser;
+
+    if (tc->error) {
+        CHECK(http_parser_has_error(p), "%s: sem erro (estado %d)", tc->file, p->state);
+        return;
+    }
+
+    CHECK(http_parser_is_done(p), "%s: incompleta (estado %d)", tc->file, p->state);
+    CHECK(p->status_code == tc->status_code, "%s: estado %u, esperado %u", tc->file, p->status_code,
+          tc->status_code);
+    CHECK(p->keep_alive == tc->keep_alive, "%s: keep_alive %d", tc->file, p->keep_alive);
+    CHECK(p->chunked == tc->chunked, "%s: chunked %d", tc->file, p->chunked);
+    CHECK(p->content_length == tc->content_length, "%s: Content-Length %u", tc->file, p->content_length);
+    CHECK(p->retry_after_s == tc->retry_after_s, "%s: Retry-After %u", tc->file, p->retry_after_s);
+    CHECK(run->consumed == len - tc->unconsumed, "%s: %zu bytes consumidos de %zu", tc->file, run->consumed, len);
+    CHECK(run->headers.count == tc->header_count, "%s: %u cabeçalhos entregues, esperado %u", tc->file,
+          run->headers.count, tc->header_count);
+    CHECK(run->headers.name_lowercase, "%s: nome de cabeçalho com maiúsculas", tc->file);
+    CHECK(strcmp(run->headers.config, tc->header_value ? tc->header_value : "") == 0,
+          "%s: X-Config \"%s\"", tc->file, run->headers.config);
+}
+
+static size_t test_load(const char* dir, const char* file, uint8_t* buf, size_t size) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, file);
+
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        CHECK(false, "abrir %s", path);
+        return 0;
+    }
+    size_t len = fread(buf, 1, size, f);
+    CHECK(feof(f), "%s maior do que %zu bytes", path, size);
+    fclose(f);
+    return len;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "uso: %s <diretório do corpus>\n", argv[0]);
+        return 2;
+    }
+
+    size_t runs = 0;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const test_case_t* tc = &cases[i];
+        static uint8_t data[TEST_RESPONSE_MAX];
+        size_t len = test_load(argv[1], tc->file, data, sizeof(data));
+        if (len == 0) {
+            continue;
+        }
+
+        test_run_t whole;
+        test_feed(data, len, len, len, tc->finish, &whole);
+        test_check_expected(tc, &whole, len);
+
+        test_run_t run;
+        for (size_t split = 1; split < len; split++) {
+            test_feed(data, len, split, len, tc->finish, &run);
+            CHECK(test_same_run(&whole, &run), "%s: resultado diferente partida no byte %zu", tc->file, split);
+            runs++;
+        }
+        test_feed(data, len, 1, 1, tc->finish, &run);
+        CHECK(test_same_run(&whole, &run), "%s: resultado diferente byte a byte", tc->file);
+        runs++;
+    }
+
+    if (failures > 0) {
+        fprintf(stderr, "%d verificações falharam\n", failures);
+        return 1;
+    }
+    printf("http_parser: %zu respostas, %zu fragmentações\n", sizeof(cases) / sizeof(cases[0]), runs);
+    return 0;
+}
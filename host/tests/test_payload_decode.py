@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""Codifica leituras com o firmware e descodifica-as com tools/payload_decode.py.
+
+Uso:
+    test_payload_decode.py <test_payload_encode> <diretório de trabalho>
+
+Executa test_payload_encode (compilado com um dos formatos do corpo), que
+escreve o corpo e as leituras originais, descodifica o corpo com o
+descodificador de referência e compara cada leitura: o instante (ts,
+age_ms ou nenhum), os sensores presentes e os valores em centésimos,
+calculados aqui a partir dos valores Q16.16 em bruto.
+"""
+
+import json
+import os
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "tools"))
+import payload_decode  # noqa: E402
+
+
+def q16_to_centi(value):
+    """Centésimos com arredondamento, como q16_to_centi() em fixed_point.h."""
+    return (value * 100 + (1 << 15)) >> 16
+
+
+def expected_reading(entry, now_ms, sensors):
+    if entry["epoch_ms"] != 0:
+        reading = {"ts": entry["epoch_ms"]}
+    elif entry["timestamp_unknown"]:
+        reading = {}
+    else:
+        reading = {"age_ms": (now_ms - entry["timestamp_ms"]) % (1 << 32)}
+    for name, value in zip(sensors, entry["values"]):
+        if value is not None:
+            reading[name] = q16_to_centi(value)
+    return reading
+
+
+def as_centi(reading, sensors):
+    """Passa os valores descodificados (em unidades) a centésimos inteiros."""
+    return {k: (round(v * 100) if k in sensors else v) for k, v in reading.items()}
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    encoder, workdir = sys.argv[1], sys.argv[2]
+    os.makedirs(workdir, exist_ok=True)
+    body_path = os.path.join(workdir, "body.bin")
+    entries_path = os.path.join(workdir, "entries.jsonl")
+
+    subprocess.run([encoder, body_path, entries_path], check=True)
+
+    with open(entries_path) as f:
+        header, *entries = [json.loads(line) for line in f]
+    with open(body_path, "rb") as f:
+        body = f.read()
+
+    sensors = tuple(header["sensors"])
+    failures = []
+    if len(body) != header["length"]:
+        failures.append("corpo de %d bytes, payload_encode indicou %d" % (len(body), header["length"]))
+    if (body[:1] == b"[") != (header["format"] == "application/json"):
+        failures.append("corpo em formato diferente de %s" % header["format"])
+
+    readings = payload_decode.decode(body, sensors)
+    if len(readings) != len(entries):
+        failures.append("%d leituras descodificadas, esperado %d" % (len(readings), len(entries)))
+
+    for i, (reading, entry) in enumerate(zip(readings, entries)):
+        expected = expected_reading(entry, header["now_ms"], sensors)
+        decoded = as_centi(reading, sensors)
+        if decoded != expected:
+            failures.append("leitura %d: %r, esperado %r (de %r)" % (i, decoded, expected, entry))
+
+    for failure in failures:
+        print(failure, file=sys.stderr)
+    if failures:
+        sys.exit(1)
+    print("%s: %d leituras descodificadas, %d bytes" % (header["format"], len(readings), len(body)))
+
+
+if __name__ == "__main__":
+    main()
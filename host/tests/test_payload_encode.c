@@ -0,0 +1,126 @@
+/**
+ * @file test_payload_encode.c
+ * @brief Codifica um lote de leituras de teste para test_payload_decode.py.
+ *
+ * Compilado uma vez por formato do corpo (PAYLOAD_FORMAT). Escreve o corpo
+ * gerado por payload_encode() e, à parte, as leituras tal como entraram no
+ * codificador (valores Q16.16 em bruto, canais, instantes), uma por linha
+ * em JSON. O script descodifica o corpo com tools/payload_decode.py e
+ * compara-o com os valores esperados, calculados por ele a partir dos brutos.
+ *
+ * Uso: test_payload_encode <corpo> <leituras>
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include "modules/payload_encoder/payload_encoder.h"
+
+#define TEST_NOW_MS 5000u
+
+// Valores Q16.16 nos extremos da faixa, à volta do arredondamento para
+// centésimos e nas mudanças de tamanho dos inteiros CBOR.
+static const q16_t values[] = {
+    0, 1, -1, INT32_MAX, INT32_MIN, INT32_MIN + 1, Q16_ONE, -Q16_ONE,
+    Q16_ONE / 2, -Q16_ONE / 2, 327, 328, -327, -328, -655, -656,
+    SENSOR_READ_ERROR,
+};
+
+static const int32_t centi_values[] = {
+    23, 24, -24, -25, 255, 256, -256, -257, 65535, 65536, -65536, -65537, 2534, -4012,
+};
+
+/**
+ * @brief Instantes: tempo Unix, idade (incluindo através da volta do contador
+ * de ms) e instante desconhecido, com e sem tempo Unix.
+ */
+static const struct {
+    uint64_t epoch_ms;
+    uint32_t timestamp_ms;
+    bool timestamp_unknown;
+} times[] = {
+    { 1760000000123ull, 0, false },
+    { 1, 0, false },
+    { 0, TEST_NOW_MS, false },
+    { 0, TEST_NOW_MS - 23, false },
+    { 0, TEST_NOW_MS - 24, false },
+    { 0, UINT32_MAX - 100, false },
+    { 0, 1234, true },
+    { 1760000000456ull, 1234, true },
+};
+
+#define TEST_VALUE_COUNT (sizeof(values) / sizeof(values[0]) + sizeof(centi_values) / sizeof(centi_values[0]))
+// Combinações de sensores ausentes: todas até 4 sensores, dos 4 primeiros acima disso.
+#define TEST_MASK_COUNT  (1u << ((SENSOR_COUNT < 4) ? SENSOR_COUNT : 4))
+#define TEST_ENTRY_COUNT (TEST_VALUE_COUNT + TEST_MASK_COUNT)
+
+static q16_t test_value(size_t i) {
+    size_t raw_count = sizeof(values) / sizeof(values[0]);
+    return (i < raw_count) ? values[i] : q16_from_centi(centi_values[i - raw_count]);
+}
+
+static void test_write(void* context, const void* data, size_t len) {
+    fwrite(data, 1, len, (FILE*)context);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "uso: %s <corpo> <leituras>\n", argv[0]);
+        return 2;
+    }
+
+    // Todos os valores em cada sensor, e depois todas as combinações de
+    // sensores ausentes; os instantes vão rodando.
+    static batch_entry_t entries[TEST_ENTRY_COUNT];
+    for (size_t i = 0; i < TEST_ENTRY_COUNT; i++) {
+        batch_entry_t* entry = &entries[i];
+        size_t t = i % (sizeof(times) / sizeof(times[0]));
+
+        entry->epoch_ms = times[t].epoch_ms;
+        entry->timestamp_ms = times[t].timestamp_ms;
+        entry->timestamp_unknown = times[t].timestamp_unknown;
+        entry->reading.channels = (i < TEST_VALUE_COUNT) ? SENSOR_CHANNELS_ALL
+                                                         : (sensor_mask_t)(i - TEST_VALUE_COUNT);
+        for (sensor_id_t id = 0; id < SENSOR_COUNT; id++) {
+            entry->reading.values[id] = test_value((i + id) % TEST_VALUE_COUNT);
+        }
+    }
+
+    FILE* body = fopen(argv[1], "wb");
+    FILE* expected = fopen(argv[2], "w");
+    if (body == NULL || expected == NULL) {
+        fprintf(stderr, "não foi possível criar %s ou %s\n", argv[1], argv[2]);
+        return 2;
+    }
+
+    int len = payload_encode(entries, TEST_ENTRY_COUNT, TEST_NOW_MS, test_write, body);
+    fclose(body);
+    if (len < 0) {
+        fprintf(stderr, "payload_encode falhou\n");
+        return 1;
+    }
+
+    fprintf(expected, "{\"format\":\"%s\",\"now_ms\":%u,\"length\":%d,\"sensors\":[",
+            payload_content_type(), TEST_NOW_MS, len);
+    for (sensor_id_t id = 0; id < SENSOR_COUNT; id++) {
+        fprintf(expected, "%s\"%s\"", (id > 0) ? "," : "", sensors_name(id));
+    }
+    fprintf(expected, "]}\n");
+
+    for (size_t i = 0; i < TEST_ENTRY_COUNT; i++) {
+        const batch_entry_t* entry = &entries[i];
+        fprintf(expected, "{\"epoch_ms\":%llu,\"timestamp_ms\":%u,\"timestamp_unknown\":%s,\"values\":[",
+                (unsigned long long)entry->epoch_ms, entry->timestamp_ms,
+                entry->timestamp_unknown ? "true" : "false");
+        for (sensor_id_t id = 0; id < SENSOR_COUNT; id++) {
+            const char* separator = (id > 0) ? "," : "";
+            if (entry->reading.channels & SENSOR_CHANNEL(id)) {
+                fprintf(expected, "%s%ld", separator, (long)entry->reading.values[id]);
+            } else {
+                fprintf(expected, "%snull", separator);
+            }
+        }
+        fprintf(expected, "]}\n");
+    }
+    fclose(expected);
+    return 0;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file test_retry_scheduler.c
+ * @brief Testa o disjuntor do retry_scheduler.
+ *
+ * Abre o disjuntor com falhas transitórias consecutivas e verifica o que a
+ * tentativa de prova decide: uma falha transitória volta a abri-lo; um
+ * sucesso ou uma rejeição permanente do conteúdo (ex: 400) fecham-no, porque
+ * o servidor respondeu.
+ */
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "modules/retry_scheduler/retry_scheduler.h"
+
+static int failures;
+
+#define CHECK(cond, ...)                                   \
+    do {                                                   \
+        if (!(cond)) {                                     \
+            fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); \
+            fprintf(stderr, __VA_ARGS__);                  \
+            fprintf(stderr, "\n");                         \
+            failures++;                                    \
+        }                                                  \
+    } while (0)
+
+/**
+ * @brief Abre o disjuntor e chega à tentativa de prova.
+ * @return O instante da prova.
+ */
+static uint32_t test_half_open(retry_scheduler_t* sched, uint32_t now_ms) {
+    for (uint32_t i = 0; i < RETRY_BREAKER_THRESHOLD; i++) {
+        retry_scheduler_record(sched, now_ms, RETRY_RESULT_TRANSIENT, HTTP_PARSER_NO_RETRY_AFTER);
+        now_ms += retry_scheduler_wait_ms(sched, now_ms);
+    }
+    CHECK(sched->state == RETRY_BREAKER_OPEN, "disjuntor no estado %d após %u falhas", sched->state,
+          RETRY_BREAKER_THRESHOLD);
+
+    CHECK(retry_scheduler_may_attempt(sched, now_ms), "prova não autorizada no fim da espera");
+    CHECK(sched->state == RETRY_BREAKER_HALF_OPEN, "disjuntor no estado %d na prova", sched->state);
+    return now_ms;
+}
+
+static void test_closed_after(const retry_scheduler_t* sched, uint32_t now_ms, const char* what) {
+    CHECK(sched->state == RETRY_BREAKER_CLOSED, "%s: disjuntor no estado %d", what, sched->state);
+    CHECK(sched->failures == 0, "%s: %u falhas", what, sched->failures);
+    CHECK(retry_scheduler_wait_ms(sched, now_ms) == 0, "%s: próximo envio adiado", what);
+}
+
+int main(void) {
+    stdio_init_all();
+
+    // Prova falhada: o disjuntor volta a abrir por RETRY_BREAKER_OPEN_MS.
+    retry_scheduler_t sched = { 0 };
+    uint32_t now_ms = test_half_open(&sched, 1000);
+    retry_scheduler_record(&sched, now_ms, RETRY_RESULT_TRANSIENT, HTTP_PARSER_NO_RETRY_AFTER);
+    CHECK(sched.state == RETRY_BREAKER_OPEN, "prova falhada: disjuntor no estado %d", sched.state);
+    CHECK(retry_scheduler_wait_ms(&sched, now_ms) >= RETRY_BREAKER_OPEN_MS / 2, "prova falhada: espera curta");
+
+    // Prova aceite.
+    sched = (retry_scheduler_t){ 0 };
+    now_ms = test_half_open(&sched, 1000);
+    retry_scheduler_record(&sched, now_ms, retry_classify(HTTP_OK, 204), HTTP_PARSER_NO_RETRY_AFTER);
+    test_closed_after(&sched, now_ms, "prova aceite");
+
+    // Prova rejeitada pelo conteúdo: o servidor está acessível.
+    static const uint16_t rejected[] = { 400, 413, 415, 422 };
+    for (size_t i = 0; i < sizeof(rejected) / sizeof(rejected[0]); i++) {
+        sched = (retry_scheduler_t){ 0 };
+        now_ms = test_half_open(&sched, 1000);
+        retry_result_t result = retry_classify(HTTP_ERROR_SERVER_REJECTED, rejected[i]);
+        CHECK(result == RETRY_RESULT_PERMANENT, "%u não é permanente", rejected[i]);
+        retry_scheduler_record(&sched, now_ms, result, HTTP_PARSER_NO_RETRY_AFTER);
+        test_closed_after(&sched, now_ms, "prova rejeitada");
+    }
+
+    // Com o disjuntor fechado, uma rejeição permanente anula as falhas anteriores.
+    sched = (retry_scheduler_t){ 0 };
+    retry_scheduler_record(&sched, 1000, RETRY_RESULT_TRANSIENT, HTTP_PARSER_NO_RETRY_AFTER);
+    retry_scheduler_record(&sched, 1000, RETRY_RESULT_PERMANENT, HTTP_PARSER_NO_RETRY_AFTER);
+    test_closed_after(&sched, 1000, "rejeição após uma falha");
+
+    if (failures > 0) {
+        fprintf(stderr, "%d verificações falharam\n", failures);
+        return 1;
+    }
+    printf("retry_scheduler: prova falhada reabre, prova aceite ou rejeitada fecha\n");
+    return 0;
+}
@@ -0,0 +1,661 @@
+/**
+ * @file w5500_posix.c
+ * @brief ethernet_manager e sockets do W5500 sobre a pilha TCP/IP do host.
+ *
+ * Cada socket do W5500 corresponde a um socket TCP não bloqueante do
+ * sistema, com memórias TX e RX do tamanho configurado no config.cmake, ou
+ * a um socket UDP, cujos datagramas passam diretamente pelo sistema. O
+ * "chip" avança quando o firmware lê o estado do socket ou espera por
+ * eventos: ethernet_wait_event() bloqueia em poll() sobre os sockets abertos
+ * e ativos em SIMR, como a tarefa de rede bloqueia na INTn na placa.
+ */
+
+#define WIZ_SOCKET_NO_ALIASES
+#include "ethernet_manager.h"
+#include "socket.h"
+#include "pico.h"
+#include "modules/logger/logger.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define W5500_MAX_SOCKET_KB 16
+
+typedef struct {
+    int fd;
+    uint8_t sr;
+    uint8_t ir;
+    uint8_t imr;
+    uint8_t io_mode;
+    uint16_t tx_size;
+    uint16_t rx_size;
+    uint16_t tx_rd;         /**< Próximo byte a entregar ao socket do sistema. */
+    uint16_t tx_wr;         /**< Sn_TX_WR. */
+    uint16_t tx_send_end;   /**< Fim dos dados confirmados com Sn_CR_SEND. */
+    bool send_pending;      /**< Sn_IR_SENDOK a sinalizar quando tx_rd chegar a tx_send_end. */
+    uint16_t rx_rd;
+    uint16_t rx_wr;
+    uint8_t tx_mem[W5500_MAX_SOCKET_KB * 1024];
+    uint8_t rx_mem[W5500_MAX_SOCKET_KB * 1024];
+} w5500_socket_t;
+
+// Memória TX/RX (KB) de cada socket, definida no config.cmake
+static const uint8_t socket_tx_kb[W5500_SOCKET_COUNT] = {
+    W5500_SOCKET_TX_KB_0, W5500_SOCKET_TX_KB_1, W5500_SOCKET_TX_KB_2, W5500_SOCKET_TX_KB_3,
+    W5500_SOCKET_TX_KB_4, W5500_SOCKET_TX_KB_5, W5500_SOCKET_TX_KB_6, W5500_SOCKET_TX_KB_7
+};
+static const uint8_t socket_rx_kb[W5500_SOCKET_COUNT] = {
+    W5500_SOCKET_RX_KB_0, W5500_SOCKET_RX_KB_1, W5500_SOCKET_RX_KB_2, W5500_SOCKET_RX_KB_3,
+    W5500_SOCKET_RX_KB_4, W5500_SOCKET_RX_KB_5, W5500_SOCKET_RX_KB_6, W5500_SOCKET_RX_KB_7
+};
+
+static w5500_socket_t sockets[W5500_SOCKET_COUNT] = {
+    [0 ... W5500_SOCKET_COUNT - 1] = { .fd = -1 }
+};
+static uint8_t simr;
+static uint8_t sockets_in_use = 0;
+static ethernet_config_t current_config;
+static ethernet_status_t current_status = ETHERNET_DISCONNECTED;
+
+static w5500_socket_t* w5500_socket(uint8_t sn) {
+    return (sn < W5500_SOCKET_COUNT) ? &sockets[sn] : NULL;
+}
+
+/**
+ * @brief Fecha o socket do sistema e põe o socket do W5500 no estado indicado.
+ */
+static void w5500_socket_drop(w5500_socket_t* s, uint8_t sr, uint8_t ir) {
+    if (s->fd >= 0) {
+        close(s->fd);
+        s->fd = -1;
+    }
+    s->sr = sr;
+    s->ir |= ir;
+    s->send_pending = false;
+}
+
+static void w5500_socket_transmit(w5500_socket_t* s) {
+    while (s->tx_rd != s->tx_send_end) {
+        uint16_t offset = s->tx_rd & (s->tx_size - 1);
+        uint16_t len = (uint16_t)(s->tx_send_end - s->tx_rd);
+        if (len > s->tx_size - offset) {
+            len = (uint16_t)(s->tx_size - offset);
+        }
+
+        ssize_t sent = send(s->fd, s->tx_mem + offset, len, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                w5500_socket_drop(s, SOCK_CLOSED, Sn_IR_TIMEOUT);
+            }
+            return;
+        }
+        s->tx_rd += (uint16_t)sent;
+    }
+
+    if (s->send_pending) {
+        s->send_pending = false;
+        s->ir |= Sn_IR_SENDOK;
+    }
+}
+
+static void w5500_socket_receive(w5500_socket_t* s) {
+    while (s->sr == SOCK_ESTABLISHED) {
+        uint16_t free_len = (uint16_t)(s->rx_size - (uint16_t)(s->rx_wr - s->rx_rd));
+        if (free_len == 0) {
+            return;
+        }
+        uint16_t offset = s->rx_wr & (s->rx_size - 1);
+        uint16_t len = (free_len < s->rx_size - offset) ? free_len : (uint16_t)(s->rx_size - offset);
+
+        ssize_t received = recv(s->fd, s->rx_mem + offset, len, MSG_DONTWAIT);
+        if (received > 0) {
+            s->rx_wr += (uint16_t)received;
+            s->ir |= Sn_IR_RECV;
+        } else if (received == 0) {
+            // FIN do servidor: os dados já recebidos continuam legíveis.
+            s->sr = SOCK_CLOSE_WAIT;
+            s->ir |= Sn_IR_DISCON;
+        } else {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                w5500_socket_drop(s, SOCK_CLOSED, Sn_IR_DISCON);
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Avança o estado do socket com o que o sistema já tem pronto, sem bloquear.
+ */
+static void w5500_socket_service(w5500_socket_t* s) {
+    if (s->fd < 0) {
+        return;
+    }
+
+    if (s->sr == SOCK_UDP) {
+        // Os datagramas ficam na fila do sistema até wiz_recvfrom().
+        struct pollfd pfd = { .fd = s->fd, .events = POLLIN };
+        if (poll(&pfd, 1, 0) > 0) {
+            s->ir |= Sn_IR_RECV;
+        }
+        return;
+    }
+
+    if (s->sr == SOCK_SYNSENT) {
+        struct pollfd pfd = { .fd = s->fd, .events = POLLOUT };
+        if (poll(&pfd, 1, 0) <= 0) {
+            return;
+        }
+
+        int error = 0;
+        socklen_t error_len = sizeof(error);
+        getsockopt(s->fd, SOL_SOCKET, SO_ERROR, &error, &error_len);
+        if (error != 0) {
+            // O W5500 reporta a recusa ou a falta de resposta como timeout.
+            w5500_socket_drop(s, SOCK_CLOSED, Sn_IR_TIMEOUT);
+            return;
+        }
+        s->sr = SOCK_ESTABLISHED;
+        s->ir |= Sn_IR_CON;
+    }
+
+    if (s->sr == SOCK_ESTABLISHED || s->sr == SOCK_CLOSE_WAIT) {
+        w5500_socket_transmit(s);
+    }
+    if (s->fd >= 0) {
+        w5500_socket_receive(s);
+    }
+}
+
+/**
+ * @brief Indica se algum socket tem eventos ativos, o equivalente à INTn em nível baixo.
+ */
+static bool w5500_interrupt_pending(void) {
+    for (uint8_t sn = 0; sn < W5500_SOCKET_COUNT; sn++) {
+        if ((simr & (1u << sn)) && (sockets[sn].ir & sockets[sn].imr)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// --- ethernet_manager.h ---
+
+int ethernet_init(ethernet_config_t* config) {
+    if (!config) {
+        LOG_ERROR("[ERRO] Configuração de rede inválida\n");
+        return -1;
+    }
+
+    memcpy(&current_config, config, sizeof(ethernet_config_t));
+
+    // Como após o reset do chip, todos os sockets começam fechados.
+    for (uint8_t sn = 0; sn < W5500_SOCKET_COUNT; sn++) {
+        w5500_socket_t* s = &sockets[sn];
+        wiz_close(sn);
+        memset(s, 0, offsetof(w5500_socket_t, tx_mem));
+        s->fd = -1;
+        s->tx_size = (uint16_t)(socket_tx_kb[sn] * 1024u);
+        s->rx_size = (uint16_t)(socket_rx_kb[sn] * 1024u);
+    }
+    simr = 0;
+
+    LOG_INFO("[OK]   W5500 simulado sobre a pilha TCP/IP do host.\n");
+    current_status = ETHERNET_CONNECTED;
+    return 0;
+}
+
+ethernet_status_t ethernet_get_status(void) {
+    return current_status;
+}
+
+void ethernet_get_network_info(wiz_NetInfo* net_info) {
+    if (net_info) {
+        memcpy(net_info->mac, current_config.mac, 6);
+        memcpy(net_info->ip, current_config.ip, 4);
+        memcpy(net_info->sn, current_config.subnet, 4);
+        memcpy(net_info->gw, current_config.gateway, 4);
+        memcpy(net_info->dns, current_config.dns, 4);
+        net_info->dhcp = current_config.dhcp;
+    }
+}
+
+void ethernet_cleanup(void) {
+    LOG_INFO("[INFO] Limpando recursos do módulo Ethernet...\n");
+    current_status = ETHERNET_DISCONNECTED;
+}
+
+int ethernet_restart(void) {
+    if (sockets_in_use != 0) {
+        LOG_WARN("[AVISO] Reinício do Ethernet adiado: sockets em uso (0x%02x).\n", sockets_in_use);
+        return -1;
+    }
+
+    LOG_INFO("[INFO] Reiniciando conexão Ethernet...\n");
+    return ethernet_init(&current_config);
+}
+
+int ethernet_socket_alloc(void) {
+    for (uint8_t i = 0; i < W5500_SOCKET_COUNT; i++) {
+        if ((sockets_in_use & (1 << i)) == 0 && socket_tx_kb[i] > 0 && socket_rx_kb[i] > 0) {
+            sockets_in_use |= (uint8_t)(1 << i);
+            return i;
+        }
+    }
+    return -1;
+}
+
+void ethernet_socket_free(uint8_t sn) {
+    if (sn < W5500_SOCKET_COUNT) {
+        simr &= (uint8_t)~(1 << sn);
+        sockets[sn].imr = 0;
+        sockets[sn].ir = 0;
+        sockets_in_use &= (uint8_t)~(1 << sn);
+    }
+}
+
+void ethernet_enable_socket_events(uint8_t sn, uint8_t mask) {
+    setSn_IMR(sn, mask);
+    setSIMR(getSIMR() | (uint8_t)(1 << sn));
+}
+
+void ethernet_disable_socket_events(uint8_t sn) {
+    setSIMR(getSIMR() & (uint8_t)~(1 << sn));
+}
+
+bool ethernet_wait_event(uint32_t timeout_ms) {
+    struct pollfd fds[W5500_SOCKET_COUNT];
+    nfds_t count = 0;
+
+    for (uint8_t sn = 0; sn < W5500_SOCKET_COUNT; sn++) {
+        w5500_socket_service(&sockets[sn]);
+    }
+    if (w5500_interrupt_pending()) {
+        return true;
+    }
+
+    for (uint8_t sn = 0; sn < W5500_SOCKET_COUNT; sn++) {
+        w5500_socket_t* s = &sockets[sn];
+        short events = 0;
+        // Um socket mascarado em SIMR não acorda a espera, como na INTn.
+        if (s->fd < 0 || !(simr & (1u << sn))) {
+            continue;
+        }
+        if (s->sr == SOCK_SYNSENT || s->tx_rd != s->tx_send_end) {
+            events |= POLLOUT;
+        }
+        if ((s->sr == SOCK_ESTABLISHED && (uint16_t)(s->rx_wr - s->rx_rd) < s->rx_size) ||
+            s->sr == SOCK_UDP) {
+            events |= POLLIN;
+        }
+        if (events) {
+            fds[count].fd = s->fd;
+            fds[count].events = events;
+            count++;
+        }
+    }
+
+    poll(fds, count, (int)timeout_ms);
+
+    for (uint8_t sn = 0; sn < W5500_SOCKET_COUNT; sn++) {
+        w5500_socket_service(&sockets[sn]);
+    }
+    return w5500_interrupt_pending();
+}
+
+bool ethernet_wait_socket_event(uint8_t sn, uint32_t timeout_ms) {
+    uint8_t saved = simr;
+
+    simr &= (uint8_t)(1 << sn);
+    bool signaled = ethernet_wait_event(timeout_ms);
+    simr = saved;
+
+    return signaled;
+}
+
+// --- socket.h ---
+
+int8_t wiz_socket(uint8_t sn, uint8_t protocol, uint16_t port, __unused uint8_t flag) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s == NULL || s->tx_size == 0 || s->rx_size == 0) {
+        return SOCKERR_SOCKNUM;
+    }
+    if (protocol != Sn_MR_TCP && protocol != Sn_MR_UDP) {
+        return SOCKERR_SOCKMODE;
+    }
+
+    wiz_close(sn);
+    int type = (protocol == Sn_MR_TCP) ? SOCK_STREAM : SOCK_DGRAM;
+    s->fd = socket(AF_INET, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (s->fd < 0) {
+        return SOCKERR_SOCKNUM;
+    }
+
+    if (protocol == Sn_MR_TCP) {
+        // O W5500 envia cada SEND de imediato, sem agregar segmentos.
+        int one = 1;
+        setsockopt(s->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    if (port != 0) {
+        struct sockaddr_in local = {
+            .sin_family = AF_INET,
+            .sin_port = htons(port),
+            .sin_addr.s_addr = htonl(INADDR_ANY)
+        };
+        if (bind(s->fd, (struct sockaddr*)&local, sizeof(local)) != 0) {
+            w5500_socket_drop(s, SOCK_CLOSED, 0);
+            return SOCKERR_SOCKNUM;
+        }
+    }
+
+    s->sr = (protocol == Sn_MR_TCP) ? SOCK_INIT : SOCK_UDP;
+    return (int8_t)sn;
+}
+
+int8_t wiz_close(uint8_t sn) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s == NULL) {
+        return SOCKERR_SOCKNUM;
+    }
+
+    w5500_socket_drop(s, SOCK_CLOSED, 0);
+    s->ir = 0;
+    s->tx_rd = s->tx_wr = s->tx_send_end = 0;
+    s->rx_rd = s->rx_wr = 0;
+    return SOCK_OK;
+}
+
+int8_t wiz_connect(uint8_t sn, uint8_t* addr, uint16_t port) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s == NULL) {
+        return SOCKERR_SOCKNUM;
+    }
+    if (s->sr != SOCK_INIT) {
+        return SOCKERR_SOCKSTATUS;
+    }
+
+    struct sockaddr_in remote = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port)
+    };
+    memcpy(&remote.sin_addr.s_addr, addr, 4);
+
+    if (connect(s->fd, (struct sockaddr*)&remote, sizeof(remote)) == 0) {
+        s->sr = SOCK_ESTABLISHED;
+        s->ir |= Sn_IR_CON;
+    } else if (errno == EINPROGRESS) {
+        s->sr = SOCK_SYNSENT;
+    } else {
+        w5500_socket_drop(s, SOCK_CLOSED, Sn_IR_TIMEOUT);
+    }
+
+    if (s->io_mode == SOCK_IO_NONBLOCK) {
+        return SOCK_BUSY;
+    }
+
+    while (s->sr == SOCK_SYNSENT) {
+        struct pollfd pfd = { .fd = s->fd, .events = POLLOUT };
+        poll(&pfd, 1, -1);
+        w5500_socket_service(s);
+    }
+    return (s->sr == SOCK_ESTABLISHED) ? SOCK_OK : SOCKERR_TIMEOUT;
+}
+
+int8_t wiz_disconnect(uint8_t sn) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s == NULL) {
+        return SOCKERR_SOCKNUM;
+    }
+
+    if (s->fd >= 0 && (s->sr == SOCK_ESTABLISHED || s->sr == SOCK_CLOSE_WAIT)) {
+        shutdown(s->fd, SHUT_WR);
+        s->sr = SOCK_FIN_WAIT;
+    }
+    return SOCK_OK;
+}
+
+int8_t wiz_ctlsocket(uint8_t sn, ctlsock_type cstype, void* arg) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s == NULL) {
+        return SOCKERR_SOCKNUM;
+    }
+
+    switch (cstype) {
+    case CS_SET_IOMODE:
+        s->io_mode = *(uint8_t*)arg;
+        return SOCK_OK;
+    case CS_GET_IOMODE:
+        *(uint8_t*)arg = s->io_mode;
+        return SOCK_OK;
+    default:
+        return SOCKERR_ARG;
+    }
+}
+
+int32_t wiz_sendto(uint8_t sn, uint8_t* buf, uint16_t len, uint8_t* addr, uint16_t port) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s == NULL) {
+        return SOCKERR_SOCKNUM;
+    }
+    if (s->sr != SOCK_UDP) {
+        return SOCKERR_SOCKSTATUS;
+    }
+
+    struct sockaddr_in remote = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port)
+    };
+    memcpy(&remote.sin_addr.s_addr, addr, 4);
+
+    // Como na ioLibrary, a função só retorna depois do SENDOK.
+    if (sendto(s->fd, buf, len, 0, (struct sockaddr*)&remote, sizeof(remote)) != (ssize_t)len) {
+        return SOCKERR_TIMEOUT;
+    }
+    return len;
+}
+
+int32_t wiz_recvfrom(uint8_t sn, uint8_t* buf, uint16_t len, uint8_t* addr, uint16_t* port) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s == NULL) {
+        return SOCKERR_SOCKNUM;
+    }
+    if (s->sr != SOCK_UDP) {
+        return SOCKERR_SOCKSTATUS;
+    }
+
+    struct sockaddr_in remote;
+    socklen_t remote_len = sizeof(remote);
+    int flags = (s->io_mode == SOCK_IO_NONBLOCK) ? MSG_DONTWAIT : 0;
+    ssize_t received = recvfrom(s->fd, buf, len, flags | MSG_TRUNC, (struct sockaddr*)&remote, &remote_len);
+    if (received < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? SOCK_BUSY : SOCKERR_SOCKSTATUS;
+    }
+
+    memcpy(addr, &remote.sin_addr.s_addr, 4);
+    *port = ntohs(remote.sin_port);
+    // O resto de um datagrama maior do que `len` é descartado.
+    return (received > len) ? len : (int32_t)received;
+}
+
+// --- w5500.h ---
+
+uint8_t getSn_SR(uint8_t sn) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s == NULL) {
+        return SOCK_CLOSED;
+    }
+    w5500_socket_service(s);
+    return s->sr;
+}
+
+uint8_t getSn_IR(uint8_t sn) {
+    w5500_socket_t* s = w5500_socket(sn);
+    return s ? s->ir : 0;
+}
+
+void setSn_IR(uint8_t sn, uint8_t ir) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s) {
+        // Como no chip, escrever 1 limpa o evento.
+        s->ir &= (uint8_t)~ir;
+    }
+}
+
+uint8_t getSn_IMR(uint8_t sn) {
+    w5500_socket_t* s = w5500_socket(sn);
+    return s ? s->imr : 0;
+}
+
+void setSn_IMR(uint8_t sn, uint8_t imr) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s) {
+        s->imr = imr;
+    }
+}
+
+uint8_t getSn_CR(__unused uint8_t sn) {
+    // Os comandos são executados de imediato.
+    return 0;
+}
+
+void setSn_CR(uint8_t sn, uint8_t cr) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s == NULL) {
+        return;
+    }
+
+    if (cr == Sn_CR_SEND) {
+        s->tx_send_end = s->tx_wr;
+        s->send_pending = true;
+        w5500_socket_service(s);
+    }
+    // Sn_CR_RECV: wiz_recv_data() já libertou o espaço na memória RX.
+}
+
+uint8_t getSIMR(void) {
+    return simr;
+}
+
+void setSIMR(uint8_t value) {
+    simr = value;
+}
+
+uint16_t getSn_TX_FSR(uint8_t sn) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s == NULL) {
+        return 0;
+    }
+    w5500_socket_service(s);
+    return (uint16_t)(s->tx_size - (uint16_t)(s->tx_wr - s->tx_rd));
+}
+
+uint16_t getSn_TX_WR(uint8_t sn) {
+    w5500_socket_t* s = w5500_socket(sn);
+    return s ? s->tx_wr : 0;
+}
+
+void setSn_TX_WR(uint8_t sn, uint16_t wr) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s) {
+        s->tx_wr = wr;
+    }
+}
+
+uint16_t getSn_RX_RSR(uint8_t sn) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s == NULL) {
+        return 0;
+    }
+    w5500_socket_service(s);
+    return (uint16_t)(s->rx_wr - s->rx_rd);
+}
+
+/**
+ * @brief Copia de/para a memória circular de um socket a partir de um ponteiro de 16 bits.
+ */
+static void w5500_ring_copy(uint8_t* ring, uint16_t size, uint16_t ptr, uint8_t* buf, uint16_t len, bool to_ring) {
+    if (size == 0) {
+        return;
+    }
+    for (uint16_t done = 0; done < len;) {
+        uint16_t offset = (uint16_t)(ptr + done) & (size - 1);
+        uint16_t chunk = (uint16_t)(size - offset);
+        if (chunk > len - done) {
+            chunk = (uint16_t)(len - done);
+        }
+        if (to_ring) {
+            memcpy(ring + offset, buf + done, chunk);
+        } else {
+            memcpy(buf + done, ring + offset, chunk);
+        }
+        done += chunk;
+    }
+}
+
+void wiz_send_data(uint8_t sn, uint8_t* wizdata, uint16_t len) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s == NULL) {
+        return;
+    }
+    w5500_ring_copy(s->tx_mem, s->tx_size, s->tx_wr, wizdata, len, true);
+    s->tx_wr += len;
+}
+
+void wiz_recv_data(uint8_t sn, uint8_t* wizdata, uint16_t len) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s == NULL) {
+        return;
+    }
+    w5500_ring_copy(s->rx_mem, s->rx_size, s->rx_rd, wizdata, len, false);
+    s->rx_rd += len;
+}
+
+void wiz_recv_ignore(uint8_t sn, uint16_t len) {
+    w5500_socket_t* s = w5500_socket(sn);
+    if (s) {
+        s->rx_rd += len;
+    }
+}
+
+/**
+ * @brief Acesso direto à memória de um socket: bits 15:0 do endereço em 31:8,
+ * bloco (WIZCHIP_TXBUF_BLOCK/WIZCHIP_RXBUF_BLOCK) em 7:3.
+ */
+static void w5500_buf_access(uint32_t addr_sel, uint8_t* buf, uint16_t len, bool write) {
+    uint8_t block = (uint8_t)((addr_sel >> 3) & 0x1F);
+    uint16_t ptr = (uint16_t)(addr_sel >> 8);
+    if (block < WIZCHIP_TXBUF_BLOCK(0)) {
+        return;
+    }
+
+    w5500_socket_t* s = w5500_socket((uint8_t)((block - WIZCHIP_TXBUF_BLOCK(0)) / 4));
+    if (s == NULL) {
+        return;
+    }
+    switch ((block - WIZCHIP_TXBUF_BLOCK(0)) % 4) {
+    case 0:
+        w5500_ring_copy(s->tx_mem, s->tx_size, ptr, buf, len, write);
+        break;
+    case 1:
+        w5500_ring_copy(s->rx_mem, s->rx_size, ptr, buf, len, write);
+        break;
+    default:
+        // Registos do socket: não simulados.
+        break;
+    }
+}
+
+void WIZCHIP_WRITE_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len) {
+    w5500_buf_access(AddrSel, pBuf, len, true);
+}
+
+void WIZCHIP_READ_BUF(uint32_t AddrSel, uint8_t* pBuf, uint16_t len) {
+    w5500_buf_access(AddrSel, pBuf, len, false);
+}
@@ -1,33 +1,139 @@
 /**
  * @file adc_manager.c
- * @brief Implementação de um driver para o conversor ADC ADS1115.
+ * @brief Implementação de um driver para um ou mais conversores ADC ADS1115.
  *
  * Este módulo fornece uma camada de abstração sobre a biblioteca ADS1115,
  * adicionando mecanismos essenciais de deteção e tratamento de erros.
  */
 
 #include "adc_manager.h"
-#include <stdio.h>
+#include "../logger/logger.h"
+#include "../i2c_bus/i2c_bus.h"
 #include "hardware/i2c.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
 
 // --- Configuração do Hardware ---
 #define I2C_PORT i2c0
-#define I2C_FREQ 400000
-#define ADS1115_I2C_ADDR 0x48
 const uint8_t SDA_PIN = 0;
 const uint8_t SCL_PIN = 1;
 
+// --- Registos do ADS1115 ---
+#define ADS1115_REG_CONVERSION 0x00
+#define ADS1115_REG_CONFIG     0x01
+#define ADS1115_REG_LO_THRESH  0x02
+#define ADS1115_REG_HI_THRESH  0x03
+#define ADS1115_COMP_QUE_MASK  0x0003
+#define ADS1115_MUX_MASK       0x7000
+// Bit OS: escrito a 1 inicia uma conversão single-shot; lido a 1, não há conversão em curso.
+#define ADS1115_OS_BIT         0x8000
+
+// --- Configuração da Aquisição Contínua ---
+#if ADC_DATA_RATE_SPS == 860
+#define ADC_ACQUISITION_RATE ADS1115_RATE_860_SPS
+#elif ADC_DATA_RATE_SPS == 475
+#define ADC_ACQUISITION_RATE ADS1115_RATE_475_SPS
+#elif ADC_DATA_RATE_SPS == 250
+#define ADC_ACQUISITION_RATE ADS1115_RATE_250_SPS
+#else
+#define ADC_ACQUISITION_RATE ADS1115_RATE_128_SPS
+#endif
+
+#define ADC_ACQUISITION_TASK_PRIORITY (configMAX_PRIORITIES - 2)
+#define ADC_ACQUISITION_STACK_SIZE    512
+// Sem pulso de RDY neste intervalo, a conversão é reiniciada.
+#define ADC_RDY_TIMEOUT_MS            50
+// Índice do buffer por canal a partir do campo MUX (bits 14:12) do registo de configuração.
+#define ADC_MUX_INDEX(mux)            (((uint16_t)(mux) >> 12) & 0x7)
+#define ADC_MUX_COUNT                 8
+// Limite de espera por uma conversão single-shot (uma conversão a 128 SPS leva ~8ms).
+#define ADC_SINGLE_SHOT_TIMEOUT_MS    20
+// Bit de notificação da tarefa de aquisição além dos de RDY (um por conversor).
+#define ADC_NOTIFY_HOLD               (1u << 30)
+// Limite de espera pela confirmação da retenção: a tarefa termina antes o serviço em curso.
+#define ADC_HOLD_TIMEOUT_MS           20
+// Retenção mais longa prevista: o apagamento de um setor da flash.
+#define ADC_HOLD_MAX_MS               400
+// Amostras guardadas durante uma retenção: todos os conversores à taxa nominal.
+#define ADC_HOLD_BUFFER_LENGTH        (ADC_DATA_RATE_SPS * ADC_DEVICE_COUNT * ADC_HOLD_MAX_MS / 1000)
+
 // --- Variáveis de Estado do Módulo ---
 
 /**
- * @brief Instância da estrutura de controlo do ADC da biblioteca.
+ * @brief Flag para verificar a inicialização.
  */
-static struct ads1115_adc adc;
+static bool is_initialized = false;
 
 /**
- * @brief Flag para verificar a inicialização.
+ * @struct adc_channel_buffer_t
+ * @brief Última amostra de um canal, publicada sem locks.
+ *
+ * Há um único escritor (a tarefa de aquisição). O contador de sequência é
+ * ímpar durante a escrita; o leitor repete a cópia se o contador mudou ou
+ * estava ímpar, o que dispensa secções críticas entre os dois núcleos.
  */
-static bool is_initialized = false;
+typedef struct {
+    volatile uint32_t sequence;
+    volatile int16_t raw;
+    volatile uint64_t timestamp_us;
+} adc_channel_buffer_t;
+
+/**
+ * @struct adc_device_t
+ * @brief Estado de um ADS1115 do barramento.
+ */
+typedef struct {
+    struct ads1115_adc adc;                          /**< Estrutura de controlo da biblioteca. */
+    uint rdy_pin;                                    /**< GPIO ligado ao seu pino ALERT/RDY. */
+    enum ads1115_mux_t channels[ADC_MUX_COUNT];      /**< Canais percorridos em round-robin. */
+    size_t channel_count;                            /**< 0 = conversor fora da aquisição. */
+    size_t index;                                    /**< Canal selecionado no multiplexador. */
+    bool settling;                                   /**< A conversão em curso começou antes da última troca de canal. */
+    TickType_t last_rdy;                             /**< Instante do último pulso de RDY. */
+    adc_channel_buffer_t buffers[ADC_MUX_COUNT];     /**< Última amostra de cada canal. */
+} adc_device_t;
+
+static adc_device_t devices[ADC_DEVICE_COUNT];
+
+static const uint8_t rdy_pins[ADC_MAX_DEVICES] = ADC_ALERT_RDY_PINS;
+
+static TaskHandle_t acquisition_task_handle = NULL;
+static uint acquisition_core = 0;
+static volatile bool is_acquiring = false;
+
+/**
+ * @struct adc_held_sample_t
+ * @brief Amostra lida durante a retenção, publicada no fim dela.
+ */
+typedef struct {
+    uint32_t timestamp_us;   /**< time_us_32() da leitura. */
+    int16_t raw;
+    uint8_t device;
+    uint8_t mux_index;       /**< ADC_MUX_INDEX() do canal. */
+} adc_held_sample_t;
+
+static adc_held_sample_t held_samples[ADC_HOLD_BUFFER_LENGTH];
+static size_t held_count = 0;
+static uint32_t held_dropped = 0;
+
+/**
+ * @brief Pedido de retenção, escrito por quem a pede, e confirmação, escrita
+ * pela tarefa de aquisição.
+ *
+ * Com `holding` a true a tarefa está no ciclo na RAM, com as interrupções
+ * do núcleo desativadas, e as transações do módulo são feitas por consulta.
+ */
+static volatile bool hold_requested = false;
+static volatile bool holding = false;
+
+/**
+ * @brief Destino do fluxo de amostras (ex: filtros de decimação dos sensores).
+ */
+static adc_sample_callback_t sample_callback = NULL;
+static void* sample_callback_context = NULL;
 
 /**
  * @brief Realiza uma verificação de baixo nível para a presença do ADC no barramento I2C.
@@ -37,15 +143,43 @@ static bool is_initialized = false;
  *
  * @return true se o dispositivo responder (ACK) no barramento, false caso contrário.
  */
-bool adc_module_is_connected() {
+bool adc_module_is_connected(uint8_t device) {
     uint8_t dummy_byte;
 
-    // Tenta ler 1 byte do dispositivo. Retornará
-    // um valor >= 0 em caso de sucesso ou um código de erro negativo em caso de falha (timeout, NACK).
+    if (device >= ADC_DEVICE_COUNT) {
+        return false;
+    }
+
+    // Tenta ler 1 byte do dispositivo. Retornará I2C_BUS_OK em caso de
+    // sucesso ou um código de erro em caso de falha (timeout, NACK).
+    i2c_bus_status_t result = i2c_bus_read(I2C_PORT, ADC_DEVICE_I2C_ADDR(device), &dummy_byte, 1);
+    return result == I2C_BUS_OK;
+}
 
-    int result = i2c_read_timeout_us(I2C_PORT, ADS1115_I2C_ADDR, &dummy_byte, 1, false, ADC_CONNECTION_CHECK_TIMEOUT_MS * 1000);
-    // return result == 1;
-    return 1;
+/**
+ * @brief Escreve um registo de 16 bits do ADS1115 numa única transação.
+ */
+static bool __not_in_flash_func(adc_write_register)(uint8_t device, uint8_t reg, uint16_t value) {
+    uint8_t buf[3] = {reg, (uint8_t)(value >> 8), (uint8_t)(value & 0xFF)};
+    if (holding) {
+        return i2c_bus_transfer_polled(I2C_PORT, ADC_DEVICE_I2C_ADDR(device), buf, 3, NULL, 0) == I2C_BUS_OK;
+    }
+    return i2c_bus_write(I2C_PORT, ADC_DEVICE_I2C_ADDR(device), buf, 3) == I2C_BUS_OK;
+}
+
+/**
+ * @brief Lê um registo de 16 bits do ADS1115: ponteiro e dados com repeated start.
+ */
+static bool __not_in_flash_func(adc_read_register)(uint8_t device, uint8_t reg, uint16_t* value) {
+    uint8_t buf[2];
+    i2c_bus_status_t status = holding
+        ? i2c_bus_transfer_polled(I2C_PORT, ADC_DEVICE_I2C_ADDR(device), &reg, 1, buf, 2)
+        : i2c_bus_write_read(I2C_PORT, ADC_DEVICE_I2C_ADDR(device), &reg, 1, buf, 2);
+    if (status != I2C_BUS_OK) {
+        return false;
+    }
+    *value = ((uint16_t)buf[0] << 8) | buf[1];
+    return true;
 }
 
 /**
@@ -57,39 +191,444 @@ adc_status_t adc_module_init(void) {
         return ADC_STATUS_OK;
     }
 
-    // Configuração de baixo nível dos pinos e do periférico I2C.
-    i2c_init(I2C_PORT, I2C_FREQ);
-    gpio_set_function(SDA_PIN, GPIO_FUNC_I2C);
-    gpio_set_function(SCL_PIN, GPIO_FUNC_I2C);
-    gpio_pull_up(SDA_PIN);
-    gpio_pull_up(SCL_PIN);
-    
-    // Impede o arranque do sistema se o hardware
-    // essencial não estiver presente.
-    if (!adc_module_is_connected()) {
-        printf("[ERRO FATAL] O dispositivo ADC (ADS1115) não foi encontrado no barramento I2C.\n");
-        is_initialized = false;
+    // Configuração de baixo nível dos pinos e do periférico I2C, partilhado
+    // com outras tarefas através do i2c_bus.
+    if (i2c_bus_init(I2C_PORT, SDA_PIN, SCL_PIN, ADC_I2C_BAUDRATE_HZ) != I2C_BUS_OK) {
+        LOG_ERROR("[ERRO FATAL] Falha ao inicializar o barramento I2C.\n");
         return ADC_STATUS_INIT_FAILED;
     }
 
-    // Apenas se a comunicação for confirmada, prossegue com a configuração
-    // lógica do dispositivo usando a biblioteca de abstração.
-    ads1115_init(I2C_PORT, ADS1115_I2C_ADDR, &adc);
-    ads1115_set_pga(ADS1115_PGA_4_096, &adc);
-    ads1115_set_data_rate(ADS1115_RATE_128_SPS, &adc);
-    ads1115_write_config(&adc);
+    for (uint8_t d = 0; d < ADC_DEVICE_COUNT; d++) {
+        // Impede o arranque do sistema se o hardware
+        // essencial não estiver presente.
+        if (!adc_module_is_connected(d)) {
+            LOG_ERROR("[ERRO FATAL] O ADS1115 %u (0x%02x) não foi encontrado no barramento I2C.\n",
+                      (unsigned)d, ADC_DEVICE_I2C_ADDR(d));
+            is_initialized = false;
+            return ADC_STATUS_INIT_FAILED;
+        }
+
+        // Apenas se a comunicação for confirmada, prossegue com a configuração
+        // lógica do dispositivo usando a biblioteca de abstração. A escrita do
+        // registo passa pelo i2c_bus, como todas as transações deste módulo.
+        struct ads1115_adc* adc = &devices[d].adc;
+        ads1115_init(I2C_PORT, ADC_DEVICE_I2C_ADDR(d), adc);
+        ads1115_set_pga(ADS1115_PGA_4_096, adc);
+        ads1115_set_data_rate(ADS1115_RATE_128_SPS, adc);
+        if (!adc_write_register(d, ADS1115_REG_CONFIG, adc->config)) {
+            LOG_ERROR("[ERRO FATAL] Falha ao configurar o ADS1115 %u.\n", (unsigned)d);
+            return ADC_STATUS_INIT_FAILED;
+        }
+        devices[d].rdy_pin = rdy_pins[d];
+    }
 
     is_initialized = true;
-    printf("[OK] Modulo ADC (ADS1115) inicializado.\n");
+    LOG_INFO("[OK] Modulo ADC (%d x ADS1115) inicializado.\n", ADC_DEVICE_COUNT);
+    return ADC_STATUS_OK;
+}
+
+static void adc_channel_publish(adc_device_t* device, enum ads1115_mux_t channel, int16_t raw,
+                                uint64_t timestamp_us) {
+    adc_channel_buffer_t* buffer = &device->buffers[ADC_MUX_INDEX(channel)];
+
+    buffer->sequence++;
+    __dmb();
+    buffer->raw = raw;
+    buffer->timestamp_us = timestamp_us;
+    __dmb();
+    buffer->sequence++;
+}
+
+/**
+ * @brief Tratador dos pinos ALERT/RDY, executado em contexto de interrupção.
+ *
+ * Apenas acorda a tarefa de aquisição, com um bit por conversor pronto: as
+ * transações I2C ficam fora da ISR.
+ */
+static void adc_rdy_irq_handler(void) {
+    uint32_t ready = 0;
+
+    for (uint8_t d = 0; d < ADC_DEVICE_COUNT; d++) {
+        if (gpio_get_irq_event_mask(devices[d].rdy_pin) & GPIO_IRQ_EDGE_FALL) {
+            gpio_acknowledge_irq(devices[d].rdy_pin, GPIO_IRQ_EDGE_FALL);
+            ready |= 1u << d;
+        }
+    }
+
+    if (ready != 0) {
+        BaseType_t higher_priority_woken = pdFALSE;
+        xTaskNotifyFromISR(acquisition_task_handle, ready, eSetBits, &higher_priority_woken);
+        portYIELD_FROM_ISR(higher_priority_woken);
+    }
+}
+
+/**
+ * @brief Guarda uma amostra lida durante a retenção.
+ */
+static void __not_in_flash_func(adc_hold_push)(uint8_t d, enum ads1115_mux_t channel, int16_t raw) {
+    if (held_count >= ADC_HOLD_BUFFER_LENGTH) {
+        held_dropped++;
+        return;
+    }
+    held_samples[held_count++] = (adc_held_sample_t){
+        .timestamp_us = time_us_32(),
+        .raw = raw,
+        .device = d,
+        .mux_index = (uint8_t)ADC_MUX_INDEX(channel),
+    };
+}
+
+/**
+ * @brief Lê a conversão concluída de um conversor e escolhe o canal seguinte.
+ *
+ * Em modo contínuo, escrever a configuração não interrompe a conversão em
+ * curso: a que já começou termina com o canal anterior e o novo só vale a
+ * partir da seguinte. Depois de cada troca de canal, o resultado seguinte
+ * é descartado. Com mais de um canal por conversor, cada canal recebe uma
+ * conversão em cada duas.
+ *
+ * Corre da RAM, também durante a retenção; a troca de canal não usa a
+ * biblioteca do ADS1115, que fica na flash.
+ */
+static void __not_in_flash_func(adc_device_service)(uint8_t d) {
+    adc_device_t* device = &devices[d];
+    enum ads1115_mux_t channel = device->channels[device->index];
+
+    uint16_t raw;
+    bool ok = adc_read_register(d, ADS1115_REG_CONVERSION, &raw);
+
+    if (device->settling) {
+        // Conversão do canal anterior, iniciada antes da troca.
+        device->settling = false;
+        return;
+    }
+
+    if (ok && holding) {
+        adc_hold_push(d, channel, (int16_t)raw);
+    } else if (ok) {
+        adc_channel_publish(device, channel, (int16_t)raw, time_us_64());
+        if (sample_callback) {
+            sample_callback(d, channel, (int16_t)raw, sample_callback_context);
+        }
+    }
+
+    if (device->channel_count > 1) {
+        if (++device->index >= device->channel_count) {
+            device->index = 0;
+        }
+        device->adc.config = (device->adc.config & ~ADS1115_MUX_MASK) | (uint16_t)device->channels[device->index];
+        adc_write_register(d, ADS1115_REG_CONFIG, device->adc.config);
+        device->settling = true;
+    }
+}
+
+/**
+ * @brief Reinicia um conversor sem pulso de RDY há ADC_RDY_TIMEOUT_MS.
+ *
+ * Reescrever a configuração retoma o modo contínuo se o conversor tiver
+ * reiniciado (ex: quebra de alimentação). Não se sabe com que canal começou
+ * a conversão em curso, por isso é descartada.
+ */
+static void __not_in_flash_func(adc_device_restart)(uint8_t d) {
+    adc_write_register(d, ADS1115_REG_CONFIG, devices[d].adc.config);
+    devices[d].settling = true;
+}
+
+/**
+ * @brief Serve os conversores por consulta até ao fim do pedido de retenção.
+ *
+ * Corre da RAM com as interrupções do núcleo desativadas: os flancos de RDY
+ * ficam registados no banco de GPIO e são lidos e reconhecidos aqui, e o
+ * limite de RDY conta em microssegundos, sem o tick.
+ */
+static void __not_in_flash_func(adc_hold_loop)(void) {
+    uint32_t last_rdy_us[ADC_DEVICE_COUNT];
+
+    if (!hold_requested) {
+        return;
+    }
+    holding = true;
+    __dmb();
+
+    uint32_t now_us = time_us_32();
+    for (uint8_t d = 0; d < ADC_DEVICE_COUNT; d++) {
+        last_rdy_us[d] = now_us;
+    }
+
+    while (hold_requested) {
+        now_us = time_us_32();
+        for (uint8_t d = 0; d < ADC_DEVICE_COUNT; d++) {
+            adc_device_t* device = &devices[d];
+            if (device->channel_count == 0) {
+                continue;
+            }
+
+            if (gpio_get_irq_event_mask(device->rdy_pin) & GPIO_IRQ_EDGE_FALL) {
+                gpio_acknowledge_irq(device->rdy_pin, GPIO_IRQ_EDGE_FALL);
+                adc_device_service(d);
+                last_rdy_us[d] = now_us;
+            } else if ((now_us - last_rdy_us[d]) >= ADC_RDY_TIMEOUT_MS * 1000u) {
+                adc_device_restart(d);
+                last_rdy_us[d] = now_us;
+            }
+        }
+        tight_loop_contents();
+    }
+
+    __dmb();
+    holding = false;
+}
+
+/**
+ * @brief Retém o núcleo até adc_module_release() e publica depois as amostras guardadas.
+ *
+ * Com o barramento tomado, nenhuma transação por interrupção fica a meio
+ * quando as interrupções são desativadas. Cada amostra guardada é publicada
+ * com o instante da sua leitura.
+ */
+static void adc_acquisition_hold(void) {
+    if (i2c_bus_lock(I2C_PORT) != I2C_BUS_OK) {
+        return;
+    }
+    held_count = 0;
+    held_dropped = 0;
+
+    uint32_t irq_status = save_and_disable_interrupts();
+    adc_hold_loop();
+    restore_interrupts(irq_status);
+    i2c_bus_unlock(I2C_PORT);
+
+    TickType_t now = xTaskGetTickCount();
+    for (uint8_t d = 0; d < ADC_DEVICE_COUNT; d++) {
+        devices[d].last_rdy = now;
+    }
+
+    uint64_t now_us = time_us_64();
+    for (size_t i = 0; i < held_count; i++) {
+        const adc_held_sample_t* sample = &held_samples[i];
+        enum ads1115_mux_t channel = (enum ads1115_mux_t)((uint16_t)sample->mux_index << 12);
+        uint64_t timestamp_us = now_us - (uint32_t)((uint32_t)now_us - sample->timestamp_us);
+
+        adc_channel_publish(&devices[sample->device], channel, sample->raw, timestamp_us);
+        if (sample_callback) {
+            sample_callback(sample->device, channel, sample->raw, sample_callback_context);
+        }
+    }
+    if (held_dropped > 0) {
+        LOG_WARN("[AVISO] %lu amostras do ADC descartadas durante a retenção.\n", (unsigned long)held_dropped);
+    }
+}
+
+/**
+ * @brief Tarefa diferida da aquisição contínua.
+ *
+ * Cada conversor converte em paralelo com os outros; a tarefa serve os que
+ * sinalizaram o fim de uma conversão, pela ordem dos endereços.
+ */
+static void adc_acquisition_task(__unused void* params) {
+    while (1) {
+        uint32_t ready = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &ready, pdMS_TO_TICKS(ADC_RDY_TIMEOUT_MS));
+        TickType_t now = xTaskGetTickCount();
+
+        for (uint8_t d = 0; d < ADC_DEVICE_COUNT; d++) {
+            adc_device_t* device = &devices[d];
+            if (device->channel_count == 0) {
+                continue;
+            }
+
+            if (ready & (1u << d)) {
+                adc_device_service(d);
+                device->last_rdy = now;
+            } else if ((now - device->last_rdy) >= pdMS_TO_TICKS(ADC_RDY_TIMEOUT_MS)) {
+                adc_device_restart(d);
+                device->last_rdy = now;
+            }
+        }
+
+        if (ready & ADC_NOTIFY_HOLD) {
+            adc_acquisition_hold();
+        }
+    }
+}
+
+adc_status_t adc_module_start_acquisition(const adc_input_t* inputs, size_t count) {
+    if (inputs == NULL || count == 0) {
+        return ADC_STATUS_INVALID_PARAM;
+    }
+
+    if (!is_initialized) {
+        return ADC_STATUS_NOT_INITIALIZED;
+    }
+
+    if (is_acquiring) {
+        return ADC_STATUS_OK;
+    }
+
+    // Reparte as entradas pelos conversores, sem repetir canais.
+    for (size_t i = 0; i < count; i++) {
+        if (inputs[i].device >= ADC_DEVICE_COUNT) {
+            return ADC_STATUS_INVALID_PARAM;
+        }
+        adc_device_t* device = &devices[inputs[i].device];
+        bool listed = false;
+        for (size_t c = 0; c < device->channel_count; c++) {
+            listed |= (device->channels[c] == inputs[i].channel);
+        }
+        if (!listed) {
+            device->channels[device->channel_count++] = inputs[i].channel;
+        }
+    }
+
+    uint32_t rdy_mask = 0;
+    uint8_t device_count = 0;
+    for (uint8_t d = 0; d < ADC_DEVICE_COUNT; d++) {
+        if (devices[d].channel_count == 0) {
+            continue;
+        }
+        // Com Hi_thresh = 0x8000 e Lo_thresh = 0x0000 o pino ALERT/RDY passa a
+        // sinalizar o fim de cada conversão em vez de um comparador.
+        if (!adc_write_register(d, ADS1115_REG_HI_THRESH, 0x8000) ||
+            !adc_write_register(d, ADS1115_REG_LO_THRESH, 0x0000)) {
+            LOG_ERROR("[ERRO] Falha ao configurar o pino ALERT/RDY do ADS1115 %u.\n", (unsigned)d);
+            return ADC_STATUS_INIT_FAILED;
+        }
+        rdy_mask |= 1u << devices[d].rdy_pin;
+        device_count++;
+    }
+
+    // A tarefa é fixada no núcleo que chama esta função, o mesmo que trata a IRQ do GPIO.
+    acquisition_core = get_core_num();
+#if configUSE_CORE_AFFINITY && (configNUM_CORES > 1)
+    xTaskCreateAffinitySet(adc_acquisition_task, "AdcAcqTask", ADC_ACQUISITION_STACK_SIZE, NULL,
+                           ADC_ACQUISITION_TASK_PRIORITY, 1u << get_core_num(), &acquisition_task_handle);
+#else
+    xTaskCreate(adc_acquisition_task, "AdcAcqTask", ADC_ACQUISITION_STACK_SIZE, NULL,
+                ADC_ACQUISITION_TASK_PRIORITY, &acquisition_task_handle);
+#endif
+    if (acquisition_task_handle == NULL) {
+        return ADC_STATUS_INIT_FAILED;
+    }
+
+    // Um único tratador para os pinos de todos os conversores.
+    gpio_add_raw_irq_handler_masked(rdy_mask, adc_rdy_irq_handler);
+
+    size_t channel_count = 0;
+    TickType_t now = xTaskGetTickCount();
+    for (uint8_t d = 0; d < ADC_DEVICE_COUNT; d++) {
+        adc_device_t* device = &devices[d];
+        if (device->channel_count == 0) {
+            continue;
+        }
+
+        // O ALERT/RDY é open-drain e ativo em nível baixo.
+        gpio_init(device->rdy_pin);
+        gpio_set_dir(device->rdy_pin, GPIO_IN);
+        gpio_pull_up(device->rdy_pin);
+        gpio_set_irq_enabled(device->rdy_pin, GPIO_IRQ_EDGE_FALL, true);
+
+        // Modo contínuo, com o comparador a disparar após cada conversão.
+        device->index = 0;
+        device->settling = false;
+        device->last_rdy = now;
+        ads1115_set_input_mux(device->channels[0], &device->adc);
+        ads1115_set_operating_mode(ADS1115_MODE_CONTINUOUS, &device->adc);
+        ads1115_set_data_rate(ADC_ACQUISITION_RATE, &device->adc);
+        device->adc.config &= ~ADS1115_COMP_QUE_MASK;
+        adc_write_register(d, ADS1115_REG_CONFIG, device->adc.config);
+        channel_count += device->channel_count;
+    }
+    irq_set_enabled(IO_IRQ_BANK0, true);
+
+    is_acquiring = true;
+    LOG_INFO("[OK] Aquisição contínua do ADC iniciada (%u canais em %u conversores, %d SPS cada).\n",
+             (unsigned)channel_count, (unsigned)device_count, ADC_DATA_RATE_SPS);
+    return ADC_STATUS_OK;
+}
+
+adc_status_t adc_module_hold(void) {
+    if (!is_acquiring) {
+        return ADC_STATUS_NOT_INITIALIZED;
+    }
+#if configUSE_CORE_AFFINITY && (configNUM_CORES > 1)
+    // Pedida no próprio núcleo, a retenção nunca seria libertada.
+    if (get_core_num() == acquisition_core) {
+        return ADC_STATUS_INVALID_PARAM;
+    }
+#endif
+
+    hold_requested = true;
+    __dmb();
+    xTaskNotify(acquisition_task_handle, ADC_NOTIFY_HOLD, eSetBits);
+
+    uint32_t start_us = time_us_32();
+    while (!holding) {
+        if ((time_us_32() - start_us) >= ADC_HOLD_TIMEOUT_MS * 1000u) {
+            // A tarefa ignora o pedido retirado quando o vier a tratar.
+            hold_requested = false;
+            LOG_WARN("[AVISO] A aquisição do ADC não confirmou a retenção.\n");
+            return ADC_STATUS_TIMEOUT;
+        }
+        tight_loop_contents();
+    }
+    return ADC_STATUS_OK;
+}
+
+void adc_module_release(void) {
+    hold_requested = false;
+    __dmb();
+    // A tarefa sai do ciclo no fim do serviço em curso.
+    while (holding) {
+        tight_loop_contents();
+    }
+}
+
+void adc_module_set_sample_callback(adc_sample_callback_t callback, void* context) {
+    sample_callback_context = context;
+    sample_callback = callback;
+}
+
+adc_status_t adc_module_read_latest(uint8_t device, enum ads1115_mux_t channel, int16_t* raw_out,
+                                    uint64_t* timestamp_us_out) {
+    if (raw_out == NULL || device >= ADC_DEVICE_COUNT) {
+        return ADC_STATUS_INVALID_PARAM;
+    }
+
+    if (!is_acquiring) {
+        return ADC_STATUS_NOT_INITIALIZED;
+    }
+
+    const adc_channel_buffer_t* buffer = &devices[device].buffers[ADC_MUX_INDEX(channel)];
+    uint32_t sequence;
+    int16_t raw;
+    uint64_t timestamp_us;
+
+    do {
+        sequence = buffer->sequence;
+        __dmb();
+        raw = buffer->raw;
+        timestamp_us = buffer->timestamp_us;
+        __dmb();
+    } while ((sequence & 1) || sequence != buffer->sequence);
+
+    // Nenhuma conversão foi publicada para este canal ainda.
+    if (sequence == 0) {
+        return ADC_STATUS_NO_SAMPLE;
+    }
+
+    *raw_out = raw;
+    if (timestamp_us_out) {
+        *timestamp_us_out = timestamp_us;
+    }
     return ADC_STATUS_OK;
 }
 
 /**
  * @brief Lê um valor de tensão de um canal específico do ADC.
  */
-adc_status_t adc_module_read_voltage(enum ads1115_mux_t channel, float *voltage_out) {
+adc_status_t adc_module_read_raw(uint8_t device, enum ads1115_mux_t channel, int16_t *raw_out) {
     // Verificação defensiva contra ponteiros nulos para evitar falhas de segmentação.
-    if (voltage_out == NULL) {
+    if (raw_out == NULL || device >= ADC_DEVICE_COUNT) {
         return ADC_STATUS_INVALID_PARAM;
     }
 
@@ -98,15 +637,60 @@ adc_status_t adc_module_read_voltage(enum ads1115_mux_t channel, float *voltage_
         return ADC_STATUS_NOT_INITIALIZED;
     }
 
+    // Com a aquisição contínua ativa, a última amostra é lida do buffer
+    // do canal, sem nenhuma transação I2C.
+    if (is_acquiring) {
+        return adc_module_read_latest(device, channel, raw_out, NULL);
+    }
+
     uint16_t adc_value;
+    struct ads1115_adc* adc = &devices[device].adc;
     
-    // Configura e realiza a leitura utilizando a biblioteca.
-    ads1115_set_input_mux(channel, &adc);
-    ads1115_write_config(&adc);
-    ads1115_read_adc(&adc_value, &adc);
+    // Configura o multiplexador e inicia uma conversão single-shot.
+    ads1115_set_input_mux(channel, adc);
+    if (!adc_write_register(device, ADS1115_REG_CONFIG, adc->config | ADS1115_OS_BIT)) {
+        return ADC_STATUS_READ_FAILED;
+    }
+
+    // Aguarda o fim da conversão, cedendo o núcleo entre consultas em vez
+    // de as encadear no barramento.
+    uint16_t config = 0;
+    uint32_t start_us = time_us_32();
+    do {
+        if ((time_us_32() - start_us) >= ADC_SINGLE_SHOT_TIMEOUT_MS * 1000u ||
+            !adc_read_register(device, ADS1115_REG_CONFIG, &config)) {
+            return ADC_STATUS_READ_FAILED;
+        }
+        if (!(config & ADS1115_OS_BIT)) {
+            if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+                vTaskDelay(1);
+            } else {
+                sleep_us(500);
+            }
+        }
+    } while (!(config & ADS1115_OS_BIT));
+
+    if (!adc_read_register(device, ADS1115_REG_CONVERSION, &adc_value)) {
+        return ADC_STATUS_READ_FAILED;
+    }
+
+    *raw_out = (int16_t)adc_value;
+    return ADC_STATUS_OK;
+}
+
+adc_status_t adc_module_read_voltage(uint8_t device, enum ads1115_mux_t channel, float *voltage_out) {
+    if (voltage_out == NULL) {
+        return ADC_STATUS_INVALID_PARAM;
+    }
+
+    int16_t raw;
+    adc_status_t status = adc_module_read_raw(device, channel, &raw);
+    if (status != ADC_STATUS_OK) {
+        return status;
+    }
 
     // Converte o valor bruto para Volts e o armazena no ponteiro de saída.
-    *voltage_out = ads1115_raw_to_volts(adc_value, &adc);
+    *voltage_out = ads1115_raw_to_volts((uint16_t)raw, &devices[device].adc);
     
     return ADC_STATUS_OK;
 }
\ No newline at end of file
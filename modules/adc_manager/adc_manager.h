@@ -1,10 +1,14 @@
 /**
  * @file adc_manager.h
- * @brief Interface pública para um driver do ADC ADS1115.
+ * @brief Interface pública para um driver de um ou mais ADC ADS1115.
  *
  * Este ficheiro define o "contrato" público para interagir com o módulo ADC.
  * A sua principal característica é o uso de um tipo de enumeração (adc_status_t)
  * para retornar o estado explícito de cada operação.
+ *
+ * Até ADC_MAX_DEVICES conversores partilham o barramento I2C, um por
+ * endereço (ADC_DEVICE_I2C_ADDR); cada entrada analógica é identificada pelo
+ * par (conversor, canal do multiplexador).
  */
 #ifndef ADC_MANAGER_H
 #define ADC_MANAGER_H
@@ -22,13 +26,69 @@ typedef enum {
     ADC_STATUS_OK,                  /**< A operação foi concluída com sucesso. */
     ADC_STATUS_NOT_INITIALIZED,     /**< A operação falhou porque o módulo não foi inicializado. */
     ADC_STATUS_INIT_FAILED,         /**< A inicialização falhou, provável falha de comunicação com o hardware. */
-    ADC_STATUS_INVALID_PARAM        /**< A operação falhou devido a um parâmetro inválido (ex: ponteiro nulo). */
+    ADC_STATUS_INVALID_PARAM,       /**< A operação falhou devido a um parâmetro inválido (ex: ponteiro nulo). */
+    ADC_STATUS_NO_SAMPLE,           /**< A aquisição contínua ainda não produziu nenhuma amostra para o canal. */
+    ADC_STATUS_READ_FAILED,         /**< A transação I2C falhou (NACK ou timeout) ou a conversão não terminou. */
+    ADC_STATUS_TIMEOUT              /**< A tarefa de aquisição não confirmou o pedido a tempo. */
 } adc_status_t;
 
 /**
- * @brief Inicializa o barramento I2C e o conversor ADC ADS1115.
+ * @brief Número máximo de ADS1115 no barramento (endereços 0x48 a 0x4B).
+ */
+#define ADC_MAX_DEVICES 4
+
+/**
+ * @brief Endereço I2C do conversor `device` (0 a ADC_DEVICE_COUNT - 1).
+ */
+#define ADC_DEVICE_I2C_ADDR(device) (0x48 + (device))
+
+/**
+ * @brief Pinos ALERT/RDY dos conversores, indexados pelo número do conversor.
+ */
+#define ADC_ALERT_RDY_PINS { ADC_ALERT_RDY_PIN_0, ADC_ALERT_RDY_PIN_1, \
+                             ADC_ALERT_RDY_PIN_2, ADC_ALERT_RDY_PIN_3 }
+
+_Static_assert(ADC_DEVICE_COUNT >= 1 && ADC_DEVICE_COUNT <= ADC_MAX_DEVICES,
+               "ADC_DEVICE_COUNT deve ser 1 a ADC_MAX_DEVICES");
+
+/**
+ * @struct adc_input_t
+ * @brief Uma entrada analógica: o conversor e o canal do seu multiplexador.
+ */
+typedef struct {
+    uint8_t device;              /**< O conversor, 0 a ADC_DEVICE_COUNT - 1. */
+    enum ads1115_mux_t channel;  /**< O canal do multiplexador (ex: ADS1115_MUX_SINGLE_0). */
+} adc_input_t;
+
+/**
+ * @brief Fundo de escala do PGA configurado (ADS1115_PGA_4_096), em Volts.
+ */
+#define ADC_FULL_SCALE_VOLTS 4.096f
+
+/**
+ * @brief Tensão correspondente a um código do conversor (16 bits com sinal).
+ */
+#define ADC_VOLTS_PER_CODE (ADC_FULL_SCALE_VOLTS / 32768.0f)
+
+/**
+ * @brief Função chamada pela aquisição contínua para cada amostra convertida.
+ *
+ * Executa no contexto da tarefa de aquisição, à taxa do conversor: deve ser
+ * curta e não bloquear. As amostras convertidas durante adc_module_hold()
+ * chegam depois da retenção, seguidas e pela ordem de conversão.
+ *
+ * @param device O conversor que produziu a amostra.
+ * @param channel O canal do multiplexador que foi convertido.
+ * @param raw O código bruto do conversor.
+ * @param context O ponteiro registado com adc_module_set_sample_callback().
+ */
+typedef void (*adc_sample_callback_t)(uint8_t device, enum ads1115_mux_t channel, int16_t raw,
+                                      void* context);
+
+/**
+ * @brief Inicializa o barramento I2C e os ADC_DEVICE_COUNT conversores ADS1115.
  *
- * Realiza a configuração do hardware e, crucialmente, verifica se o dispositivo
+ * Realiza a configuração do hardware e, crucialmente, verifica se cada dispositivo
  * ADC está presente e a comunicar no barramento I2C antes de sinalizar sucesso.
  * Esta função deve ser chamada com sucesso antes de qualquer outra função do módulo.
  *
@@ -37,28 +97,117 @@ typedef enum {
 adc_status_t adc_module_init(void);
 
 /**
- * @brief Verifica se o dispositivo ADC está presente no barramento I2C.
+ * @brief Verifica se um conversor ADC está presente no barramento I2C.
  *
  * Realiza uma comunicação de baixo nível para garantir que o dispositivo
  * está a responder antes de tentar operações de leitura ou escrita.
  *
+ * @param device O conversor, 0 a ADC_DEVICE_COUNT - 1.
  * @return true se o dispositivo estiver conectado e a responder, false caso contrário.
  */
-bool adc_module_is_connected(void);
+bool adc_module_is_connected(uint8_t device);
 
 /**
- * @brief Lê a tensão de um canal específico do ADS1115.
+ * @brief Lê a tensão de um canal específico de um ADS1115.
  *
  * Esta função encapsula a seleção do canal, a leitura do valor bruto e a
  * conversão para Volts. Inclui uma verificação de saúde em tempo de execução
  * para garantir que a comunicação com o ADC ainda está ativa.
  *
+ * @param device O conversor, 0 a ADC_DEVICE_COUNT - 1.
  * @param channel O canal do multiplexador a ser lido (ex: ADS1115_MUX_SINGLE_0).
  * @param voltage_out Ponteiro para uma variável float onde o valor da tensão
  * lida será armazenado. O ponteiro não deve ser nulo.
  * @return ADC_STATUS_OK se a leitura for bem-sucedida, ou um código de erro
  * relevante em caso de falha.
  */
-adc_status_t adc_module_read_voltage(enum ads1115_mux_t channel, float *voltage_out);
+adc_status_t adc_module_read_voltage(uint8_t device, enum ads1115_mux_t channel, float *voltage_out);
+
+/**
+ * @brief Lê o código bruto de um canal, sem conversão para Volts.
+ *
+ * Com a aquisição contínua ativa devolve a última amostra do canal; caso
+ * contrário realiza uma conversão single-shot. Cada código vale
+ * ADC_VOLTS_PER_CODE Volts.
+ *
+ * @param device O conversor, 0 a ADC_DEVICE_COUNT - 1.
+ * @param channel O canal do multiplexador a ser lido (ex: ADS1115_MUX_SINGLE_0).
+ * @param raw_out Ponteiro que receberá o código bruto do conversor.
+ * @return ADC_STATUS_OK se a leitura for bem-sucedida, ou um código de erro
+ * relevante em caso de falha.
+ */
+adc_status_t adc_module_read_raw(uint8_t device, enum ads1115_mux_t channel, int16_t *raw_out);
+
+/**
+ * @brief Inicia a aquisição contínua, comandada pelos pinos ALERT/RDY dos ADS1115.
+ *
+ * Cada conversor com entradas na lista passa a converter continuamente e a
+ * sinalizar cada conversão concluída no seu pino ALERT/RDY. Uma tarefa de
+ * alta prioridade, acordada pelas interrupções desses pinos, lê o resultado
+ * do conversor que terminou, publica-o no buffer da entrada e comuta o seu
+ * multiplexador para a entrada seguinte desse conversor (round-robin). A
+ * conversão já em curso durante a troca ainda é do canal anterior e é
+ * descartada: com N > 1 entradas, cada uma recebe uma conversão em 2 * N.
+ * Os conversores trabalham em paralelo: enquanto um converte, os outros
+ * são lidos, e o débito total cresce com o número de conversores.
+ * A partir daí, adc_module_read_voltage() devolve a última amostra da
+ * entrada sem aceder ao barramento I2C.
+ *
+ * @param inputs As entradas a serem percorridas, em qualquer ordem.
+ * @param count O número de entradas em `inputs`.
+ * @return ADC_STATUS_OK em caso de sucesso, ou um código de erro relevante em caso de falha.
+ */
+adc_status_t adc_module_start_acquisition(const adc_input_t* inputs, size_t count);
+
+/**
+ * @brief Retém o núcleo da aquisição na RAM, sem parar a aquisição (ex: durante a escrita na flash).
+ *
+ * A tarefa de aquisição desativa as interrupções do seu núcleo e passa a
+ * servir os conversores por consulta, num ciclo que corre da RAM e não toca
+ * no XIP: o pino ALERT/RDY e o barramento I2C são lidos diretamente nos
+ * registos. As amostras ficam num buffer em RAM e são publicadas, com os
+ * seus instantes, por adc_module_release(). Enquanto a retenção durar, o
+ * outro núcleo pode desativar o XIP sem flash_safe_execute().
+ *
+ * Deve ser chamada no outro núcleo: retido, o núcleo da aquisição não corre
+ * mais nada. Espera ativamente pela confirmação e deve ser sempre seguida
+ * de adc_module_release(), mesmo sem sucesso.
+ *
+ * @return ADC_STATUS_OK com o núcleo retido, ADC_STATUS_TIMEOUT se a tarefa
+ * não confirmou a retenção a tempo, ADC_STATUS_INVALID_PARAM no núcleo da
+ * aquisição, ou ADC_STATUS_NOT_INITIALIZED sem aquisição contínua.
+ */
+adc_status_t adc_module_hold(void);
+
+/**
+ * @brief Liberta o núcleo retido com adc_module_hold().
+ *
+ * Espera que a tarefa de aquisição saia do ciclo na RAM; as amostras do
+ * buffer são entregues a seguir, na tarefa de aquisição.
+ */
+void adc_module_release(void);
+
+/**
+ * @brief Obtém a última amostra bruta de um canal em aquisição contínua, em O(1).
+ *
+ * @param device O conversor, 0 a ADC_DEVICE_COUNT - 1.
+ * @param channel O canal do multiplexador a ser consultado.
+ * @param raw_out Ponteiro que receberá o código bruto do conversor.
+ * @param timestamp_us_out Ponteiro opcional que receberá o instante da amostra (time_us_64()).
+ * @return ADC_STATUS_OK se houver amostra, ADC_STATUS_NO_SAMPLE se o canal
+ * ainda não tiver sido convertido, ou um código de erro relevante.
+ */
+adc_status_t adc_module_read_latest(uint8_t device, enum ads1115_mux_t channel, int16_t* raw_out,
+                                    uint64_t* timestamp_us_out);
+
+/**
+ * @brief Regista a função que recebe o fluxo de amostras da aquisição contínua.
+ *
+ * Deve ser chamada antes de adc_module_start_acquisition().
+ *
+ * @param callback A função a ser chamada para cada amostra, ou NULL para remover.
+ * @param context Ponteiro opaco repassado à função.
+ */
+void adc_module_set_sample_callback(adc_sample_callback_t callback, void* context);
 
 #endif // ADC_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,119 @@
+/**
+ * @file analog_filter.c
+ * @brief Implementação dos filtros de decimação em aritmética inteira.
+ */
+
+#include "analog_filter.h"
+#include <stddef.h>
+#include <string.h>
+
+void analog_filter_init(analog_filter_t* filter, const analog_filter_config_t* config) {
+    if (filter == NULL || config == NULL) {
+        return;
+    }
+
+    memset(filter, 0, sizeof(*filter));
+    filter->config = *config;
+
+    if (filter->config.window == 0) {
+        filter->config.window = 1;
+    } else if (filter->config.window > ANALOG_FILTER_MAX_WINDOW) {
+        filter->config.window = ANALOG_FILTER_MAX_WINDOW;
+    }
+}
+
+void analog_filter_push(analog_filter_t* filter, int16_t raw) {
+    switch (filter->config.kind) {
+        case ANALOG_FILTER_BOXCAR:
+            filter->boxcar_sum += raw;
+            filter->boxcar_count++;
+            break;
+
+        case ANALOG_FILTER_MOVING_AVERAGE:
+        case ANALOG_FILTER_MEDIAN:
+            // A soma corrente evita percorrer a janela a cada amostra.
+            if (filter->window_filled == filter->config.window) {
+                filter->window_sum -= filter->window[filter->window_index];
+            } else {
+                filter->window_filled++;
+            }
+            filter->window[filter->window_index] = raw;
+            filter->window_sum += raw;
+            filter->window_index = (uint8_t)((filter->window_index + 1) % filter->config.window);
+            break;
+
+        case ANALOG_FILTER_NONE:
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Mediana da janela por ordenação por inserção de uma cópia (n <= 16).
+ */
+static int32_t analog_filter_median(const analog_filter_t* filter) {
+    int16_t sorted[ANALOG_FILTER_MAX_WINDOW];
+    uint8_t n = filter->window_filled;
+
+    for (uint8_t i = 0; i < n; i++) {
+        int16_t value = filter->window[i];
+        int j = i;
+        while (j > 0 && sorted[j - 1] > value) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+
+    // Com n par, a média dos dois centrais preserva meio código de resolução.
+    if ((n & 1) == 0) {
+        return ((int32_t)sorted[n / 2 - 1] + sorted[n / 2]) << (ANALOG_FILTER_FRAC_BITS - 1);
+    }
+    return (int32_t)sorted[n / 2] << ANALOG_FILTER_FRAC_BITS;
+}
+
+/**
+ * @brief Divisão com arredondamento ao mais próximo, simétrica em torno de zero.
+ */
+static int32_t analog_filter_round_div(int64_t numerator, uint32_t denominator) {
+    int64_t half = denominator / 2;
+    return (int32_t)((numerator >= 0) ? (numerator + half) / denominator
+                                      : (numerator - half) / denominator);
+}
+
+bool analog_filter_output(analog_filter_t* filter, int32_t* code_out) {
+    if (filter == NULL || code_out == NULL) {
+        return false;
+    }
+
+    switch (filter->config.kind) {
+        case ANALOG_FILTER_BOXCAR:
+            if (filter->boxcar_count == 0) {
+                return false;
+            }
+            *code_out = analog_filter_round_div(filter->boxcar_sum * (1 << ANALOG_FILTER_FRAC_BITS),
+                                                filter->boxcar_count);
+            filter->boxcar_sum = 0;
+            filter->boxcar_count = 0;
+            return true;
+
+        case ANALOG_FILTER_MOVING_AVERAGE:
+            if (filter->window_filled == 0) {
+                return false;
+            }
+            *code_out = analog_filter_round_div((int64_t)filter->window_sum * (1 << ANALOG_FILTER_FRAC_BITS),
+                                                filter->window_filled);
+            return true;
+
+        case ANALOG_FILTER_MEDIAN:
+            if (filter->window_filled == 0) {
+                return false;
+            }
+            *code_out = analog_filter_median(filter);
+            return true;
+
+        case ANALOG_FILTER_NONE:
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,85 @@
+/**
+ * @file analog_filter.h
+ * @brief Interface pública dos filtros de decimação para canais analógicos.
+ *
+ * Cada filtro consome o fluxo de códigos brutos de alta taxa produzido pela
+ * aquisição contínua do ADC e entrega um valor decimado à taxa de envio.
+ * Toda a aritmética é inteira: o Cortex-M0+ não tem FPU.
+ *
+ * As saídas são códigos do ADC com ANALOG_FILTER_FRAC_BITS bits fracionários,
+ * preservando a resolução adicional obtida pela sobreamostragem.
+ */
+#ifndef ANALOG_FILTER_H
+#define ANALOG_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Bits fracionários das saídas dos filtros (código bruto << 4). */
+#define ANALOG_FILTER_FRAC_BITS 4
+
+/** @brief Comprimento máximo da janela dos filtros de média móvel e mediana. */
+#define ANALOG_FILTER_MAX_WINDOW 16
+
+/**
+ * @enum analog_filter_kind_t
+ * @brief Tipos de filtro disponíveis por sensor.
+ */
+typedef enum {
+    ANALOG_FILTER_NONE,           /**< Sem filtro: usa a última amostra do ADC. */
+    ANALOG_FILTER_BOXCAR,         /**< Média de todas as amostras desde a última saída (integra e descarta). */
+    ANALOG_FILTER_MOVING_AVERAGE, /**< Média das últimas `window` amostras. */
+    ANALOG_FILTER_MEDIAN          /**< Mediana das últimas `window` amostras, robusta a picos. */
+} analog_filter_kind_t;
+
+/**
+ * @struct analog_filter_config_t
+ * @brief Escolha do filtro de um sensor.
+ */
+typedef struct {
+    analog_filter_kind_t kind; /**< O tipo de filtro. */
+    uint8_t window;            /**< Comprimento da janela (média móvel e mediana), até ANALOG_FILTER_MAX_WINDOW. */
+} analog_filter_config_t;
+
+/**
+ * @struct analog_filter_t
+ * @brief Estado de um filtro. Deve ser preparado com analog_filter_init().
+ */
+typedef struct {
+    analog_filter_config_t config;
+    int64_t boxcar_sum;                       /**< Soma das amostras do bloco atual (BOXCAR). */
+    uint32_t boxcar_count;                    /**< Amostras no bloco atual (BOXCAR). */
+    int16_t window[ANALOG_FILTER_MAX_WINDOW]; /**< Últimas amostras (MOVING_AVERAGE e MEDIAN). */
+    int32_t window_sum;                       /**< Soma das amostras da janela (MOVING_AVERAGE). */
+    uint8_t window_index;                     /**< Posição da próxima escrita na janela. */
+    uint8_t window_filled;                    /**< Amostras válidas na janela. */
+} analog_filter_t;
+
+/**
+ * @brief Prepara o estado de um filtro.
+ *
+ * @param filter O estado a ser inicializado.
+ * @param config A escolha do filtro. Janelas fora do intervalo são limitadas.
+ */
+void analog_filter_init(analog_filter_t* filter, const analog_filter_config_t* config);
+
+/**
+ * @brief Consome uma amostra bruta do ADC. Chamada à taxa de aquisição.
+ *
+ * @param filter O estado do filtro.
+ * @param raw O código bruto do conversor.
+ */
+void analog_filter_push(analog_filter_t* filter, int16_t raw);
+
+/**
+ * @brief Produz o valor decimado. Chamada à taxa de envio.
+ *
+ * No filtro BOXCAR, o bloco é reiniciado após cada saída.
+ *
+ * @param filter O estado do filtro.
+ * @param code_out Ponteiro que receberá o código filtrado, com ANALOG_FILTER_FRAC_BITS bits fracionários.
+ * @return true se havia amostras para produzir uma saída, false caso contrário.
+ */
+bool analog_filter_output(analog_filter_t* filter, int32_t* code_out);
+
+#endif // ANALOG_FILTER_H
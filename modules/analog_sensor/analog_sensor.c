@@ -3,33 +3,145 @@
  * @brief Implementação do driver de sensor analógico genérico.
  *
  * Fornece a lógica de baixo nível para interagir com o módulo ADC e aplicar
- * as fórmulas de conversão definidas externamente.
+ * a calibração de cada sensor. Todo o caminho, do código do ADC ao valor de
+ * engenharia, usa aritmética inteira: o RP2040 não tem FPU e cada operação
+ * float seria emulada em software.
  */
 
 #include "analog_sensor.h"
 #include "../sensor_manager/sensor_manager.h"
+#include "../logger/logger.h"
 #include <stddef.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#if ANALOG_SENSOR_BENCHMARK
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#endif
 
-int analog_sensor_read(const analog_sensor_t* sensor, float* voltage_out, float* final_value_out) {
+static bool analog_sensor_has_filter(const analog_sensor_t* sensor) {
+    return sensor->filter.kind != ANALOG_FILTER_NONE && sensor->filter_state != NULL;
+}
+
+void analog_sensor_init(const analog_sensor_t* sensor) {
+    if (sensor != NULL && analog_sensor_has_filter(sensor)) {
+        analog_filter_init(sensor->filter_state, &sensor->filter);
+    }
+}
+
+void analog_sensor_push_sample(const analog_sensor_t* sensor, int16_t raw) {
+    if (sensor == NULL || !analog_sensor_has_filter(sensor)) {
+        return;
+    }
+
+    // O filtro é partilhado entre a tarefa de aquisição e a de amostragem.
+    taskENTER_CRITICAL();
+    analog_filter_push(sensor->filter_state, raw);
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Obtém o código decimado pelo filtro do sensor.
+ */
+static adc_status_t analog_sensor_read_filtered(const analog_sensor_t* sensor, int32_t* code_out) {
+    taskENTER_CRITICAL();
+    bool has_output = analog_filter_output(sensor->filter_state, code_out);
+    taskEXIT_CRITICAL();
+
+    return has_output ? ADC_STATUS_OK : ADC_STATUS_NO_SAMPLE;
+}
+
+/**
+ * @brief Obtém a última amostra do canal, na mesma escala das saídas dos filtros.
+ */
+static adc_status_t analog_sensor_read_unfiltered(const analog_sensor_t* sensor, int32_t* code_out) {
+    int16_t raw;
+    adc_status_t status = adc_module_read_raw(sensor->adc_device, sensor->adc_channel, &raw);
+    if (status == ADC_STATUS_OK) {
+        *code_out = (int32_t)raw * (1 << ANALOG_FILTER_FRAC_BITS);
+    }
+    return status;
+}
+
+int analog_sensor_read(const analog_sensor_t* sensor, int32_t* code_out, q16_t* final_value_out) {
     // Verificação de ponteiros Nulos
-    if (sensor == NULL || sensor->convert == NULL || voltage_out == NULL || final_value_out == NULL) {
-        return SENSOR_READ_ERROR;
+    if (sensor == NULL || code_out == NULL || final_value_out == NULL) {
+        return -1;
     }
     
-    // Interage com a camada de hardware (ADC) para obter a tensão.
-    adc_status_t status = adc_module_read_voltage(sensor->adc_channel, voltage_out);
+    // Obtém o código decimado pelo filtro ou, sem filtro, diretamente do ADC.
+    adc_status_t status = analog_sensor_has_filter(sensor)
+        ? analog_sensor_read_filtered(sensor, code_out)
+        : analog_sensor_read_unfiltered(sensor, code_out);
 
-    // Valida o resultado da operação de hardware.
-    if (status != ADC_STATUS_OK) {
-        // Se a leitura da tensão falhar propaga o erro sem tentar a conversão.
-        *voltage_out = SENSOR_READ_ERROR;
+    // Valida o resultado da operação de hardware. Uma tensão negativa está
+    // fora da faixa de qualquer sensor ligado em modo single-ended, exceto
+    // o ruído em torno de 0 V, que é lido como 0.
+    if (status == ADC_STATUS_OK && *code_out < 0 &&
+        *code_out >= -ANALOG_SENSOR_ZERO_NOISE_CODES * (1 << ANALOG_FILTER_FRAC_BITS)) {
+        *code_out = 0;
+    }
+    if (status != ADC_STATUS_OK || *code_out < 0) {
+        // Se a leitura falhar propaga o erro sem tentar a conversão.
         *final_value_out = SENSOR_READ_ERROR;
 
-        return SENSOR_READ_ERROR;
+        return -1;
     }
     
-    // Se a leitura da tensão for bem-sucedida, calculamos o valor final
-    *final_value_out = sensor->convert(*voltage_out, sensor->param1, sensor->param2, sensor->param3);
+    // Se a leitura for bem-sucedida, calculamos o valor final
+    *final_value_out = analog_sensor_convert(&sensor->cal, *code_out);
     
     return 0;
-}
\ No newline at end of file
+}
+
+#if ANALOG_SENSOR_BENCHMARK
+
+#define ANALOG_SENSOR_BENCHMARK_ITERATIONS 10000
+
+/**
+ * @brief Caminho de referência em float, equivalente ao usado antes da calibração em ponto fixo.
+ */
+static float __attribute__((noinline)) analog_sensor_convert_float(int32_t code, float max_v,
+                                                                    float max_value, float min_value) {
+    float v = (float)code * (ADC_VOLTS_PER_CODE / (1 << ANALOG_FILTER_FRAC_BITS));
+    if (max_v == 0.0f) {
+        return min_value;
+    }
+    return min_value + (v * ((max_value - min_value) / max_v));
+}
+
+static q16_t __attribute__((noinline)) analog_sensor_convert_fixed(const analog_sensor_cal_t* cal, int32_t code) {
+    return analog_sensor_convert(cal, code);
+}
+
+void analog_sensor_benchmark(void) {
+    static const analog_sensor_cal_t cal = ANALOG_SENSOR_LINEAR_CAL(3.3, 100.0, 0.0);
+
+    // Entradas voláteis impedem o compilador de resolver as conversões em tempo de compilação.
+    volatile float max_v = 3.3f, max_value = 100.0f, min_value = 0.0f;
+    volatile int32_t code = 12345 << ANALOG_FILTER_FRAC_BITS;
+    volatile float float_sink;
+    volatile q16_t fixed_sink;
+
+    uint32_t start = time_us_32();
+    for (int i = 0; i < ANALOG_SENSOR_BENCHMARK_ITERATIONS; i++) {
+        float_sink = analog_sensor_convert_float(code + i, max_v, max_value, min_value);
+    }
+    uint32_t float_us = time_us_32() - start;
+
+    start = time_us_32();
+    for (int i = 0; i < ANALOG_SENSOR_BENCHMARK_ITERATIONS; i++) {
+        fixed_sink = analog_sensor_convert_fixed(&cal, code + i);
+    }
+    uint32_t fixed_us = time_us_32() - start;
+
+    uint32_t mhz = clock_get_hz(clk_sys) / 1000000;
+    LOG_INFO("[INFO] Conversao de sensor: float %lu ciclos, Q16.16 %lu ciclos (media de %d).\n",
+             (unsigned long)((uint64_t)float_us * mhz / ANALOG_SENSOR_BENCHMARK_ITERATIONS),
+             (unsigned long)((uint64_t)fixed_us * mhz / ANALOG_SENSOR_BENCHMARK_ITERATIONS),
+             ANALOG_SENSOR_BENCHMARK_ITERATIONS);
+    (void)float_sink;
+    (void)fixed_sink;
+}
+
+#endif
@@ -12,62 +12,138 @@
 #define ANALOG_SENSOR_H
 
 #include "../adc_manager/adc_manager.h"
+#include "../analog_filter/analog_filter.h"
+#include "../fixed_point/fixed_point.h"
 
 /**
- * @brief Ponteiro de função para uma fórmula de conversão de sensor.
+ * @brief Bits fracionários do ganho de calibração, além dos 16 do formato Q16.16.
+ */
+#define ANALOG_SENSOR_GAIN_SHIFT 16
+
+/**
+ * @brief Códigos negativos tratados como 0 V.
  *
- * Define um contrato para qualquer função que converta uma tensão lida
- * numa unidade de engenharia final (ex: graus Celsius, porcentagem).
+ * Com a entrada a 0 V, o offset e o ruído do ADS1115 dão alguns códigos
+ * abaixo de zero; só uma tensão mais negativa do que isto (~2 mV) indica
+ * uma falha da ligação.
+ */
+#define ANALOG_SENSOR_ZERO_NOISE_CODES 16
+
+/**
+ * @struct analog_sensor_cal_t
+ * @brief Calibração linear de um sensor em ponto fixo.
  *
- * @param voltage A tensão de entrada proveniente do ADC.
- * @param p1 O primeiro parâmetro de calibração/conversão.
- * @param p2 O segundo parâmetro de calibração/conversão.
- * @param p3 O terceiro parâmetro de calibração/conversão.
- * @return O valor final convertido na unidade de engenharia.
+ * Converte um código do ADC (com ANALOG_FILTER_FRAC_BITS bits fracionários)
+ * na unidade de engenharia com uma única multiplicação e soma:
+ * valor_q16 = offset + (codigo * gain) >> ANALOG_SENSOR_GAIN_SHIFT.
  */
-typedef float (*sensor_conversion_fn)(float voltage, float p1, float p2, float p3);
+typedef struct {
+    /** @brief Valor de engenharia correspondente a 0 V, em Q16.16. */
+    q16_t offset;
+
+    /** @brief Unidades de engenharia por código do ADC, em Q16.(16 + ANALOG_SENSOR_GAIN_SHIFT). */
+    int32_t gain;
+} analog_sensor_cal_t;
+
+/**
+ * @brief Calcula, em tempo de compilação, a calibração de uma interpolação linear.
+ *
+ * Mapeia 0 V em `min_value` e `max_voltage` em `max_value`, incorporando o
+ * fundo de escala do ADC e os bits fracionários dos filtros no ganho.
+ *
+ * @param max_voltage A tensão correspondente a `max_value`.
+ * @param max_value O valor de engenharia no topo da escala.
+ * @param min_value O valor de engenharia a 0 V.
+ */
+#define ANALOG_SENSOR_LINEAR_CAL(max_voltage, max_value, min_value) {                         \
+    .offset = Q16_FROM_FLOAT(min_value),                                                       \
+    .gain   = ((max_voltage) == 0) ? 0 : (int32_t)(                                            \
+        ((double)(max_value) - (double)(min_value)) / (double)(max_voltage)                    \
+        * ((double)ADC_VOLTS_PER_CODE / (1 << ANALOG_FILTER_FRAC_BITS))                        \
+        * (double)((int64_t)1 << (Q16_FRAC_BITS + ANALOG_SENSOR_GAIN_SHIFT)) + 0.5)            \
+}
 
 /**
  * @struct analog_sensor_t
  * @brief Estrutura de definição para um sensor analógico genérico.
  *
  * Encapsula todas as informações necessárias para definir e ler um sensor:
- * o seu mapeamento de hardware, os seus parâmetros de calibração e a
- * lógica de software para converter a sua leitura.
+ * o seu mapeamento de hardware, a sua calibração em ponto fixo e o filtro
+ * aplicado ao fluxo de amostras do seu canal.
  */
 typedef struct {
-    /** @brief O canal do multiplexador do ADC ao qual o sensor está fisicamente conectado. */
-    enum ads1115_mux_t adc_channel;
+    /** @brief O conversor ADS1115 ao qual o sensor está ligado (0 a ADC_DEVICE_COUNT - 1). */
+    uint8_t adc_device;
 
-    /** @brief Primeiro parâmetro de calibração (ex: tensão máxima, offset). */
-    float param1;
+    /** @brief O canal do multiplexador desse conversor ao qual o sensor está fisicamente conectado. */
+    enum ads1115_mux_t adc_channel;
 
-    /** @brief Segundo parâmetro de calibração (ex: valor máximo, fator de escala). */
-    float param2;
+    /** @brief Calibração pré-calculada (ver ANALOG_SENSOR_LINEAR_CAL). */
+    analog_sensor_cal_t cal;
 
-    /** @brief Terceiro parâmetro de calibração (ex: valor mínimo, fator de escala). */
-    float param3;
+    /** @brief Filtro de decimação aplicado ao fluxo de amostras do canal (ex: mediana de 9). */
+    analog_filter_config_t filter;
 
-    /** @brief Ponteiro para a função que implementa a fórmula de conversão específica deste sensor. */
-    sensor_conversion_fn convert;
+    /** @brief Estado mutável do filtro. Pode ser NULL quando `filter.kind` é ANALOG_FILTER_NONE. */
+    analog_filter_t* filter_state;
 } analog_sensor_t;
 
 /**
- * @brief Lê a tensão de um sensor e retorna o valor final convertido.
+ * @brief Prepara o estado do filtro de decimação do sensor.
+ *
+ * @param sensor Um ponteiro constante para a estrutura de definição do sensor.
+ */
+void analog_sensor_init(const analog_sensor_t* sensor);
+
+/**
+ * @brief Entrega ao filtro do sensor uma amostra de alta taxa do seu canal.
+ *
+ * Destina-se a ser chamada a partir do fluxo da aquisição contínua do ADC.
+ *
+ * @param sensor Um ponteiro constante para a estrutura de definição do sensor.
+ * @param raw O código bruto do conversor.
+ */
+void analog_sensor_push_sample(const analog_sensor_t* sensor, int16_t raw);
+
+/**
+ * @brief Converte um código do ADC na unidade de engenharia do sensor.
+ *
+ * @param cal A calibração do sensor.
+ * @param code O código do ADC, com ANALOG_FILTER_FRAC_BITS bits fracionários.
+ * @return O valor de engenharia em Q16.16.
+ */
+static inline q16_t analog_sensor_convert(const analog_sensor_cal_t* cal, int32_t code) {
+    return cal->offset + (q16_t)(((int64_t)code * cal->gain) >> ANALOG_SENSOR_GAIN_SHIFT);
+}
+
+/**
+ * @brief Lê o código de um sensor e retorna o valor final convertido.
  *
  * Função principal do módulo. Ela orquestra o processo de leitura:
- * 1. Interage com a camada de ADC para obter uma leitura de tensão bruta.
+ * 1. Obtém o código decimado pelo filtro do sensor ou, sem filtro, a última
+ * amostra da camada de ADC.
  * 2. Verifica se a leitura de hardware foi bem-sucedida.
- * 3. Se bem-sucedida, invoca a função de conversão específica do sensor
+ * 3. Se bem-sucedida, aplica a calibração em ponto fixo do sensor
  * para calcular o valor final.
  * 4. Propaga os erros de forma inequívoca.
  *
  * @param sensor Um ponteiro constante para a estrutura de definição do sensor.
- * @param voltage_out Ponteiro para uma variável float que receberá a tensão lida.
- * @param final_value_out Ponteiro para uma variável float que receberá o valor final convertido.
- * @return O valor de engenharia final (ex: 25.5 °C), ou um valor de erro
- * em caso de falha de leitura no ADC.
+ * @param code_out Ponteiro que receberá o código lido, com ANALOG_FILTER_FRAC_BITS bits fracionários.
+ * @param final_value_out Ponteiro que receberá o valor final convertido, em Q16.16.
+ * @return 0 em caso de sucesso, ou -1 em caso de falha de leitura no ADC ou
+ * de código abaixo de -ANALOG_SENSOR_ZERO_NOISE_CODES (fora da faixa do
+ * sensor); um código negativo acima desse limite é lido como 0 V. Em caso
+ * de falha, `final_value_out` recebe SENSOR_READ_ERROR.
+ */
+int analog_sensor_read(const analog_sensor_t* sensor, int32_t* code_out, q16_t* final_value_out);
+
+#if ANALOG_SENSOR_BENCHMARK
+/**
+ * @brief Mede os ciclos por conversão do caminho em ponto fixo e do antigo caminho em float.
+ *
+ * Ativado pela opção ANALOG_SENSOR_BENCHMARK do config.cmake; o resultado é impresso na saída padrão.
  */
-int analog_sensor_read(const analog_sensor_t* sensor, float* voltage_out, float* final_value_out);
+void analog_sensor_benchmark(void);
+#endif
 
 #endif // ANALOG_SENSOR_H
\ No newline at end of file
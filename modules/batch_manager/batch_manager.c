@@ -0,0 +1,391 @@
+/**
+ * @file batch_manager.c
+ * @brief Implementação do acumulador de leituras em lote.
+ *
+ * Reduz o custo de rede por amostra: os ~200 bytes de cabeçalhos HTTP
+ * passam a ser pagos uma vez por lote em vez de uma vez por leitura.
+ */
+
+#include "batch_manager.h"
+#include "../flash_store/flash_store.h"
+#include "../payload_encoder/payload_encoder.h"
+#include "../retry_scheduler/retry_scheduler.h"
+#include "../sntp_client/sntp_client.h"
+#include "../logger/logger.h"
+
+// Leituras do armazenamento em flash enviadas por requisição de drenagem.
+#define BATCH_DRAIN_MAX_READINGS 20
+
+/**
+ * @brief Buffer de capacidade fixa com as leituras pendentes.
+ */
+static batch_entry_t entries[BATCH_MAX_READINGS];
+
+/**
+ * @brief Quantidade de leituras válidas em `entries`.
+ */
+static size_t entry_count = 0;
+
+/**
+ * @brief Maior espera de cada sensor até ao envio (BATCH_MAX_AGE_MS por omissão).
+ */
+static uint32_t report_interval_ms[SENSOR_COUNT] = {
+    [0 ... SENSOR_COUNT - 1] = BATCH_MAX_AGE_MS
+};
+
+/**
+ * @brief Instante da leitura mais antiga do lote que contém cada sensor.
+ */
+static uint32_t oldest_ms[SENSOR_COUNT];
+static sensor_mask_t pending_channels = 0;
+
+batch_status_t batch_add(const sensors_reading_t* reading, uint32_t timestamp_ms) {
+    if (reading == NULL) {
+        return BATCH_STATUS_INVALID_PARAM;
+    }
+
+    if (entry_count >= BATCH_MAX_READINGS) {
+        return BATCH_STATUS_FULL;
+    }
+
+    entries[entry_count].timestamp_ms = timestamp_ms;
+    entries[entry_count].epoch_ms = 0;
+    entries[entry_count].timestamp_unknown = false;
+    entries[entry_count].reading = *reading;
+    entry_count++;
+
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        if ((reading->channels & SENSOR_CHANNEL(i)) && !(pending_channels & SENSOR_CHANNEL(i))) {
+            oldest_ms[i] = timestamp_ms;
+        }
+    }
+    pending_channels |= reading->channels;
+
+    return BATCH_STATUS_OK;
+}
+
+bool batch_should_flush(uint32_t now_ms) {
+    if (entry_count == 0) {
+        return false;
+    }
+
+    if (entry_count >= BATCH_MAX_READINGS) {
+        return true;
+    }
+
+    // Cada sensor tem o seu limite de idade; o primeiro a expirar leva o lote.
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        if ((pending_channels & SENSOR_CHANNEL(i)) &&
+            (now_ms - oldest_ms[i]) >= report_interval_ms[i]) {
+            return true;
+        }
+    }
+
+    // Leituras sem nenhum sensor (ex: da flash) seguem o limite global.
+    return pending_channels == 0 && (now_ms - entries[0].timestamp_ms) >= BATCH_MAX_AGE_MS;
+}
+
+void batch_set_report_interval(sensor_id_t sensor, uint32_t interval_ms) {
+    if (sensor < SENSOR_COUNT) {
+        report_interval_ms[sensor] = interval_ms;
+    }
+}
+
+/**
+ * @brief Converte em tempo Unix o instante das leituras que ainda não o têm.
+ *
+ * As leituras do lote ao vivo são todas deste arranque: a diferença entre
+ * os relógios medida pelo SNTP data também as feitas antes da primeira
+ * sincronização. Chamada antes de o lote ser enviado ou guardado na flash.
+ */
+static void batch_resolve_epoch(void) {
+    for (size_t i = 0; i < entry_count; i++) {
+        if (entries[i].epoch_ms == 0 &&
+            !sntp_client_to_epoch_ms(entries[i].reading.timestamp_us, &entries[i].epoch_ms)) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Esvazia o lote ao vivo.
+ */
+static void batch_clear(void) {
+    entry_count = 0;
+    pending_channels = 0;
+}
+
+/**
+ * @brief Leituras a codificar no corpo de uma requisição.
+ */
+typedef struct {
+    const batch_entry_t* list;
+    size_t count;
+    uint32_t now_ms;
+} batch_payload_t;
+
+static void batch_payload_write(void* context, const void* data, size_t len) {
+    http_tx_write((http_tx_t*)context, data, len);
+}
+
+/**
+ * @brief Codifica as leituras diretamente na requisição em curso.
+ */
+static bool batch_write_body(http_tx_t* tx, void* context) {
+    const batch_payload_t* payload = (const batch_payload_t*)context;
+
+    return payload_encode(payload->list, payload->count, payload->now_ms,
+                          batch_payload_write, tx) >= 0;
+}
+
+/**
+ * @brief Conexões ao servidor: uma para o lote ao vivo, outra para a
+ * drenagem da flash, cada uma no seu socket do W5500.
+ */
+static http_connection_t live_connection;
+static http_connection_t backlog_connection;
+
+/**
+ * @brief Agendador partilhado pelas duas conexões, que usam o mesmo servidor.
+ */
+static retry_scheduler_t upload_scheduler;
+
+/**
+ * @brief Um envio de leituras numa das conexões.
+ */
+typedef struct {
+    http_connection_t* conn;
+    batch_payload_t payload;
+    http_status_t http_status;
+    retry_result_t result;
+    bool requested;
+    bool started;
+} batch_upload_t;
+
+/**
+ * @brief Inicia o POST de uma lista de leituras, sem esperar pela resposta.
+ *
+ * O corpo é gerado diretamente na memória TX do socket, sem buffer
+ * intermédio do tamanho do lote.
+ */
+static void batch_upload_begin(batch_upload_t* upload, http_connection_t* conn,
+                               const batch_entry_t* list, size_t count, uint32_t now_ms) {
+    upload->conn = conn;
+    upload->payload.list = list;
+    upload->payload.count = count;
+    upload->payload.now_ms = now_ms;
+    upload->http_status = http_request_begin(conn, batch_write_body, &upload->payload,
+                                             payload_content_type());
+    upload->requested = true;
+    upload->started = (upload->http_status == HTTP_OK);
+}
+
+/**
+ * @brief Classifica os envios concluídos e regista-os no agendador.
+ *
+ * Basta uma falha transitória para adiar os próximos envios; um sucesso sem
+ * falhas transitórias fecha o disjuntor.
+ */
+static void batch_upload_record(batch_upload_t* const* uploads, size_t count, uint32_t now_ms) {
+    retry_result_t combined = RETRY_RESULT_PERMANENT;
+    uint32_t retry_after_s = HTTP_PARSER_NO_RETRY_AFTER;
+
+    for (size_t i = 0; i < count; i++) {
+        batch_upload_t* upload = uploads[i];
+        if (!upload->requested) {
+            continue;
+        }
+
+        uint16_t http_code = 0;
+        uint32_t upload_retry_after_s = HTTP_PARSER_NO_RETRY_AFTER;
+        if (upload->started) {
+            http_get_response_info(upload->conn, &http_code, &upload_retry_after_s);
+        }
+        upload->result = retry_classify(upload->http_status, http_code);
+
+        if (upload->result == RETRY_RESULT_TRANSIENT) {
+            combined = RETRY_RESULT_TRANSIENT;
+            if (upload_retry_after_s != HTTP_PARSER_NO_RETRY_AFTER &&
+                (retry_after_s == HTTP_PARSER_NO_RETRY_AFTER || upload_retry_after_s > retry_after_s)) {
+                retry_after_s = upload_retry_after_s;
+            }
+        } else if (upload->result == RETRY_RESULT_SUCCESS && combined == RETRY_RESULT_PERMANENT) {
+            combined = RETRY_RESULT_SUCCESS;
+        }
+    }
+
+    retry_scheduler_record(&upload_scheduler, now_ms, combined, retry_after_s);
+}
+
+/**
+ * @brief Guarda o lote ao vivo no armazenamento em flash e esvazia-o.
+ */
+static size_t batch_store_entries(void) {
+    size_t saved = 0;
+
+    for (size_t i = 0; i < entry_count; i++) {
+        if (flash_store_append(&entries[i]) == FLASH_STORE_OK) {
+            saved++;
+        }
+    }
+    batch_clear();
+    return saved;
+}
+
+/**
+ * @brief Converte o resultado HTTP de um envio num estado do módulo.
+ */
+static batch_status_t batch_upload_status(const batch_upload_t* upload) {
+    if (upload->http_status == HTTP_ERROR_ENCODE_FAILED ||
+        upload->http_status == HTTP_ERROR_REQUEST_TOO_LARGE) {
+        LOG_ERROR("[ERRO] Lote de %u leituras não coube na requisição.\n",
+                  (unsigned)upload->payload.count);
+        return BATCH_STATUS_ENCODE_FAILED;
+    }
+
+    return (upload->http_status == HTTP_OK) ? BATCH_STATUS_OK : BATCH_STATUS_SEND_FAILED;
+}
+
+/**
+ * @brief Envia o lote ao vivo e/ou um lote da flash, em paralelo.
+ *
+ * As duas requisições decorrem em conexões e sockets distintos; a tarefa
+ * fica suspensa até ambas terminarem.
+ */
+static batch_status_t batch_upload_run(uint32_t now_ms, bool flush, bool drain,
+                                       batch_status_t* flush_out, batch_status_t* drain_out,
+                                       http_status_t* http_status_out) {
+    static batch_entry_t backlog[BATCH_DRAIN_MAX_READINGS];
+
+    batch_upload_t live = { .requested = false, .started = false };
+    batch_upload_t stored = { .requested = false, .started = false };
+    batch_upload_t* const uploads[2] = { &live, &stored };
+    http_connection_t* active[2];
+    size_t active_count = 0;
+
+    *flush_out = BATCH_STATUS_EMPTY;
+    *drain_out = BATCH_STATUS_EMPTY;
+
+    if (flush) {
+        batch_resolve_epoch();
+    }
+
+    // Durante o backoff não há tentativas: o lote ao vivo segue para a flash
+    // e a drenagem espera, sem abrir conexões ao servidor.
+    if (!retry_scheduler_may_attempt(&upload_scheduler, now_ms)) {
+        if (flush && entry_count > 0) {
+            size_t flushed = entry_count;
+            size_t saved = batch_store_entries();
+            LOG_WARN("[AVISO] Envio adiado %lu ms. %u de %u leituras guardadas na flash.\n",
+                     (unsigned long)retry_scheduler_wait_ms(&upload_scheduler, now_ms),
+                     (unsigned)saved, (unsigned)flushed);
+            *flush_out = BATCH_STATUS_DEFERRED;
+        }
+        if (drain) {
+            *drain_out = BATCH_STATUS_DEFERRED;
+        }
+        return (*flush_out == BATCH_STATUS_EMPTY && *drain_out == BATCH_STATUS_EMPTY)
+            ? BATCH_STATUS_EMPTY : BATCH_STATUS_DEFERRED;
+    }
+
+    // A tentativa de prova do disjuntor é uma única requisição.
+    if (upload_scheduler.state == RETRY_BREAKER_HALF_OPEN && flush && entry_count > 0) {
+        drain = false;
+    }
+
+    if (flush && entry_count > 0) {
+        batch_upload_begin(&live, &live_connection, entries, entry_count, now_ms);
+        if (live.started) {
+            active[active_count++] = &live_connection;
+        }
+    }
+
+    size_t backlog_count = drain ? flash_store_peek(backlog, BATCH_DRAIN_MAX_READINGS) : 0;
+    if (backlog_count > 0) {
+        batch_upload_begin(&stored, &backlog_connection, backlog, backlog_count, now_ms);
+        if (stored.started) {
+            active[active_count++] = &backlog_connection;
+        }
+    }
+
+    http_request_run(active, active_count);
+
+    if (live.started) {
+        http_request_step(live.conn, &live.http_status);
+    }
+    if (stored.started) {
+        http_request_step(stored.conn, &stored.http_status);
+    }
+
+    batch_upload_record(uploads, 2, now_ms);
+
+    // A drenagem é confirmada antes de novas leituras entrarem na flash.
+    if (backlog_count > 0) {
+        *drain_out = batch_upload_status(&stored);
+        if (*drain_out == BATCH_STATUS_OK) {
+            flash_store_consume(backlog_count);
+            LOG_INFO("[OK] %u leituras da flash enviadas (%u pendentes).\n",
+                     (unsigned)backlog_count, (unsigned)flash_store_pending());
+        } else if (stored.result == RETRY_RESULT_PERMANENT) {
+            // Repetir o mesmo lote falharia sempre e bloquearia a drenagem.
+            flash_store_consume(backlog_count);
+            LOG_ERROR("[ERRO] %u leituras da flash rejeitadas sem nova tentativa e descartadas.\n",
+                      (unsigned)backlog_count);
+        }
+        // Numa falha transitória as leituras permanecem na flash para a próxima tentativa.
+    }
+
+    if (flush && entry_count > 0) {
+        size_t flushed = entry_count;
+        *flush_out = batch_upload_status(&live);
+        if (http_status_out) {
+            *http_status_out = live.http_status;
+        }
+
+        if (*flush_out == BATCH_STATUS_OK) {
+            LOG_INFO("[OK] Lote de %u leituras enviado.\n", (unsigned)flushed);
+            batch_clear();
+        } else if (live.result == RETRY_RESULT_PERMANENT) {
+            LOG_ERROR("[ERRO] Lote rejeitado sem nova tentativa. %u leituras descartadas.\n",
+                      (unsigned)flushed);
+            batch_clear();
+        } else {
+            // As leituras não entregues seguem para o armazenamento em flash.
+            size_t saved = batch_store_entries();
+            LOG_ERROR("[ERRO] Falha no envio do lote. %u de %u leituras guardadas na flash.\n",
+                      (unsigned)saved, (unsigned)flushed);
+        }
+    } else if (http_status_out && backlog_count > 0) {
+        *http_status_out = stored.http_status;
+    }
+
+    // O primeiro erro (lote ao vivo primeiro) representa o estado da ligação.
+    if (*flush_out != BATCH_STATUS_OK && *flush_out != BATCH_STATUS_EMPTY) {
+        return *flush_out;
+    }
+    if (*drain_out != BATCH_STATUS_OK && *drain_out != BATCH_STATUS_EMPTY) {
+        return *drain_out;
+    }
+    return (*flush_out == BATCH_STATUS_EMPTY && *drain_out == BATCH_STATUS_EMPTY)
+        ? BATCH_STATUS_EMPTY : BATCH_STATUS_OK;
+}
+
+batch_status_t batch_flush(uint32_t now_ms, http_status_t* http_status_out) {
+    batch_status_t flush_status, drain_status;
+    return batch_upload_run(now_ms, true, false, &flush_status, &drain_status, http_status_out);
+}
+
+batch_status_t batch_drain_backlog(uint32_t now_ms, http_status_t* http_status_out) {
+    batch_status_t flush_status, drain_status;
+    return batch_upload_run(now_ms, false, true, &flush_status, &drain_status, http_status_out);
+}
+
+batch_status_t batch_upload(uint32_t now_ms, bool drain_backlog) {
+    batch_status_t flush_status, drain_status;
+    return batch_upload_run(now_ms, batch_should_flush(now_ms), drain_backlog,
+                            &flush_status, &drain_status, NULL);
+}
+
+size_t batch_count(void) {
+    return entry_count;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file batch_manager.h
+ * @brief Interface pública para o acumulador de leituras em lote.
+ *
+ * Este módulo fica entre a leitura dos sensores e o cliente HTTP. As leituras
+ * são guardadas com o instante de aquisição num buffer de capacidade fixa e
+ * enviadas num único POST (JSON ou CBOR, ver payload_encoder.h) quando o lote atinge BATCH_MAX_READINGS
+ * leituras ou quando a leitura mais antiga de algum sensor ultrapassa o
+ * intervalo de envio desse sensor (BATCH_MAX_AGE_MS por omissão).
+ */
+#ifndef BATCH_MANAGER_H
+#define BATCH_MANAGER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "../sensor_manager/sensor_manager.h"
+#include "../http_client/http_client.h"
+
+/**
+ * @struct batch_entry_t
+ * @brief Uma leitura de sensores acompanhada do instante de aquisição.
+ */
+typedef struct {
+    uint32_t timestamp_ms;     /**< Instante da aquisição, em ms desde o arranque. */
+    uint64_t epoch_ms;         /**< Instante da aquisição em tempo Unix (ms); 0 enquanto o relógio não está sincronizado. */
+    bool timestamp_unknown;    /**< `timestamp_ms` não é deste arranque (leitura da flash de um arranque anterior, ou registo corrompido): sem `epoch_ms`, o instante é desconhecido. */
+    sensors_reading_t reading; /**< Valores lidos dos sensores. */
+} batch_entry_t;
+
+/**
+ * @enum batch_status_t
+ * @brief Define os possíveis códigos de estado retornados pelo módulo de lotes.
+ */
+typedef enum {
+    BATCH_STATUS_OK,            /**< A operação foi concluída com sucesso. */
+    BATCH_STATUS_FULL,          /**< O lote está cheio; é necessário enviá-lo antes de acrescentar leituras. */
+    BATCH_STATUS_EMPTY,         /**< Não há leituras acumuladas para enviar. */
+    BATCH_STATUS_INVALID_PARAM, /**< A operação falhou devido a um parâmetro inválido (ex: ponteiro nulo). */
+    BATCH_STATUS_ENCODE_FAILED, /**< O lote não coube na memória TX do socket. */
+    BATCH_STATUS_SEND_FAILED,   /**< O cliente HTTP não conseguiu entregar o lote. */
+    BATCH_STATUS_DEFERRED       /**< Envio adiado pelo backoff ou pelo disjuntor (ver retry_scheduler.h). */
+} batch_status_t;
+
+/**
+ * @brief Acrescenta uma leitura ao lote atual.
+ *
+ * @param reading Ponteiro para a leitura a ser copiada para o lote.
+ * @param timestamp_ms Instante da aquisição, em ms desde o arranque.
+ * @return BATCH_STATUS_OK em caso de sucesso, BATCH_STATUS_FULL se o lote
+ * já estiver na capacidade máxima.
+ */
+batch_status_t batch_add(const sensors_reading_t* reading, uint32_t timestamp_ms);
+
+/**
+ * @brief Indica se o lote atingiu o limite de quantidade ou de idade.
+ *
+ * @param now_ms O instante atual, em ms desde o arranque.
+ * @return true se o lote deve ser enviado, false caso contrário.
+ */
+bool batch_should_flush(uint32_t now_ms);
+
+/**
+ * @brief Define a maior espera das leituras de um sensor até ao envio.
+ *
+ * Um sensor lento (ex: temperatura) pode esperar muito mais do que um
+ * rápido (ex: vazão); o lote é enviado quando o primeiro limite expira.
+ *
+ * @param sensor O sensor.
+ * @param interval_ms O intervalo de envio, em ms.
+ */
+void batch_set_report_interval(sensor_id_t sensor, uint32_t interval_ms);
+
+/**
+ * @brief Serializa o lote no formato configurado e envia-o num único POST.
+ *
+ * Cada elemento do array carrega o tempo Unix da aquisição, obtido do
+ * instante monotónico da leitura com o relógio SNTP (ver sntp_client.h),
+ * ou, se o relógio ainda não foi sincronizado, a idade da leitura no
+ * momento do envio (`age_ms`). O lote é esvaziado em qualquer caso:
+ * as leituras de um envio com falha transitória, ou adiado pelo agendador
+ * de novas tentativas, são guardadas no armazenamento em flash (flash_store)
+ * para envio posterior com batch_drain_backlog(); as de um envio rejeitado
+ * de forma permanente (ver retry_classify()) são descartadas.
+ *
+ * @param now_ms O instante atual, em ms desde o arranque.
+ * @param http_status_out Ponteiro opcional que recebe o estado do cliente HTTP.
+ * @return BATCH_STATUS_OK se o servidor confirmou o lote, ou um código de
+ * erro relevante em caso de falha.
+ */
+batch_status_t batch_flush(uint32_t now_ms, http_status_t* http_status_out);
+
+/**
+ * @brief Envia um lote de leituras guardadas na flash durante falhas de rede.
+ *
+ * As leituras mais antigas do armazenamento são enviadas num único POST e
+ * marcadas como entregues apenas após a confirmação do servidor, ou
+ * descartadas se o servidor as rejeitar de forma permanente.
+ *
+ * @param now_ms O instante atual, em ms desde o arranque.
+ * @param http_status_out Ponteiro opcional que recebe o estado do cliente HTTP.
+ * @return BATCH_STATUS_OK se o servidor confirmou o lote, BATCH_STATUS_EMPTY
+ * se não houver leituras pendentes, ou um código de erro relevante.
+ */
+batch_status_t batch_drain_backlog(uint32_t now_ms, http_status_t* http_status_out);
+
+/**
+ * @brief Envia, em paralelo, o lote (se atingiu o limite) e um lote da flash.
+ *
+ * O lote ao vivo e as leituras guardadas seguem em conexões e sockets do
+ * W5500 distintos, pelo que a drenagem da flash não atrasa a telemetria.
+ * Equivale a batch_flush() e batch_drain_backlog() executadas em simultâneo.
+ *
+ * @param now_ms O instante atual, em ms desde o arranque.
+ * @param drain_backlog true para enviar também leituras pendentes da flash.
+ * @return BATCH_STATUS_OK se todos os envios foram confirmados,
+ * BATCH_STATUS_EMPTY se não havia nada a enviar, BATCH_STATUS_DEFERRED
+ * durante o backoff, ou o código de erro do primeiro envio falhado.
+ */
+batch_status_t batch_upload(uint32_t now_ms, bool drain_backlog);
+
+/**
+ * @brief Retorna o número de leituras atualmente acumuladas.
+ */
+size_t batch_count(void);
+
+#endif // BATCH_MANAGER_H
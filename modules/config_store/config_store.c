@@ -0,0 +1,397 @@
+/**
+ * @file config_store.c
+ * @brief Implementação da configuração de amostragem persistida em flash.
+ *
+ * Layout: a região é uma sequência de posições de CONFIG_SLOT_SIZE bytes,
+ * cada uma com no máximo um registo. Uma alteração grava um registo novo,
+ * com número de sequência crescente, na posição seguinte; o registo válido
+ * de maior sequência é a configuração em vigor. Um setor só é apagado
+ * quando a escrita chega a ele, e a região tem pelo menos dois setores,
+ * pelo que o registo anterior sobrevive a uma escrita interrompida.
+ */
+
+#include "config_store.h"
+#include "../logger/logger.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CONFIG_RECORD_MAGIC 0xC5
+
+// Espaço reservado a cada registo: o tamanho do registo arredondado à
+// potência de 2 seguinte (64 bytes até três sensores), para que um setor
+// tenha um número inteiro de posições.
+#define CONFIG_RECORD_DATA_SIZE (9u + sizeof(config_sensor_t) * SENSOR_COUNT)
+#define CONFIG_SLOT_SIZE        (CONFIG_RECORD_DATA_SIZE <= 64u ? 64u :   \
+                                 CONFIG_RECORD_DATA_SIZE <= 128u ? 128u : \
+                                 CONFIG_RECORD_DATA_SIZE <= 256u ? 256u : 512u)
+#define SLOTS_PER_SECTOR (FLASH_IO_SECTOR_SIZE / CONFIG_SLOT_SIZE)
+
+// Maior atribuição aceite (ex: "conductivity.report_ms=86400000").
+#define CONFIG_ASSIGNMENT_MAX 48
+
+/**
+ * @struct config_record_t
+ * @brief Formato binário da configuração gravada na flash.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t magic;            /**< CONFIG_RECORD_MAGIC. */
+    uint8_t version;          /**< CONFIG_STORE_VERSION. */
+    uint16_t length;          /**< sizeof(config_record_t), que muda com SENSOR_COUNT. */
+    uint32_t sequence;        /**< Número de sequência do registo. */
+    config_sensor_t sensors[SENSOR_COUNT];
+    uint8_t crc;              /**< CRC-8 dos restantes bytes do registo. */
+} config_record_t;
+
+_Static_assert(sizeof(config_record_t) == CONFIG_RECORD_DATA_SIZE, "config_record_t fora do tamanho previsto");
+_Static_assert(sizeof(config_record_t) <= CONFIG_SLOT_SIZE, "config_record_t excede CONFIG_SLOT_SIZE");
+
+// --- Variáveis de Estado do Módulo ---
+
+static const flash_io_t* config_io = NULL;
+static uint32_t slot_count;     // Capacidade da região, em registos
+static uint32_t next_slot;      // Próxima posição de escrita
+static uint32_t next_sequence;  // Sequência do próximo registo
+
+// Partilhadas entre tarefas: acedidas apenas em secção crítica.
+static device_config_t current;
+static volatile uint32_t generation;
+static bool dirty;
+
+// Banda morta da tabela de sensores, nas unidades do sensor, em centésimos.
+#define CONFIG_DEADBAND_CENTI(x) ((uint32_t)((x) * 100.0 + 0.5))
+
+static const device_config_t default_config = {
+    .sensors = {
+#define SENSOR_TABLE_DEFAULTS(id, name, unit, device, channel, kind, max_voltage, max_value,  \
+                              min_value, filter_kind, window, sample_ms, report_ms, deadband, \
+                              heartbeat_ms)                                                   \
+        [SENSOR_##id] = { sample_ms, report_ms, CONFIG_DEADBAND_CENTI(deadband), heartbeat_ms },
+        SENSOR_TABLE(SENSOR_TABLE_DEFAULTS)
+#undef SENSOR_TABLE_DEFAULTS
+    }
+};
+
+static uint8_t config_record_crc(const config_record_t* record) {
+    const uint8_t* bytes = (const uint8_t*)record;
+    uint8_t crc = 0;
+
+    for (size_t i = 0; i < sizeof(*record); i++) {
+        if (i == offsetof(config_record_t, crc)) {
+            continue;
+        }
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static bool config_interval_is_valid(uint32_t interval_ms) {
+    return interval_ms >= CONFIG_MIN_INTERVAL_MS && interval_ms <= CONFIG_MAX_INTERVAL_MS;
+}
+
+static bool config_is_valid(const device_config_t* config) {
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        if (!config_interval_is_valid(config->sensors[i].sample_interval_ms) ||
+            !config_interval_is_valid(config->sensors[i].report_interval_ms) ||
+            !config_interval_is_valid(config->sensors[i].heartbeat_ms) ||
+            config->sensors[i].deadband_centi > CONFIG_MAX_DEADBAND_CENTI) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool config_record_is_valid(const config_record_t* record) {
+    device_config_t config;
+
+    if (record->magic != CONFIG_RECORD_MAGIC || record->version != CONFIG_STORE_VERSION ||
+        record->length != sizeof(config_record_t) || record->crc != config_record_crc(record)) {
+        return false;
+    }
+    memcpy(config.sensors, record->sensors, sizeof(config.sensors));
+    return config_is_valid(&config);
+}
+
+static bool config_slot_is_erased(uint32_t slot) {
+    uint8_t bytes[sizeof(config_record_t)];
+
+    if (config_io->read(slot * CONFIG_SLOT_SIZE, bytes, sizeof(bytes)) != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        if (bytes[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+config_store_status_t config_store_init(const flash_io_t* io) {
+    if (io != NULL &&
+        (io->size < 2 * FLASH_IO_SECTOR_SIZE || (io->size % FLASH_IO_SECTOR_SIZE) != 0)) {
+        return CONFIG_STORE_INVALID_PARAM;
+    }
+
+    current = default_config;
+    generation++;
+    dirty = false;
+    config_io = io;
+    next_slot = 0;
+    next_sequence = 0;
+
+    if (io == NULL) {
+        return CONFIG_STORE_OK;
+    }
+
+    // O registo válido de maior sequência é a configuração em vigor.
+    slot_count = io->size / CONFIG_SLOT_SIZE;
+    config_record_t record;
+    bool found = false;
+    uint32_t newest_slot = 0;
+
+    for (uint32_t slot = 0; slot < slot_count; slot++) {
+        if (io->read(slot * CONFIG_SLOT_SIZE, &record, sizeof(record)) != 0 ||
+            !config_record_is_valid(&record)) {
+            continue;
+        }
+        if (!found || record.sequence >= next_sequence) {
+            found = true;
+            newest_slot = slot;
+            next_sequence = record.sequence + 1;
+            memcpy(current.sensors, record.sensors, sizeof(current.sensors));
+        }
+    }
+
+    if (found) {
+        next_slot = (newest_slot + 1) % slot_count;
+    }
+
+    LOG_INFO("[OK] Configuração %s.\n", found ? "carregada da flash" : "por omissão");
+    for (sensor_id_t id = 0; id < SENSOR_COUNT; id++) {
+        LOG_INFO("[INFO]   %s: amostragem %lu ms, envio %lu ms, pulsação %lu ms.\n", sensors_name(id),
+                 (unsigned long)current.sensors[id].sample_interval_ms,
+                 (unsigned long)current.sensors[id].report_interval_ms,
+                 (unsigned long)current.sensors[id].heartbeat_ms);
+    }
+    return CONFIG_STORE_OK;
+}
+
+void config_store_get(device_config_t* out) {
+    taskENTER_CRITICAL();
+    *out = current;
+    taskEXIT_CRITICAL();
+}
+
+uint32_t config_store_generation(void) {
+    return generation;
+}
+
+config_store_status_t config_store_set(const device_config_t* config) {
+    if (config == NULL || !config_is_valid(config)) {
+        return CONFIG_STORE_INVALID_PARAM;
+    }
+
+    bool changed;
+    taskENTER_CRITICAL();
+    changed = memcmp(&current, config, sizeof(current)) != 0;
+    if (changed) {
+        current = *config;
+        generation++;
+        dirty = true;
+    }
+    taskEXIT_CRITICAL();
+
+    if (changed) {
+        LOG_INFO("[INFO] Configuração de amostragem alterada; gravação pendente.\n");
+    }
+    return CONFIG_STORE_OK;
+}
+
+/**
+ * @brief Interpreta um valor decimal com até duas casas (ex: "0.25") em centésimos.
+ */
+static bool config_parse_centi(const char* text, uint32_t* centi_out) {
+    uint32_t centi = 0;
+    int fraction_digits = -1;   // -1 enquanto na parte inteira
+    bool any_digit = false;
+
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '.' && fraction_digits < 0) {
+            fraction_digits = 0;
+        } else if (*c >= '0' && *c <= '9' && fraction_digits < 2) {
+            centi = centi * 10 + (uint32_t)(*c - '0');
+            fraction_digits += (fraction_digits >= 0);
+            any_digit = true;
+            if (centi > CONFIG_MAX_DEADBAND_CENTI) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+
+    // Escala para centésimos conforme as casas decimais lidas.
+    for (int i = (fraction_digits < 0) ? 0 : fraction_digits; i < 2; i++) {
+        centi *= 10;
+    }
+    if (!any_digit || centi > CONFIG_MAX_DEADBAND_CENTI) {
+        return false;
+    }
+    *centi_out = centi;
+    return true;
+}
+
+/**
+ * @brief Interpreta uma atribuição `sensor.chave=valor` sobre `config`.
+ */
+static bool config_parse_assignment(const char* text, size_t len, device_config_t* config) {
+    char buf[CONFIG_ASSIGNMENT_MAX];
+    if (len == 0 || len >= sizeof(buf)) {
+        return false;
+    }
+    memcpy(buf, text, len);
+    buf[len] = '\0';
+
+    char* dot = strchr(buf, '.');
+    char* equals = strchr(buf, '=');
+    if (dot == NULL || equals == NULL || equals < dot) {
+        return false;
+    }
+    *dot = '\0';
+    *equals = '\0';
+
+    config_sensor_t* sensor = NULL;
+    for (sensor_id_t id = 0; id < SENSOR_COUNT; id++) {
+        if (strcmp(buf, sensors_name(id)) == 0) {
+            sensor = &config->sensors[id];
+        }
+    }
+
+    if (sensor == NULL) {
+        return false;
+    }
+    if (strcmp(dot + 1, "deadband") == 0) {
+        return config_parse_centi(equals + 1, &sensor->deadband_centi);
+    }
+
+    char* end;
+    unsigned long value = strtoul(equals + 1, &end, 10);
+    if (end == equals + 1 || *end != '\0' || value > CONFIG_MAX_INTERVAL_MS) {
+        return false;
+    }
+
+    if (strcmp(dot + 1, "sample_ms") == 0) {
+        sensor->sample_interval_ms = (uint32_t)value;
+    } else if (strcmp(dot + 1, "report_ms") == 0) {
+        sensor->report_interval_ms = (uint32_t)value;
+    } else if (strcmp(dot + 1, "heartbeat_ms") == 0) {
+        sensor->heartbeat_ms = (uint32_t)value;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+config_store_status_t config_store_apply(const char* assignments) {
+    if (assignments == NULL) {
+        return CONFIG_STORE_INVALID_PARAM;
+    }
+
+    device_config_t config;
+    config_store_get(&config);
+
+    const char* item = assignments;
+    while (*item != '\0') {
+        size_t len = strcspn(item, ",");
+        // Espaços à volta de cada atribuição são ignorados.
+        while (len > 0 && *item == ' ') {
+            item++;
+            len--;
+        }
+        size_t trimmed = len;
+        while (trimmed > 0 && item[trimmed - 1] == ' ') {
+            trimmed--;
+        }
+
+        if (!config_parse_assignment(item, trimmed, &config)) {
+            LOG_WARN("[AVISO] Atribuição de configuração inválida ignorada.\n");
+            return CONFIG_STORE_INVALID_PARAM;
+        }
+        item += len;
+        if (*item == ',') {
+            item++;
+        }
+    }
+
+    config_store_status_t status = config_store_set(&config);
+    if (status != CONFIG_STORE_OK) {
+        LOG_WARN("[AVISO] Configuração fora dos limites (%u a %lu ms, banda morta até %lu) ignorada.\n",
+                 (unsigned)CONFIG_MIN_INTERVAL_MS, (unsigned long)CONFIG_MAX_INTERVAL_MS,
+                 (unsigned long)(CONFIG_MAX_DEADBAND_CENTI / 100));
+    }
+    return status;
+}
+
+config_store_status_t config_store_sync(void) {
+    if (config_io == NULL || !dirty) {
+        return CONFIG_STORE_OK;
+    }
+
+    config_record_t record;
+    memset(&record, 0, sizeof(record));
+    taskENTER_CRITICAL();
+    memcpy(record.sensors, current.sensors, sizeof(record.sensors));
+    dirty = false;
+    taskEXIT_CRITICAL();
+
+    record.magic = CONFIG_RECORD_MAGIC;
+    record.version = CONFIG_STORE_VERSION;
+    record.length = sizeof(config_record_t);
+    record.sequence = next_sequence;
+    record.crc = config_record_crc(&record);
+
+    // Uma escrita interrompida pode ter deixado lixo na posição: a escrita
+    // continua no início do setor seguinte.
+    uint32_t slot = next_slot;
+    if ((slot % SLOTS_PER_SECTOR) != 0 && !config_slot_is_erased(slot)) {
+        slot = ((slot / SLOTS_PER_SECTOR + 1) * SLOTS_PER_SECTOR) % slot_count;
+    }
+
+    // A primeira escrita num setor apaga-o; o registo anterior está noutro setor.
+    int result = ((slot % SLOTS_PER_SECTOR) == 0) ? config_io->erase_sector(slot * CONFIG_SLOT_SIZE) : 0;
+    if (result == FLASH_IO_BUSY) {
+        dirty = true;
+        LOG_WARN("[AVISO] Gravação da configuração adiada.\n");
+        return CONFIG_STORE_BUSY;
+    }
+    if (result != 0) {
+        dirty = true;
+        LOG_ERROR("[ERRO] Falha ao apagar o setor da configuração.\n");
+        return CONFIG_STORE_IO_ERROR;
+    }
+    result = config_io->program(slot * CONFIG_SLOT_SIZE, &record, sizeof(record));
+    if (result == FLASH_IO_BUSY) {
+        // A posição não foi tocada: a próxima tentativa volta a usá-la.
+        dirty = true;
+        LOG_WARN("[AVISO] Gravação da configuração adiada.\n");
+        return CONFIG_STORE_BUSY;
+    }
+    if (result != 0) {
+        // A posição pode ter ficado suja: a próxima tentativa usa a seguinte.
+        next_slot = (slot + 1) % slot_count;
+        dirty = true;
+        LOG_ERROR("[ERRO] Falha ao gravar a configuração na flash.\n");
+        return CONFIG_STORE_IO_ERROR;
+    }
+
+    next_slot = (slot + 1) % slot_count;
+    next_sequence++;
+    LOG_INFO("[OK] Configuração gravada na flash (registo %lu).\n", (unsigned long)record.sequence);
+    return CONFIG_STORE_OK;
+}
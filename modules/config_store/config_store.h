@@ -0,0 +1,139 @@
+/**
+ * @file config_store.h
+ * @brief Interface pública da configuração de amostragem alterável em execução.
+ *
+ * Cada sensor tem o seu período de amostragem, o seu intervalo de envio
+ * (a maior espera de uma leitura até seguir para o servidor) e a sua
+ * política de envio por exceção (ver report_filter.h). Os valores
+ * iniciais vêm do config.cmake; o servidor pode alterá-los sem nova
+ * gravação do firmware, com cabeçalhos na resposta aos POSTs:
+ *
+ *     X-Config: temperature.sample_ms=60000,temperature.report_ms=600000
+ *     X-Config: flow.sample_ms=100,flow.deadband=0.5,flow.heartbeat_ms=300000
+ *
+ * Cada cabeçalho tem no máximo HTTP_PARSER_VALUE_MAX - 1 caracteres; uma
+ * lista mais longa é repartida por vários cabeçalhos.
+ *
+ * A configuração é persistida numa região própria da flash (ver flash_io.h),
+ * em registos versionados com CRC, e sobrevive a reinícios.
+ */
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <stdint.h>
+#include "../flash_store/flash_io.h"
+#include "../sensor_manager/sensor_manager.h"
+
+/**
+ * @brief Versão do layout dos registos em flash; registos de outra versão são ignorados.
+ */
+#define CONFIG_STORE_VERSION 3
+
+/**
+ * @brief Menor período de amostragem ou intervalo de envio aceite, em ms.
+ */
+#define CONFIG_MIN_INTERVAL_MS 10u
+
+/**
+ * @brief Maior período de amostragem ou intervalo de envio aceite (24 h), em ms.
+ */
+#define CONFIG_MAX_INTERVAL_MS 86400000u
+
+/**
+ * @brief Maior banda morta aceite, em centésimos das unidades do sensor.
+ */
+#define CONFIG_MAX_DEADBAND_CENTI 1000000u
+
+/**
+ * @enum config_store_status_t
+ * @brief Define os possíveis códigos de estado retornados pelo módulo config_store.
+ */
+typedef enum {
+    CONFIG_STORE_OK,            /**< A operação foi concluída com sucesso. */
+    CONFIG_STORE_INVALID_PARAM, /**< Configuração fora dos limites ou atribuição mal formada. */
+    CONFIG_STORE_IO_ERROR,      /**< A flash reportou um erro de programação ou apagamento. */
+    CONFIG_STORE_BUSY           /**< A escrita foi adiada sem tocar na flash; fica para a próxima sincronização. */
+} config_store_status_t;
+
+/**
+ * @struct config_sensor_t
+ * @brief Temporização de um sensor.
+ */
+typedef struct {
+    uint32_t sample_interval_ms; /**< Período de amostragem (chave `sample_ms`). */
+    uint32_t report_interval_ms; /**< Maior espera de uma leitura até ao envio (chave `report_ms`). */
+    uint32_t deadband_centi;     /**< Banda morta em centésimos, 0 = sem filtro (chave `deadband`, ex: 0.25). */
+    uint32_t heartbeat_ms;       /**< Maior silêncio do sensor (chave `heartbeat_ms`). */
+} config_sensor_t;
+
+/**
+ * @struct device_config_t
+ * @brief Configuração completa, indexada por sensor_id_t.
+ */
+typedef struct {
+    config_sensor_t sensors[SENSOR_COUNT];
+} device_config_t;
+
+/**
+ * @brief Carrega a configuração mais recente da flash, ou os valores do config.cmake.
+ *
+ * Deve ser chamada antes de as tarefas consultarem a configuração. Sem
+ * região de flash (`io` NULL) a configuração vive apenas em RAM.
+ *
+ * @param io A região de configuração (ex: flash_io_rp2040_config()), ou NULL.
+ * @return CONFIG_STORE_OK, ou CONFIG_STORE_INVALID_PARAM se a região for inválida.
+ */
+config_store_status_t config_store_init(const flash_io_t* io);
+
+/**
+ * @brief Copia a configuração em vigor.
+ *
+ * Pode ser chamada de qualquer tarefa, em qualquer núcleo.
+ *
+ * @param out A estrutura que recebe a configuração.
+ */
+void config_store_get(device_config_t* out);
+
+/**
+ * @brief Retorna um contador que muda a cada alteração da configuração.
+ *
+ * Permite às tarefas detetar uma alteração sem copiar a configuração.
+ */
+uint32_t config_store_generation(void);
+
+/**
+ * @brief Substitui a configuração em vigor.
+ *
+ * A nova configuração aplica-se de imediato; a gravação na flash fica para
+ * config_store_sync(). Uma configuração igual à atual não é gravada.
+ *
+ * @param config A nova configuração.
+ * @return CONFIG_STORE_OK, ou CONFIG_STORE_INVALID_PARAM se algum intervalo
+ * estiver fora de [CONFIG_MIN_INTERVAL_MS, CONFIG_MAX_INTERVAL_MS] ou a banda
+ * morta acima de CONFIG_MAX_DEADBAND_CENTI.
+ */
+config_store_status_t config_store_set(const device_config_t* config);
+
+/**
+ * @brief Aplica uma lista de atribuições `sensor.chave=valor`, separadas por vírgulas.
+ *
+ * As chaves são `sample_ms`, `report_ms`, `deadband` (nas unidades do
+ * sensor, até duas casas decimais) e `heartbeat_ms`. A lista é aplicada
+ * por inteiro ou rejeitada por inteiro.
+ *
+ * @param assignments O texto das atribuições (ex: "flow.sample_ms=100").
+ * @return CONFIG_STORE_OK, ou CONFIG_STORE_INVALID_PARAM.
+ */
+config_store_status_t config_store_apply(const char* assignments);
+
+/**
+ * @brief Grava na flash a configuração em vigor, se tiver sido alterada.
+ *
+ * Como no flash_store, na placa a escrita retém o outro núcleo na RAM e é
+ * adiada se a retenção não for possível.
+ *
+ * @return CONFIG_STORE_OK, CONFIG_STORE_BUSY ou CONFIG_STORE_IO_ERROR.
+ */
+config_store_status_t config_store_sync(void);
+
+#endif // CONFIG_STORE_H
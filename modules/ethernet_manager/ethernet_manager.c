@@ -3,8 +3,11 @@
 #include "socket.h"
 #include "pico/stdlib.h"
 #include "hardware/spi.h"
+#include "hardware/irq.h"
+#include "FreeRTOS.h"
+#include "task.h"
 #include <string.h>
-#include <stdio.h>
+#include "../logger/logger.h"
 
 // Configuração dos pinos SPI para W5500
 #define SPI_PORT spi0
@@ -13,11 +16,50 @@
 #define PIN_SCK  18
 #define PIN_MOSI 19 
 #define PIN_RST  20
+#define PIN_INT  W5500_INT_PIN
+
+// Índice da notificação de tarefa usada pela INTn (ver FreeRTOSConfig.h)
+#define ETHERNET_EVENT_NOTIFY_INDEX 2
 
 // Variáveis globais
 static ethernet_config_t current_config;
 static ethernet_status_t current_status = ETHERNET_DISCONNECTED;
 
+// Tarefa bloqueada em ethernet_wait_event()
+static TaskHandle_t event_task = NULL;
+
+// Memória TX/RX (KB) de cada socket, definida no config.cmake
+static const uint8_t socket_tx_kb[W5500_SOCKET_COUNT] = {
+    W5500_SOCKET_TX_KB_0, W5500_SOCKET_TX_KB_1, W5500_SOCKET_TX_KB_2, W5500_SOCKET_TX_KB_3,
+    W5500_SOCKET_TX_KB_4, W5500_SOCKET_TX_KB_5, W5500_SOCKET_TX_KB_6, W5500_SOCKET_TX_KB_7
+};
+static const uint8_t socket_rx_kb[W5500_SOCKET_COUNT] = {
+    W5500_SOCKET_RX_KB_0, W5500_SOCKET_RX_KB_1, W5500_SOCKET_RX_KB_2, W5500_SOCKET_RX_KB_3,
+    W5500_SOCKET_RX_KB_4, W5500_SOCKET_RX_KB_5, W5500_SOCKET_RX_KB_6, W5500_SOCKET_RX_KB_7
+};
+
+// Sockets entregues pelo pool (bit n = socket n em uso)
+static uint8_t sockets_in_use = 0;
+
+/**
+ * @brief Interrupção da INTn do W5500.
+ *
+ * A INTn fica em nível baixo enquanto houver bits ativos nos registradores
+ * Sn_IR. A interrupção é de nível e desativa-se a si própria: volta a ser
+ * armada na próxima espera, depois de a tarefa ter limpo os eventos.
+ */
+static void ethernet_int_irq_handler(void) {
+    if (gpio_get_irq_event_mask(PIN_INT) & GPIO_IRQ_LEVEL_LOW) {
+        gpio_set_irq_enabled(PIN_INT, GPIO_IRQ_LEVEL_LOW, false);
+
+        if (event_task != NULL) {
+            BaseType_t higher_priority_woken = pdFALSE;
+            vTaskNotifyGiveIndexedFromISR(event_task, ETHERNET_EVENT_NOTIFY_INDEX, &higher_priority_woken);
+            portYIELD_FROM_ISR(higher_priority_woken);
+        }
+    }
+}
+
 // Função de reset do W5500
 static void wizchip_reset(void) {
     gpio_put(PIN_RST, 0);
@@ -27,7 +69,7 @@ static void wizchip_reset(void) {
 }
 
 static int init_spi_and_pins(void) {
-    printf("[INFO] Inicializando SPI e pinos do W5500...\n");
+    LOG_INFO("[INFO] Inicializando SPI e pinos do W5500...\n");
     
     // Inicializa SPI a 50MHz
     spi_init(SPI_PORT, 50 * 1000 * 1000);
@@ -46,7 +88,21 @@ static int init_spi_and_pins(void) {
     gpio_init(PIN_RST);
     gpio_set_dir(PIN_RST, GPIO_OUT);
     gpio_put(PIN_RST, 1);
+
+    // Configura pino INTn (dreno aberto, ativo em nível baixo)
+    gpio_init(PIN_INT);
+    gpio_set_dir(PIN_INT, GPIO_IN);
+    gpio_pull_up(PIN_INT);
+    static bool int_handler_added = false;
+    if (!int_handler_added) {
+        gpio_add_raw_irq_handler(PIN_INT, ethernet_int_irq_handler);
+        irq_set_enabled(IO_IRQ_BANK0, true);
+        int_handler_added = true;
+    }
     
+    // Canais DMA para as rajadas de dados dos sockets
+    w5500_spi_dma_init();
+
     // Reset do W5500
     wizchip_reset();
     
@@ -55,11 +111,11 @@ static int init_spi_and_pins(void) {
 
 int ethernet_init(ethernet_config_t* config) {
     if (!config) {
-        printf("[ERRO] Configuração de rede inválida\n");
+        LOG_ERROR("[ERRO] Configuração de rede inválida\n");
         return -1;
     }
     
-    printf("[INFO] Inicializando módulo Ethernet...\n");
+    LOG_INFO("[INFO] Inicializando módulo Ethernet...\n");
     current_status = ETHERNET_CONNECTING;
     
     // Copia configuração
@@ -67,7 +123,7 @@ int ethernet_init(ethernet_config_t* config) {
     
     // Inicializa SPI e pinos
     if (init_spi_and_pins() != 0) {
-        printf("[ERRO] Falha na inicialização do SPI\n");
+        LOG_ERROR("[ERRO] Falha na inicialização do SPI\n");
         current_status = ETHERNET_ERROR;
         return -1;
     }
@@ -77,12 +133,15 @@ int ethernet_init(ethernet_config_t* config) {
     reg_wizchip_spi_cbfunc(w5500_spi_readbyte, w5500_spi_writebyte);
     reg_wizchip_spiburst_cbfunc(w5500_spi_readburst, w5500_spi_writeburst);
     
-    // Inicializa buffers de socket (8 sockets de 2KB cada)
-    uint8_t tx_size[] = {2, 2, 2, 2, 2, 2, 2, 2};
-    uint8_t rx_size[] = {2, 2, 2, 2, 2, 2, 2, 2};
+    // Reparte os 16KB de TX e de RX pelos sockets conforme o config.cmake.
+    // Os sockets sem memória ficam fora do pool.
+    uint8_t tx_size[W5500_SOCKET_COUNT];
+    uint8_t rx_size[W5500_SOCKET_COUNT];
+    memcpy(tx_size, socket_tx_kb, sizeof(tx_size));
+    memcpy(rx_size, socket_rx_kb, sizeof(rx_size));
     
     if (wizchip_init(tx_size, rx_size) != 0) {
-        printf("[ERRO] Falha na inicialização do WizChip\n");
+        LOG_ERROR("[ERRO] Falha na inicialização do WizChip\n");
         current_status = ETHERNET_ERROR;
         return -1;
     }
@@ -102,17 +161,17 @@ int ethernet_init(ethernet_config_t* config) {
     wiz_NetInfo check_info;
     wizchip_getnetinfo(&check_info);
     
-    printf("[OK]   W5500 inicializado com sucesso!\n");
-    printf("[INFO] MAC: %02X:%02X:%02X:%02X:%02X:%02X\n", 
-           check_info.mac[0], check_info.mac[1], check_info.mac[2],
-           check_info.mac[3], check_info.mac[4], check_info.mac[5]);
-    printf("[INFO] IP: %d.%d.%d.%d\n", 
-           check_info.ip[0], check_info.ip[1], check_info.ip[2], check_info.ip[3]);
-    printf("[INFO] Gateway: %d.%d.%d.%d\n", 
-           check_info.gw[0], check_info.gw[1], check_info.gw[2], check_info.gw[3]);
+    LOG_INFO("[OK]   W5500 inicializado com sucesso!\n");
+    LOG_INFO("[INFO] MAC: %02X:%02X:%02X:%02X:%02X:%02X\n", 
+             check_info.mac[0], check_info.mac[1], check_info.mac[2],
+             check_info.mac[3], check_info.mac[4], check_info.mac[5]);
+    LOG_INFO("[INFO] IP: %d.%d.%d.%d\n", 
+             check_info.ip[0], check_info.ip[1], check_info.ip[2], check_info.ip[3]);
+    LOG_INFO("[INFO] Gateway: %d.%d.%d.%d\n", 
+             check_info.gw[0], check_info.gw[1], check_info.gw[2], check_info.gw[3]);
 
 
-    printf("[INFO] Aguardando link físico...\n");
+    LOG_INFO("[INFO] Aguardando link físico...\n");
     int retries = 5; // Tenta por 2.5 segundos
     while (retries > 0 && wizphy_getphylink() != PHY_LINK_ON) {
         sleep_ms(500);
@@ -120,12 +179,12 @@ int ethernet_init(ethernet_config_t* config) {
     }
 
     if (wizphy_getphylink() != PHY_LINK_ON) {
-        printf("[ERRO] Link Ethernet não detectado após a inicialização. Verifique o cabo.\n");
+        LOG_ERROR("[ERRO] Link Ethernet não detectado após a inicialização. Verifique o cabo.\n");
         current_status = ETHERNET_DISCONNECTED;
         return -1; // Sinaliza a falha
     }
     
-    printf("[OK] Link físico detectado.\n");
+    LOG_INFO("[OK] Link físico detectado.\n");
     current_status = ETHERNET_CONNECTED;
     return 0;
 }
@@ -136,12 +195,12 @@ ethernet_status_t ethernet_get_status(void) {
     
     if (phy_status == PHY_LINK_OFF) {
         if (current_status == ETHERNET_CONNECTED) {
-            printf("[INFO] Link Ethernet desconectado\n");
+            LOG_INFO("[INFO] Link Ethernet desconectado\n");
             current_status = ETHERNET_DISCONNECTED;
         }
     } else if (phy_status == PHY_LINK_ON) {
         if (current_status == ETHERNET_DISCONNECTED) {
-            printf("[INFO] Link Ethernet conectado\n");
+            LOG_INFO("[INFO] Link Ethernet conectado\n");
             current_status = ETHERNET_CONNECTED;
         }
     }
@@ -156,16 +215,91 @@ void ethernet_get_network_info(wiz_NetInfo* net_info) {
 }
 
 void ethernet_cleanup(void) {
-    printf("[INFO] Limpando recursos do módulo Ethernet...\n");
+    LOG_INFO("[INFO] Limpando recursos do módulo Ethernet...\n");
     current_status = ETHERNET_DISCONNECTED;
 }
 
 int ethernet_restart(void) {
-    printf("[INFO] Reiniciando conexão Ethernet...\n");
-    
+    // O reset fecha todos os sockets sem aviso às tarefas que os usam.
+    if (sockets_in_use != 0) {
+        LOG_WARN("[AVISO] Reinício do Ethernet adiado: sockets em uso (0x%02x).\n", sockets_in_use);
+        return -1;
+    }
+
+    LOG_INFO("[INFO] Reiniciando conexão Ethernet...\n");
+
     // Reset do W5500
     wizchip_reset();
     
     // Reaplica configuração
     return ethernet_init(&current_config);
-}
\ No newline at end of file
+}
+
+void ethernet_enable_socket_events(uint8_t sn, uint8_t mask) {
+    setSn_IMR(sn, mask);
+    setSIMR(getSIMR() | (uint8_t)(1 << sn));
+}
+
+void ethernet_disable_socket_events(uint8_t sn) {
+    setSIMR(getSIMR() & (uint8_t)~(1 << sn));
+}
+
+bool ethernet_wait_event(uint32_t timeout_ms) {
+    // Um evento ainda por tratar mantém a INTn em nível baixo.
+    if (!gpio_get(PIN_INT)) {
+        return true;
+    }
+
+    event_task = xTaskGetCurrentTaskHandle();
+    ulTaskNotifyTakeIndexed(ETHERNET_EVENT_NOTIFY_INDEX, pdTRUE, 0);
+
+    // Se a INTn descer entre a leitura acima e este ponto, a interrupção
+    // de nível dispara logo ao ser ativada.
+    gpio_set_irq_enabled(PIN_INT, GPIO_IRQ_LEVEL_LOW, true);
+    bool signaled = ulTaskNotifyTakeIndexed(ETHERNET_EVENT_NOTIFY_INDEX, pdTRUE,
+                                            pdMS_TO_TICKS(timeout_ms)) > 0;
+    gpio_set_irq_enabled(PIN_INT, GPIO_IRQ_LEVEL_LOW, false);
+
+    event_task = NULL;
+    return signaled;
+}
+
+bool ethernet_wait_socket_event(uint8_t sn, uint32_t timeout_ms) {
+    uint8_t simr = getSIMR();
+
+    setSIMR(simr & (uint8_t)(1 << sn));
+    bool signaled = ethernet_wait_event(timeout_ms);
+    setSIMR(simr);
+
+    return signaled;
+}
+
+int ethernet_socket_alloc(void) {
+    int sn = -1;
+
+    taskENTER_CRITICAL();
+    for (uint8_t i = 0; i < W5500_SOCKET_COUNT; i++) {
+        if ((sockets_in_use & (1 << i)) == 0 && socket_tx_kb[i] > 0 && socket_rx_kb[i] > 0) {
+            sockets_in_use |= (uint8_t)(1 << i);
+            sn = i;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return sn;
+}
+
+void ethernet_socket_free(uint8_t sn) {
+    if (sn >= W5500_SOCKET_COUNT) {
+        return;
+    }
+
+    ethernet_disable_socket_events(sn);
+    setSn_IMR(sn, 0);
+    setSn_IR(sn, 0xFF);
+
+    taskENTER_CRITICAL();
+    sockets_in_use &= (uint8_t)~(1 << sn);
+    taskEXIT_CRITICAL();
+}
@@ -2,8 +2,12 @@
 #define ETHERNET_MANAGER_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "wizchip_conf.h"
 
+// Número de sockets de hardware do W5500
+#define W5500_SOCKET_COUNT 8
+
 // Estrutura para configuração de rede
 typedef struct {
     uint8_t mac[6];       // Endereço MAC
@@ -48,8 +52,75 @@ void ethernet_cleanup(void);
 
 /**
  * @brief Reinicia a conexão Ethernet
- * @return 0 se sucesso, -1 se erro
+ *
+ * O reset do W5500 fecha todos os sockets: o reinício é recusado enquanto
+ * algum socket do pool estiver em uso (ver ethernet_socket_alloc()).
+ *
+ * @return 0 se sucesso, -1 se erro ou se há sockets em uso
  */
 int ethernet_restart(void);
 
+/**
+ * @brief Obtém um socket livre do W5500
+ *
+ * Apenas os sockets com memória TX e RX atribuída no config.cmake
+ * (W5500_SOCKET_TX_KB / W5500_SOCKET_RX_KB) fazem parte do pool; são
+ * entregues por ordem de número.
+ *
+ * @return O número do socket, ou -1 se todos estiverem em uso
+ */
+int ethernet_socket_alloc(void);
+
+/**
+ * @brief Devolve ao pool um socket obtido com ethernet_socket_alloc()
+ *
+ * Desativa também a sinalização dos seus eventos e limpa os que ficaram
+ * pendentes, para que um socket livre não mantenha a INTn ativa.
+ *
+ * @param sn Número do socket, já fechado
+ */
+void ethernet_socket_free(uint8_t sn);
+
+/**
+ * @brief Ativa a sinalização de eventos de um socket na INTn do W5500
+ * @param sn Número do socket
+ * @param mask Eventos a sinalizar (combinação de Sn_IR_CON, Sn_IR_DISCON,
+ * Sn_IR_RECV, Sn_IR_TIMEOUT e Sn_IR_SENDOK)
+ */
+void ethernet_enable_socket_events(uint8_t sn, uint8_t mask);
+
+/**
+ * @brief Retira um socket da INTn (SIMR), por exemplo enquanto está inativo
+ *
+ * Os eventos que entretanto ocorram ficam registados em Sn_IR e voltam a
+ * ser sinalizados com ethernet_enable_socket_events().
+ *
+ * @param sn Número do socket
+ */
+void ethernet_disable_socket_events(uint8_t sn);
+
+/**
+ * @brief Suspende a tarefa até o W5500 sinalizar um evento de socket na INTn
+ *
+ * Os eventos devem ser limpos (escrevendo em Sn_IR) depois de tratados;
+ * enquanto houver eventos pendentes a função retorna de imediato.
+ *
+ * @param timeout_ms Tempo máximo de espera
+ * @return true se há um evento a tratar, false se o tempo esgotou
+ */
+bool ethernet_wait_event(uint32_t timeout_ms);
+
+/**
+ * @brief Como ethernet_wait_event(), mas apenas pelos eventos de um socket
+ *
+ * Durante a espera os restantes sockets ficam mascarados em SIMR: os seus
+ * eventos continuam pendentes em Sn_IR, mas não ativam a INTn, e são
+ * sinalizados quando a máscara é reposta no fim da espera.
+ *
+ * @param sn Número do socket
+ * @param timeout_ms Tempo máximo de espera
+ * @return true se o socket tem um evento a tratar, false se o tempo esgotou
+ */
+bool ethernet_wait_socket_event(uint8_t sn, uint32_t timeout_ms);
+
 #endif // ETHERNET_MANAGER_H
\ No newline at end of file
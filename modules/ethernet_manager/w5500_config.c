@@ -2,6 +2,10 @@
 #include "wizchip_macros.h"
 #include "hardware/spi.h"
 #include "hardware/gpio.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "FreeRTOS.h"
+#include "task.h"
 
 // Configuração dos pinos SPI para W5500
 #define SPI_PORT spi0
@@ -11,6 +15,133 @@
 #define PIN_MOSI 19
 #define PIN_RST  20
 
+// Limite de espera por uma transferência DMA (uma rajada de 16KB a 50MHz leva ~3ms)
+#define W5500_SPI_DMA_TIMEOUT_MS 50
+
+// Canais DMA: TX alimenta o FIFO de envio, RX esvazia o FIFO de receção.
+// O fim do canal RX marca o fim da transferência, pois o último byte
+// só chega depois de ter sido completamente transmitido.
+static int dma_tx_channel = -1;
+static int dma_rx_channel = -1;
+
+// Tarefa à espera da transferência em curso
+static TaskHandle_t dma_waiting_task = NULL;
+
+/**
+ * @brief Interrupção de fim de transferência do canal RX: acorda a tarefa em espera.
+ */
+static void w5500_spi_dma_irq_handler(void) {
+    if (!dma_channel_get_irq1_status(dma_rx_channel)) {
+        return;
+    }
+    dma_channel_acknowledge_irq1(dma_rx_channel);
+
+    if (dma_waiting_task != NULL) {
+        BaseType_t higher_priority_woken = pdFALSE;
+        vTaskNotifyGiveIndexedFromISR(dma_waiting_task, W5500_SPI_DMA_NOTIFY_INDEX, &higher_priority_woken);
+        portYIELD_FROM_ISR(higher_priority_woken);
+    }
+}
+
+void w5500_spi_dma_init(void) {
+    if (dma_tx_channel >= 0) {
+        return;
+    }
+
+    dma_tx_channel = dma_claim_unused_channel(false);
+    dma_rx_channel = dma_claim_unused_channel(false);
+    if (dma_tx_channel < 0 || dma_rx_channel < 0) {
+        // Sem canais livres as rajadas continuam no modo bloqueante.
+        if (dma_tx_channel >= 0) {
+            dma_channel_unclaim(dma_tx_channel);
+        }
+        if (dma_rx_channel >= 0) {
+            dma_channel_unclaim(dma_rx_channel);
+        }
+        dma_tx_channel = -1;
+        dma_rx_channel = -1;
+        return;
+    }
+
+    irq_add_shared_handler(DMA_IRQ_1, w5500_spi_dma_irq_handler,
+                           PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    dma_channel_set_irq1_enabled(dma_rx_channel, true);
+    irq_set_enabled(DMA_IRQ_1, true);
+}
+
+/**
+ * @brief Indica se a rajada deve usar DMA.
+ *
+ * Rajadas curtas (endereço e registradores) terminam mais depressa em modo
+ * bloqueante do que o custo de programar o DMA e trocar de tarefa. Antes de
+ * o escalonador arrancar não há tarefa para suspender.
+ */
+static bool w5500_spi_use_dma(uint16_t len) {
+    return len >= W5500_SPI_DMA_THRESHOLD &&
+           dma_tx_channel >= 0 &&
+           xTaskGetSchedulerState() == taskSCHEDULER_RUNNING;
+}
+
+/**
+ * @brief Executa uma rajada full-duplex por DMA, suspendendo a tarefa até ao fim.
+ *
+ * @param tx_buf Bytes a enviar, ou NULL para enviar zeros.
+ * @param rx_buf Destino dos bytes recebidos, ou NULL para os descartar.
+ * @param len Número de bytes.
+ */
+static void w5500_spi_dma_transfer(const uint8_t* tx_buf, uint8_t* rx_buf, uint16_t len) {
+    static const uint8_t tx_dummy = 0;
+    static uint8_t rx_dummy;
+
+    spi_hw_t* hw = spi_get_hw(SPI_PORT);
+
+    dma_channel_config tx_config = dma_channel_get_default_config(dma_tx_channel);
+    channel_config_set_transfer_data_size(&tx_config, DMA_SIZE_8);
+    channel_config_set_dreq(&tx_config, spi_get_dreq(SPI_PORT, true));
+    channel_config_set_read_increment(&tx_config, tx_buf != NULL);
+    channel_config_set_write_increment(&tx_config, false);
+    dma_channel_configure(dma_tx_channel, &tx_config, &hw->dr,
+                          tx_buf != NULL ? tx_buf : &tx_dummy, len, false);
+
+    dma_channel_config rx_config = dma_channel_get_default_config(dma_rx_channel);
+    channel_config_set_transfer_data_size(&rx_config, DMA_SIZE_8);
+    channel_config_set_dreq(&rx_config, spi_get_dreq(SPI_PORT, false));
+    channel_config_set_read_increment(&rx_config, false);
+    channel_config_set_write_increment(&rx_config, rx_buf != NULL);
+    dma_channel_configure(dma_rx_channel, &rx_config,
+                          rx_buf != NULL ? rx_buf : &rx_dummy, &hw->dr, len, false);
+
+    // Descarta notificações antigas antes de armar a espera. O índice é
+    // próprio para não consumir as notificações da INTn (ethernet_wait_event).
+    ulTaskNotifyTakeIndexed(W5500_SPI_DMA_NOTIFY_INDEX, pdTRUE, 0);
+    dma_waiting_task = xTaskGetCurrentTaskHandle();
+
+    // Os dois canais arrancam juntos para que o FIFO RX nunca transborde.
+    dma_start_channel_mask((1u << dma_tx_channel) | (1u << dma_rx_channel));
+
+    if (ulTaskNotifyTakeIndexed(W5500_SPI_DMA_NOTIFY_INDEX, pdTRUE, pdMS_TO_TICKS(W5500_SPI_DMA_TIMEOUT_MS)) == 0) {
+        // Não deve acontecer; garante que nenhum canal continua a escrever no buffer.
+        dma_channel_abort(dma_tx_channel);
+        dma_channel_abort(dma_rx_channel);
+
+        // O SSP ainda envia o que ficou no FIFO TX. Espera que pare e
+        // descarta o FIFO RX, como no fim de spi_write_blocking(): o CS só
+        // sobe com o barramento parado e a rajada seguinte não lê bytes desta.
+        while (spi_is_readable(SPI_PORT)) {
+            (void)hw->dr;
+        }
+        while (spi_is_busy(SPI_PORT)) {
+            tight_loop_contents();
+        }
+        while (spi_is_readable(SPI_PORT)) {
+            (void)hw->dr;
+        }
+        hw->icr = SPI_SSPICR_RORIC_BITS;
+    }
+
+    dma_waiting_task = NULL;
+}
+
 // Implementação das funções de callback para SPI
 void w5500_cs_select(void) {
     gpio_put(PIN_CS, 0);
@@ -31,9 +162,17 @@ void w5500_spi_writebyte(uint8_t wb) {
 }
 
 void w5500_spi_readburst(uint8_t* pBuf, uint16_t len) {
+    if (w5500_spi_use_dma(len)) {
+        w5500_spi_dma_transfer(NULL, pBuf, len);
+        return;
+    }
     spi_read_blocking(SPI_PORT, 0, pBuf, len);
 }
 
 void w5500_spi_writeburst(uint8_t* pBuf, uint16_t len) {
+    if (w5500_spi_use_dma(len)) {
+        w5500_spi_dma_transfer(pBuf, NULL, len);
+        return;
+    }
     spi_write_blocking(SPI_PORT, pBuf, len);
 }
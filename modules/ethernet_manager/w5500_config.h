@@ -7,6 +7,14 @@
 // Definição do tipo datasize_t usado pela ioLibrary
 typedef int16_t datasize_t;
 
+// Rajadas a partir deste tamanho (bytes) são feitas por DMA, libertando o CPU
+#ifndef W5500_SPI_DMA_THRESHOLD
+#define W5500_SPI_DMA_THRESHOLD 32
+#endif
+
+// Índice da notificação de tarefa usada pelo fim das transferências DMA
+#define W5500_SPI_DMA_NOTIFY_INDEX 1
+
 // Funções de interface SPI para W5500
 void w5500_cs_select(void);
 void w5500_cs_deselect(void);
@@ -15,6 +23,9 @@ void w5500_spi_writebyte(uint8_t wb);
 void w5500_spi_readburst(uint8_t* pBuf, uint16_t len);
 void w5500_spi_writeburst(uint8_t* pBuf, uint16_t len);
 
+// Reserva os canais DMA das rajadas; sem canais livres mantém o modo bloqueante
+void w5500_spi_dma_init(void);
+
 // Macros para controle do CS
 #define WIZCHIP_CS_SELECT() w5500_cs_select()
 #define WIZCHIP_CS_DESELECT() w5500_cs_deselect()
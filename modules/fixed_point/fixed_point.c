@@ -0,0 +1,17 @@
+/**
+ * @file fixed_point.c
+ * @brief Implementação das rotinas de ponto fixo que não cabem em macros.
+ */
+
+#include "fixed_point.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+int q16_format(char* buf, size_t size, q16_t value) {
+    int32_t centi = q16_to_centi(value);
+    int32_t magnitude = labs(centi);
+
+    return snprintf(buf, size, "%s%ld.%02ld",
+                    (centi < 0) ? "-" : "",
+                    (long)(magnitude / 100), (long)(magnitude % 100));
+}
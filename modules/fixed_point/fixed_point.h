@@ -0,0 +1,62 @@
+/**
+ * @file fixed_point.h
+ * @brief Aritmética de ponto fixo Q16.16 para o Cortex-M0+ (sem FPU).
+ *
+ * Um valor q16_t é um inteiro de 32 bits com 16 bits fracionários, cobrindo
+ * a faixa de -32768 a 32767.99998 com resolução de 1/65536.
+ */
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Valor em ponto fixo Q16.16.
+ */
+typedef int32_t q16_t;
+
+#define Q16_FRAC_BITS 16
+#define Q16_ONE       ((q16_t)1 << Q16_FRAC_BITS)
+
+/**
+ * @brief Converte um inteiro para Q16.16.
+ */
+#define Q16_FROM_INT(x) ((q16_t)((x) * Q16_ONE))
+
+/**
+ * @brief Converte uma constante de vírgula flutuante para Q16.16, com arredondamento.
+ *
+ * Destina-se a constantes conhecidas em tempo de compilação (ex: os valores
+ * SENSOR_* do config.cmake): o compilador resolve a expressão e nenhuma
+ * operação de vírgula flutuante chega ao binário.
+ */
+#define Q16_FROM_FLOAT(x) ((q16_t)((x) * 65536.0 + (((x) >= 0) ? 0.5 : -0.5)))
+
+/**
+ * @brief Converte um valor Q16.16 para centésimos, com arredondamento.
+ */
+static inline int32_t q16_to_centi(q16_t value) {
+    return (int32_t)(((int64_t)value * 100 + (Q16_ONE / 2)) >> Q16_FRAC_BITS);
+}
+
+/**
+ * @brief Converte um valor em centésimos para Q16.16.
+ */
+static inline q16_t q16_from_centi(int32_t centi) {
+    return (q16_t)(((int64_t)centi << Q16_FRAC_BITS) / 100);
+}
+
+/**
+ * @brief Formata um valor Q16.16 com duas casas decimais (ex: "-12.34").
+ *
+ * Usa apenas formatação de inteiros, evitando o printf de vírgula flutuante.
+ *
+ * @param buf O buffer de destino.
+ * @param size O tamanho do buffer.
+ * @param value O valor a formatar.
+ * @return O número de caracteres escritos, como snprintf().
+ */
+int q16_format(char* buf, size_t size, q16_t value);
+
+#endif // FIXED_POINT_H
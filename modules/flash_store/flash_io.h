@@ -0,0 +1,111 @@
+/**
+ * @file flash_io.h
+ * @brief Interface de acesso a uma região de memória flash NOR.
+ *
+ * Isola o armazenamento persistente do hardware concreto: os módulos
+ * flash_store e config_store operam sobre esta interface, cada um na sua
+ * região, e a implementação pode ser a flash QSPI do RP2040 ou um simulador
+ * baseado em ficheiro no host.
+ *
+ * Layout no fim da flash da placa:
+ * | firmware ... | config_store (CONFIG_STORE_SIZE_KB) | flash_store (FLASH_STORE_SIZE_KB) |
+ */
+#ifndef FLASH_IO_H
+#define FLASH_IO_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/** @brief Menor unidade de programação da flash, em bytes. */
+#define FLASH_IO_PAGE_SIZE   256u
+
+/** @brief Menor unidade de apagamento da flash, em bytes. */
+#define FLASH_IO_SECTOR_SIZE 4096u
+
+/** @brief A escrita não começou e a flash não foi alterada: deve ser repetida mais tarde. */
+#define FLASH_IO_BUSY        1
+
+/**
+ * @struct flash_io_t
+ * @brief Operações sobre uma região de flash endereçada a partir de 0.
+ *
+ * Todas as operações retornam 0 em caso de sucesso e -1 em caso de erro;
+ * `program` e `erase_sector` podem ainda retornar FLASH_IO_BUSY. Tal como numa flash NOR real, `program` apenas limpa bits (1 -> 0):
+ * bytes 0xFF no buffer preservam o conteúdo existente.
+ */
+typedef struct {
+    /** @brief Tamanho da região, múltiplo de FLASH_IO_SECTOR_SIZE. */
+    uint32_t size;
+
+    /** @brief Lê `len` bytes a partir de `offset`. */
+    int (*read)(uint32_t offset, void* buf, size_t len);
+
+    /** @brief Programa `len` bytes a partir de `offset`, sem exigir alinhamento. */
+    int (*program)(uint32_t offset, const void* buf, size_t len);
+
+    /** @brief Apaga (volta a 0xFF) o setor que começa em `offset`. */
+    int (*erase_sector)(uint32_t offset);
+} flash_io_t;
+
+/**
+ * @brief Retorna a implementação sobre a flash QSPI do RP2040.
+ *
+ * A região ocupa os últimos FLASH_STORE_SIZE_KB da flash da placa.
+ */
+const flash_io_t* flash_io_rp2040(void);
+
+/**
+ * @brief Retorna a implementação sobre a região de configuração da flash do RP2040.
+ *
+ * A região ocupa os CONFIG_STORE_SIZE_KB imediatamente antes da região do
+ * flash_store.
+ */
+const flash_io_t* flash_io_rp2040_config(void);
+
+/**
+ * @enum flash_io_write_mode_t
+ * @brief Como prosseguir com uma escrita na flash do RP2040, decidido antes dela.
+ */
+typedef enum {
+    FLASH_IO_WRITE_LOCKOUT,  /**< flash_safe_execute() bloqueia o outro núcleo durante a operação. */
+    FLASH_IO_WRITE_HELD,     /**< O outro núcleo corre só da RAM até `end`: basta desativar as interrupções. */
+    FLASH_IO_WRITE_POSTPONE  /**< A operação retorna FLASH_IO_BUSY sem tocar na flash. */
+} flash_io_write_mode_t;
+
+/**
+ * @brief Regista as funções chamadas antes e depois de cada escrita na flash do RP2040.
+ *
+ * O XIP fica desativado durante cada programação de página (~1 ms) ou
+ * apagamento de setor (até ~400 ms), e nenhum núcleo pode executar da flash
+ * nesse intervalo. `begin` prepara o outro núcleo e escolhe o modo (ex:
+ * retém-no num ciclo na RAM que continua a aquisição do ADC); `end` é
+ * chamada depois, qualquer que tenha sido o modo. Valem para as duas regiões.
+ *
+ * @param begin Chamada antes da operação, ou NULL (FLASH_IO_WRITE_LOCKOUT).
+ * @param end Chamada depois da operação, ou NULL.
+ */
+void flash_io_rp2040_set_write_hooks(flash_io_write_mode_t (*begin)(void), void (*end)(void));
+
+/**
+ * @brief Retorna a implementação sobre um ficheiro, usada no build host.
+ *
+ * O ficheiro tem FLASH_STORE_SIZE_KB e é criado apagado (0xFF) se não
+ * existir; o conteúdo persiste entre execuções, como a flash da placa.
+ *
+ * @param path O caminho do ficheiro que guarda a região.
+ * @return A implementação, ou NULL se o ficheiro não puder ser aberto.
+ */
+const flash_io_t* flash_io_file(const char* path);
+
+/**
+ * @brief Retorna a região de configuração sobre um ficheiro, usada no build host.
+ *
+ * Como flash_io_file(), com CONFIG_STORE_SIZE_KB; as duas regiões podem
+ * estar abertas em simultâneo, em ficheiros distintos.
+ *
+ * @param path O caminho do ficheiro que guarda a região.
+ * @return A implementação, ou NULL se o ficheiro não puder ser aberto.
+ */
+const flash_io_t* flash_io_file_config(const char* path);
+
+#endif // FLASH_IO_H
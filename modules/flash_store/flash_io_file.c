@@ -0,0 +1,164 @@
+/**
+ * @file flash_io_file.c
+ * @brief Implementação de flash_io_t sobre um ficheiro, para o build host.
+ *
+ * Reproduz a semântica da flash NOR: a programação apenas limpa bits e só
+ * o apagamento de um setor inteiro os volta a 1. Assim o flash_store corre
+ * no host exatamente como na placa, incluindo a recuperação após reinício.
+ */
+
+#include "flash_io.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define FLASH_STORE_SIZE_BYTES  (FLASH_STORE_SIZE_KB * 1024u)
+#define CONFIG_STORE_SIZE_BYTES (CONFIG_STORE_SIZE_KB * 1024u)
+
+/**
+ * @brief Uma região de flash guardada num ficheiro.
+ */
+typedef struct {
+    FILE* file;
+    uint32_t size;
+} flash_file_region_t;
+
+static flash_file_region_t store_region = { NULL, FLASH_STORE_SIZE_BYTES };
+static flash_file_region_t config_region = { NULL, CONFIG_STORE_SIZE_BYTES };
+
+static int file_read(flash_file_region_t* region, uint32_t offset, void* buf, size_t len) {
+    if (offset + len > region->size ||
+        fseek(region->file, (long)offset, SEEK_SET) != 0 ||
+        fread(buf, 1, len, region->file) != len) {
+        return -1;
+    }
+    return 0;
+}
+
+static int file_program(flash_file_region_t* region, uint32_t offset, const void* buf, size_t len) {
+    uint8_t page_buf[FLASH_IO_PAGE_SIZE];
+    const uint8_t* src = (const uint8_t*)buf;
+
+    if (offset + len > region->size) {
+        return -1;
+    }
+
+    while (len > 0) {
+        size_t chunk = (len < sizeof(page_buf)) ? len : sizeof(page_buf);
+
+        // Tal como na flash, um bit a 0 não volta a 1 sem apagar o setor.
+        if (file_read(region, offset, page_buf, chunk) != 0) {
+            return -1;
+        }
+        for (size_t i = 0; i < chunk; i++) {
+            page_buf[i] &= src[i];
+        }
+        if (fseek(region->file, (long)offset, SEEK_SET) != 0 ||
+            fwrite(page_buf, 1, chunk, region->file) != chunk) {
+            return -1;
+        }
+
+        offset += chunk;
+        src += chunk;
+        len -= chunk;
+    }
+
+    return fflush(region->file) == 0 ? 0 : -1;
+}
+
+static int file_erase_sector(flash_file_region_t* region, uint32_t offset) {
+    uint8_t erased[FLASH_IO_SECTOR_SIZE];
+
+    if ((offset % FLASH_IO_SECTOR_SIZE) != 0 || offset >= region->size) {
+        return -1;
+    }
+
+    memset(erased, 0xFF, sizeof(erased));
+    if (fseek(region->file, (long)offset, SEEK_SET) != 0 ||
+        fwrite(erased, 1, sizeof(erased), region->file) != sizeof(erased)) {
+        return -1;
+    }
+    return fflush(region->file) == 0 ? 0 : -1;
+}
+
+/**
+ * @brief Abre o ficheiro de uma região, criando-o apagado se necessário.
+ */
+static bool file_open(flash_file_region_t* region, const char* path) {
+    if (region->file != NULL) {
+        fclose(region->file);
+    }
+
+    // Um ficheiro de outro tamanho (ex: FLASH_STORE_SIZE_KB alterado) é
+    // descartado, tal como uma região nova na placa.
+    region->file = fopen(path, "r+b");
+    if (region->file != NULL &&
+        (fseek(region->file, 0, SEEK_END) != 0 || ftell(region->file) != (long)region->size)) {
+        fclose(region->file);
+        region->file = NULL;
+    }
+
+    if (region->file == NULL) {
+        region->file = fopen(path, "w+b");
+        if (region->file == NULL) {
+            return false;
+        }
+        for (uint32_t offset = 0; offset < region->size; offset += FLASH_IO_SECTOR_SIZE) {
+            if (file_erase_sector(region, offset) != 0) {
+                fclose(region->file);
+                region->file = NULL;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// flash_io_t não tem contexto: cada região tem as suas funções de entrada.
+
+static int store_read(uint32_t offset, void* buf, size_t len) {
+    return file_read(&store_region, offset, buf, len);
+}
+
+static int store_program(uint32_t offset, const void* buf, size_t len) {
+    return file_program(&store_region, offset, buf, len);
+}
+
+static int store_erase_sector(uint32_t offset) {
+    return file_erase_sector(&store_region, offset);
+}
+
+static int config_read(uint32_t offset, void* buf, size_t len) {
+    return file_read(&config_region, offset, buf, len);
+}
+
+static int config_program(uint32_t offset, const void* buf, size_t len) {
+    return file_program(&config_region, offset, buf, len);
+}
+
+static int config_erase_sector(uint32_t offset) {
+    return file_erase_sector(&config_region, offset);
+}
+
+static const flash_io_t file_flash_io = {
+    .size = FLASH_STORE_SIZE_BYTES,
+    .read = store_read,
+    .program = store_program,
+    .erase_sector = store_erase_sector
+};
+
+static const flash_io_t file_config_io = {
+    .size = CONFIG_STORE_SIZE_BYTES,
+    .read = config_read,
+    .program = config_program,
+    .erase_sector = config_erase_sector
+};
+
+const flash_io_t* flash_io_file(const char* path) {
+    return file_open(&store_region, path) ? &file_flash_io : NULL;
+}
+
+const flash_io_t* flash_io_file_config(const char* path) {
+    return file_open(&config_region, path) ? &file_config_io : NULL;
+}
@@ -0,0 +1,197 @@
+/**
+ * @file flash_io_rp2040.c
+ * @brief Implementação de flash_io_t sobre a flash QSPI do RP2040.
+ *
+ * O XIP fica desativado durante a programação ou o apagamento. As funções
+ * de flash_io_rp2040_set_write_hooks() envolvem cada escrita e decidem se o
+ * outro núcleo já está retido na RAM ou se flash_safe_execute() o bloqueia.
+ */
+
+#include "flash_io.h"
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+
+#define FLASH_STORE_SIZE_BYTES     (FLASH_STORE_SIZE_KB * 1024u)
+#define FLASH_STORE_REGION_OFFSET  (PICO_FLASH_SIZE_BYTES - FLASH_STORE_SIZE_BYTES)
+#define CONFIG_STORE_SIZE_BYTES    (CONFIG_STORE_SIZE_KB * 1024u)
+#define CONFIG_STORE_REGION_OFFSET (FLASH_STORE_REGION_OFFSET - CONFIG_STORE_SIZE_BYTES)
+#define FLASH_SAFE_TIMEOUT_MS      100
+
+/**
+ * @brief Uma região da flash, em deslocamentos a partir do início da flash.
+ */
+typedef struct {
+    uint32_t base;
+    uint32_t size;
+} flash_region_t;
+
+static const flash_region_t store_region = { FLASH_STORE_REGION_OFFSET, FLASH_STORE_SIZE_BYTES };
+static const flash_region_t config_region = { CONFIG_STORE_REGION_OFFSET, CONFIG_STORE_SIZE_BYTES };
+
+static flash_io_write_mode_t (*write_begin)(void) = NULL;
+static void (*write_end)(void) = NULL;
+
+typedef struct {
+    uint32_t offset;
+    const uint8_t* data;
+} flash_program_args_t;
+
+static void flash_program_page(void* param) {
+    const flash_program_args_t* args = (const flash_program_args_t*)param;
+    flash_range_program(args->offset, args->data, FLASH_PAGE_SIZE);
+}
+
+static void flash_erase_sector(void* param) {
+    flash_range_erase((uint32_t)(uintptr_t)param, FLASH_SECTOR_SIZE);
+}
+
+static flash_io_write_mode_t rp2040_write_begin(void) {
+    return write_begin ? write_begin() : FLASH_IO_WRITE_LOCKOUT;
+}
+
+static void rp2040_write_end(void) {
+    if (write_end) {
+        write_end();
+    }
+}
+
+/**
+ * @brief Executa uma operação com o XIP desativado.
+ *
+ * Com o outro núcleo retido na RAM basta desativar as interrupções deste;
+ * caso contrário, flash_safe_execute() bloqueia também o outro núcleo.
+ */
+static int rp2040_execute(flash_io_write_mode_t mode, void (*func)(void*), void* param) {
+    if (mode == FLASH_IO_WRITE_HELD) {
+        uint32_t irq_status = save_and_disable_interrupts();
+        func(param);
+        restore_interrupts(irq_status);
+        return 0;
+    }
+    return (flash_safe_execute(func, param, FLASH_SAFE_TIMEOUT_MS) == PICO_OK) ? 0 : -1;
+}
+
+static int rp2040_read(const flash_region_t* region, uint32_t offset, void* buf, size_t len) {
+    if (offset + len > region->size) {
+        return -1;
+    }
+
+    // A flash está mapeada em memória através do XIP.
+    memcpy(buf, (const void*)(XIP_BASE + region->base + offset), len);
+    return 0;
+}
+
+static int rp2040_program(const flash_region_t* region, uint32_t offset, const void* buf, size_t len) {
+    static uint8_t page_buf[FLASH_PAGE_SIZE];
+    const uint8_t* src = (const uint8_t*)buf;
+
+    if (offset + len > region->size) {
+        return -1;
+    }
+
+    // O hardware só programa páginas inteiras: o restante da página é
+    // preenchido com 0xFF, que não altera os bytes já gravados. As páginas
+    // de uma chamada são programadas na mesma retenção.
+    flash_io_write_mode_t mode = rp2040_write_begin();
+    if (mode == FLASH_IO_WRITE_POSTPONE) {
+        rp2040_write_end();
+        return FLASH_IO_BUSY;
+    }
+    while (len > 0) {
+        uint32_t page_offset = offset & ~(FLASH_PAGE_SIZE - 1);
+        uint32_t in_page = offset - page_offset;
+        size_t chunk = FLASH_PAGE_SIZE - in_page;
+        if (chunk > len) {
+            chunk = len;
+        }
+
+        memset(page_buf, 0xFF, sizeof(page_buf));
+        memcpy(page_buf + in_page, src, chunk);
+
+        flash_program_args_t args = {
+            .offset = region->base + page_offset,
+            .data = page_buf
+        };
+        if (rp2040_execute(mode, flash_program_page, &args) != 0) {
+            rp2040_write_end();
+            return -1;
+        }
+
+        offset += chunk;
+        src += chunk;
+        len -= chunk;
+    }
+    rp2040_write_end();
+
+    return 0;
+}
+
+static int rp2040_erase_sector(const flash_region_t* region, uint32_t offset) {
+    if ((offset % FLASH_SECTOR_SIZE) != 0 || offset >= region->size) {
+        return -1;
+    }
+
+    uint32_t flash_offset = region->base + offset;
+    flash_io_write_mode_t mode = rp2040_write_begin();
+    int result = (mode == FLASH_IO_WRITE_POSTPONE)
+        ? FLASH_IO_BUSY
+        : rp2040_execute(mode, flash_erase_sector, (void*)(uintptr_t)flash_offset);
+    rp2040_write_end();
+    return result;
+}
+
+// flash_io_t não tem contexto: cada região tem as suas funções de entrada.
+
+static int store_read(uint32_t offset, void* buf, size_t len) {
+    return rp2040_read(&store_region, offset, buf, len);
+}
+
+static int store_program(uint32_t offset, const void* buf, size_t len) {
+    return rp2040_program(&store_region, offset, buf, len);
+}
+
+static int store_erase_sector(uint32_t offset) {
+    return rp2040_erase_sector(&store_region, offset);
+}
+
+static int config_read(uint32_t offset, void* buf, size_t len) {
+    return rp2040_read(&config_region, offset, buf, len);
+}
+
+static int config_program(uint32_t offset, const void* buf, size_t len) {
+    return rp2040_program(&config_region, offset, buf, len);
+}
+
+static int config_erase_sector(uint32_t offset) {
+    return rp2040_erase_sector(&config_region, offset);
+}
+
+static const flash_io_t rp2040_flash_io = {
+    .size = FLASH_STORE_SIZE_BYTES,
+    .read = store_read,
+    .program = store_program,
+    .erase_sector = store_erase_sector
+};
+
+static const flash_io_t rp2040_config_io = {
+    .size = CONFIG_STORE_SIZE_BYTES,
+    .read = config_read,
+    .program = config_program,
+    .erase_sector = config_erase_sector
+};
+
+const flash_io_t* flash_io_rp2040(void) {
+    return &rp2040_flash_io;
+}
+
+const flash_io_t* flash_io_rp2040_config(void) {
+    return &rp2040_config_io;
+}
+
+void flash_io_rp2040_set_write_hooks(flash_io_write_mode_t (*begin)(void), void (*end)(void)) {
+    write_begin = begin;
+    write_end = end;
+}
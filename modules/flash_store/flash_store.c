@@ -0,0 +1,469 @@
+/**
+ * @file flash_store.c
+ * @brief Implementação do buffer circular de leituras em flash.
+ *
+ * Layout: a região é uma sequência de registos de tamanho fixo (32 bytes
+ * com até seis sensores, ver flash_record_t). Cada registo
+ * tem um número de sequência crescente, que permite reencontrar a cabeça do
+ * log após um reinício, e um byte de flags que é programado em dois passos
+ * (gravado -> enviado) sem necessidade de apagar o setor.
+ *
+ * O instante `timestamp_ms` só tem significado no arranque em que foi
+ * medido: cada registo leva o número do arranque, que é o do registo mais
+ * recente da região mais um. Um arranque sem registos não consome número,
+ * e nenhuma escrita extra é necessária para o manter.
+ *
+ * Entre a cauda e a cabeça pode haver posições sem registo pendente: o
+ * registo de uma escrita interrompida e o resto do seu setor, abandonado
+ * pela escrita seguinte (ver flash_store_init()). A leitura e a marcação
+ * de envio percorrem as posições e saltam-nas.
+ */
+
+#include "flash_store.h"
+#include "../logger/logger.h"
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Bits do campo `flags`. Um bit limpo (0) indica que o evento ocorreu.
+#define FLASH_RECORD_FLAG_WRITTEN 0x01
+#define FLASH_RECORD_FLAG_SENT    0x02
+
+// Leituras aguardando a próxima sincronização com a flash.
+#define FLASH_STORE_STAGING_CAPACITY 32
+
+// Bytes de um registo sem enchimento (no mínimo 22, com um sensor), e o
+// tamanho arredondado à potência de 2 seguinte, para que uma página da flash
+// tenha um número inteiro de registos: 32 bytes até seis sensores, 64 acima.
+#define FLASH_RECORD_DATA_SIZE (20u + 2u * SENSOR_COUNT)
+#define FLASH_RECORD_SIZE      (FLASH_RECORD_DATA_SIZE <= 32u ? 32u : 64u)
+
+/**
+ * @struct flash_record_t
+ * @brief Formato binário de uma leitura gravada na flash.
+ *
+ * Os valores são guardados em centésimos da unidade de engenharia, pela
+ * ordem da tabela de sensores; um sensor ausente da leitura é guardado como
+ * FLASH_RECORD_ABSENT. Alterar a lista SENSORS muda o formato: os registos
+ * pendentes de um firmware anterior deixam de ser legíveis.
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t sequence;                  /**< Número de sequência do registo no log. */
+    uint32_t timestamp_ms;              /**< Instante da aquisição, em ms desde o arranque. */
+    uint64_t epoch_ms;                  /**< Instante da aquisição em tempo Unix (ms), 0 se desconhecido. */
+    uint16_t boot;                      /**< Número do arranque em que o registo foi gravado. */
+    int16_t values_centi[SENSOR_COUNT]; /**< Valor de cada sensor, em centésimos. */
+    uint8_t reserved[FLASH_RECORD_SIZE - FLASH_RECORD_DATA_SIZE]; /**< Enchimento, a 0xFF. */
+    uint8_t crc;                        /**< CRC-8 dos campos anteriores. */
+    uint8_t flags;                      /**< Estado do registo (FLASH_RECORD_FLAG_*). */
+} flash_record_t;
+
+_Static_assert(sizeof(flash_record_t) == FLASH_RECORD_SIZE, "flash_record_t fora do tamanho previsto");
+
+#define FLASH_RECORD_ABSENT INT16_MIN
+#define RECORDS_PER_PAGE   (FLASH_IO_PAGE_SIZE / FLASH_RECORD_SIZE)
+#define RECORDS_PER_SECTOR (FLASH_IO_SECTOR_SIZE / FLASH_RECORD_SIZE)
+
+// --- Variáveis de Estado do Módulo ---
+
+static const flash_io_t* flash_io = NULL;
+static uint32_t slot_count;     // Capacidade da região, em registos
+static uint32_t head_slot;      // Próxima posição de escrita
+static uint32_t tail_slot;      // Registo pendente mais antigo
+static uint32_t pending_count;  // Registos gravados que aguardam envio
+static uint32_t next_sequence;  // Sequência do próximo registo
+static uint16_t current_boot;   // Número deste arranque
+
+static batch_entry_t staged[FLASH_STORE_STAGING_CAPACITY];
+static size_t staged_count;
+
+// Intervalo de registos entregues cuja marcação ainda não foi gravada.
+static uint32_t sent_mark_slot;
+static uint32_t sent_mark_count;
+
+static uint8_t flash_record_crc(const flash_record_t* record) {
+    const uint8_t* bytes = (const uint8_t*)record;
+    uint8_t crc = 0;
+
+    for (size_t i = 0; i < offsetof(flash_record_t, crc); i++) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static bool flash_record_is_valid(const flash_record_t* record) {
+    return (record->flags & FLASH_RECORD_FLAG_WRITTEN) == 0 &&
+           record->crc == flash_record_crc(record);
+}
+
+static bool flash_record_is_pending(const flash_record_t* record) {
+    return flash_record_is_valid(record) && (record->flags & FLASH_RECORD_FLAG_SENT) != 0;
+}
+
+static bool flash_record_is_erased(const flash_record_t* record) {
+    const uint8_t* bytes = (const uint8_t*)record;
+    for (size_t i = 0; i < FLASH_RECORD_SIZE; i++) {
+        if (bytes[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int flash_record_read(uint32_t slot, flash_record_t* record) {
+    return flash_io->read(slot * FLASH_RECORD_SIZE, record, FLASH_RECORD_SIZE);
+}
+
+static int16_t to_centi(q16_t value) {
+    int32_t centi = q16_to_centi(value);
+    if (centi >= INT16_MAX) {
+        return INT16_MAX;
+    }
+    // INT16_MIN fica reservado para FLASH_RECORD_ABSENT.
+    if (centi <= INT16_MIN) {
+        return INT16_MIN + 1;
+    }
+    return (int16_t)centi;
+}
+
+static int16_t field_to_centi(const sensors_reading_t* reading, sensor_id_t id) {
+    if (!(reading->channels & SENSOR_CHANNEL(id))) {
+        return FLASH_RECORD_ABSENT;
+    }
+    return to_centi(sensors_reading_value(reading, id));
+}
+
+static q16_t field_from_centi(int16_t centi, sensor_id_t id, sensor_mask_t* channels) {
+    if (centi == FLASH_RECORD_ABSENT) {
+        return 0;
+    }
+    *channels |= SENSOR_CHANNEL(id);
+    return q16_from_centi(centi);
+}
+
+static void flash_record_encode(const batch_entry_t* entry, uint32_t sequence, flash_record_t* record) {
+    record->sequence = sequence;
+    record->timestamp_ms = entry->timestamp_ms;
+    record->epoch_ms = entry->epoch_ms;
+    record->boot = current_boot;
+    for (sensor_id_t id = 0; id < SENSOR_COUNT; id++) {
+        record->values_centi[id] = field_to_centi(&entry->reading, id);
+    }
+    memset(record->reserved, 0xFF, sizeof(record->reserved));
+    record->crc = flash_record_crc(record);
+    record->flags = (uint8_t)~FLASH_RECORD_FLAG_WRITTEN;
+}
+
+static void flash_record_decode(const flash_record_t* record, batch_entry_t* entry) {
+    entry->timestamp_ms = record->timestamp_ms;
+    entry->epoch_ms = record->epoch_ms;
+    entry->timestamp_unknown = (record->boot != current_boot);
+    entry->reading.channels = 0;
+    for (sensor_id_t id = 0; id < SENSOR_COUNT; id++) {
+        entry->reading.values[id] =
+            field_from_centi(record->values_centi[id], id, &entry->reading.channels);
+    }
+}
+
+static bool flash_slot_is_pending(uint32_t slot) {
+    flash_record_t record;
+    return flash_record_read(slot, &record) == 0 && flash_record_is_pending(&record);
+}
+
+/**
+ * @brief Primeira posição com um registo pendente a partir de `slot`, ou a cabeça.
+ */
+static uint32_t flash_store_next_pending(uint32_t slot) {
+    while (slot != head_slot && !flash_slot_is_pending(slot)) {
+        slot = (slot + 1) % slot_count;
+    }
+    return slot;
+}
+
+/**
+ * @brief Apaga o setor antes da primeira escrita nele.
+ *
+ * Se a cauda estiver nesse setor, a região está cheia: os registos pendentes
+ * mais antigos são descartados em favor dos novos.
+ */
+static flash_store_status_t flash_store_prepare_slot(uint32_t slot) {
+    if (slot % RECORDS_PER_SECTOR != 0) {
+        return FLASH_STORE_OK;
+    }
+
+    uint32_t sector_end = slot + RECORDS_PER_SECTOR;
+    if (pending_count > 0 && tail_slot >= slot && tail_slot < sector_end) {
+        uint32_t lost = 0;
+        for (uint32_t s = tail_slot; s < sector_end && lost < pending_count; s++) {
+            lost += flash_slot_is_pending(s) ? 1 : 0;
+        }
+        pending_count -= lost;
+        tail_slot = (pending_count > 0) ? flash_store_next_pending(sector_end % slot_count) : slot;
+        LOG_WARN("[AVISO] Armazenamento em flash cheio. %lu leituras antigas descartadas.\n",
+                 (unsigned long)lost);
+    }
+
+    int result = flash_io->erase_sector(slot * FLASH_RECORD_SIZE);
+    if (result != 0) {
+        return (result == FLASH_IO_BUSY) ? FLASH_STORE_BUSY : FLASH_STORE_IO_ERROR;
+    }
+    return FLASH_STORE_OK;
+}
+
+flash_store_status_t flash_store_init(const flash_io_t* io) {
+    if (io == NULL || io->size < FLASH_IO_SECTOR_SIZE || (io->size % FLASH_IO_SECTOR_SIZE) != 0) {
+        return FLASH_STORE_INVALID_PARAM;
+    }
+
+    flash_io = io;
+    slot_count = io->size / FLASH_RECORD_SIZE;
+    staged_count = 0;
+    sent_mark_count = 0;
+
+    // Passo 1: Localizar o registo mais recente (maior sequência).
+    flash_record_t record;
+    bool found = false;
+    uint32_t newest_slot = 0;
+    uint32_t newest_sequence = 0;
+    uint16_t newest_boot = 0;
+
+    for (uint32_t slot = 0; slot < slot_count; slot++) {
+        if (flash_record_read(slot, &record) != 0) {
+            flash_io = NULL;
+            return FLASH_STORE_IO_ERROR;
+        }
+        if (flash_record_is_valid(&record) && (!found || record.sequence > newest_sequence)) {
+            found = true;
+            newest_slot = slot;
+            newest_sequence = record.sequence;
+            newest_boot = record.boot;
+        }
+    }
+
+    head_slot = 0;
+    tail_slot = 0;
+    pending_count = 0;
+    next_sequence = 0;
+    current_boot = 0;
+
+    if (found) {
+        head_slot = (newest_slot + 1) % slot_count;
+        next_sequence = newest_sequence + 1;
+        current_boot = (uint16_t)(newest_boot + 1);
+        tail_slot = head_slot;
+
+        // Passo 2: A partir da posição mais antiga, o primeiro registo ainda
+        // não entregue é a cauda; daí até à cabeça contam-se os pendentes,
+        // saltando as posições abandonadas por escritas interrompidas.
+        for (uint32_t i = 0; i < slot_count; i++) {
+            uint32_t slot = (head_slot + i) % slot_count;
+            if (flash_slot_is_pending(slot)) {
+                tail_slot = slot;
+                break;
+            }
+        }
+        for (uint32_t slot = tail_slot; slot != head_slot; slot = (slot + 1) % slot_count) {
+            pending_count += flash_slot_is_pending(slot) ? 1 : 0;
+        }
+
+        // Passo 3: Uma escrita interrompida pode ter deixado lixo na cabeça;
+        // nesse caso, a escrita continua no início do setor seguinte.
+        if (head_slot % RECORDS_PER_SECTOR != 0 &&
+            flash_record_read(head_slot, &record) == 0 && !flash_record_is_erased(&record)) {
+            head_slot = ((head_slot / RECORDS_PER_SECTOR + 1) * RECORDS_PER_SECTOR) % slot_count;
+        }
+
+        if (pending_count == 0) {
+            tail_slot = head_slot;
+        }
+    }
+
+    LOG_INFO("[OK] Armazenamento em flash inicializado (%lu KB, %lu leituras pendentes).\n",
+             (unsigned long)(io->size / 1024), (unsigned long)pending_count);
+    return FLASH_STORE_OK;
+}
+
+flash_store_status_t flash_store_append(const batch_entry_t* entry) {
+    if (flash_io == NULL) {
+        return FLASH_STORE_NOT_INITIALIZED;
+    }
+    if (entry == NULL) {
+        return FLASH_STORE_INVALID_PARAM;
+    }
+
+    // Sem espaço na preparação: grava imediatamente para não perder a leitura.
+    if (staged_count >= FLASH_STORE_STAGING_CAPACITY) {
+        flash_store_status_t status = flash_store_sync();
+        if (status != FLASH_STORE_OK) {
+            return status;
+        }
+    }
+
+    staged[staged_count++] = *entry;
+    return FLASH_STORE_OK;
+}
+
+/**
+ * @brief Persiste as marcações de envio, agrupadas por página.
+ */
+static flash_store_status_t flash_store_sync_sent_marks(void) {
+    static uint8_t mark_buf[FLASH_IO_PAGE_SIZE];
+
+    while (sent_mark_count > 0) {
+        uint32_t slot = sent_mark_slot;
+        uint32_t count = RECORDS_PER_PAGE - (slot % RECORDS_PER_PAGE);
+        if (count > sent_mark_count) {
+            count = sent_mark_count;
+        }
+
+        // Apenas o byte de flags de cada registo é alterado; 0xFF preserva o resto.
+        memset(mark_buf, 0xFF, count * FLASH_RECORD_SIZE);
+        for (uint32_t i = 0; i < count; i++) {
+            mark_buf[i * FLASH_RECORD_SIZE + offsetof(flash_record_t, flags)] =
+                (uint8_t)~(FLASH_RECORD_FLAG_WRITTEN | FLASH_RECORD_FLAG_SENT);
+        }
+
+        int result = flash_io->program(slot * FLASH_RECORD_SIZE, mark_buf, count * FLASH_RECORD_SIZE);
+        if (result != 0) {
+            return (result == FLASH_IO_BUSY) ? FLASH_STORE_BUSY : FLASH_STORE_IO_ERROR;
+        }
+
+        sent_mark_slot = (slot + count) % slot_count;
+        sent_mark_count -= count;
+    }
+
+    return FLASH_STORE_OK;
+}
+
+/**
+ * @brief Remove da área de preparação as `written` leituras mais antigas.
+ */
+static void flash_store_drop_staged(size_t written) {
+    staged_count -= written;
+    memmove(staged, &staged[written], staged_count * sizeof(staged[0]));
+}
+
+/**
+ * @brief Grava as leituras preparadas, uma página por operação de programação.
+ *
+ * Se uma escrita for adiada, as leituras ainda por gravar ficam na área de
+ * preparação.
+ */
+static flash_store_status_t flash_store_sync_staged(void) {
+    flash_record_t chunk[RECORDS_PER_PAGE];
+    size_t index = 0;
+
+    while (index < staged_count) {
+        uint32_t slot = head_slot;
+        flash_store_status_t status = flash_store_prepare_slot(slot);
+        if (status != FLASH_STORE_OK) {
+            flash_store_drop_staged(index);
+            return status;
+        }
+
+        // Agrupa os registos que cabem no resto da página atual.
+        size_t count = 0;
+        do {
+            flash_record_encode(&staged[index], next_sequence + count, &chunk[count]);
+            count++;
+            index++;
+        } while (index < staged_count && ((slot + count) % RECORDS_PER_PAGE) != 0);
+
+        int result = flash_io->program(slot * FLASH_RECORD_SIZE, chunk, count * FLASH_RECORD_SIZE);
+        if (result != 0) {
+            flash_store_drop_staged(index - count);
+            return (result == FLASH_IO_BUSY) ? FLASH_STORE_BUSY : FLASH_STORE_IO_ERROR;
+        }
+
+        if (pending_count == 0) {
+            tail_slot = slot;
+        }
+        pending_count += count;
+        next_sequence += count;
+        head_slot = (slot + count) % slot_count;
+    }
+
+    staged_count = 0;
+    return FLASH_STORE_OK;
+}
+
+flash_store_status_t flash_store_sync(void) {
+    if (flash_io == NULL) {
+        return FLASH_STORE_NOT_INITIALIZED;
+    }
+
+    if (staged_count == 0 && sent_mark_count == 0) {
+        return FLASH_STORE_OK;
+    }
+
+    // As marcações vêm primeiro: o apagamento de um setor pela escrita de
+    // novos registos não pode ocorrer antes de elas serem gravadas.
+    flash_store_status_t status = flash_store_sync_sent_marks();
+    if (status == FLASH_STORE_OK) {
+        status = flash_store_sync_staged();
+    }
+
+    if (status == FLASH_STORE_BUSY) {
+        LOG_WARN("[AVISO] Escrita na flash adiada. %u leituras por gravar.\n", (unsigned)staged_count);
+    } else if (status != FLASH_STORE_OK) {
+        LOG_ERROR("[ERRO] Falha ao gravar na flash. %u leituras descartadas.\n", (unsigned)staged_count);
+        staged_count = 0;
+    }
+    return status;
+}
+
+size_t flash_store_peek(batch_entry_t* out, size_t max_count) {
+    if (flash_io == NULL || out == NULL) {
+        return 0;
+    }
+
+    size_t count = 0;
+    flash_record_t record;
+
+    for (uint32_t slot = tail_slot; count < max_count && count < pending_count && slot != head_slot;
+         slot = (slot + 1) % slot_count) {
+        if (flash_record_read(slot, &record) != 0) {
+            break;
+        }
+        if (flash_record_is_pending(&record)) {
+            flash_record_decode(&record, &out[count++]);
+        }
+    }
+
+    return count;
+}
+
+flash_store_status_t flash_store_consume(size_t count) {
+    if (flash_io == NULL) {
+        return FLASH_STORE_NOT_INITIALIZED;
+    }
+    if (count > pending_count) {
+        return FLASH_STORE_INVALID_PARAM;
+    }
+
+    if (count == 0) {
+        return FLASH_STORE_OK;
+    }
+
+    // As posições saltadas entre os registos entregues também são marcadas:
+    // a marcação é um intervalo contínuo, e nelas não há registos a perder.
+    uint32_t slot = tail_slot;
+    for (size_t consumed = 0; consumed < count && slot != head_slot; slot = (slot + 1) % slot_count) {
+        consumed += flash_slot_is_pending(slot) ? 1 : 0;
+    }
+    if (sent_mark_count == 0) {
+        sent_mark_slot = tail_slot;
+    }
+    sent_mark_count = (slot + slot_count - sent_mark_slot) % slot_count;
+
+    pending_count -= count;
+    tail_slot = (pending_count > 0) ? flash_store_next_pending(slot) : head_slot;
+    return FLASH_STORE_OK;
+}
+
+size_t flash_store_pending(void) {
+    return pending_count;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file flash_store.h
+ * @brief Interface pública do armazenamento persistente de leituras não enviadas.
+ *
+ * Implementa um buffer circular estruturado em log sobre uma região reservada
+ * da flash. Leituras que não puderam ser entregues ao servidor são anexadas
+ * como registos binários compactos (32 bytes com até seis sensores, 64
+ * acima disso) e drenadas por ordem de chegada quando a ligação volta. A região é percorrida sequencialmente,
+ * pelo que todos os setores sofrem o mesmo número de apagamentos.
+ *
+ * As operações que tocam na flash são adiadas para flash_store_sync(). Na
+ * placa cada escrita retém o outro núcleo num ciclo na RAM, que continua a
+ * aquisição do ADC (ver flash_io_rp2040_set_write_hooks()); se a retenção não
+ * for possível, a escrita é adiada para a sincronização seguinte.
+ */
+#ifndef FLASH_STORE_H
+#define FLASH_STORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "flash_io.h"
+#include "../batch_manager/batch_manager.h"
+
+/**
+ * @enum flash_store_status_t
+ * @brief Define os possíveis códigos de estado retornados pelo módulo flash_store.
+ */
+typedef enum {
+    FLASH_STORE_OK,              /**< A operação foi concluída com sucesso. */
+    FLASH_STORE_NOT_INITIALIZED, /**< A operação falhou porque o módulo não foi inicializado. */
+    FLASH_STORE_INVALID_PARAM,   /**< A operação falhou devido a um parâmetro inválido. */
+    FLASH_STORE_IO_ERROR,        /**< A flash reportou um erro de leitura, programação ou apagamento. */
+    FLASH_STORE_BUSY             /**< A escrita foi adiada sem tocar na flash; nada se perdeu. */
+} flash_store_status_t;
+
+/**
+ * @brief Inicializa o armazenamento, reconstruindo o estado a partir da flash.
+ *
+ * Percorre os registos gravados para localizar a cabeça (próxima posição de
+ * escrita) e a cauda (registo pendente mais antigo). Não escreve na flash.
+ *
+ * @param io Implementação de acesso à flash (ex: flash_io_rp2040()).
+ * @return FLASH_STORE_OK em caso de sucesso, ou um código de erro relevante.
+ */
+flash_store_status_t flash_store_init(const flash_io_t* io);
+
+/**
+ * @brief Acrescenta uma leitura ao armazenamento.
+ *
+ * A leitura é colocada numa área de preparação em RAM e só é gravada na
+ * próxima chamada a flash_store_sync(), salvo se essa área estiver cheia.
+ * Quando a região está cheia, os registos pendentes mais antigos são
+ * sobrescritos. Se a área estiver cheia e a escrita for adiada, a leitura
+ * não é guardada e a função retorna FLASH_STORE_BUSY.
+ *
+ * @param entry A leitura a ser guardada.
+ * @return FLASH_STORE_OK em caso de sucesso, ou um código de erro relevante.
+ */
+flash_store_status_t flash_store_append(const batch_entry_t* entry);
+
+/**
+ * @brief Grava na flash as leituras preparadas e as marcações de envio pendentes.
+ *
+ * Com FLASH_STORE_BUSY, o que não foi gravado fica para a próxima chamada.
+ *
+ * @return FLASH_STORE_OK em caso de sucesso, ou um código de erro relevante.
+ */
+flash_store_status_t flash_store_sync(void);
+
+/**
+ * @brief Copia as leituras pendentes mais antigas, sem as remover.
+ *
+ * @param out Array que receberá as leituras.
+ * @param max_count Capacidade de `out`.
+ * @return O número de leituras copiadas.
+ */
+size_t flash_store_peek(batch_entry_t* out, size_t max_count);
+
+/**
+ * @brief Marca como entregues as `count` leituras pendentes mais antigas.
+ *
+ * Deve ser chamada após o servidor confirmar as leituras obtidas com
+ * flash_store_peek(). A marcação é persistida na próxima sincronização.
+ *
+ * @param count Número de leituras entregues.
+ * @return FLASH_STORE_OK em caso de sucesso, ou um código de erro relevante.
+ */
+flash_store_status_t flash_store_consume(size_t count);
+
+/**
+ * @brief Retorna o número de leituras gravadas na flash que aguardam envio.
+ */
+size_t flash_store_pending(void);
+
+#endif // FLASH_STORE_H
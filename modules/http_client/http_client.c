@@ -1,27 +1,130 @@
 #include "http_client.h"
-#include "ethernet_manager.h" 
+#include "ethernet_manager.h"
 #include "socket.h"
+#include "../trace/trace.h"
+#include "../logger/logger.h"
 #include "pico/stdlib.h"
 #include <stdio.h>
 #include <string.h>
-#include <stdlib.h>
 
-#define HTTP_REQUEST_BUF_SIZE 512
-#define HTTP_RESPONSE_BUF_SIZE 512
+// Bytes acumulados antes de cada rajada SPI para a memória TX do socket
+#define HTTP_TX_STAGING_SIZE 64
+
+// Bytes lidos da memória RX do socket de cada vez para o analisador da resposta
+#define HTTP_RX_CHUNK_SIZE 64
+
+// Dígitos reservados para o Content-Length (corpo até 99999 bytes)
+#define HTTP_CONTENT_LENGTH_DIGITS 5
+
+// Maior Content-Type aceite nos modelos de cabeçalhos
+#define HTTP_CONTENT_TYPE_MAX 48
+
+// Content-Types distintos com modelo de cabeçalhos em cache (ex: JSON e CBOR)
+#define HTTP_HEADER_TEMPLATE_SLOTS 2
+
+#if HTTP_KEEP_ALIVE
+#define HTTP_CONNECTION_HEADER "keep-alive"
+#else
+#define HTTP_CONNECTION_HEADER "close"
+#endif
+
+// Eventos do socket sinalizados na INTn do W5500
+#define HTTP_SOCKET_EVENTS (Sn_IR_CON | Sn_IR_DISCON | Sn_IR_RECV | Sn_IR_TIMEOUT | Sn_IR_SENDOK)
+
+// Partes constantes dos cabeçalhos, antes e depois do Content-Type
+#define HTTP_HEADER_PREFIX "POST " TARGET_PATH " HTTP/1.1\r\n" \
+                           "Host: " TARGET_SERVER_IP "\r\n" \
+                           "Authorization: Bearer " BEARER_TOKEN "\r\n" \
+                           "Content-Type: "
+#define HTTP_HEADER_LENGTH_FIELD "\r\nContent-Length: "
+#define HTTP_HEADER_SUFFIX "\r\nConnection: " HTTP_CONNECTION_HEADER "\r\n\r\n"
+
+/**
+ * @brief Estado de uma requisição escrita diretamente na memória TX do socket.
+ *
+ * As posições são deslocamentos relativos ao início da requisição; o
+ * endereço na memória TX é o ponteiro Sn_TX_WR inicial mais o deslocamento,
+ * com a mesma aritmética de 16 bits usada pelo W5500.
+ */
+struct http_tx {
+    uint8_t socket;
+    uint16_t start_ptr;       /**< Sn_TX_WR no início da requisição. */
+    uint16_t capacity;        /**< Espaço livre na memória TX no início da requisição. */
+    uint32_t written;         /**< Bytes já transferidos para a memória TX. */
+    uint32_t length_offset;   /**< Posição do valor reservado para o Content-Length. */
+    uint32_t body_offset;     /**< Posição do primeiro byte do corpo. */
+    bool overflow;            /**< A requisição excedeu `capacity`. */
+    uint16_t staged;          /**< Bytes em `staging` ainda não transferidos. */
+    uint8_t staging[HTTP_TX_STAGING_SIZE];
+};
+
+/**
+ * @brief Bloco de cabeçalhos de um Content-Type, formatado uma única vez.
+ *
+ * Só o valor do Content-Length, de largura fixa, muda entre requisições:
+ * cada envio copia o bloco e preenche esse campo no fim.
+ */
+typedef struct {
+    uint16_t len;             /**< Tamanho do bloco; 0 = posição livre. */
+    uint16_t length_offset;   /**< Posição do valor reservado para o Content-Length. */
+    uint8_t content_type_len;
+    char text[sizeof(HTTP_HEADER_PREFIX) - 1 + HTTP_CONTENT_TYPE_MAX +
+              sizeof(HTTP_HEADER_LENGTH_FIELD) - 1 + HTTP_CONTENT_LENGTH_DIGITS +
+              sizeof(HTTP_HEADER_SUFFIX) - 1];
+} http_header_template_t;
+
+static http_header_template_t header_templates[HTTP_HEADER_TEMPLATE_SLOTS];
+static uint8_t header_template_evict;
+
+/**
+ * @brief Endereço do servidor, convertido de TARGET_SERVER_IP uma única vez.
+ */
+static uint8_t server_ip[4];
+static bool server_ip_parsed = false;
+
+/**
+ * @brief Destino dos cabeçalhos das respostas que o analisador não interpreta.
+ */
+static http_parser_header_fn response_header_handler = NULL;
+static void* response_header_context = NULL;
+
+/**
+ * @brief Conexões abertas, indexadas pelo socket do W5500.
+ */
+static http_connection_t* open_connections[W5500_SOCKET_COUNT];
+
+static void http_connection_close(http_connection_t* conn);
+
+/**
+ * @brief Fecha as conexões mantidas sem requisição em curso.
+ *
+ * O reset do W5500 perde todos os sockets; ethernet_restart() recusa-o
+ * enquanto algum estiver em uso. As conexões com requisição em curso
+ * mantêm-se e terminam pelo seu próprio prazo.
+ */
+static void http_close_idle_connections(void) {
+    for (uint8_t sn = 0; sn < W5500_SOCKET_COUNT; sn++) {
+        http_connection_t* conn = open_connections[sn];
+        if (conn != NULL && (conn->state == HTTP_STATE_IDLE || conn->state == HTTP_STATE_DONE)) {
+            http_connection_close(conn);
+        }
+    }
+}
 
 static bool is_network_ready() {
     if (ethernet_get_status() == ETHERNET_CONNECTED) {
         return true;
     }
 
-    printf("[AVISO] Ethernet desconectado. Tentando reconectar...\n");
+    LOG_WARN("[AVISO] Ethernet desconectado. Tentando reconectar...\n");
+    http_close_idle_connections();
     if (ethernet_restart() != 0) {
-        printf("[ERRO] Falha na reconexão Ethernet.\n");
+        LOG_ERROR("[ERRO] Falha na reconexão Ethernet.\n");
         return false;
     }
 
     // Se o restart foi bem-sucedido, o init interno já validou o link
-    printf("[OK] Ethernet reconectado com sucesso.\n");
+    LOG_INFO("[OK] Ethernet reconectado com sucesso.\n");
     return true;
 }
 
@@ -37,7 +140,7 @@ static int http_parse_ip_string(const char* ip_str, uint8_t* ip_bytes) {
     if (sscanf(ip_str, "%d.%d.%d.%d", &ip1, &ip2, &ip3, &ip4) != 4) {
         return -1;
     }
-    if (ip1 < 0 || ip1 > 255 || ip2 < 0 || ip2 > 255 || 
+    if (ip1 < 0 || ip1 > 255 || ip2 < 0 || ip2 > 255 ||
         ip3 < 0 || ip3 > 255 || ip4 < 0 || ip4 > 255) {
         return -1;
     }
@@ -48,124 +151,628 @@ static int http_parse_ip_string(const char* ip_str, uint8_t* ip_bytes) {
     return 0;
 }
 
-http_status_t http_send_sensor_data(float temperature, float conductivity, float flow) {
+/**
+ * @brief Encerra a conexão atual e contabiliza as requisições que ela atendeu.
+ */
+static void http_connection_close(http_connection_t* conn) {
+    if (!conn->open) {
+        return;
+    }
 
-    // Buffers estáticos para requisição e resposta
-    static uint8_t http_request_buf[HTTP_REQUEST_BUF_SIZE];
-    static uint8_t http_response_buf[HTTP_RESPONSE_BUF_SIZE];
+    disconnect(conn->socket);
+    close(conn->socket);
+    ethernet_socket_free(conn->socket);
+    open_connections[conn->socket] = NULL;
+    conn->open = false;
 
-    // Verificação de pré-condição: a rede está pronta?
-    if (!is_network_ready()) {
-        return HTTP_ERROR_CONNECT_FAILED; // Retorna um erro
+    conn->stats.last_connection_requests = conn->stats.current_connection_requests;
+    conn->stats.current_connection_requests = 0;
+    LOG_INFO("[INFO] Conexão TCP encerrada após %lu requisição(ões).\n",
+             (unsigned long)conn->stats.last_connection_requests);
+}
+
+/**
+ * @brief Verifica se a conexão mantida ainda está utilizável.
+ *
+ * O W5500 reflete no registrador Sn_SR o fecho iniciado pelo servidor
+ * (FIN -> SOCK_CLOSE_WAIT) ou um RST/timeout (SOCK_CLOSED). Nesses casos a
+ * conexão local é libertada para que o próximo envio reconecte.
+ */
+static bool http_connection_is_alive(http_connection_t* conn) {
+    if (!conn->open) {
+        return false;
+    }
+
+    if (getSn_SR(conn->socket) != SOCK_ESTABLISHED) {
+        LOG_WARN("[AVISO] Servidor encerrou a conexão TCP. Reconectando...\n");
+        http_connection_close(conn);
+        return false;
     }
 
-    uint8_t dest_ip[4];
-    if (http_parse_ip_string(TARGET_SERVER_IP, dest_ip) != 0) {
-        printf("[ERRO] IP do servidor inválido: %s\n", TARGET_SERVER_IP);
-        return HTTP_ERROR_INVALID_IP;
+    // Descarta bytes pendentes de respostas anteriores para não
+    // confundir a resposta da próxima requisição.
+    uint16_t stale_len = getSn_RX_RSR(conn->socket);
+    if (stale_len > 0) {
+        wiz_recv_ignore(conn->socket, stale_len);
+        setSn_CR(conn->socket, Sn_CR_RECV);
+        while (getSn_CR(conn->socket));
+    }
+
+    return true;
+}
+
+/**
+ * @brief Abre o socket e inicia a conexão TCP, sem esperar pelo handshake.
+ *
+ * O socket fica em modo não bloqueante: connect() apenas emite o comando
+ * CONNECT e o estabelecimento é sinalizado pelo evento Sn_IR_CON.
+ */
+static http_status_t http_connection_open(http_connection_t* conn) {
+    LOG_INFO("[INFO] Tentando conectar ao servidor %d.%d.%d.%d:%d...\n",
+             conn->dest_ip[0], conn->dest_ip[1], conn->dest_ip[2], conn->dest_ip[3], conn->dest_port);
+
+    // 1. Obter um socket livre do W5500 e criar o socket TCP
+    int sn = ethernet_socket_alloc();
+    if (sn < 0) {
+        LOG_ERROR("[ERRO] Nenhum socket do W5500 disponível.\n");
+        return HTTP_ERROR_SOCKET_CREATION;
     }
-    
-    uint16_t dest_port = TARGET_PORT;
-    const char* uri = TARGET_PATH;
-    uint8_t socket_num = 0;
+    conn->socket = (uint8_t)sn;
 
-    printf("[INFO] Tentando conectar ao servidor %d.%d.%d.%d:%d...\n", 
-           dest_ip[0], dest_ip[1], dest_ip[2], dest_ip[3], dest_port);
-    
-    // 1. Criar socket TCP
-    if (socket(socket_num, Sn_MR_TCP, 0, 0) != socket_num) {
-        printf("[ERRO] Falha ao criar socket TCP.\n");
+    if (socket(conn->socket, Sn_MR_TCP, 0, 0) != conn->socket) {
+        LOG_ERROR("[ERRO] Falha ao criar socket TCP.\n");
+        ethernet_socket_free(conn->socket);
         return HTTP_ERROR_SOCKET_CREATION;
     }
-    
-    // 2. Conectar ao servidor
-    if (connect(socket_num, dest_ip, dest_port) != SOCK_OK) {
-        printf("[ERRO] Falha ao conectar ao servidor.\n");
-        close(socket_num);
+
+    uint8_t io_mode = SOCK_IO_NONBLOCK;
+    ctlsocket(conn->socket, CS_SET_IOMODE, &io_mode);
+    ethernet_enable_socket_events(conn->socket, HTTP_SOCKET_EVENTS);
+
+    // 2. Iniciar a conexão ao servidor
+    conn->phase_start_us = trace_begin();
+    int8_t result = connect(conn->socket, conn->dest_ip, conn->dest_port);
+    if (result != SOCK_OK && result != SOCK_BUSY) {
+        LOG_ERROR("[ERRO] Falha ao conectar ao servidor.\n");
+        close(conn->socket);
+        ethernet_socket_free(conn->socket);
         return HTTP_ERROR_CONNECT_FAILED;
     }
-    printf("[OK] Conexão TCP estabelecida.\n");
-    
-    // 3. Preparar JSON payload
-    char json_payload[256];
-    int json_len = snprintf(json_payload, sizeof(json_payload),
-        "{\"temperature\":%.2f,\"conductivity\":%.2f,\"flow\":%.2f}",
-        temperature, conductivity, flow);
-    
-    if (json_len >= sizeof(json_payload)) {
-        printf("[ERRO] JSON payload muito grande\n");
-        disconnect(socket_num);
-        close(socket_num);
-        return HTTP_ERROR_REQUEST_TOO_LARGE;
+
+    conn->open = true;
+    open_connections[conn->socket] = conn;
+    return HTTP_OK;
+}
+
+/**
+ * @brief Transfere os bytes preparados para a memória TX, sem os enviar.
+ */
+static void http_tx_flush(http_tx_t* tx) {
+    if (tx->staged == 0 || tx->overflow) {
+        return;
     }
-    printf("[DADOS] Enviando JSON: %s\n", json_payload);
-    
-    // 4. Montar requisição HTTP completa
-    int request_len = snprintf((char*)http_request_buf, HTTP_REQUEST_BUF_SIZE,
-        "POST %s HTTP/1.1\r\n"
-        "Host: %s\r\n"
-        "Authorization: Bearer %s\r\n"
-        "Content-Type: application/json\r\n"
-        "Content-Length: %d\r\n"
-        "Connection: close\r\n"
-        "\r\n"
-        "%s",
-        uri, TARGET_SERVER_IP, BEARER_TOKEN, json_len, json_payload);
-
-    if (request_len >= HTTP_REQUEST_BUF_SIZE) {
-        printf("[ERRO] Requisição HTTP muito grande\n");
-        disconnect(socket_num);
-        close(socket_num);
-        return HTTP_ERROR_REQUEST_TOO_LARGE;
+
+    if (tx->written + tx->staged > tx->capacity) {
+        tx->overflow = true;
+        return;
+    }
+
+    // wiz_send_data escreve a partir de Sn_TX_WR e avança o ponteiro.
+    wiz_send_data(tx->socket, tx->staging, tx->staged);
+    tx->written += tx->staged;
+    tx->staged = 0;
+}
+
+void http_tx_write(http_tx_t* tx, const void* data, size_t len) {
+    const uint8_t* bytes = (const uint8_t*)data;
+
+    // Blocos longos (ex: os cabeçalhos pré-formatados) seguem numa só
+    // rajada, sem cópia para o buffer de preparação.
+    if (tx->staged == 0 && len >= HTTP_TX_STAGING_SIZE && !tx->overflow) {
+        if (tx->written + len > tx->capacity) {
+            tx->overflow = true;
+            return;
+        }
+        wiz_send_data(tx->socket, (uint8_t*)bytes, (uint16_t)len);
+        tx->written += len;
+        return;
+    }
+
+    while (len > 0 && !tx->overflow) {
+        size_t chunk = HTTP_TX_STAGING_SIZE - tx->staged;
+        if (chunk > len) {
+            chunk = len;
+        }
+
+        memcpy(tx->staging + tx->staged, bytes, chunk);
+        tx->staged += chunk;
+        bytes += chunk;
+        len -= chunk;
+
+        if (tx->staged == HTTP_TX_STAGING_SIZE) {
+            http_tx_flush(tx);
+        }
+    }
+}
+
+/**
+ * @brief Escreve o valor do Content-Length na posição reservada nos cabeçalhos.
+ *
+ * O valor é alinhado à direita com espaços, que o HTTP aceita como espaço
+ * opcional antes do valor do campo.
+ */
+static bool http_tx_patch_content_length(http_tx_t* tx, uint32_t body_len) {
+    uint8_t digits[HTTP_CONTENT_LENGTH_DIGITS];
+    size_t pos = sizeof(digits);
+
+    memset(digits, ' ', sizeof(digits));
+    do {
+        if (pos == 0) {
+            return false;
+        }
+        digits[--pos] = (uint8_t)('0' + body_len % 10);
+        body_len /= 10;
+    } while (body_len > 0);
+
+    uint16_t ptr = (uint16_t)(tx->start_ptr + tx->length_offset);
+    uint32_t addrsel = ((uint32_t)ptr << 8) + (WIZCHIP_TXBUF_BLOCK(tx->socket) << 3);
+    WIZCHIP_WRITE_BUF(addrsel, digits, HTTP_CONTENT_LENGTH_DIGITS);
+    return true;
+}
+
+/**
+ * @brief Obtém o bloco de cabeçalhos de um Content-Type, formatando-o na primeira utilização.
+ *
+ * @return O modelo, ou NULL se o Content-Type exceder HTTP_CONTENT_TYPE_MAX.
+ */
+static const http_header_template_t* http_header_template(const char* content_type) {
+    size_t type_len = strlen(content_type);
+    const size_t prefix_len = sizeof(HTTP_HEADER_PREFIX) - 1;
+
+    if (type_len > HTTP_CONTENT_TYPE_MAX) {
+        return NULL;
     }
-    
-    // 5. Enviar requisição
-    if (send(socket_num, http_request_buf, request_len) < 0) {
-        printf("[ERRO] Falha ao enviar requisição HTTP.\n");
-        disconnect(socket_num);
-        close(socket_num);
+
+    http_header_template_t* slot = NULL;
+    for (size_t i = 0; i < HTTP_HEADER_TEMPLATE_SLOTS; i++) {
+        http_header_template_t* candidate = &header_templates[i];
+        if (candidate->len != 0 && candidate->content_type_len == type_len &&
+            memcmp(candidate->text + prefix_len, content_type, type_len) == 0) {
+            return candidate;
+        }
+        if (slot == NULL && candidate->len == 0) {
+            slot = candidate;
+        }
+    }
+
+    // Todas as posições ocupadas: substitui-as à vez.
+    if (slot == NULL) {
+        slot = &header_templates[header_template_evict];
+        header_template_evict = (uint8_t)((header_template_evict + 1) % HTTP_HEADER_TEMPLATE_SLOTS);
+    }
+
+    char* cursor = slot->text;
+    memcpy(cursor, HTTP_HEADER_PREFIX, prefix_len);
+    cursor += prefix_len;
+    memcpy(cursor, content_type, type_len);
+    cursor += type_len;
+    memcpy(cursor, HTTP_HEADER_LENGTH_FIELD, sizeof(HTTP_HEADER_LENGTH_FIELD) - 1);
+    cursor += sizeof(HTTP_HEADER_LENGTH_FIELD) - 1;
+    slot->length_offset = (uint16_t)(cursor - slot->text);
+    memset(cursor, ' ', HTTP_CONTENT_LENGTH_DIGITS);
+    cursor += HTTP_CONTENT_LENGTH_DIGITS;
+    memcpy(cursor, HTTP_HEADER_SUFFIX, sizeof(HTTP_HEADER_SUFFIX) - 1);
+    cursor += sizeof(HTTP_HEADER_SUFFIX) - 1;
+
+    slot->content_type_len = (uint8_t)type_len;
+    slot->len = (uint16_t)(cursor - slot->text);
+    return slot;
+}
+
+/**
+ * @brief Escreve cabeçalhos e corpo na memória TX do socket e emite o comando SEND.
+ */
+static http_status_t http_send_request(http_connection_t* conn, uint32_t* body_len_out) {
+    http_tx_t tx;
+
+    if (getSn_SR(conn->socket) != SOCK_ESTABLISHED) {
         return HTTP_ERROR_SEND_FAILED;
     }
-    printf("[OK] Requisição enviada. Aguardando resposta...\n");
-    
-    // 6. Aguardar e ler resposta com timeout
-    uint32_t timeout = 0;
-    while (getSn_RX_RSR(socket_num) == 0 && timeout < HTTP_TIMEOUT_MS) {
-        sleep_ms(10);
-        timeout += 10;
-    }
-    
-    if (timeout >= HTTP_TIMEOUT_MS) {
-        printf("[AVISO] Timeout na resposta do servidor\n");
-        disconnect(socket_num);
-        close(socket_num);
-        return HTTP_ERROR_TIMEOUT;
-    }
-    
-    int32_t response_len = recv(socket_num, http_response_buf, HTTP_RESPONSE_BUF_SIZE - 1);
-    if (response_len <= 0) {
-        printf("[ERRO] Falha ao receber dados do servidor. Código: %ld\n", response_len);
-        disconnect(socket_num);
-        close(socket_num);
-        return HTTP_ERROR_RECV_FAILED;
-    }
-    
-    http_response_buf[response_len] = '\0';
-    printf("[INFO] Resposta do servidor:\n%s\n", (char*)http_response_buf);
-
-    // 7. Analisar o código de estado HTTP
-    if (strstr((char*)http_response_buf, "HTTP/1.1 200 OK") == NULL &&
-        strstr((char*)http_response_buf, "HTTP/1.1 201 Created") == NULL) {
-        printf("[ERRO] Servidor respondeu com um código de estado de erro.\n");
-        disconnect(socket_num);
-        close(socket_num);
-        return HTTP_ERROR_SERVER_REJECTED;
-    }
-
-    // 8. Fechar conexão
-    disconnect(socket_num);
-    close(socket_num);
-    
-    printf("[OK] Ciclo de envio concluído com sucesso.\n");
+
+    const http_header_template_t* header = http_header_template(conn->content_type);
+    if (header == NULL) {
+        return HTTP_ERROR_REQUEST_TOO_LARGE;
+    }
+
+    uint64_t encode_start_us = trace_begin();
+
+    tx.socket = conn->socket;
+    tx.start_ptr = getSn_TX_WR(conn->socket);
+    tx.capacity = getSn_TX_FSR(conn->socket);
+    tx.written = 0;
+    tx.staged = 0;
+    tx.overflow = false;
+
+    // Os cabeçalhos são constantes exceto o Content-Length, cujo valor só
+    // é conhecido depois de o corpo ser escrito: o modelo reserva o espaço.
+    http_tx_write(&tx, header->text, header->len);
+    tx.length_offset = header->length_offset;
+    tx.body_offset = header->len;
+
+    bool body_ok = conn->write_body(&tx, conn->context);
+    http_tx_flush(&tx);
+
+    uint32_t body_len = tx.written - tx.body_offset;
+    http_status_t status = HTTP_OK;
+
+    if (!body_ok) {
+        status = HTTP_ERROR_ENCODE_FAILED;
+    } else if (tx.overflow || !http_tx_patch_content_length(&tx, body_len)) {
+        status = HTTP_ERROR_REQUEST_TOO_LARGE;
+    }
+
+    if (status != HTTP_OK) {
+        // Descarta o que foi escrito: nada chegou a ser enviado.
+        setSn_TX_WR(conn->socket, tx.start_ptr);
+        return status;
+    }
+
+    trace_end(TRACE_ENCODE, encode_start_us);
+
+    // A confirmação chega depois como evento Sn_IR_SENDOK.
+    setSn_CR(conn->socket, Sn_CR_SEND);
+    while (getSn_CR(conn->socket));
+    conn->phase_start_us = trace_begin();
+
+    *body_len_out = body_len;
     return HTTP_OK;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Termina a requisição em curso com o resultado indicado.
+ */
+static void http_request_finish(http_connection_t* conn, http_status_t status) {
+    conn->status = status;
+    conn->state = HTTP_STATE_DONE;
+
+    // A conexão só é mantida após uma troca bem-sucedida e com keep-alive
+    // aceite pelo servidor.
+    if (status != HTTP_OK || !HTTP_KEEP_ALIVE || !conn->response.keep_alive) {
+        http_connection_close(conn);
+    } else {
+        // Inativa até à próxima requisição: um fecho pelo servidor não
+        // pode manter a INTn ativa enquanto a tarefa espera por outros sockets.
+        ethernet_disable_socket_events(conn->socket);
+    }
+}
+
+static void http_request_send_failed(http_connection_t* conn);
+
+/**
+ * @brief Escreve a requisição na conexão aberta e passa a aguardar o SENDOK.
+ */
+static void http_request_send(http_connection_t* conn) {
+    http_status_t status = http_send_request(conn, &conn->body_len);
+    if (status == HTTP_ERROR_SEND_FAILED) {
+        http_request_send_failed(conn);
+        return;
+    }
+
+    if (status != HTTP_OK) {
+        if (status == HTTP_ERROR_REQUEST_TOO_LARGE) {
+            LOG_ERROR("[ERRO] Requisição HTTP muito grande\n");
+        }
+        http_request_finish(conn, status);
+        return;
+    }
+
+    conn->state = HTTP_STATE_SENDING;
+}
+
+/**
+ * @brief Trata a falha de envio numa conexão, reabrindo-a uma vez se era reutilizada.
+ *
+ * Uma conexão reutilizada pode ter sido fechada pelo servidor entre a
+ * verificação de estado e o envio.
+ */
+static void http_request_send_failed(http_connection_t* conn) {
+    bool was_reused = conn->stats.current_connection_requests > 0;
+    http_connection_close(conn);
+
+    if (was_reused && !conn->retried &&
+        http_connection_open(conn) == HTTP_OK) {
+        conn->retried = true;
+        conn->state = HTTP_STATE_CONNECTING;
+        return;
+    }
+
+    LOG_ERROR("[ERRO] Falha ao enviar requisição HTTP.\n");
+    http_request_finish(conn, HTTP_ERROR_SEND_FAILED);
+}
+
+/**
+ * @brief Passa ao analisador os bytes disponíveis no buffer RX.
+ *
+ * Os bytes são lidos em pequenos blocos e descartados depois de analisados;
+ * bytes após o fim da resposta não pertencem a nenhuma requisição.
+ */
+static void http_request_receive(http_connection_t* conn, uint16_t available) {
+    uint8_t chunk[HTTP_RX_CHUNK_SIZE];
+
+    while (available > 0 && !http_parser_is_done(&conn->response) &&
+           !http_parser_has_error(&conn->response)) {
+        uint16_t len = (available < sizeof(chunk)) ? available : (uint16_t)sizeof(chunk);
+
+        wiz_recv_data(conn->socket, chunk, len);
+        setSn_CR(conn->socket, Sn_CR_RECV);
+        while (getSn_CR(conn->socket));
+
+        http_parser_feed(&conn->response, chunk, len);
+        available -= len;
+    }
+}
+
+/**
+ * @brief Conclui com sucesso uma requisição cujo corpo de resposta não chegou inteiro.
+ *
+ * A linha de estado 2xx já confirmou o envio: repeti-lo duplicaria as
+ * leituras no servidor. A conexão, com o resto do corpo por ler, é fechada.
+ */
+static void http_request_finish_body_cut(http_connection_t* conn) {
+    trace_end(TRACE_RECV, conn->phase_start_us);
+    conn->response.keep_alive = false;
+    http_request_finish(conn, HTTP_OK);
+}
+
+/**
+ * @brief Avalia a resposta após novos bytes ou após o fecho da conexão.
+ */
+static void http_request_check_response(http_connection_t* conn) {
+    http_parser_t* response = &conn->response;
+
+    if (http_parser_has_error(response)) {
+        // O erro pode estar no corpo que chegou no mesmo bloco que os cabeçalhos.
+        if (response->headers_complete && response->status_code >= 200 && response->status_code <= 299) {
+            LOG_WARN("[AVISO] Corpo da resposta mal formado; envio já confirmado.\n");
+            http_request_finish_body_cut(conn);
+            return;
+        }
+        LOG_ERROR("[ERRO] Resposta HTTP mal formada ou incompleta.\n");
+        http_request_finish(conn, HTTP_ERROR_RECV_FAILED);
+        return;
+    }
+
+    if (conn->state == HTTP_STATE_AWAIT_HEADERS && response->headers_complete) {
+        LOG_INFO("[INFO] Resposta do servidor: HTTP/1.%u %u\n",
+                 response->version_minor, response->status_code);
+
+        // 6. Analisar o código de estado HTTP
+        if (response->status_code < 200 || response->status_code > 299) {
+            trace_end(TRACE_RECV, conn->phase_start_us);
+            LOG_ERROR("[ERRO] Servidor respondeu com um código de estado de erro.\n");
+            if (response->retry_after_s != HTTP_PARSER_NO_RETRY_AFTER) {
+                LOG_WARN("[AVISO] Servidor pede nova tentativa após %lu s.\n",
+                         (unsigned long)response->retry_after_s);
+            }
+            http_request_finish(conn, HTTP_ERROR_SERVER_REJECTED);
+            return;
+        }
+
+        // O corpo da resposta não é usado, mas tem de ser consumido para não
+        // contaminar a próxima resposta na mesma conexão.
+        conn->state = HTTP_STATE_AWAIT_BODY;
+    }
+
+    if (http_parser_is_done(response)) {
+        trace_end(TRACE_RECV, conn->phase_start_us);
+        http_request_finish(conn, HTTP_OK);
+    }
+}
+
+http_status_t http_request_begin(http_connection_t* conn, http_body_writer_t write_body, void* context, const char* content_type) {
+    if (write_body == NULL || content_type == NULL) {
+        return HTTP_ERROR_ENCODE_FAILED;
+    }
+
+    if (conn->state != HTTP_STATE_IDLE && conn->state != HTTP_STATE_DONE) {
+        return HTTP_ERROR_BUSY;
+    }
+
+    // Verificação de pré-condição: a rede está pronta?
+    if (!is_network_ready()) {
+        http_connection_close(conn);
+        return HTTP_ERROR_CONNECT_FAILED; // Retorna um erro
+    }
+
+    if (!server_ip_parsed) {
+        if (http_parse_ip_string(TARGET_SERVER_IP, server_ip) != 0) {
+            LOG_ERROR("[ERRO] IP do servidor inválido: %s\n", TARGET_SERVER_IP);
+            return HTTP_ERROR_INVALID_IP;
+        }
+        server_ip_parsed = true;
+    }
+
+    memcpy(conn->dest_ip, server_ip, sizeof(conn->dest_ip));
+
+    conn->dest_port = TARGET_PORT;
+    conn->write_body = write_body;
+    conn->context = context;
+    conn->content_type = content_type;
+    conn->retried = false;
+    conn->body_len = 0;
+    http_parser_init(&conn->response);
+    http_parser_set_header_handler(&conn->response, response_header_handler, response_header_context);
+    conn->deadline_ms = to_ms_since_boot(get_absolute_time()) + HTTP_TIMEOUT_MS;
+
+    // 1-2. Obter uma conexão TCP (reutilizada ou nova)
+    if (http_connection_is_alive(conn)) {
+        // Eventos antigos da conexão mantida não dizem respeito a esta requisição.
+        setSn_IR(conn->socket, getSn_IR(conn->socket));
+        ethernet_enable_socket_events(conn->socket, HTTP_SOCKET_EVENTS);
+        http_request_send(conn);
+    } else {
+        http_status_t conn_status = http_connection_open(conn);
+        if (conn_status != HTTP_OK) {
+            conn->state = HTTP_STATE_IDLE;
+            return conn_status;
+        }
+        conn->state = HTTP_STATE_CONNECTING;
+    }
+
+    return (conn->state == HTTP_STATE_DONE) ? conn->status : HTTP_OK;
+}
+
+http_request_state_t http_request_step(http_connection_t* conn, http_status_t* status_out) {
+    if (conn->state != HTTP_STATE_IDLE && conn->state != HTTP_STATE_DONE) {
+        // Lê e limpa os eventos pendentes, libertando a INTn.
+        uint8_t events = getSn_IR(conn->socket);
+        if (events) {
+            setSn_IR(conn->socket, events);
+        }
+        uint8_t sock_status = getSn_SR(conn->socket);
+
+        switch (conn->state) {
+        case HTTP_STATE_CONNECTING:
+            if (sock_status == SOCK_ESTABLISHED) {
+                trace_end(TRACE_CONNECT, conn->phase_start_us);
+                LOG_INFO("[OK] Conexão TCP estabelecida.\n");
+                conn->stats.connections_opened++;
+                http_request_send(conn);
+            } else if ((events & (Sn_IR_TIMEOUT | Sn_IR_DISCON)) || sock_status == SOCK_CLOSED) {
+                LOG_ERROR("[ERRO] Falha ao conectar ao servidor.\n");
+                http_request_finish(conn, HTTP_ERROR_CONNECT_FAILED);
+            }
+            break;
+
+        case HTTP_STATE_SENDING:
+            if (!(events & Sn_IR_SENDOK)) {
+                if ((events & Sn_IR_TIMEOUT) || sock_status == SOCK_CLOSED) {
+                    http_request_send_failed(conn);
+                }
+                break;
+            }
+            trace_end(TRACE_SEND, conn->phase_start_us);
+            conn->phase_start_us = trace_begin();
+            conn->stats.current_connection_requests++;
+            LOG_DEBUG("[DADOS] Enviado %s (%lu bytes).\n", conn->content_type,
+                      (unsigned long)conn->body_len);
+            LOG_INFO("[OK] Requisição enviada. Aguardando resposta...\n");
+            conn->state = HTTP_STATE_AWAIT_HEADERS;
+            // A resposta pode ter chegado junto com o SENDOK: o seu Sn_IR_RECV
+            // acabou de ser limpo e não voltará a acionar a INTn.
+            // fall through
+
+        case HTTP_STATE_AWAIT_HEADERS:
+        case HTTP_STATE_AWAIT_BODY: {
+            uint16_t available = getSn_RX_RSR(conn->socket);
+            if (available > 0) {
+                http_request_receive(conn, available);
+                http_request_check_response(conn);
+            } else if (sock_status != SOCK_ESTABLISHED) {
+                // Sem mais dados a chegar: conclui um corpo delimitado pelo fecho.
+                http_parser_finish(&conn->response);
+                if (conn->state == HTTP_STATE_AWAIT_BODY) {
+                    // A linha de estado já confirmou o envio; um fecho antecipado
+                    // do corpo apenas impede a reutilização da conexão.
+                    http_request_finish(conn, HTTP_OK);
+                } else {
+                    // Um RST ou FIN sem resposta: não há nada a aguardar.
+                    LOG_ERROR("[ERRO] Falha ao receber dados do servidor. Estado: 0x%02x\n", sock_status);
+                    http_request_finish(conn, HTTP_ERROR_RECV_FAILED);
+                }
+            }
+            break;
+        }
+
+        default:
+            break;
+        }
+
+        if (conn->state != HTTP_STATE_DONE &&
+            (int32_t)(to_ms_since_boot(get_absolute_time()) - conn->deadline_ms) >= 0) {
+            if (conn->state == HTTP_STATE_AWAIT_BODY) {
+                LOG_WARN("[AVISO] Timeout no corpo da resposta; envio já confirmado.\n");
+                http_request_finish_body_cut(conn);
+            } else {
+                LOG_WARN("[AVISO] Timeout na resposta do servidor\n");
+                http_request_finish(conn, conn->state == HTTP_STATE_CONNECTING
+                                    ? HTTP_ERROR_CONNECT_FAILED : HTTP_ERROR_TIMEOUT);
+            }
+        }
+    }
+
+    if (conn->state == HTTP_STATE_DONE && status_out) {
+        *status_out = conn->status;
+    }
+    return conn->state;
+}
+
+void http_request_run(http_connection_t* const* conns, size_t count) {
+    while (1) {
+        bool pending = false;
+        uint32_t wait_ms = HTTP_TIMEOUT_MS;
+        uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+
+        for (size_t i = 0; i < count; i++) {
+            http_request_state_t state = http_request_step(conns[i], NULL);
+            if (state == HTTP_STATE_IDLE || state == HTTP_STATE_DONE) {
+                continue;
+            }
+
+            pending = true;
+            int32_t remaining_ms = (int32_t)(conns[i]->deadline_ms - now_ms);
+            if (remaining_ms < 0) {
+                remaining_ms = 0;
+            }
+            if ((uint32_t)remaining_ms < wait_ms) {
+                wait_ms = (uint32_t)remaining_ms;
+            }
+        }
+
+        if (!pending) {
+            return;
+        }
+
+        // 5. Aguardar o próximo evento de qualquer socket; o prazo de cada
+        // requisição é verificado no passo seguinte.
+        ethernet_wait_event(wait_ms);
+    }
+}
+
+http_status_t http_post_stream(http_connection_t* conn, http_body_writer_t write_body,
+                               void* context, const char* content_type) {
+    http_status_t status = http_request_begin(conn, write_body, context, content_type);
+    if (status != HTTP_OK) {
+        return status;
+    }
+
+    http_request_run(&conn, 1);
+    http_request_step(conn, &status);
+
+    if (status == HTTP_OK) {
+        LOG_INFO("[OK] Ciclo de envio concluído com sucesso.\n");
+    }
+    return status;
+}
+
+void http_get_connection_stats(const http_connection_t* conn, http_connection_stats_t* stats) {
+    if (conn && stats) {
+        *stats = conn->stats;
+    }
+}
+
+void http_get_response_info(const http_connection_t* conn, uint16_t* status_code, uint32_t* retry_after_s) {
+    bool answered = conn->response.headers_complete;
+
+    if (status_code) {
+        *status_code = answered ? conn->response.status_code : 0;
+    }
+    if (retry_after_s) {
+        *retry_after_s = answered ? conn->response.retry_after_s : HTTP_PARSER_NO_RETRY_AFTER;
+    }
+}
+
+void http_set_response_header_handler(http_parser_header_fn handler, void* context) {
+    response_header_context = context;
+    response_header_handler = handler;
+}
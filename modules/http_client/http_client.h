@@ -8,6 +8,9 @@
 #define HTTP_CLIENT_H
 
 #include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "../http_parser/http_parser.h"
 
 /**
  * @enum http_status_t
@@ -18,29 +21,190 @@ typedef enum {
     HTTP_ERROR_INVALID_IP,      /**< O endereço IP do servidor fornecido é inválido. */
     HTTP_ERROR_SOCKET_CREATION, /**< Falha ao alocar um socket para a comunicação. */
     HTTP_ERROR_CONNECT_FAILED,  /**< Falha ao estabelecer a conexão TCP com o servidor. */
-    HTTP_ERROR_REQUEST_TOO_LARGE,/**< O payload da requisição excedeu o tamanho do buffer. */
+    HTTP_ERROR_REQUEST_TOO_LARGE,/**< A requisição excedeu o espaço livre do buffer TX do socket. */
+    HTTP_ERROR_ENCODE_FAILED,   /**< A função de escrita do corpo abortou a requisição. */
     HTTP_ERROR_SEND_FAILED,     /**< Ocorreu um erro durante o envio dos dados pela rede. */
     HTTP_ERROR_TIMEOUT,         /**< O servidor não respondeu dentro do tempo limite esperado. */
     HTTP_ERROR_SERVER_REJECTED, /**< O servidor respondeu com um código de erro HTTP (ex: 4xx, 5xx). */
-    HTTP_ERROR_RECV_FAILED      /**< Falha ao receber dados do servidor após o envio. */
+    HTTP_ERROR_RECV_FAILED,     /**< Falha ao receber dados do servidor após o envio. */
+    HTTP_ERROR_BUSY             /**< Já existe uma requisição em curso. */
 } http_status_t;
 
 /**
- * @brief Envia os dados dos sensores para o servidor configurado via HTTP POST.
+ * @enum http_request_state_t
+ * @brief Estados de uma requisição, avançados por http_request_step().
+ */
+typedef enum {
+    HTTP_STATE_IDLE,          /**< Nenhuma requisição iniciada. */
+    HTTP_STATE_CONNECTING,    /**< À espera do estabelecimento da conexão TCP. */
+    HTTP_STATE_SENDING,       /**< Requisição na memória TX, à espera da confirmação SENDOK. */
+    HTTP_STATE_AWAIT_HEADERS, /**< À espera da linha de estado e dos cabeçalhos da resposta. */
+    HTTP_STATE_AWAIT_BODY,    /**< A descartar o corpo da resposta (Content-Length, chunked ou até ao fecho). */
+    HTTP_STATE_DONE           /**< Requisição concluída; o resultado está disponível. */
+} http_request_state_t;
+
+/**
+ * @struct http_connection_stats_t
+ * @brief Estatísticas de reutilização da conexão TCP com o servidor.
+ */
+typedef struct {
+    uint32_t connections_opened;          /**< Total de conexões TCP abertas desde o arranque. */
+    uint32_t current_connection_requests; /**< Requisições atendidas pela conexão atualmente aberta. */
+    uint32_t last_connection_requests;    /**< Requisições atendidas pela última conexão encerrada. */
+} http_connection_stats_t;
+
+/**
+ * @brief Escritor de uma requisição em curso, diretamente na memória TX do socket.
+ */
+typedef struct http_tx http_tx_t;
+
+/**
+ * @brief Função que escreve o corpo de uma requisição com http_tx_write().
+ *
+ * Pode ser chamada mais de uma vez para a mesma requisição (reenvio após
+ * reconexão), pelo que deve produzir sempre o mesmo corpo.
  *
- * Esta função encapsula todo o ciclo de vida de uma requisição HTTP:
- * 1. Criação do socket TCP.
- * 2. Conexão com o servidor.
- * 3. Formatação do payload JSON e dos cabeçalhos HTTP.
- * 4. Envio da requisição.
- * 5. Espera e validação da resposta do servidor.
- * 6. Encerramento da conexão.
+ * @param tx O escritor da requisição.
+ * @param context O contexto passado a http_post_stream().
+ * @return true se o corpo foi escrito, false para abortar a requisição.
+ */
+typedef bool (*http_body_writer_t)(http_tx_t* tx, void* context);
+
+/**
+ * @struct http_connection_t
+ * @brief Uma conexão ao servidor e a requisição que nela decorre.
  *
- * @param temperature O valor da temperatura a ser enviado.
- * @param conducitivity O valor da concentração a ser enviado.
- * @param flow O valor da vazão a ser enviado.
+ * Cada conexão obtém um socket do W5500 (ethernet_socket_alloc()) quando
+ * abre e devolve-o quando fecha, pelo que várias conexões podem ter
+ * requisições em curso em simultâneo. Deve ser inicializada a zeros (ex:
+ * variável estática) e usada apenas através das funções deste módulo.
+ */
+typedef struct {
+    // Conexão TCP mantida entre requisições
+    uint8_t socket;                  /**< Socket do W5500 em uso, válido enquanto `open`. */
+    bool open;
+    http_connection_stats_t stats;
+
+    // Requisição em curso
+    http_request_state_t state;
+    http_status_t status;
+    http_body_writer_t write_body;
+    void* context;
+    const char* content_type;
+    uint8_t dest_ip[4];
+    uint16_t dest_port;
+    bool retried;                    /**< A conexão já foi reaberta após uma falha de envio. */
+    uint32_t deadline_ms;            /**< Fim do prazo HTTP_TIMEOUT_MS da requisição. */
+    uint64_t phase_start_us;         /**< Início da fase em curso (conexão, envio, receção), para trace.h. */
+    uint32_t body_len;               /**< Tamanho do corpo enviado. */
+    http_parser_t response;          /**< Analisador da resposta; código e Retry-After válidos no fim. */
+} http_connection_t;
+
+/**
+ * @brief Acrescenta bytes ao corpo da requisição em curso.
+ *
+ * Os bytes passam por um pequeno buffer de preparação e seguem em rajadas
+ * para a memória TX do W5500. Um excesso de capacidade é assinalado no
+ * escritor e reportado por http_post_stream().
+ *
+ * @param tx O escritor da requisição.
+ * @param data Os bytes a escrever (podem ser binários).
+ * @param len O número de bytes.
+ */
+void http_tx_write(http_tx_t* tx, const void* data, size_t len);
+
+/**
+ * @brief Inicia um HTTP POST com um corpo gerado em fluxo, sem bloquear.
+ *
+ * Reutiliza a conexão mantida (HTTP_KEEP_ALIVE) ou inicia uma nova; a
+ * requisição avança depois com http_request_step(), em resposta aos eventos
+ * do W5500 (ver ethernet_wait_event()). A requisição é escrita diretamente na
+ * memória TX do socket: os cabeçalhos vêm de um bloco formatado uma única
+ * vez por Content-Type, e o Content-Length, reservado nesse bloco, é
+ * preenchido no fim, antes do comando SEND. A requisição completa tem de
+ * caber no espaço livre do buffer TX.
+ *
+ * @param conn A conexão onde decorre a requisição.
+ * @param write_body A função que escreve o corpo (ex: um array de leituras).
+ * @param context Contexto repassado a `write_body`, que deve permanecer
+ * válido até ao fim da requisição.
+ * @param content_type O valor do cabeçalho Content-Type (ex: "application/json"),
+ * com até 48 caracteres.
+ * @return HTTP_OK se a requisição foi iniciada, ou um código de erro relevante.
+ */
+http_status_t http_request_begin(http_connection_t* conn, http_body_writer_t write_body,
+                                 void* context, const char* content_type);
+
+/**
+ * @brief Avança a requisição em curso de acordo com os eventos do socket.
+ *
+ * Nunca bloqueia. Trata os eventos sinalizados pelo W5500 (conexão, envio
+ * confirmado, dados recebidos, fecho, timeout TCP), limpa-os e aplica o
+ * limite HTTP_TIMEOUT_MS da requisição.
+ *
+ * @param conn A conexão onde decorre a requisição.
+ * @param status_out Ponteiro opcional que recebe o resultado quando o
+ * estado retornado é HTTP_STATE_DONE.
+ * @return O estado da requisição após o passo.
+ */
+http_request_state_t http_request_step(http_connection_t* conn, http_status_t* status_out);
+
+/**
+ * @brief Avança as requisições iniciadas em várias conexões até todas terminarem.
+ *
+ * Entre os passos a tarefa fica suspensa à espera da INTn do W5500, sem
+ * consumir CPU; os resultados são depois obtidos com http_request_step().
+ *
+ * @param conns As conexões a acompanhar.
+ * @param count O número de conexões em `conns`.
+ */
+void http_request_run(http_connection_t* const* conns, size_t count);
+
+/**
+ * @brief Envia um corpo gerado em fluxo para o servidor configurado via HTTP POST.
+ *
+ * Versão bloqueante de http_request_begin()/http_request_run() para uma
+ * única conexão.
+ * A conexão é encerrada após erros e, sem HTTP_KEEP_ALIVE, após cada
+ * requisição; uma conexão reutilizada que falhe no envio é reaberta uma vez.
+ *
+ * @param conn A conexão a usar.
+ * @param write_body A função que escreve o corpo (ex: um array de leituras).
+ * @param context Contexto repassado a `write_body`.
+ * @param content_type O valor do cabeçalho Content-Type (ex: "application/json").
  * @return Um status `http_status_t` indicando o resultado da operação.
  */
-http_status_t http_send_sensor_data(float temperature, float conductivity, float flow);
+http_status_t http_post_stream(http_connection_t* conn, http_body_writer_t write_body,
+                               void* context, const char* content_type);
+
+/**
+ * @brief Obtém as estatísticas de reutilização da conexão TCP.
+ *
+ * @param conn A conexão consultada.
+ * @param stats Ponteiro para a estrutura que receberá as estatísticas.
+ */
+void http_get_connection_stats(const http_connection_t* conn, http_connection_stats_t* stats);
+
+/**
+ * @brief Obtém o código de estado e o Retry-After da última resposta.
+ *
+ * @param conn A conexão consultada, com a requisição em HTTP_STATE_DONE.
+ * @param status_code Recebe o código de estado HTTP, ou 0 se não houve resposta.
+ * @param retry_after_s Recebe o Retry-After em segundos, ou HTTP_PARSER_NO_RETRY_AFTER.
+ */
+void http_get_response_info(const http_connection_t* conn, uint16_t* status_code, uint32_t* retry_after_s);
+
+/**
+ * @brief Regista a função que recebe os cabeçalhos das respostas do servidor.
+ *
+ * Aplica-se às requisições iniciadas depois da chamada, em todas as
+ * conexões. Recebe apenas os cabeçalhos que o cliente não interpreta (ver
+ * http_parser_set_header_handler()), por exemplo atualizações de
+ * configuração enviadas pelo servidor na resposta a um POST.
+ *
+ * @param handler A função, ou NULL para remover.
+ * @param context Ponteiro opaco repassado à função.
+ */
+void http_set_response_header_handler(http_parser_header_fn handler, void* context);
 
 #endif // HTTP_CLIENT_H
\ No newline at end of file
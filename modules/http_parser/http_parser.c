@@ -0,0 +1,439 @@
+/**
+ * @file http_parser.c
+ * @brief Implementação do analisador incremental de respostas HTTP/1.x.
+ *
+ * As linhas (linha de estado, cabeçalhos, tamanhos de bloco) são lidas byte
+ * a byte com um sub-estado em `line_state`; os corpos são saltados em bloco.
+ * O CR antes do LF é opcional, como recomenda o RFC 9112 aos destinatários.
+ */
+
+#include "http_parser.h"
+#include <string.h>
+
+#define HTTP_PARSER_VERSION_PREFIX "HTTP/1."
+
+// Sub-estados da linha de estado após o prefixo da versão
+enum {
+    STATUS_VERSION_MINOR = sizeof(HTTP_PARSER_VERSION_PREFIX) - 1,
+    STATUS_SPACE,
+    STATUS_CODE_1,
+    STATUS_CODE_2,
+    STATUS_CODE_3,
+    STATUS_REASON
+};
+
+// Sub-estados das linhas de cabeçalho e de trailer
+enum {
+    HEADER_LINE_START,
+    HEADER_NAME,
+    HEADER_VALUE,
+    HEADER_SKIP_LINE
+};
+
+// Sub-estados da linha de tamanho de um bloco
+enum {
+    CHUNK_SIZE_DIGITS,
+    CHUNK_SIZE_EXTENSION
+};
+
+static bool is_digit(uint8_t c) {
+    return c >= '0' && c <= '9';
+}
+
+static bool is_space(uint8_t c) {
+    return c == ' ' || c == '\t';
+}
+
+static uint8_t to_lower(uint8_t c) {
+    return (c >= 'A' && c <= 'Z') ? (uint8_t)(c - 'A' + 'a') : c;
+}
+
+static int hex_value(uint8_t c) {
+    if (is_digit(c)) {
+        return c - '0';
+    }
+    c = to_lower(c);
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief Compara `len` bytes sem distinguir maiúsculas de minúsculas.
+ */
+static bool equal_ignore_case(const char* a, const char* b, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (to_lower((uint8_t)a[i]) != to_lower((uint8_t)b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Converte um valor decimal sem sinal; falha em texto vazio, inválido ou acima de 32 bits.
+ */
+static bool parse_decimal(const char* text, uint32_t* out) {
+    uint32_t value = 0;
+
+    if (*text == '\0') {
+        return false;
+    }
+    for (; *text != '\0'; text++) {
+        if (!is_digit((uint8_t)*text) || value > (UINT32_MAX - 9) / 10) {
+            return false;
+        }
+        value = value * 10 + (uint32_t)(*text - '0');
+    }
+    *out = value;
+    return true;
+}
+
+/**
+ * @brief Indica se `token` aparece como elemento da lista separada por vírgulas `list`.
+ *
+ * Os elementos são tokens: a comparação não distingue maiúsculas de minúsculas.
+ */
+static bool list_has_token(const char* list, const char* token) {
+    size_t token_len = strlen(token);
+
+    while (*list != '\0') {
+        while (*list == ',' || is_space((uint8_t)*list)) {
+            list++;
+        }
+        const char* start = list;
+        while (*list != '\0' && *list != ',') {
+            list++;
+        }
+        const char* end = list;
+        while (end > start && is_space((uint8_t)end[-1])) {
+            end--;
+        }
+        if ((size_t)(end - start) == token_len && equal_ignore_case(start, token, token_len)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Indica se a resposta é informativa (ex: 100 Continue) e precede a resposta final.
+ */
+static bool http_parser_is_interim(const http_parser_t* parser) {
+    return parser->status_code >= 100 && parser->status_code < 200 && parser->status_code != 101;
+}
+
+/**
+ * @brief Interpreta um cabeçalho completo; os restantes são ignorados.
+ */
+static void http_parser_header(http_parser_t* parser) {
+    if (parser->name_overflow) {
+        return;
+    }
+
+    parser->name[parser->name_len] = '\0';
+    parser->value[parser->value_len] = '\0';
+
+    // Um valor truncado não é interpretado, exceto para o Content-Length,
+    // onde significa um tamanho impossível de representar.
+    if (strcmp(parser->name, "content-length") == 0) {
+        uint32_t length;
+        if (parser->value_overflow || !parse_decimal(parser->value, &length) ||
+            (parser->has_content_length && length != parser->content_length)) {
+            parser->state = HTTP_PARSER_ERROR;
+            return;
+        }
+        parser->content_length = length;
+        parser->has_content_length = true;
+    } else if (parser->value_overflow) {
+        return;
+    } else if (strcmp(parser->name, "transfer-encoding") == 0) {
+        // O chunked tem de ser a última codificação aplicada.
+        size_t len = strlen(parser->value);
+        parser->chunked = len >= 7 && equal_ignore_case(parser->value + len - 7, "chunked", 7);
+    } else if (strcmp(parser->name, "connection") == 0) {
+        if (list_has_token(parser->value, "close")) {
+            parser->keep_alive = false;
+        } else if (list_has_token(parser->value, "keep-alive")) {
+            parser->keep_alive = true;
+        }
+    } else if (strcmp(parser->name, "retry-after") == 0) {
+        // Apenas a forma em segundos; uma data HTTP é ignorada.
+        uint32_t seconds;
+        if (parse_decimal(parser->value, &seconds)) {
+            parser->retry_after_s = seconds;
+        }
+    } else if (parser->on_header && !http_parser_is_interim(parser)) {
+        // Os cabeçalhos das respostas informativas não são entregues.
+        parser->on_header(parser->name, parser->value, parser->header_context);
+    }
+}
+
+/**
+ * @brief Escolhe o enquadramento do corpo após a linha em branco dos cabeçalhos.
+ */
+static void http_parser_headers_done(http_parser_t* parser) {
+    if (http_parser_is_interim(parser)) {
+        http_parser_header_fn on_header = parser->on_header;
+        void* header_context = parser->header_context;
+        http_parser_init(parser);
+        http_parser_set_header_handler(parser, on_header, header_context);
+        return;
+    }
+
+    parser->headers_complete = true;
+
+    if ((parser->status_code >= 100 && parser->status_code < 200) ||
+        parser->status_code == 204 || parser->status_code == 304) {
+        parser->state = HTTP_PARSER_DONE;
+    } else if (parser->chunked) {
+        parser->state = HTTP_PARSER_CHUNK_SIZE;
+        parser->line_state = CHUNK_SIZE_DIGITS;
+        parser->remaining = 0;
+        parser->saw_digit = false;
+    } else if (parser->has_content_length) {
+        parser->remaining = parser->content_length;
+        parser->state = (parser->remaining == 0) ? HTTP_PARSER_DONE : HTTP_PARSER_BODY_LENGTH;
+    } else {
+        // Sem enquadramento o fim do corpo é o fecho da conexão.
+        parser->keep_alive = false;
+        parser->state = HTTP_PARSER_BODY_UNTIL_CLOSE;
+    }
+}
+
+static void http_parser_status_byte(http_parser_t* parser, uint8_t c) {
+    uint8_t pos = parser->line_state;
+
+    if (pos < STATUS_VERSION_MINOR) {
+        if (c != (uint8_t)HTTP_PARSER_VERSION_PREFIX[pos]) {
+            parser->state = HTTP_PARSER_ERROR;
+            return;
+        }
+    } else if (pos == STATUS_VERSION_MINOR) {
+        if (c != '0' && c != '1') {
+            parser->state = HTTP_PARSER_ERROR;
+            return;
+        }
+        parser->version_minor = (uint8_t)(c - '0');
+        parser->keep_alive = (parser->version_minor == 1);
+    } else if (pos == STATUS_SPACE) {
+        if (c != ' ') {
+            parser->state = HTTP_PARSER_ERROR;
+            return;
+        }
+    } else if (pos <= STATUS_CODE_3) {
+        if (!is_digit(c)) {
+            parser->state = HTTP_PARSER_ERROR;
+            return;
+        }
+        parser->status_code = (uint16_t)(parser->status_code * 10 + (c - '0'));
+    } else {
+        // A frase de motivo é opcional e não é usada.
+        if (c == '\n') {
+            if (parser->status_code < 100) {
+                parser->state = HTTP_PARSER_ERROR;
+            } else {
+                parser->state = HTTP_PARSER_HEADER_LINE;
+                parser->line_state = HEADER_LINE_START;
+            }
+        } else if (pos == STATUS_REASON && c != ' ' && c != '\r') {
+            parser->state = HTTP_PARSER_ERROR;
+        } else {
+            parser->line_state = STATUS_REASON + 1;
+        }
+        return;
+    }
+
+    parser->line_state++;
+}
+
+/**
+ * @brief Consome um byte de uma linha de cabeçalho ou de trailer.
+ * @return true quando a linha em branco que termina a secção foi lida.
+ */
+static bool http_parser_header_byte(http_parser_t* parser, uint8_t c, bool interpret) {
+    if (c == '\r') {
+        return false;
+    }
+
+    switch (parser->line_state) {
+    case HEADER_LINE_START:
+        if (c == '\n') {
+            return true;
+        }
+        if (is_space(c)) {
+            // Continuação obsoleta da linha anterior: ignorada.
+            parser->line_state = HEADER_SKIP_LINE;
+            return false;
+        }
+        parser->name_len = 0;
+        parser->value_len = 0;
+        parser->name_overflow = false;
+        parser->value_overflow = false;
+        parser->line_state = HEADER_NAME;
+        // fall through
+    case HEADER_NAME:
+        if (c == ':') {
+            parser->line_state = HEADER_VALUE;
+        } else if (c == '\n' || is_space(c)) {
+            parser->state = HTTP_PARSER_ERROR;
+        } else if (parser->name_len < HTTP_PARSER_NAME_MAX - 1) {
+            parser->name[parser->name_len++] = (char)to_lower(c);
+        } else {
+            parser->name_overflow = true;
+        }
+        return false;
+
+    case HEADER_VALUE:
+        if (c == '\n') {
+            while (parser->value_len > 0 && is_space((uint8_t)parser->value[parser->value_len - 1])) {
+                parser->value_len--;
+            }
+            if (interpret) {
+                http_parser_header(parser);
+            }
+            parser->line_state = HEADER_LINE_START;
+        } else if (parser->value_len == 0 && is_space(c)) {
+            // Espaço antes do valor.
+        } else if (parser->value_len < HTTP_PARSER_VALUE_MAX - 1) {
+            // O valor mantém as maiúsculas (ex: chaves do X-Config); os
+            // tokens são comparados sem as distinguir.
+            parser->value[parser->value_len++] = (char)c;
+        } else {
+            parser->value_overflow = true;
+        }
+        return false;
+
+    default:
+        if (c == '\n') {
+            parser->line_state = HEADER_LINE_START;
+        }
+        return false;
+    }
+}
+
+static void http_parser_chunk_size_byte(http_parser_t* parser, uint8_t c) {
+    if (c == '\r') {
+        return;
+    }
+
+    if (c == '\n') {
+        if (!parser->saw_digit) {
+            parser->state = HTTP_PARSER_ERROR;
+        } else if (parser->remaining == 0) {
+            parser->state = HTTP_PARSER_TRAILER_LINE;
+            parser->line_state = HEADER_LINE_START;
+        } else {
+            parser->state = HTTP_PARSER_CHUNK_DATA;
+        }
+        return;
+    }
+
+    int digit = (parser->line_state == CHUNK_SIZE_DIGITS) ? hex_value(c) : -1;
+    if (digit >= 0) {
+        if (parser->remaining > (UINT32_MAX >> 4)) {
+            parser->state = HTTP_PARSER_ERROR;
+            return;
+        }
+        parser->remaining = (parser->remaining << 4) | (uint32_t)digit;
+        parser->saw_digit = true;
+    } else if (c == ';' || is_space(c)) {
+        // Extensões do bloco: ignoradas até ao fim da linha.
+        parser->line_state = CHUNK_SIZE_EXTENSION;
+    } else if (parser->line_state == CHUNK_SIZE_DIGITS) {
+        parser->state = HTTP_PARSER_ERROR;
+    }
+}
+
+void http_parser_init(http_parser_t* parser) {
+    memset(parser, 0, sizeof(*parser));
+    parser->retry_after_s = HTTP_PARSER_NO_RETRY_AFTER;
+    parser->state = HTTP_PARSER_STATUS_LINE;
+}
+
+void http_parser_set_header_handler(http_parser_t* parser, http_parser_header_fn handler, void* context) {
+    parser->header_context = context;
+    parser->on_header = handler;
+}
+
+size_t http_parser_feed(http_parser_t* parser, const uint8_t* data, size_t len) {
+    size_t pos = 0;
+
+    while (pos < len) {
+        switch (parser->state) {
+        case HTTP_PARSER_DONE:
+        case HTTP_PARSER_ERROR:
+            return pos;
+
+        case HTTP_PARSER_BODY_LENGTH:
+        case HTTP_PARSER_CHUNK_DATA: {
+            size_t take = len - pos;
+            if (take > parser->remaining) {
+                take = parser->remaining;
+            }
+            pos += take;
+            parser->remaining -= (uint32_t)take;
+            if (parser->remaining == 0) {
+                parser->state = (parser->state == HTTP_PARSER_BODY_LENGTH)
+                    ? HTTP_PARSER_DONE : HTTP_PARSER_CHUNK_END;
+            }
+            continue;
+        }
+
+        case HTTP_PARSER_BODY_UNTIL_CLOSE:
+            return len;
+
+        default:
+            break;
+        }
+
+        uint8_t c = data[pos++];
+
+        switch (parser->state) {
+        case HTTP_PARSER_STATUS_LINE:
+            http_parser_status_byte(parser, c);
+            break;
+
+        case HTTP_PARSER_HEADER_LINE:
+            if (http_parser_header_byte(parser, c, true) && parser->state == HTTP_PARSER_HEADER_LINE) {
+                http_parser_headers_done(parser);
+            }
+            break;
+
+        case HTTP_PARSER_CHUNK_SIZE:
+            http_parser_chunk_size_byte(parser, c);
+            break;
+
+        case HTTP_PARSER_CHUNK_END:
+            if (c == '\n') {
+                parser->state = HTTP_PARSER_CHUNK_SIZE;
+                parser->line_state = CHUNK_SIZE_DIGITS;
+                parser->saw_digit = false;
+            } else if (c != '\r') {
+                parser->state = HTTP_PARSER_ERROR;
+            }
+            break;
+
+        case HTTP_PARSER_TRAILER_LINE:
+            if (http_parser_header_byte(parser, c, false) && parser->state == HTTP_PARSER_TRAILER_LINE) {
+                parser->state = HTTP_PARSER_DONE;
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return pos;
+}
+
+void http_parser_finish(http_parser_t* parser) {
+    if (parser->state == HTTP_PARSER_BODY_UNTIL_CLOSE) {
+        parser->state = HTTP_PARSER_DONE;
+    } else if (parser->state != HTTP_PARSER_DONE) {
+        parser->state = HTTP_PARSER_ERROR;
+    }
+    parser->keep_alive = false;
+}
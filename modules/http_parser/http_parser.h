@@ -0,0 +1,157 @@
+/**
+ * @file http_parser.h
+ * @brief Interface pública do analisador incremental de respostas HTTP/1.x.
+ *
+ * O analisador consome a resposta byte a byte, à medida que chega do socket,
+ * e não guarda a resposta: apenas o estado atual e os campos extraídos
+ * (código de estado, enquadramento do corpo, Retry-After e Connection).
+ * Os restantes cabeçalhos podem ser entregues a uma função registada com
+ * http_parser_set_header_handler(). A memória usada é fixa e limitada pelo
+ * tamanho de http_parser_t.
+ */
+#ifndef HTTP_PARSER_H
+#define HTTP_PARSER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Maior nome de cabeçalho guardado; nomes mais longos não são relevantes e são ignorados.
+ */
+#define HTTP_PARSER_NAME_MAX 20
+
+/**
+ * @brief Maior valor de cabeçalho relevante guardado para interpretação.
+ *
+ * Dimensionado para as atribuições de configuração (ex: X-Config); um valor
+ * mais longo é ignorado por inteiro.
+ */
+#define HTTP_PARSER_VALUE_MAX 64
+
+/**
+ * @brief Valor de `retry_after_s` quando a resposta não trouxe Retry-After em segundos.
+ */
+#define HTTP_PARSER_NO_RETRY_AFTER UINT32_MAX
+
+/**
+ * @enum http_parser_state_t
+ * @brief Estados do analisador.
+ */
+typedef enum {
+    HTTP_PARSER_STATUS_LINE,   /**< A ler a linha de estado. */
+    HTTP_PARSER_HEADER_LINE,   /**< A ler uma linha de cabeçalho. */
+    HTTP_PARSER_BODY_LENGTH,   /**< A consumir um corpo com Content-Length. */
+    HTTP_PARSER_CHUNK_SIZE,    /**< A ler a linha de tamanho de um bloco (chunked). */
+    HTTP_PARSER_CHUNK_DATA,    /**< A consumir os dados de um bloco. */
+    HTTP_PARSER_CHUNK_END,     /**< A ler o CRLF que termina um bloco. */
+    HTTP_PARSER_TRAILER_LINE,  /**< A ler os cabeçalhos finais após o último bloco. */
+    HTTP_PARSER_BODY_UNTIL_CLOSE, /**< Corpo sem enquadramento: termina com o fecho da conexão. */
+    HTTP_PARSER_DONE,          /**< Resposta completa. */
+    HTTP_PARSER_ERROR          /**< Resposta mal formada. */
+} http_parser_state_t;
+
+/**
+ * @brief Função que recebe os cabeçalhos não interpretados pelo analisador.
+ *
+ * O nome chega em minúsculas e o valor tal como foi enviado, ambos sem
+ * espaços nas pontas; cabeçalhos com nome ou valor truncados não são
+ * entregues, nem os das respostas informativas (1xx) que precedem a final.
+ *
+ * @param name O nome do cabeçalho (ex: "x-config").
+ * @param value O valor do cabeçalho, com as maiúsculas originais.
+ * @param context O ponteiro registado com http_parser_set_header_handler().
+ */
+typedef void (*http_parser_header_fn)(const char* name, const char* value, void* context);
+
+/**
+ * @struct http_parser_t
+ * @brief Estado e resultados do analisador. Inicializar com http_parser_init().
+ */
+typedef struct {
+    // Resultados
+    uint16_t status_code;      /**< Código de estado numérico (ex: 204). */
+    uint8_t version_minor;     /**< 0 para HTTP/1.0, 1 para HTTP/1.1. */
+    bool headers_complete;     /**< Linha de estado e cabeçalhos lidos por completo. */
+    bool chunked;              /**< Corpo em Transfer-Encoding: chunked. */
+    bool has_content_length;   /**< A resposta trouxe Content-Length. */
+    bool keep_alive;           /**< A conexão pode ser reutilizada após a resposta. */
+    uint32_t content_length;   /**< Valor do Content-Length, se presente. */
+    uint32_t retry_after_s;    /**< Retry-After em segundos, ou HTTP_PARSER_NO_RETRY_AFTER. */
+
+    // Cabeçalhos não interpretados
+    http_parser_header_fn on_header;
+    void* header_context;
+
+    // Estado interno
+    http_parser_state_t state;
+    uint32_t remaining;        /**< Bytes do corpo ou do bloco atual por consumir. */
+    uint8_t line_state;        /**< Posição dentro da linha atual (sub-estado). */
+    uint8_t name_len;
+    uint8_t value_len;
+    bool name_overflow;
+    bool value_overflow;
+    bool saw_digit;
+    char name[HTTP_PARSER_NAME_MAX];
+    char value[HTTP_PARSER_VALUE_MAX];
+} http_parser_t;
+
+/**
+ * @brief Prepara o analisador para uma nova resposta.
+ *
+ * @param parser O analisador.
+ */
+void http_parser_init(http_parser_t* parser);
+
+/**
+ * @brief Regista a função que recebe os cabeçalhos não interpretados.
+ *
+ * Deve ser chamada após http_parser_init(); os trailers de um corpo
+ * chunked não são entregues.
+ *
+ * @param parser O analisador.
+ * @param handler A função, ou NULL para remover.
+ * @param context Ponteiro opaco repassado à função.
+ */
+void http_parser_set_header_handler(http_parser_t* parser, http_parser_header_fn handler, void* context);
+
+/**
+ * @brief Consome bytes da resposta.
+ *
+ * Pode ser chamada com qualquer fragmentação da resposta, incluindo um byte
+ * de cada vez. Para ao concluir a resposta ou ao encontrar um erro.
+ *
+ * @param parser O analisador.
+ * @param data Os bytes recebidos.
+ * @param len O número de bytes.
+ * @return O número de bytes consumidos; menor que `len` apenas se a
+ * resposta terminou (bytes seguintes pertencem à próxima resposta) ou
+ * se ocorreu um erro.
+ */
+size_t http_parser_feed(http_parser_t* parser, const uint8_t* data, size_t len);
+
+/**
+ * @brief Informa o analisador de que o servidor fechou a conexão.
+ *
+ * Conclui um corpo delimitado pelo fecho; em qualquer outro estado
+ * intermédio a resposta fica truncada e o analisador passa a erro.
+ *
+ * @param parser O analisador.
+ */
+void http_parser_finish(http_parser_t* parser);
+
+/**
+ * @brief Indica se a resposta foi lida por completo.
+ */
+static inline bool http_parser_is_done(const http_parser_t* parser) {
+    return parser->state == HTTP_PARSER_DONE;
+}
+
+/**
+ * @brief Indica se a resposta está mal formada ou truncada.
+ */
+static inline bool http_parser_has_error(const http_parser_t* parser) {
+    return parser->state == HTTP_PARSER_ERROR;
+}
+
+#endif // HTTP_PARSER_H
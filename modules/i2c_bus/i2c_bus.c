@@ -0,0 +1,154 @@
+/**
+ * @file i2c_bus.c
+ * @brief Implementação do barramento I2C partilhado: posse do barramento e validação.
+ */
+
+#include "i2c_bus.h"
+#include "i2c_bus_port.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+// Tempo máximo de uma transação bloqueante, por byte (um byte a 100 kHz leva 90 us).
+#define I2C_BUS_BLOCKING_TIMEOUT_US_PER_BYTE 1000
+
+/**
+ * @brief Mutex de posse de cada barramento; NULL até i2c_bus_init().
+ */
+static SemaphoreHandle_t bus_mutex[2] = {NULL, NULL};
+
+static SemaphoreHandle_t* i2c_bus_mutex(i2c_inst_t* i2c) {
+    if (i2c == i2c0) {
+        return &bus_mutex[0];
+    }
+    if (i2c == i2c1) {
+        return &bus_mutex[1];
+    }
+    return NULL;
+}
+
+i2c_bus_status_t i2c_bus_init(i2c_inst_t* i2c, uint sda_pin, uint scl_pin, uint32_t baudrate_hz) {
+    SemaphoreHandle_t* mutex = i2c_bus_mutex(i2c);
+    if (mutex == NULL || baudrate_hz == 0) {
+        return I2C_BUS_INVALID_PARAM;
+    }
+
+    // Garante a idempotência da função.
+    if (*mutex != NULL) {
+        return I2C_BUS_OK;
+    }
+
+    // Configuração de baixo nível dos pinos e do periférico I2C. Acima de
+    // 400 kHz o SDK ajusta os tempos de SCL e o filtro de picos para Fm+.
+    i2c_init(i2c, baudrate_hz);
+    gpio_set_function(sda_pin, GPIO_FUNC_I2C);
+    gpio_set_function(scl_pin, GPIO_FUNC_I2C);
+    gpio_pull_up(sda_pin);
+    gpio_pull_up(scl_pin);
+
+    *mutex = xSemaphoreCreateMutex();
+    if (*mutex == NULL) {
+        return I2C_BUS_NOT_INITIALIZED;
+    }
+
+    i2c_bus_port_init(i2c);
+    return I2C_BUS_OK;
+}
+
+i2c_bus_status_t i2c_bus_blocking_transfer(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t src_len,
+                                           uint8_t* dst, size_t dst_len) {
+    if (src_len > 0) {
+        uint timeout_us = (uint)(src_len + 1) * I2C_BUS_BLOCKING_TIMEOUT_US_PER_BYTE;
+        int written = i2c_write_timeout_us(i2c, addr, src, src_len, dst_len > 0, timeout_us);
+        if (written != (int)src_len) {
+            return written == PICO_ERROR_TIMEOUT ? I2C_BUS_TIMEOUT : I2C_BUS_NACK;
+        }
+    }
+    if (dst_len > 0) {
+        uint timeout_us = (uint)(dst_len + 1) * I2C_BUS_BLOCKING_TIMEOUT_US_PER_BYTE;
+        int read = i2c_read_timeout_us(i2c, addr, dst, dst_len, false, timeout_us);
+        if (read != (int)dst_len) {
+            return read == PICO_ERROR_TIMEOUT ? I2C_BUS_TIMEOUT : I2C_BUS_NACK;
+        }
+    }
+    return I2C_BUS_OK;
+}
+
+/**
+ * @brief Executa uma transação com a posse exclusiva do barramento.
+ *
+ * Antes do arranque do escalonador não há outras tarefas nem notificações:
+ * a transação é bloqueante, sem mutex.
+ */
+static i2c_bus_status_t i2c_bus_transfer(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t src_len,
+                                         uint8_t* dst, size_t dst_len) {
+    SemaphoreHandle_t* mutex = i2c_bus_mutex(i2c);
+    if (mutex == NULL) {
+        return I2C_BUS_INVALID_PARAM;
+    }
+    if (*mutex == NULL) {
+        return I2C_BUS_NOT_INITIALIZED;
+    }
+
+    if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) {
+        return i2c_bus_blocking_transfer(i2c, addr, src, src_len, dst, dst_len);
+    }
+
+    if (xSemaphoreTake(*mutex, pdMS_TO_TICKS(I2C_BUS_TIMEOUT_MS)) != pdTRUE) {
+        return I2C_BUS_TIMEOUT;
+    }
+    i2c_bus_status_t status = i2c_bus_port_transfer(i2c, addr, src, src_len, dst, dst_len);
+    xSemaphoreGive(*mutex);
+    return status;
+}
+
+i2c_bus_status_t i2c_bus_write(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t len) {
+    if (src == NULL || len == 0) {
+        return I2C_BUS_INVALID_PARAM;
+    }
+    return i2c_bus_transfer(i2c, addr, src, len, NULL, 0);
+}
+
+i2c_bus_status_t i2c_bus_read(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst, size_t len) {
+    if (dst == NULL || len == 0) {
+        return I2C_BUS_INVALID_PARAM;
+    }
+    return i2c_bus_transfer(i2c, addr, NULL, 0, dst, len);
+}
+
+i2c_bus_status_t i2c_bus_write_read(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t src_len,
+                                    uint8_t* dst, size_t dst_len) {
+    if (src == NULL || src_len == 0 || dst == NULL || dst_len == 0) {
+        return I2C_BUS_INVALID_PARAM;
+    }
+    return i2c_bus_transfer(i2c, addr, src, src_len, dst, dst_len);
+}
+
+i2c_bus_status_t i2c_bus_lock(i2c_inst_t* i2c) {
+    SemaphoreHandle_t* mutex = i2c_bus_mutex(i2c);
+    if (mutex == NULL) {
+        return I2C_BUS_INVALID_PARAM;
+    }
+    if (*mutex == NULL) {
+        return I2C_BUS_NOT_INITIALIZED;
+    }
+    if (xSemaphoreTake(*mutex, pdMS_TO_TICKS(I2C_BUS_TIMEOUT_MS)) != pdTRUE) {
+        return I2C_BUS_TIMEOUT;
+    }
+    return I2C_BUS_OK;
+}
+
+void i2c_bus_unlock(i2c_inst_t* i2c) {
+    SemaphoreHandle_t* mutex = i2c_bus_mutex(i2c);
+    if (mutex != NULL && *mutex != NULL) {
+        xSemaphoreGive(*mutex);
+    }
+}
+
+i2c_bus_status_t __not_in_flash_func(i2c_bus_transfer_polled)(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src,
+                                                              size_t src_len, uint8_t* dst, size_t dst_len) {
+    if ((src_len > 0 && src == NULL) || (dst_len > 0 && dst == NULL) || src_len + dst_len == 0) {
+        return I2C_BUS_INVALID_PARAM;
+    }
+    return i2c_bus_port_transfer_polled(i2c, addr, src, src_len, dst, dst_len);
+}
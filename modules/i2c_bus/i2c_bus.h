@@ -0,0 +1,124 @@
+/**
+ * @file i2c_bus.h
+ * @brief Interface pública do barramento I2C partilhado entre tarefas.
+ *
+ * Cada transação (escrita, leitura, ou escrita seguida de leitura com
+ * repeated start) é atómica: um mutex por barramento serializa as tarefas
+ * clientes. Com o escalonador em execução a transferência corre por
+ * interrupção e a tarefa que a pediu dorme numa notificação até ao STOP;
+ * antes do arranque do escalonador as transações são bloqueantes. Com o
+ * barramento tomado por i2c_bus_lock(), as transações por consulta servem
+ * código que corre com as interrupções desativadas.
+ */
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "hardware/i2c.h"
+
+/**
+ * @brief Índice da notificação de tarefa usada pelo fim das transações (ver FreeRTOSConfig.h).
+ */
+#define I2C_BUS_NOTIFY_INDEX 3
+
+/**
+ * @brief Maior espera pelo mutex ou pelo fim de uma transação, em ms.
+ */
+#define I2C_BUS_TIMEOUT_MS 20
+
+/**
+ * @enum i2c_bus_status_t
+ * @brief Define os possíveis códigos de estado retornados pelo módulo i2c_bus.
+ */
+typedef enum {
+    I2C_BUS_OK,                 /**< A transação foi concluída com sucesso. */
+    I2C_BUS_NOT_INITIALIZED,    /**< O barramento não foi preparado com i2c_bus_init(). */
+    I2C_BUS_INVALID_PARAM,      /**< Ponteiro nulo ou transação vazia. */
+    I2C_BUS_NACK,               /**< O dispositivo não respondeu (NACK) ou a arbitragem foi perdida. */
+    I2C_BUS_TIMEOUT             /**< O mutex ou o fim da transação não chegaram a tempo. */
+} i2c_bus_status_t;
+
+/**
+ * @brief Inicializa o periférico, os pinos e o mutex de um barramento.
+ *
+ * Idempotente. A frequência pode ir até 1 MHz (Fast-mode Plus), que exige
+ * pull-ups mais fortes do que os 400 kHz do Fast-mode.
+ *
+ * @param i2c O periférico (i2c0 ou i2c1).
+ * @param sda_pin O GPIO de SDA.
+ * @param scl_pin O GPIO de SCL.
+ * @param baudrate_hz A frequência de SCL, em Hz.
+ * @return I2C_BUS_OK, ou I2C_BUS_INVALID_PARAM.
+ */
+i2c_bus_status_t i2c_bus_init(i2c_inst_t* i2c, uint sda_pin, uint scl_pin, uint32_t baudrate_hz);
+
+/**
+ * @brief Escreve `len` bytes num dispositivo, terminando com STOP.
+ *
+ * @param i2c O barramento.
+ * @param addr O endereço de 7 bits do dispositivo.
+ * @param src Os bytes a enviar.
+ * @param len O número de bytes, pelo menos 1.
+ * @return I2C_BUS_OK, ou um código de erro relevante.
+ */
+i2c_bus_status_t i2c_bus_write(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t len);
+
+/**
+ * @brief Lê `len` bytes de um dispositivo, terminando com STOP.
+ *
+ * @param i2c O barramento.
+ * @param addr O endereço de 7 bits do dispositivo.
+ * @param dst O destino dos bytes lidos.
+ * @param len O número de bytes, pelo menos 1.
+ * @return I2C_BUS_OK, ou um código de erro relevante.
+ */
+i2c_bus_status_t i2c_bus_read(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst, size_t len);
+
+/**
+ * @brief Escreve e depois lê, com repeated start entre as duas fases.
+ *
+ * É a forma de ler um registo (ex: o ponteiro do ADS1115 seguido dos dois
+ * bytes do registo) sem que outra tarefa se intercale no barramento.
+ *
+ * @param i2c O barramento.
+ * @param addr O endereço de 7 bits do dispositivo.
+ * @param src Os bytes a enviar.
+ * @param src_len O número de bytes a enviar, pelo menos 1.
+ * @param dst O destino dos bytes lidos.
+ * @param dst_len O número de bytes a ler, pelo menos 1.
+ * @return I2C_BUS_OK, ou um código de erro relevante.
+ */
+i2c_bus_status_t i2c_bus_write_read(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t src_len,
+                                    uint8_t* dst, size_t dst_len);
+
+/**
+ * @brief Toma a posse do barramento para uma sequência de transações por consulta.
+ *
+ * @param i2c O barramento.
+ * @return I2C_BUS_OK, ou um código de erro relevante.
+ */
+i2c_bus_status_t i2c_bus_lock(i2c_inst_t* i2c);
+
+/**
+ * @brief Liberta o barramento tomado com i2c_bus_lock().
+ */
+void i2c_bus_unlock(i2c_inst_t* i2c);
+
+/**
+ * @brief Executa uma transação por consulta dos registos do controlador.
+ *
+ * Não usa interrupções nem o escalonador e, na placa, corre da RAM: pode
+ * ser chamada com as interrupções do núcleo desativadas enquanto o outro
+ * núcleo escreve na flash. Exige o barramento tomado com i2c_bus_lock().
+ * `src_len` ou `dst_len` podem ser 0, mas não ambos.
+ *
+ * @return I2C_BUS_OK, ou um código de erro relevante.
+ */
+i2c_bus_status_t i2c_bus_transfer_polled(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t src_len,
+                                         uint8_t* dst, size_t dst_len);
+
+#endif // I2C_BUS_H
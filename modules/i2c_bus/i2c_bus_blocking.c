@@ -0,0 +1,22 @@
+/**
+ * @file i2c_bus_blocking.c
+ * @brief Transações do i2c_bus com as chamadas bloqueantes do SDK (build host).
+ *
+ * No host os dispositivos I2C são simulados e respondem de imediato: não
+ * há transferência em curso por que esperar.
+ */
+
+#include "i2c_bus_port.h"
+
+void i2c_bus_port_init(__unused i2c_inst_t* i2c) {
+}
+
+i2c_bus_status_t i2c_bus_port_transfer(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t src_len,
+                                       uint8_t* dst, size_t dst_len) {
+    return i2c_bus_blocking_transfer(i2c, addr, src, src_len, dst, dst_len);
+}
+
+i2c_bus_status_t i2c_bus_port_transfer_polled(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t src_len,
+                                              uint8_t* dst, size_t dst_len) {
+    return i2c_bus_blocking_transfer(i2c, addr, src, src_len, dst, dst_len);
+}
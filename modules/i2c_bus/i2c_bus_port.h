@@ -0,0 +1,42 @@
+/**
+ * @file i2c_bus_port.h
+ * @brief Interface interna entre o i2c_bus e a implementação de cada plataforma.
+ *
+ * O i2c_bus.c trata do mutex e das transações antes do arranque do
+ * escalonador; a plataforma executa as transações com a tarefa a dormir:
+ * i2c_bus_rp2040.c no firmware, i2c_bus_blocking.c no build host.
+ */
+#ifndef I2C_BUS_PORT_H
+#define I2C_BUS_PORT_H
+
+#include "i2c_bus.h"
+
+/**
+ * @brief Prepara a plataforma para as transações de um barramento já inicializado.
+ */
+void i2c_bus_port_init(i2c_inst_t* i2c);
+
+/**
+ * @brief Executa uma transação, com a posse do barramento já garantida.
+ *
+ * `src_len` ou `dst_len` podem ser 0, mas não ambos. Só é chamada com o
+ * escalonador em execução.
+ */
+i2c_bus_status_t i2c_bus_port_transfer(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t src_len,
+                                       uint8_t* dst, size_t dst_len);
+
+/**
+ * @brief Executa uma transação por consulta, com a posse do barramento já garantida.
+ *
+ * Na placa corre da RAM e não toca no XIP (ver i2c_bus_transfer_polled()).
+ */
+i2c_bus_status_t i2c_bus_port_transfer_polled(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t src_len,
+                                              uint8_t* dst, size_t dst_len);
+
+/**
+ * @brief Executa uma transação com as chamadas bloqueantes do SDK.
+ */
+i2c_bus_status_t i2c_bus_blocking_transfer(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t src_len,
+                                           uint8_t* dst, size_t dst_len);
+
+#endif // I2C_BUS_PORT_H
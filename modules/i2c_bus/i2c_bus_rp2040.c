@@ -0,0 +1,241 @@
+/**
+ * @file i2c_bus_rp2040.c
+ * @brief Transações do i2c_bus por interrupção, no controlador I2C do RP2040.
+ *
+ * A tarefa escreve no FIFO de comandos (16 entradas) a transação inteira,
+ * ou o que nela couber, e dorme numa notificação. O tratador repõe os
+ * comandos em falta (TX_EMPTY), esvazia o FIFO de receção (RX_FULL) e
+ * acorda a tarefa na condição de STOP, que o controlador gera tanto no fim
+ * da transação como depois de um abort (NACK, arbitragem perdida). Uma
+ * transação do ADS1115 (até 3 bytes) custa uma única interrupção.
+ *
+ * As transações por consulta reutilizam o enchimento e o esvaziamento dos
+ * FIFOs, que por isso ficam na RAM com elas.
+ */
+
+#include "i2c_bus_port.h"
+#include "hardware/irq.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define I2C_BUS_FIFO_DEPTH 16
+
+// Comandos por emitir ou bytes por receber que justificam a interrupção de RX.
+#define I2C_BUS_RX_THRESHOLD (I2C_BUS_FIFO_DEPTH / 2)
+
+/**
+ * @struct i2c_bus_transfer_t
+ * @brief Transação em curso num barramento, partilhada com o tratador.
+ */
+typedef struct {
+    const uint8_t* src;
+    size_t src_len;
+    uint8_t* dst;
+    size_t dst_len;
+    size_t issued;              /**< Comandos já escritos no FIFO (escritas e leituras). */
+    size_t received;            /**< Bytes já lidos do FIFO de receção. */
+    uint32_t abort_source;      /**< IC_TX_ABRT_SOURCE do último abort, 0 se nenhum. */
+    TaskHandle_t waiting_task;
+} i2c_bus_transfer_t;
+
+static i2c_bus_transfer_t transfers[2];
+
+/**
+ * @brief Escreve no FIFO os comandos seguintes da transação.
+ *
+ * As leituras em voo ficam limitadas à profundidade do FIFO de receção,
+ * que nunca transborda. Desarma TX_EMPTY quando não há mais nada a emitir.
+ */
+static void __not_in_flash_func(i2c_bus_fill)(i2c_hw_t* hw, i2c_bus_transfer_t* transfer) {
+    size_t total = transfer->src_len + transfer->dst_len;
+
+    while (transfer->issued < total && hw->txflr < I2C_BUS_FIFO_DEPTH) {
+        size_t i = transfer->issued;
+        uint32_t cmd;
+
+        if (i < transfer->src_len) {
+            cmd = transfer->src[i];
+        } else {
+            if ((i - transfer->src_len) - transfer->received >= I2C_BUS_FIFO_DEPTH) {
+                break;
+            }
+            cmd = I2C_IC_DATA_CMD_CMD_BITS;
+            // Repeated start entre a fase de escrita e a de leitura.
+            if (i == transfer->src_len && transfer->src_len > 0) {
+                cmd |= I2C_IC_DATA_CMD_RESTART_BITS;
+            }
+        }
+        if (i + 1 == total) {
+            cmd |= I2C_IC_DATA_CMD_STOP_BITS;
+        }
+        hw->data_cmd = cmd;
+        transfer->issued++;
+    }
+
+    if (transfer->issued < total && hw->txflr < I2C_BUS_FIFO_DEPTH) {
+        // Limitado pelas leituras em voo: retoma com RX_FULL.
+        hw_clear_bits(&hw->intr_mask, I2C_IC_INTR_MASK_M_TX_EMPTY_BITS);
+    } else if (transfer->issued < total) {
+        hw_set_bits(&hw->intr_mask, I2C_IC_INTR_MASK_M_TX_EMPTY_BITS);
+    } else {
+        hw_clear_bits(&hw->intr_mask, I2C_IC_INTR_MASK_M_TX_EMPTY_BITS);
+    }
+}
+
+static void __not_in_flash_func(i2c_bus_drain)(i2c_hw_t* hw, i2c_bus_transfer_t* transfer) {
+    while (hw->rxflr > 0 && transfer->received < transfer->dst_len) {
+        transfer->dst[transfer->received++] = (uint8_t)hw->data_cmd;
+    }
+}
+
+static void i2c_bus_irq_handler(uint index) {
+    i2c_inst_t* i2c = index == 0 ? i2c0 : i2c1;
+    i2c_hw_t* hw = i2c_get_hw(i2c);
+    i2c_bus_transfer_t* transfer = &transfers[index];
+    uint32_t status = hw->intr_stat;
+
+    if (status & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        // O controlador esvazia o FIFO de comandos e gera STOP a seguir.
+        transfer->abort_source = hw->tx_abrt_source;
+        (void)hw->clr_tx_abrt;
+        transfer->issued = transfer->src_len + transfer->dst_len;
+        hw_clear_bits(&hw->intr_mask, I2C_IC_INTR_MASK_M_TX_EMPTY_BITS);
+    }
+
+    i2c_bus_drain(hw, transfer);
+
+    if (!(status & I2C_IC_INTR_STAT_R_STOP_DET_BITS)) {
+        if (transfer->abort_source == 0) {
+            i2c_bus_fill(hw, transfer);
+        }
+        return;
+    }
+
+    (void)hw->clr_stop_det;
+    hw->intr_mask = 0;
+
+    if (transfer->waiting_task != NULL) {
+        BaseType_t higher_priority_woken = pdFALSE;
+        vTaskNotifyGiveIndexedFromISR(transfer->waiting_task, I2C_BUS_NOTIFY_INDEX, &higher_priority_woken);
+        portYIELD_FROM_ISR(higher_priority_woken);
+    }
+}
+
+static void i2c0_bus_irq_handler(void) {
+    i2c_bus_irq_handler(0);
+}
+
+static void i2c1_bus_irq_handler(void) {
+    i2c_bus_irq_handler(1);
+}
+
+void i2c_bus_port_init(i2c_inst_t* i2c) {
+    uint index = i2c_hw_index(i2c);
+    uint irq = index == 0 ? I2C0_IRQ : I2C1_IRQ;
+
+    i2c_get_hw(i2c)->intr_mask = 0;
+    irq_set_exclusive_handler(irq, index == 0 ? i2c0_bus_irq_handler : i2c1_bus_irq_handler);
+    irq_set_enabled(irq, true);
+}
+
+i2c_bus_status_t i2c_bus_port_transfer(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t src_len,
+                                       uint8_t* dst, size_t dst_len) {
+    i2c_hw_t* hw = i2c_get_hw(i2c);
+    i2c_bus_transfer_t* transfer = &transfers[i2c_hw_index(i2c)];
+
+    // O endereço do alvo só pode mudar com o controlador desligado.
+    hw->enable = 0;
+    hw->tar = addr;
+    hw->enable = I2C_IC_ENABLE_ENABLE_BITS;
+
+    *transfer = (i2c_bus_transfer_t){
+        .src = src,
+        .src_len = src_len,
+        .dst = dst,
+        .dst_len = dst_len,
+        .waiting_task = xTaskGetCurrentTaskHandle(),
+    };
+
+    // Leituras curtas cabem no FIFO e são recolhidas no STOP; as longas
+    // precisam de RX_FULL para libertar espaço a meio da transação.
+    hw->rx_tl = I2C_BUS_RX_THRESHOLD - 1;
+    uint32_t mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+    if (dst_len > I2C_BUS_FIFO_DEPTH) {
+        mask |= I2C_IC_INTR_MASK_M_RX_FULL_BITS;
+    }
+
+    // Descarta uma notificação pendente de uma transação anterior interrompida.
+    ulTaskNotifyTakeIndexed(I2C_BUS_NOTIFY_INDEX, pdTRUE, 0);
+    (void)hw->clr_intr;
+
+    // A interrupção só é desmascarada depois do enchimento inicial: o
+    // tratador nunca mexe no FIFO em paralelo com a tarefa.
+    i2c_bus_fill(hw, transfer);
+    hw_set_bits(&hw->intr_mask, mask);
+
+    if (ulTaskNotifyTakeIndexed(I2C_BUS_NOTIFY_INDEX, pdTRUE, pdMS_TO_TICKS(I2C_BUS_TIMEOUT_MS)) == 0) {
+        // Sem STOP a tempo (ex: SCL preso por um dispositivo): aborta a transação.
+        hw->intr_mask = 0;
+        transfer->waiting_task = NULL;
+        hw_set_bits(&hw->enable, I2C_IC_ENABLE_ABORT_BITS);
+        return I2C_BUS_TIMEOUT;
+    }
+    transfer->waiting_task = NULL;
+
+    if (transfer->abort_source != 0 || transfer->received != dst_len) {
+        return I2C_BUS_NACK;
+    }
+    return I2C_BUS_OK;
+}
+
+i2c_bus_status_t __not_in_flash_func(i2c_bus_port_transfer_polled)(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src,
+                                                                   size_t src_len, uint8_t* dst, size_t dst_len) {
+    i2c_hw_t* hw = i2c_get_hw(i2c);
+    i2c_bus_transfer_t* transfer = &transfers[i2c_hw_index(i2c)];
+
+    hw->intr_mask = 0;
+    hw->enable = 0;
+    hw->tar = addr;
+    hw->enable = I2C_IC_ENABLE_ENABLE_BITS;
+
+    *transfer = (i2c_bus_transfer_t){
+        .src = src,
+        .src_len = src_len,
+        .dst = dst,
+        .dst_len = dst_len,
+    };
+    (void)hw->clr_intr;
+
+    // Os estados vêm do registo bruto: a transação não usa interrupções.
+    i2c_bus_status_t status = I2C_BUS_OK;
+    uint32_t start_us = time_us_32();
+    while (1) {
+        uint32_t raw = hw->raw_intr_stat;
+        if (raw & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+            transfer->abort_source = hw->tx_abrt_source;
+            (void)hw->clr_tx_abrt;
+            transfer->issued = transfer->src_len + transfer->dst_len;
+        }
+        i2c_bus_drain(hw, transfer);
+        if (raw & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS) {
+            (void)hw->clr_stop_det;
+            break;
+        }
+        if ((time_us_32() - start_us) >= I2C_BUS_TIMEOUT_MS * 1000u) {
+            hw_set_bits(&hw->enable, I2C_IC_ENABLE_ABORT_BITS);
+            status = I2C_BUS_TIMEOUT;
+            break;
+        }
+        i2c_bus_fill(hw, transfer);
+    }
+
+    if (status == I2C_BUS_OK && (transfer->abort_source != 0 || transfer->received != dst_len)) {
+        status = I2C_BUS_NACK;
+    }
+
+    // i2c_bus_fill() pode ter desmascarado TX_EMPTY: a interrupção que fica
+    // pendente encontra uma transação vazia.
+    hw->intr_mask = 0;
+    *transfer = (i2c_bus_transfer_t){ 0 };
+    return status;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file logger.c
+ * @brief Implementação do anel de registos e da tarefa que o esvazia.
+ *
+ * O Cortex-M0+ não tem instruções de acesso exclusivo (LDREX/STREX), pelo
+ * que o anel é protegido por um spinlock de hardware do RP2040 com as
+ * interrupções desativadas apenas durante a cópia do registo: um produtor
+ * nunca espera pelo stdio, só por outro produtor a meio de uma cópia.
+ */
+
+#include "logger.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdio.h>
+
+// Pausa da tarefa de registo quando o anel está vazio
+#define LOGGER_DRAIN_INTERVAL_MS 10
+
+#if (LOG_RING_SIZE & (LOG_RING_SIZE - 1)) != 0
+#error "LOG_RING_SIZE deve ser uma potência de 2"
+#endif
+
+/**
+ * @brief Um registo guardado no anel.
+ */
+typedef struct {
+    const char* fmt;
+    uint32_t timestamp_us;
+    uint8_t level;
+    uint8_t argc;
+    log_arg_t args[LOG_MAX_ARGS];
+} logger_record_t;
+
+static logger_record_t ring[LOG_RING_SIZE];
+static uint32_t ring_head;  /**< Próxima posição a escrever (contador livre). */
+static uint32_t ring_tail;  /**< Próxima posição a ler (contador livre). */
+static uint32_t dropped;    /**< Registos descartados com o anel cheio. */
+static spin_lock_t* ring_lock;
+
+static const char dropped_fmt[] = "[AVISO] %lu registos de log descartados (anel cheio).\n";
+
+void logger_init(void) {
+    ring_lock = spin_lock_instance((uint)spin_lock_claim_unused(true));
+}
+
+void logger_write(uint8_t level, const char* fmt, const log_arg_t* args, uint32_t argc) {
+    if (ring_lock == NULL) {
+        return;
+    }
+    if (argc > LOG_MAX_ARGS) {
+        argc = LOG_MAX_ARGS;
+    }
+
+    uint32_t timestamp_us = time_us_32();
+    uint32_t saved_irq = spin_lock_blocking(ring_lock);
+
+    if (ring_head - ring_tail >= LOG_RING_SIZE) {
+        dropped++;
+    } else {
+        logger_record_t* record = &ring[ring_head & (LOG_RING_SIZE - 1)];
+        record->fmt = fmt;
+        record->timestamp_us = timestamp_us;
+        record->level = level;
+        record->argc = (uint8_t)argc;
+        for (uint32_t i = 0; i < argc; i++) {
+            record->args[i] = args[i];
+        }
+        ring_head++;
+    }
+
+    spin_unlock(ring_lock, saved_irq);
+}
+
+/**
+ * @brief Retira o registo mais antigo do anel.
+ * @return true se havia um registo; com o anel vazio, `dropped_out` recebe
+ * os registos descartados desde a última chamada.
+ */
+static bool logger_pop(logger_record_t* out, uint32_t* dropped_out) {
+    bool found = false;
+    uint32_t saved_irq = spin_lock_blocking(ring_lock);
+
+    if (ring_tail != ring_head) {
+        *out = ring[ring_tail & (LOG_RING_SIZE - 1)];
+        ring_tail++;
+        found = true;
+    } else {
+        *dropped_out = dropped;
+        dropped = 0;
+    }
+
+    spin_unlock(ring_lock, saved_irq);
+    return found;
+}
+
+#if LOG_OUTPUT == LOG_OUTPUT_BINARY
+
+static void logger_put_u32(uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        putchar_raw((int)((value >> (8 * i)) & 0xFF));
+    }
+}
+
+/**
+ * @brief Envia o registo em binário, sem conversão de fim de linha.
+ *
+ * Trama: LOG_FRAME_MAGIC, nível, argc, endereço do formato, instante (µs)
+ * e os argumentos, em little-endian. O host obtém o formato (e as strings
+ * de argumentos `%s`) a partir do ELF do firmware.
+ */
+static void logger_emit(const logger_record_t* record) {
+    putchar_raw(LOG_FRAME_MAGIC);
+    putchar_raw(record->level);
+    putchar_raw(record->argc);
+    logger_put_u32((uint32_t)(uintptr_t)record->fmt);
+    logger_put_u32(record->timestamp_us);
+    for (uint32_t i = 0; i < record->argc; i++) {
+        logger_put_u32((uint32_t)record->args[i]);
+    }
+}
+
+#else
+
+/**
+ * @brief Formata o registo no stdio, precedido do instante em segundos.
+ *
+ * Os argumentos em falta são passados a zero; o formato só lê os seus.
+ */
+static void logger_emit(const logger_record_t* record) {
+    log_arg_t args[LOG_MAX_ARGS] = {0};
+    for (uint32_t i = 0; i < record->argc; i++) {
+        args[i] = record->args[i];
+    }
+
+    printf("%5lu.%03lu ", (unsigned long)(record->timestamp_us / 1000000u),
+           (unsigned long)((record->timestamp_us / 1000u) % 1000u));
+    printf(record->fmt, args[0], args[1], args[2], args[3], args[4], args[5]);
+}
+
+#endif // LOG_OUTPUT
+
+void logger_task(__unused void* params) {
+    logger_record_t record;
+    uint32_t lost = 0;
+
+    while (1) {
+        while (logger_pop(&record, &lost)) {
+            logger_emit(&record);
+        }
+
+        if (lost > 0) {
+            logger_record_t notice = {
+                .fmt = dropped_fmt,
+                .timestamp_us = time_us_32(),
+                .level = LOG_LEVEL_WARN,
+                .argc = 1,
+                .args = { lost }
+            };
+            logger_emit(&notice);
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(LOGGER_DRAIN_INTERVAL_MS));
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * @file logger.h
+ * @brief Interface pública do registo (log) diferido.
+ *
+ * As chamadas LOG_*() não formatam nem escrevem no stdio: guardam um
+ * registo compacto (ponteiro para o formato, instante, nível e até
+ * LOG_MAX_ARGS argumentos do tamanho de um ponteiro) num anel partilhado
+ * pelos dois núcleos. Uma tarefa de baixa prioridade (logger_task())
+ * esvazia o anel e formata os registos (LOG_OUTPUT TEXT) ou envia-os em
+ * binário para descodificação no host com tools/log_decode.py
+ * (LOG_OUTPUT BINARY).
+ *
+ * Regras para as chamadas:
+ * - o formato é uma string literal (fica na flash e identifica o registo);
+ * - os argumentos são inteiros de até 32 bits ou ponteiros;
+ * - um argumento `%s` tem de apontar para uma string permanente (literal
+ *   ou constante), pois é lida apenas quando o registo é formatado.
+ *
+ * Mensagens acima de LOG_LEVEL são removidas em tempo de compilação.
+ */
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stdint.h>
+
+#define LOG_LEVEL_ERROR 0
+#define LOG_LEVEL_WARN  1
+#define LOG_LEVEL_INFO  2
+#define LOG_LEVEL_DEBUG 3
+
+#define LOG_OUTPUT_TEXT   0
+#define LOG_OUTPUT_BINARY 1
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#ifndef LOG_OUTPUT
+#define LOG_OUTPUT LOG_OUTPUT_TEXT
+#endif
+
+/**
+ * @brief Número máximo de argumentos por registo.
+ */
+#define LOG_MAX_ARGS 6
+
+/**
+ * @brief Início de cada registo no fluxo binário (LOG_OUTPUT BINARY).
+ */
+#define LOG_FRAME_MAGIC 0xA5
+
+/**
+ * @brief Argumento de um registo: 32 bits no RP2040, 64 bits no build host.
+ *
+ * Com a largura de um ponteiro, um `%s` continua válido no host e um `%ld`
+ * recebe o valor com sinal estendido ao tamanho de `long`.
+ */
+typedef uintptr_t log_arg_t;
+
+/**
+ * @brief Prepara o anel de registos. Deve ser chamada antes de qualquer LOG_*().
+ */
+void logger_init(void);
+
+/**
+ * @brief Tarefa que esvazia o anel e escreve os registos no stdio.
+ *
+ * Deve ter a prioridade mais baixa do sistema: só ela bloqueia quando o
+ * host não lê o USB CDC.
+ */
+void logger_task(void* params);
+
+/**
+ * @brief Guarda um registo no anel. Usar através das macros LOG_*().
+ *
+ * Nunca bloqueia: com o anel cheio o registo é descartado e contado.
+ * Pode ser chamada de qualquer núcleo, tarefa ou interrupção.
+ *
+ * @param level O nível do registo.
+ * @param fmt O formato printf, uma string literal.
+ * @param args Os argumentos convertidos para log_arg_t.
+ * @param argc O número de argumentos (até LOG_MAX_ARGS).
+ */
+void logger_write(uint8_t level, const char* fmt, const log_arg_t* args, uint32_t argc);
+
+// Contagem e conversão dos argumentos das macros
+#define LOG_ARG(x) ((log_arg_t)(x))
+#define LOG_NARGS(...) LOG_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, n, ...) n
+#define LOG_ARGS_0()
+#define LOG_ARGS_1(a) LOG_ARG(a)
+#define LOG_ARGS_2(a, ...) LOG_ARG(a), LOG_ARGS_1(__VA_ARGS__)
+#define LOG_ARGS_3(a, ...) LOG_ARG(a), LOG_ARGS_2(__VA_ARGS__)
+#define LOG_ARGS_4(a, ...) LOG_ARG(a), LOG_ARGS_3(__VA_ARGS__)
+#define LOG_ARGS_5(a, ...) LOG_ARG(a), LOG_ARGS_4(__VA_ARGS__)
+#define LOG_ARGS_6(a, ...) LOG_ARG(a), LOG_ARGS_5(__VA_ARGS__)
+#define LOG_CONCAT(a, b) LOG_CONCAT_(a, b)
+#define LOG_CONCAT_(a, b) a##b
+
+#define LOG_AT(level, fmt, ...) do { \
+    if ((level) <= LOG_LEVEL) { \
+        const log_arg_t log_args_[] = { 0, LOG_CONCAT(LOG_ARGS_, LOG_NARGS(__VA_ARGS__))(__VA_ARGS__) }; \
+        logger_write((level), "" fmt, log_args_ + 1, LOG_NARGS(__VA_ARGS__)); \
+    } \
+} while (0)
+
+#define LOG_ERROR(fmt, ...) LOG_AT(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define LOG_WARN(fmt, ...)  LOG_AT(LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#define LOG_INFO(fmt, ...)  LOG_AT(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define LOG_DEBUG(fmt, ...) LOG_AT(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+
+#endif // LOGGER_H
@@ -0,0 +1,194 @@
+/**
+ * @file payload_encoder.c
+ * @brief Implementação dos codificadores JSON e CBOR do corpo de telemetria.
+ */
+
+#include "payload_encoder.h"
+#include <stdio.h>
+
+#if PAYLOAD_FORMAT == PAYLOAD_FORMAT_CBOR
+
+// Tipos principais (major types) do CBOR usados por este codificador.
+#define CBOR_MAJOR_UNSIGNED 0
+#define CBOR_MAJOR_NEGATIVE 1
+#define CBOR_MAJOR_ARRAY    4
+
+// Valor simples `null`, usado para os sensores ausentes de uma leitura.
+#define CBOR_NULL 0xF6
+
+/**
+ * @brief Destino dos bytes codificados.
+ */
+typedef struct {
+    payload_write_fn write;
+    void* context;
+    size_t len;
+} cbor_writer_t;
+
+/**
+ * @brief Escreve o cabeçalho de um item: tipo principal e argumento na forma mais curta.
+ */
+static void cbor_put_head(cbor_writer_t* w, uint8_t major, uint64_t value) {
+    uint8_t head[9];
+    size_t len;
+    uint8_t type = (uint8_t)(major << 5);
+
+    if (value < 24) {
+        head[0] = type | (uint8_t)value;
+        len = 1;
+    } else if (value <= 0xFF) {
+        head[0] = type | 24;
+        head[1] = (uint8_t)value;
+        len = 2;
+    } else if (value <= 0xFFFF) {
+        head[0] = type | 25;
+        head[1] = (uint8_t)(value >> 8);
+        head[2] = (uint8_t)value;
+        len = 3;
+    } else if (value <= 0xFFFFFFFFu) {
+        head[0] = type | 26;
+        head[1] = (uint8_t)(value >> 24);
+        head[2] = (uint8_t)(value >> 16);
+        head[3] = (uint8_t)(value >> 8);
+        head[4] = (uint8_t)value;
+        len = 5;
+    } else {
+        head[0] = type | 27;
+        for (size_t i = 8; i > 0; i--) {
+            head[i] = (uint8_t)value;
+            value >>= 8;
+        }
+        len = 9;
+    }
+
+    w->write(w->context, head, len);
+    w->len += len;
+}
+
+static void cbor_put_int(cbor_writer_t* w, int32_t value) {
+    if (value >= 0) {
+        cbor_put_head(w, CBOR_MAJOR_UNSIGNED, (uint32_t)value);
+    } else {
+        // Inteiros negativos são codificados como -1 - n.
+        cbor_put_head(w, CBOR_MAJOR_NEGATIVE, (uint32_t)(-1 - value));
+    }
+}
+
+static void cbor_put_null(cbor_writer_t* w) {
+    static const uint8_t null_item = CBOR_NULL;
+    w->write(w->context, &null_item, 1);
+    w->len++;
+}
+
+/**
+ * @brief Escreve o instante da leitura: o tempo Unix em ms, -1 - age_ms se
+ * a leitura foi feita antes da sincronização do relógio, ou null se é de
+ * um arranque anterior sem tempo Unix.
+ */
+static void cbor_put_time(cbor_writer_t* w, const batch_entry_t* entry, uint32_t now_ms) {
+    if (entry->epoch_ms != 0) {
+        cbor_put_head(w, CBOR_MAJOR_UNSIGNED, entry->epoch_ms);
+    } else if (entry->timestamp_unknown) {
+        cbor_put_null(w);
+    } else {
+        cbor_put_head(w, CBOR_MAJOR_NEGATIVE, now_ms - entry->timestamp_ms);
+    }
+}
+
+int payload_encode(const batch_entry_t* list, size_t count, uint32_t now_ms,
+                   payload_write_fn write, void* context) {
+    if (list == NULL || write == NULL) {
+        return -1;
+    }
+
+    cbor_writer_t w = { .write = write, .context = context, .len = 0 };
+
+    cbor_put_head(&w, CBOR_MAJOR_ARRAY, (uint32_t)count);
+    for (size_t i = 0; i < count; i++) {
+        cbor_put_head(&w, CBOR_MAJOR_ARRAY, PAYLOAD_CBOR_FIELDS);
+        cbor_put_time(&w, &list[i], now_ms);
+        for (sensor_id_t id = 0; id < SENSOR_COUNT; id++) {
+            if (list[i].reading.channels & SENSOR_CHANNEL(id)) {
+                cbor_put_int(&w, q16_to_centi(sensors_reading_value(&list[i].reading, id)));
+            } else {
+                cbor_put_null(&w);
+            }
+        }
+    }
+
+    return (int)w.len;
+}
+
+const char* payload_content_type(void) {
+    return "application/cbor";
+}
+
+#else
+
+// Maior objeto JSON de uma leitura: o instante (tempo Unix ou idade) e, por
+// sensor, o nome (até 24 caracteres) e o valor no pior caso.
+#define PAYLOAD_JSON_RECORD_SIZE (32 + 40 * SENSOR_COUNT)
+
+int payload_encode(const batch_entry_t* list, size_t count, uint32_t now_ms,
+                   payload_write_fn write, void* context) {
+    if (list == NULL || write == NULL) {
+        return -1;
+    }
+
+    char record[PAYLOAD_JSON_RECORD_SIZE];
+    size_t len = 0;
+
+    write(context, "[", 1);
+    len++;
+
+    for (size_t i = 0; i < count; i++) {
+        const char* separator = (i > 0) ? "," : "";
+        int written;
+        if (list[i].epoch_ms != 0) {
+            written = snprintf(record, sizeof(record), "%s{\"ts\":%llu",
+                               separator, (unsigned long long)list[i].epoch_ms);
+        } else if (list[i].timestamp_unknown) {
+            // De um arranque anterior e sem tempo Unix: a idade seria falsa.
+            written = snprintf(record, sizeof(record), "%s{", separator);
+        } else {
+            written = snprintf(record, sizeof(record), "%s{\"age_ms\":%lu",
+                               separator, (unsigned long)(now_ms - list[i].timestamp_ms));
+        }
+
+        // Apenas os sensores presentes na leitura.
+        for (sensor_id_t id = 0; id < SENSOR_COUNT; id++) {
+            if (written < 0 || (size_t)written >= sizeof(record)) {
+                break;
+            }
+            if (!(list[i].reading.channels & SENSOR_CHANNEL(id))) {
+                continue;
+            }
+            char value[16];
+            q16_format(value, sizeof(value), sensors_reading_value(&list[i].reading, id));
+            written += snprintf(record + written, sizeof(record) - (size_t)written,
+                                "%s\"%s\":%s", (record[written - 1] == '{') ? "" : ",",
+                                sensors_name(id), value);
+        }
+
+        if (written >= 0 && (size_t)written < sizeof(record)) {
+            written += snprintf(record + written, sizeof(record) - (size_t)written, "}");
+        }
+        if (written < 0 || (size_t)written >= sizeof(record)) {
+            return -1;
+        }
+
+        write(context, record, (size_t)written);
+        len += written;
+    }
+
+    write(context, "]", 1);
+    len++;
+
+    return (int)len;
+}
+
+const char* payload_content_type(void) {
+    return "application/json";
+}
+
+#endif
@@ -0,0 +1,81 @@
+/**
+ * @file payload_encoder.h
+ * @brief Interface pública para a codificação do corpo das requisições de telemetria.
+ *
+ * O formato é escolhido em tempo de compilação pela opção PAYLOAD_FORMAT do
+ * config.cmake:
+ * - PAYLOAD_FORMAT_JSON: array JSON de objetos, legível e compatível com o
+ *   servidor original.
+ * - PAYLOAD_FORMAT_CBOR: CBOR (RFC 8949), sem nenhuma formatação de vírgula
+ *   flutuante e cerca de 4x mais compacto.
+ *
+ * Cada leitura leva o instante de aquisição em tempo Unix (ms), ou, se foi
+ * feita antes da primeira sincronização SNTP (ver sntp_client.h), a sua
+ * idade no momento do envio. Uma leitura da flash de um arranque anterior
+ * sem tempo Unix não tem instante conhecido e é enviada sem nenhum dos dois.
+ *
+ * Layout CBOR: um array com uma entrada por leitura, cada entrada sendo um
+ * array de inteiros [tempo, <um por sensor>], com os sensores pela ordem da
+ * lista SENSORS do config.cmake (por omissão temperature, conductivity,
+ * flow) e os valores em centésimos (ex: 2534 = 25.34). Um sensor ausente da
+ * leitura (fora do seu período de amostragem) é `null` no CBOR e omitido no
+ * JSON. O tempo é um inteiro positivo com o tempo Unix em ms (`ts` no
+ * JSON), um negativo -1 - age_ms quando a hora ainda não é conhecida
+ * (`age_ms` no JSON), ou `null` quando o instante é desconhecido (nenhum
+ * dos dois campos no JSON). O descodificador de referência está em
+ * tools/payload_decode.py.
+ */
+#ifndef PAYLOAD_ENCODER_H
+#define PAYLOAD_ENCODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../batch_manager/batch_manager.h"
+
+#define PAYLOAD_FORMAT_JSON 0
+#define PAYLOAD_FORMAT_CBOR 1
+
+#ifndef PAYLOAD_FORMAT
+#define PAYLOAD_FORMAT PAYLOAD_FORMAT_JSON
+#endif
+
+/**
+ * @brief Número de campos de cada leitura no layout CBOR: o tempo e um por sensor.
+ */
+#define PAYLOAD_CBOR_FIELDS (1 + SENSOR_COUNT)
+
+/**
+ * @brief Função que recebe os bytes codificados (ex: http_tx_write()).
+ *
+ * @param context O contexto passado a payload_encode().
+ * @param data Os bytes codificados.
+ * @param len O número de bytes.
+ */
+typedef void (*payload_write_fn)(void* context, const void* data, size_t len);
+
+/**
+ * @brief Codifica uma lista de leituras no formato configurado.
+ *
+ * O corpo é entregue em pequenos pedaços a `write`, à medida que é gerado,
+ * sem nenhum buffer do tamanho do corpo. Cada leitura carrega o tempo Unix
+ * da aquisição (`ts`) ou, sem relógio sincronizado, a sua idade no momento
+ * do envio (`age_ms`), a partir da qual o servidor reconstrói o instante;
+ * leituras com `timestamp_unknown` e sem tempo Unix não levam nenhum.
+ *
+ * @param list As leituras a codificar.
+ * @param count O número de leituras em `list`.
+ * @param now_ms O instante atual, em ms desde o arranque.
+ * @param write A função que recebe os bytes codificados.
+ * @param context Contexto repassado a `write`.
+ * @return O tamanho do corpo gerado, ou -1 em caso de parâmetro inválido
+ * ou de leitura que não coube no buffer de formatação.
+ */
+int payload_encode(const batch_entry_t* list, size_t count, uint32_t now_ms,
+                   payload_write_fn write, void* context);
+
+/**
+ * @brief Retorna o valor do cabeçalho Content-Type do formato configurado.
+ */
+const char* payload_content_type(void);
+
+#endif // PAYLOAD_ENCODER_H
@@ -0,0 +1,61 @@
+/**
+ * @file report_filter.c
+ * @brief Implementação do envio por exceção.
+ */
+
+#include "report_filter.h"
+#include <stddef.h>
+#include <string.h>
+
+void report_filter_init(report_filter_t* filter) {
+    if (filter == NULL) {
+        return;
+    }
+    memset(filter, 0, sizeof(*filter));
+}
+
+void report_filter_set(report_filter_t* filter, sensor_id_t sensor, q16_t deadband,
+                       uint32_t heartbeat_ms) {
+    if (filter == NULL || sensor >= SENSOR_COUNT) {
+        return;
+    }
+    filter->deadband[sensor] = deadband < 0 ? 0 : deadband;
+    filter->heartbeat_ms[sensor] = heartbeat_ms;
+}
+
+sensor_mask_t report_filter_apply(report_filter_t* filter, sensors_reading_t* reading, uint32_t now_ms) {
+    if (filter == NULL || reading == NULL) {
+        return 0;
+    }
+
+    sensor_mask_t channels = 0;
+
+    for (sensor_id_t id = 0; id < SENSOR_COUNT; id++) {
+        if (!(reading->channels & SENSOR_CHANNEL(id))) {
+            continue;
+        }
+        filter->offered++;
+
+        q16_t value = sensors_reading_value(reading, id);
+        // Em 64 bits: a diferença entre extremos da faixa Q16.16 não cabe em 32.
+        int64_t change = (int64_t)value - filter->last_value[id];
+        if (change < 0) {
+            change = -change;
+        }
+
+        // A banda morta compara com o último valor enviado, não com a
+        // leitura anterior: uma deriva lenta acaba por ser enviada.
+        if (!(filter->reported & SENSOR_CHANNEL(id)) ||
+            change > filter->deadband[id] ||
+            (now_ms - filter->last_ms[id]) >= filter->heartbeat_ms[id]) {
+            channels |= SENSOR_CHANNEL(id);
+            filter->reported |= SENSOR_CHANNEL(id);
+            filter->last_value[id] = value;
+            filter->last_ms[id] = now_ms;
+            filter->passed++;
+        }
+    }
+
+    reading->channels = channels;
+    return channels;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file report_filter.h
+ * @brief Interface pública do envio por exceção (banda morta e pulsação por sensor).
+ *
+ * Num processo estável a maioria das leituras repete a anterior. O filtro
+ * fica entre a amostragem e o lote: um valor só segue para o servidor se
+ * se afastar do último valor enviado mais do que a banda morta do sensor,
+ * ou se o sensor estiver em silêncio há mais do que a sua pulsação
+ * (heartbeat). Uma leitura que segue carrega apenas os sensores alterados
+ * (máscara `channels` de sensors_reading_t); uma leitura sem nenhum é
+ * descartada.
+ */
+#ifndef REPORT_FILTER_H
+#define REPORT_FILTER_H
+
+#include <stdint.h>
+#include "../fixed_point/fixed_point.h"
+#include "../sensor_manager/sensor_manager.h"
+
+/**
+ * @struct report_filter_t
+ * @brief Estado do filtro. Deve ser preparado com report_filter_init().
+ */
+typedef struct {
+    q16_t deadband[SENSOR_COUNT];       /**< Variação mínima enviada, nas unidades do sensor (0 = todas). */
+    uint32_t heartbeat_ms[SENSOR_COUNT]; /**< Maior silêncio de cada sensor, em ms. */
+    q16_t last_value[SENSOR_COUNT];     /**< Último valor enviado de cada sensor. */
+    uint32_t last_ms[SENSOR_COUNT];     /**< Instante do último valor enviado. */
+    sensor_mask_t reported;             /**< Sensores com um valor já enviado (SENSOR_CHANNEL bits). */
+    uint32_t offered;                   /**< Valores recebidos, para estatística. */
+    uint32_t passed;                    /**< Valores enviados, para estatística. */
+} report_filter_t;
+
+/**
+ * @brief Prepara o estado do filtro, sem banda morta: todos os valores seguem.
+ *
+ * O primeiro valor de cada sensor segue sempre.
+ *
+ * @param filter O estado a ser inicializado.
+ */
+void report_filter_init(report_filter_t* filter);
+
+/**
+ * @brief Define a política de um sensor.
+ *
+ * Pode ser chamada a qualquer momento (ex: após um X-Config): o último
+ * valor enviado é mantido.
+ *
+ * @param filter O estado do filtro.
+ * @param sensor O sensor.
+ * @param deadband A variação mínima enviada, nas unidades do sensor (0 = todas).
+ * @param heartbeat_ms O maior silêncio do sensor, em ms.
+ */
+void report_filter_set(report_filter_t* filter, sensor_id_t sensor, q16_t deadband,
+                       uint32_t heartbeat_ms);
+
+/**
+ * @brief Retira da leitura os sensores que não precisam de ser enviados.
+ *
+ * Os sensores que seguem passam a ser a referência da banda morta e da
+ * pulsação.
+ *
+ * @param filter O estado do filtro.
+ * @param reading A leitura; a máscara `channels` é reduzida aos sensores a enviar.
+ * @param now_ms O instante da aquisição, em ms desde o arranque.
+ * @return A nova máscara `channels`; 0 se a leitura não deve ser enviada.
+ */
+sensor_mask_t report_filter_apply(report_filter_t* filter, sensors_reading_t* reading, uint32_t now_ms);
+
+#endif // REPORT_FILTER_H
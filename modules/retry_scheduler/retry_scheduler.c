@@ -0,0 +1,120 @@
+/**
+ * @file retry_scheduler.c
+ * @brief Implementação do agendador de novas tentativas de envio.
+ *
+ * O jitter evita que os dispositivos da frota, que perdem a ligação ao mesmo
+ * tempo numa falha do servidor, voltem a tentar todos no mesmo instante.
+ */
+
+#include "retry_scheduler.h"
+#include "pico/rand.h"
+#include "../logger/logger.h"
+
+/**
+ * @brief Sorteia uma espera em [limit/2, limit] ("equal jitter").
+ *
+ * Metade da espera é garantida, pelo que o backoff nunca colapsa para
+ * valores próximos de zero; a outra metade dispersa os dispositivos.
+ */
+static uint32_t retry_jitter(uint32_t limit_ms) {
+    uint32_t half = limit_ms / 2;
+    return half + get_rand_32() % (limit_ms - half + 1);
+}
+
+/**
+ * @brief Limite do backoff exponencial após `failures` falhas consecutivas.
+ */
+static uint32_t retry_backoff_limit(uint32_t failures) {
+    uint32_t limit = RETRY_BASE_MS;
+
+    for (uint32_t i = 1; i < failures && limit < RETRY_MAX_MS; i++) {
+        limit *= 2;
+    }
+    return (limit < RETRY_MAX_MS) ? limit : RETRY_MAX_MS;
+}
+
+retry_result_t retry_classify(http_status_t status, uint16_t http_code) {
+    switch (status) {
+    case HTTP_OK:
+        return RETRY_RESULT_SUCCESS;
+
+    case HTTP_ERROR_INVALID_IP:
+    case HTTP_ERROR_REQUEST_TOO_LARGE:
+    case HTTP_ERROR_ENCODE_FAILED:
+        return RETRY_RESULT_PERMANENT;
+
+    case HTTP_ERROR_SERVER_REJECTED:
+        if (http_code == 400 || http_code == 413 || http_code == 415 || http_code == 422) {
+            return RETRY_RESULT_PERMANENT;
+        }
+        return RETRY_RESULT_TRANSIENT;
+
+    default:
+        // Conexão, envio, receção, timeout, sockets esgotados.
+        return RETRY_RESULT_TRANSIENT;
+    }
+}
+
+bool retry_scheduler_may_attempt(retry_scheduler_t* sched, uint32_t now_ms) {
+    if (!sched->waiting) {
+        return true;
+    }
+
+    if ((int32_t)(now_ms - sched->next_attempt_ms) < 0) {
+        return false;
+    }
+
+    sched->waiting = false;
+    if (sched->state == RETRY_BREAKER_OPEN) {
+        LOG_INFO("[INFO] Disjuntor semiaberto: tentativa de prova.\n");
+        sched->state = RETRY_BREAKER_HALF_OPEN;
+    }
+    return true;
+}
+
+void retry_scheduler_record(retry_scheduler_t* sched, uint32_t now_ms,
+                            retry_result_t result, uint32_t retry_after_s) {
+    // Um sucesso ou uma rejeição permanente do conteúdo mostram que o
+    // servidor está acessível: o disjuntor fecha (também a partir da
+    // tentativa de prova) e o próximo envio não é adiado.
+    if (result != RETRY_RESULT_TRANSIENT) {
+        if (sched->state != RETRY_BREAKER_CLOSED || sched->failures > 0) {
+            LOG_INFO("[OK] Envios restabelecidos após %lu falhas.\n", (unsigned long)sched->failures);
+        }
+        sched->state = RETRY_BREAKER_CLOSED;
+        sched->failures = 0;
+        sched->waiting = false;
+        return;
+    }
+
+    sched->failures++;
+
+    uint32_t wait_ms;
+    if (sched->state == RETRY_BREAKER_HALF_OPEN || sched->failures >= RETRY_BREAKER_THRESHOLD) {
+        if (sched->state != RETRY_BREAKER_OPEN) {
+            LOG_WARN("[AVISO] Disjuntor aberto após %lu falhas consecutivas.\n",
+                     (unsigned long)sched->failures);
+        }
+        sched->state = RETRY_BREAKER_OPEN;
+        wait_ms = retry_jitter(RETRY_BREAKER_OPEN_MS);
+    } else {
+        wait_ms = retry_jitter(retry_backoff_limit(sched->failures));
+    }
+
+    // O Retry-After do servidor é um mínimo, limitado contra valores absurdos.
+    if (retry_after_s != HTTP_PARSER_NO_RETRY_AFTER) {
+        uint32_t after_s = (retry_after_s < RETRY_MAX_AFTER_S) ? retry_after_s : RETRY_MAX_AFTER_S;
+        if (after_s * 1000u > wait_ms) {
+            wait_ms = after_s * 1000u;
+        }
+    }
+
+    sched->waiting = true;
+    sched->next_attempt_ms = now_ms + wait_ms;
+    LOG_WARN("[AVISO] Próximo envio adiado %lu ms.\n", (unsigned long)wait_ms);
+}
+
+uint32_t retry_scheduler_wait_ms(const retry_scheduler_t* sched, uint32_t now_ms) {
+    int32_t remaining = (int32_t)(sched->next_attempt_ms - now_ms);
+    return (sched->waiting && remaining > 0) ? (uint32_t)remaining : 0;
+}
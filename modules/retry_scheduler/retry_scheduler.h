@@ -0,0 +1,97 @@
+/**
+ * @file retry_scheduler.h
+ * @brief Interface pública do agendador de novas tentativas de envio.
+ *
+ * Após falhas transitórias os envios são adiados com backoff exponencial e
+ * jitter, respeitando o Retry-After do servidor. Falhas consecutivas abrem
+ * um disjuntor (circuit breaker) que suspende os envios por um período
+ * longo; findo esse período uma única tentativa de prova decide se o
+ * disjuntor fecha ou volta a abrir.
+ */
+#ifndef RETRY_SCHEDULER_H
+#define RETRY_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../http_client/http_client.h"
+
+/**
+ * @enum retry_breaker_state_t
+ * @brief Estados do disjuntor.
+ */
+typedef enum {
+    RETRY_BREAKER_CLOSED,    /**< Envios normais, com backoff após cada falha. */
+    RETRY_BREAKER_OPEN,      /**< Envios suspensos por RETRY_BREAKER_OPEN_MS. */
+    RETRY_BREAKER_HALF_OPEN  /**< Uma tentativa de prova em curso. */
+} retry_breaker_state_t;
+
+/**
+ * @enum retry_result_t
+ * @brief Classificação do resultado de um envio.
+ */
+typedef enum {
+    RETRY_RESULT_SUCCESS,    /**< O servidor confirmou o envio. */
+    RETRY_RESULT_TRANSIENT,  /**< Falha de rede ou do servidor: repetir mais tarde. */
+    RETRY_RESULT_PERMANENT   /**< Repetir o mesmo envio falharia de novo. */
+} retry_result_t;
+
+/**
+ * @struct retry_scheduler_t
+ * @brief Estado do agendador. Uma variável estática (a zeros) começa fechada e sem espera.
+ */
+typedef struct {
+    retry_breaker_state_t state;
+    uint32_t failures;        /**< Falhas transitórias consecutivas. */
+    bool waiting;             /**< Há um instante mínimo para a próxima tentativa. */
+    uint32_t next_attempt_ms; /**< Instante a partir do qual se pode tentar, se `waiting`. */
+} retry_scheduler_t;
+
+/**
+ * @brief Classifica o resultado de um envio.
+ *
+ * Timeouts, falhas de conexão, envio ou receção, e respostas 408, 429 e
+ * 5xx são transitórias. Um IP inválido, um corpo que não cabe na requisição
+ * e as rejeições do conteúdo pelo servidor (400, 413, 415, 422) são
+ * permanentes; as restantes rejeições 4xx (ex: 401, 404) dependem da
+ * configuração do servidor e são tratadas como transitórias.
+ *
+ * @param status O resultado do cliente HTTP.
+ * @param http_code O código de estado da resposta, usado com HTTP_ERROR_SERVER_REJECTED.
+ * @return A classificação do resultado.
+ */
+retry_result_t retry_classify(http_status_t status, uint16_t http_code);
+
+/**
+ * @brief Indica se um envio pode ser tentado agora.
+ *
+ * Terminado o período do disjuntor aberto, a tentativa autorizada é a de
+ * prova (estado RETRY_BREAKER_HALF_OPEN).
+ *
+ * @param sched O agendador.
+ * @param now_ms O instante atual, em ms desde o arranque.
+ * @return true se o envio pode ser feito, false se deve ser adiado.
+ */
+bool retry_scheduler_may_attempt(retry_scheduler_t* sched, uint32_t now_ms);
+
+/**
+ * @brief Regista o resultado de uma tentativa e agenda a próxima.
+ *
+ * Um sucesso ou um resultado permanente fecham o disjuntor e anulam as
+ * falhas; um resultado transitório adia a próxima tentativa e, na prova
+ * ou ao fim de RETRY_BREAKER_THRESHOLD falhas, abre o disjuntor.
+ *
+ * @param sched O agendador.
+ * @param now_ms O instante da tentativa, em ms desde o arranque.
+ * @param result A classificação do resultado (ver retry_classify()).
+ * @param retry_after_s O Retry-After da resposta em segundos, ou
+ * HTTP_PARSER_NO_RETRY_AFTER.
+ */
+void retry_scheduler_record(retry_scheduler_t* sched, uint32_t now_ms,
+                            retry_result_t result, uint32_t retry_after_s);
+
+/**
+ * @brief Retorna o tempo em ms até à próxima tentativa autorizada (0 se já autorizada).
+ */
+uint32_t retry_scheduler_wait_ms(const retry_scheduler_t* sched, uint32_t now_ms);
+
+#endif // RETRY_SCHEDULER_H
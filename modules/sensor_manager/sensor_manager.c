@@ -2,85 +2,184 @@
 * @file sensor_manager.c
 * @brief Implementation of sensor reading management
 *
-* Contains the initialization logic, conversion (calibration) functions
+* Contains the initialization logic, sensor calibrations
 * and analog sensor readings.
 */
 #include "sensor_manager.h"
-#include <stdio.h>
+#include "../logger/logger.h"
+#include <stdlib.h>
+#include "pico/stdlib.h"
 #include "../analog_sensor/analog_sensor.h" 
 #include "../adc_manager/adc_manager.h"
 
-static float convert_linear_interpolation(float v, float max_v, float max_value, float min_value) {
-    if (v < 0.0f) {
-        return SENSOR_READ_ERROR;
-    }
-    if (max_v == 0.0f) {
-        return min_value;
-    }
+static analog_filter_t sensor_filters[SENSOR_COUNT];
 
-    float value_range = max_value - min_value;
-    return min_value + (v * (value_range / max_v));
-}
+// Each conversion kind of the table maps to its own compile-time
+// calibration macro (e.g., LINEAR -> ANALOG_SENSOR_LINEAR_CAL).
+#define SENSOR_TABLE_CAL(kind, max_voltage, max_value, min_value) \
+    ANALOG_SENSOR_##kind##_CAL(max_voltage, max_value, min_value)
 
-static const analog_sensor_t temperature_sensor = {
-    .adc_channel = ADS1115_MUX_SINGLE_0,
-    .param1      = SENSOR_TEMPERATURE_MAX_VOLTAGE, 
-    .param2      = SENSOR_TEMPERATURE_MAX_VALUE,  
-    .param3      = SENSOR_TEMPERATURE_MIN_VALUE,   
-    .convert     = convert_linear_interpolation
+// Indexed by sensor_id_t, generated from the SENSORS list of config.cmake
+static const analog_sensor_t sensors[SENSOR_COUNT] = {
+#define SENSOR_TABLE_ENTRY(id, name, unit, dev, ch, conv, max_voltage, max_value, min_value, \
+                           filt, win, ...)                                                   \
+    [SENSOR_##id] = {                                                                        \
+        .adc_device   = (dev),                                                               \
+        .adc_channel  = ADS1115_MUX_SINGLE_##ch,                                             \
+        .cal          = SENSOR_TABLE_CAL(conv, max_voltage, max_value, min_value),           \
+        .filter       = { .kind = ANALOG_FILTER_##filt, .window = (win) },                   \
+        .filter_state = &sensor_filters[SENSOR_##id]                                         \
+    },
+    SENSOR_TABLE(SENSOR_TABLE_ENTRY)
+#undef SENSOR_TABLE_ENTRY
 };
 
-static const analog_sensor_t conductivity_sensor = {
-    .adc_channel = ADS1115_MUX_SINGLE_1,
-    .param1      = SENSOR_CONDUCTIVITY_MAX_VOLTAGE, 
-    .param2      = SENSOR_CONDUCTIVITY_MAX_VALUE,  
-    .param3      = SENSOR_CONDUCTIVITY_MIN_VALUE,   
-    .convert     = convert_linear_interpolation
+static const char* const sensor_names[SENSOR_COUNT] = {
+#define SENSOR_TABLE_NAME(id, name, ...) [SENSOR_##id] = name,
+    SENSOR_TABLE(SENSOR_TABLE_NAME)
+#undef SENSOR_TABLE_NAME
 };
 
-static const analog_sensor_t flow_sensor = {
-    .adc_channel = ADS1115_MUX_SINGLE_2,
-    .param1      = SENSOR_FLOW_MAX_VOLTAGE, 
-    .param2      = SENSOR_FLOW_MAX_VALUE,  
-    .param3      = SENSOR_FLOW_MIN_VALUE,   
-    .convert     = convert_linear_interpolation
+static const char* const sensor_units[SENSOR_COUNT] = {
+#define SENSOR_TABLE_UNIT(id, name, unit, ...) [SENSOR_##id] = unit,
+    SENSOR_TABLE(SENSOR_TABLE_UNIT)
+#undef SENSOR_TABLE_UNIT
 };
 
+/**
+ * @brief Routes each sample of the ADC stream to the filter of its sensor
+ *
+ * Runs in the ADC acquisition task, at the converter rate
+ */
+static void sensors_on_adc_sample(uint8_t device, enum ads1115_mux_t channel, int16_t raw,
+                                  __unused void* context) {
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        if (sensors[i].adc_device == device && sensors[i].adc_channel == channel) {
+            analog_sensor_push_sample(&sensors[i], raw);
+        }
+    }
+}
+
 int sensors_init(void) {
-    printf("[INFO] Inicializando sensores...\n");
+    LOG_INFO("[INFO] Inicializando sensores...\n");
 
     if (adc_module_init() != ADC_STATUS_OK) {
-        printf("[ERRO FATAL] Falha ao inicializar o módulo ADC. Verifique o hardware.\n");
+        LOG_ERROR("[ERRO FATAL] Falha ao inicializar o módulo ADC. Verifique o hardware.\n");
+        return 1;
+    }
+
+    // Continuous conversion streams every sample into the sensor filters,
+    // which decimate it down to one value per report.
+    adc_input_t inputs[SENSOR_COUNT];
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        analog_sensor_init(&sensors[i]);
+        inputs[i].device = sensors[i].adc_device;
+        inputs[i].channel = sensors[i].adc_channel;
+    }
+    adc_module_set_sample_callback(sensors_on_adc_sample, NULL);
+
+    if (adc_module_start_acquisition(inputs, SENSOR_COUNT) != ADC_STATUS_OK) {
+        LOG_ERROR("[ERRO FATAL] Falha ao iniciar a aquisição contínua do ADC.\n");
         return 1;
     }
 
-    printf("[OK] Sensores inicializados com sucesso.\n");
+#if ANALOG_SENSOR_BENCHMARK
+    analog_sensor_benchmark();
+#endif
+
+    LOG_INFO("[OK] Sensores inicializados com sucesso.\n");
     return 0;
 }
 
 int sensors_read_all(sensors_reading_t* reading) {
+    return sensors_read(reading, SENSOR_CHANNELS_ALL);
+}
+
+int sensors_read(sensors_reading_t* reading, sensor_mask_t channels) {
     if (!reading) {
-        printf("[ERRO] Ponteiro para leitura dos sensores é nulo.\n");
+        LOG_ERROR("[ERRO] Ponteiro para leitura dos sensores é nulo.\n");
         return 1;
     }
 
-    // // Verificação da conexão com o módulo ADC ADS1115.
-    // if (!adc_module_is_connected()) {
-    //     printf("[ERRO EM EXECUÇÃO] Perda de comunicação com o ADC.\n");
-    //     reading->temperature_c = SENSOR_READ_ERROR;
-    //     reading->conductivity_percent = SENSOR_READ_ERROR;
-    //     reading->flow_liter = SENSOR_READ_ERROR;
-    //     return 1;
-    // }
+    int32_t codes[SENSOR_COUNT] = { 0 };
+    sensor_mask_t requested = channels & SENSOR_CHANNELS_ALL;
+
+    reading->channels = requested;
+    reading->timestamp_us = time_us_64();
 
-    // float temp_v, cond_v, flow_v;
+    // Um sensor que falha sai da leitura; os restantes mantêm-se.
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        reading->values[i] = 0;
+        if ((requested & SENSOR_CHANNEL(i)) &&
+            analog_sensor_read(&sensors[i], &codes[i], &reading->values[i]) != 0) {
+            LOG_ERROR("[ERRO EM EXECUÇÃO] Falha na leitura do ADC: %s.\n", sensor_names[i]);
+            reading->channels &= (sensor_mask_t)~SENSOR_CHANNEL(i);
+        }
+    }
 
-    // analog_sensor_read(&temperature_sensor, &temp_v, &reading->temperature_c);
-    // analog_sensor_read(&conductivity_sensor, &cond_v, &reading->conductivity_percent);
-    // analog_sensor_read(&flow_sensor, &flow_v, &reading->flow_liter);
+    if (requested != 0 && reading->channels == 0) {
+        for (size_t i = 0; i < SENSOR_COUNT; i++) {
+            reading->values[i] = SENSOR_READ_ERROR;
+        }
+        return 1;
+    }
 
-    printf("[DADOS] Temp: %.2f C (%.5f V) | Cond: %.2f %% (%.5f V) | Flow: %.2f L/min (%.5f V)\n", 
-           1,1,1,1,1,1
-    );
+    // Apenas inteiros e strings constantes: o registo é formatado mais
+    // tarde, pela tarefa de log, que não pode ler strings formatadas na
+    // pilha desta função.
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        if (reading->channels & SENSOR_CHANNEL(i)) {
+            int32_t centi = q16_to_centi(reading->values[i]);
+            LOG_DEBUG("[DADOS] %s: %ld.%02ld %s (código ADC %ld)\n", sensor_names[i],
+                      centi / 100, labs(centi % 100), sensor_units[i], codes[i]);
+        }
+    }
     return 0;
-}
\ No newline at end of file
+}
+
+const char* sensors_name(sensor_id_t id) {
+    return (id < SENSOR_COUNT) ? sensor_names[id] : NULL;
+}
+
+const char* sensors_unit(sensor_id_t id) {
+    return (id < SENSOR_COUNT) ? sensor_units[id] : NULL;
+}
+
+void sensors_schedule_init(sensors_schedule_t* schedule, const uint32_t interval_ms[SENSOR_COUNT],
+                           uint32_t now_ms) {
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        schedule->interval_ms[i] = interval_ms[i];
+        schedule->next_ms[i] = now_ms;
+    }
+}
+
+sensor_mask_t sensors_schedule_due(sensors_schedule_t* schedule, uint32_t now_ms) {
+    sensor_mask_t due = 0;
+
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        if ((int32_t)(now_ms - schedule->next_ms[i]) < 0) {
+            continue;
+        }
+        due |= SENSOR_CHANNEL(i);
+        schedule->next_ms[i] += schedule->interval_ms[i];
+        if ((int32_t)(now_ms - schedule->next_ms[i]) >= 0) {
+            schedule->next_ms[i] = now_ms + schedule->interval_ms[i];
+        }
+    }
+    return due;
+}
+
+uint32_t sensors_schedule_wait_ms(const sensors_schedule_t* schedule, uint32_t now_ms) {
+    uint32_t wait_ms = UINT32_MAX;
+
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        int32_t remaining = (int32_t)(schedule->next_ms[i] - now_ms);
+        if (remaining <= 0) {
+            return 0;
+        }
+        if ((uint32_t)remaining < wait_ms) {
+            wait_ms = (uint32_t)remaining;
+        }
+    }
+    return wait_ms;
+}
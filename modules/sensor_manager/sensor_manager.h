@@ -5,6 +5,10 @@
 #ifndef SENSOR_MANAGER_H
 #define SENSOR_MANAGER_H
 
+#include <stdint.h>
+#include "../fixed_point/fixed_point.h"
+#include "sensor_table.h"
+
 /**
 * @brief Error value used in the fields of the reading structure
 *
@@ -14,20 +18,63 @@
 * Used to populate the 'sensors_reading_t' fields when
 * 'sensors_read_all()' returns an error code
 */
-#define SENSOR_READ_ERROR -1.0f
+#define SENSOR_READ_ERROR Q16_FROM_INT(-1)
+
+/**
+ * @brief Identifies each sensor, in the order of the SENSORS list of config.cmake
+ *
+ * Generated from 'sensor_table.h': a sensor named "flow" is SENSOR_FLOW
+ */
+typedef enum {
+#define SENSOR_TABLE_ID(id, ...) SENSOR_##id,
+    SENSOR_TABLE(SENSOR_TABLE_ID)
+#undef SENSOR_TABLE_ID
+    SENSOR_COUNT
+} sensor_id_t;
+
+/**
+ * @brief Set of sensors, one bit per sensor_id_t (up to 4 ADS1115 x 4 inputs)
+ */
+typedef uint16_t sensor_mask_t;
+
+/**
+ * @brief Bit of a sensor in the 'channels' mask of 'sensors_reading_t'
+ */
+#define SENSOR_CHANNEL(id) ((sensor_mask_t)(1u << (id)))
+
+/**
+ * @brief Mask with every sensor present
+ */
+#define SENSOR_CHANNELS_ALL ((sensor_mask_t)((1u << SENSOR_COUNT) - 1))
+
+_Static_assert(SENSOR_COUNT <= 16, "The channel mask holds at most 16 sensors");
 
 /**
  * @brief Structure for sensor reading data
  * 
- * This structure is populated by the 'sensors_read_all()' function
- * In case of reading failure, the fields will contain SENSOR_READ_ERROR
+ * This structure is populated by the 'sensors_read()' function
+ * All values are Q16.16 fixed-point (see fixed_point.h), in the unit of
+ * each sensor (SENSOR_<NAME>_UNIT in config.cmake)
+ * Only the values flagged in 'channels' were read; the others are meaningless
+ * A sensor whose read failed is left out of 'channels' and holds SENSOR_READ_ERROR
  */
 typedef struct {
-    float temperature; /**< Temperature value in degrees Celsius */
-    float conductivity; /**< Conductivity value in microsiemens per centimeter */
-    float flow; /**< Flow rate value in liters */
+    q16_t values[SENSOR_COUNT]; /**< Value of each sensor, indexed by sensor_id_t */
+    sensor_mask_t channels; /**< Sensors present in this reading (SENSOR_CHANNEL bits) */
+    uint64_t timestamp_us; /**< Acquisition instant, time_us_64() when the filter windows closed */
 } sensors_reading_t;
 
+/**
+ * @brief Per-sensor sampling schedule
+ *
+ * Each sensor is read on its own period; a reading carries only the
+ * sensors that were due at that instant
+ */
+typedef struct {
+    uint32_t interval_ms[SENSOR_COUNT]; /**< Sampling period of each sensor */
+    uint32_t next_ms[SENSOR_COUNT];     /**< Next instant each sensor is due */
+} sensors_schedule_t;
+
 /**
  * @brief Initializes all sensors and hardware modules
  * 
@@ -43,9 +90,10 @@ int sensors_init(void);
  * 
  * @param reading [out] Pointer to the structure where the data was read
  * 
- * @return 0 on success (all data was read)
- * @return 1 on error (e.g., 'reading' pointer is NULL or communication failure
- * with the ADC hardware)
+ * @return 0 on success (at least one sensor was read; the sensors that failed
+ * are left out of 'channels')
+ * @return 1 on error (e.g., 'reading' pointer is NULL or every requested
+ * sensor failed to read)
  * 
  * @warning In case of an error (return 1),
  * all fields of the 'reading' structure will be
@@ -53,4 +101,72 @@ int sensors_init(void);
  */
 int sensors_read_all(sensors_reading_t* reading);
 
+/**
+ * @brief Reads only the sensors selected in a channel mask
+ *
+ * Each selected sensor closes its filter window, so a sensor read less often
+ * averages over a longer period. The reading is stamped with the instant the
+ * windows closed ('timestamp_us'), on the monotonic clock
+ *
+ * @param reading [out] Pointer to the structure where the data was read
+ * @param channels Sensors to read (SENSOR_CHANNEL bits)
+ *
+ * @return 0 on success, 1 on error (same contract as 'sensors_read_all()')
+ */
+int sensors_read(sensors_reading_t* reading, sensor_mask_t channels);
+
+/**
+ * @brief Returns the name of a sensor, as used in the payload and in the configuration
+ *
+ * @param id The sensor
+ * @return The name (e.g., "temperature"), or NULL for an invalid id
+ */
+const char* sensors_name(sensor_id_t id);
+
+/**
+ * @brief Returns the engineering unit of a sensor (e.g., "C")
+ *
+ * @param id The sensor
+ * @return The unit, or NULL for an invalid id
+ */
+const char* sensors_unit(sensor_id_t id);
+
+/**
+ * @brief Value of a sensor in a reading
+ */
+static inline q16_t sensors_reading_value(const sensors_reading_t* reading, sensor_id_t id) {
+    return reading->values[id];
+}
+
+/**
+ * @brief Starts a schedule with every sensor due at 'now_ms'
+ *
+ * @param schedule The schedule
+ * @param interval_ms Sampling period of each sensor, indexed by sensor_id_t
+ * @param now_ms Current instant, in ms since boot
+ */
+void sensors_schedule_init(sensors_schedule_t* schedule, const uint32_t interval_ms[SENSOR_COUNT],
+                           uint32_t now_ms);
+
+/**
+ * @brief Returns the sensors due at 'now_ms' and advances their deadlines
+ *
+ * Missed periods are not made up in a burst: a late sensor is due once and
+ * its next deadline is one period from now
+ *
+ * @param schedule The schedule
+ * @param now_ms Current instant, in ms since boot
+ * @return Mask of the sensors to read (SENSOR_CHANNEL bits), possibly 0
+ */
+sensor_mask_t sensors_schedule_due(sensors_schedule_t* schedule, uint32_t now_ms);
+
+/**
+ * @brief Time until the next sensor is due
+ *
+ * @param schedule The schedule
+ * @param now_ms Current instant, in ms since boot
+ * @return Milliseconds to wait, 0 if a sensor is already due
+ */
+uint32_t sensors_schedule_wait_ms(const sensors_schedule_t* schedule, uint32_t now_ms);
+
 #endif // SENSOR_MANAGER_H
@@ -0,0 +1,229 @@
+/**
+ * @file sntp_client.c
+ * @brief Implementação do cliente SNTP sobre um socket UDP do W5500.
+ *
+ * Cada consulta mede os quatro instantes do RFC 4330: t1 (envio) e t4
+ * (receção) no relógio monotónico, T2 e T3 no relógio do servidor. A
+ * diferença entre os dois relógios é ((T2 - t1) + (T3 - t4)) / 2, exata
+ * quando os atrasos de ida e de volta são iguais; o erro fica limitado a
+ * metade do tempo de ida e volta, que numa rede local é de poucos ms.
+ */
+
+#include "sntp_client.h"
+#include "ethernet_manager.h"
+#include "socket.h"
+#include "../logger/logger.h"
+#include "pico/stdlib.h"
+#include <string.h>
+
+#define SNTP_PACKET_SIZE 48
+
+// Maior datagrama lido do socket (cabeçalho NTP mais extensões ou autenticação)
+#define SNTP_RX_BUFFER_SIZE 96
+
+// Primeiro byte do pedido: LI = 0, VN = 4, Mode = 3 (cliente)
+#define SNTP_REQUEST_FLAGS ((4u << 3) | 3u)
+
+#define SNTP_MODE_SERVER 4
+#define SNTP_LI_ALARM 3
+
+// Segundos entre a época NTP (1900) e a época Unix (1970)
+#define SNTP_UNIX_EPOCH_OFFSET_S 2208988800ull
+
+// Posição dos campos no pacote NTP
+#define SNTP_OFFSET_STRATUM 1
+#define SNTP_OFFSET_ORIGINATE 24
+#define SNTP_OFFSET_RECEIVE 32
+#define SNTP_OFFSET_TRANSMIT 40
+
+static const uint8_t server_ip[4] = {
+    SNTP_SERVER_IP_0, SNTP_SERVER_IP_1, SNTP_SERVER_IP_2, SNTP_SERVER_IP_3
+};
+
+/**
+ * @brief Tempo Unix menos time_us_64(), em us; válido com `synced`.
+ */
+static int64_t epoch_offset_us = 0;
+static bool synced = false;
+
+static uint32_t next_sync_ms = 0;
+
+static uint64_t sntp_read_u64(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+static void sntp_write_u64(uint8_t* p, uint64_t value) {
+    for (int i = 7; i >= 0; i--) {
+        p[i] = (uint8_t)value;
+        value >>= 8;
+    }
+}
+
+/**
+ * @brief Converte um timestamp NTP (32.32 s desde 1900) em us desde 1970.
+ *
+ * Segundos com o bit mais significativo a 0 pertencem à era seguinte,
+ * a partir de 2036 (RFC 4330, secção 3).
+ */
+static int64_t sntp_timestamp_to_unix_us(uint64_t timestamp) {
+    uint64_t seconds = timestamp >> 32;
+    uint64_t fraction = timestamp & 0xFFFFFFFFull;
+
+    if ((seconds & 0x80000000ull) == 0) {
+        seconds += 0x100000000ull;
+    }
+    return (int64_t)((seconds - SNTP_UNIX_EPOCH_OFFSET_S) * 1000000ull + ((fraction * 1000000ull) >> 32));
+}
+
+/**
+ * @brief Valida a resposta e atualiza a diferença entre os relógios.
+ */
+static sntp_status_t sntp_process_reply(const uint8_t* reply, int32_t len, uint64_t request_tx, uint64_t t1_us,
+                                        uint64_t t4_us) {
+    if (len < SNTP_PACKET_SIZE) {
+        return SNTP_ERROR_INVALID_REPLY;
+    }
+
+    uint8_t leap = reply[0] >> 6;
+    uint8_t mode = reply[0] & 0x07;
+    uint8_t stratum = reply[SNTP_OFFSET_STRATUM];
+
+    // O Originate tem de ecoar o Transmit do pedido: descarta respostas
+    // atrasadas de consultas anteriores e datagramas forjados.
+    if (mode != SNTP_MODE_SERVER || sntp_read_u64(&reply[SNTP_OFFSET_ORIGINATE]) != request_tx) {
+        return SNTP_ERROR_INVALID_REPLY;
+    }
+    // Estrato 0 é um "kiss-o'-death"; LI = 3 indica um servidor sem sincronização.
+    if (stratum == 0 || stratum > 15 || leap == SNTP_LI_ALARM) {
+        LOG_WARN("[AVISO] Servidor SNTP não sincronizado (estrato %u, LI %u)\n", stratum, leap);
+        return SNTP_ERROR_INVALID_REPLY;
+    }
+
+    int64_t t2_us = sntp_timestamp_to_unix_us(sntp_read_u64(&reply[SNTP_OFFSET_RECEIVE]));
+    int64_t t3_us = sntp_timestamp_to_unix_us(sntp_read_u64(&reply[SNTP_OFFSET_TRANSMIT]));
+
+    int64_t offset_us = ((t2_us - (int64_t)t1_us) + (t3_us - (int64_t)t4_us)) / 2;
+    int64_t delay_us = (int64_t)(t4_us - t1_us) - (t3_us - t2_us);
+
+    if (synced) {
+        LOG_INFO("[OK] Relógio SNTP ressincronizado: correção %ld us, ida e volta %ld us\n",
+                 (long)(offset_us - epoch_offset_us), (long)delay_us);
+    } else {
+        LOG_INFO("[OK] Relógio SNTP sincronizado (estrato %u): ida e volta %ld us\n", stratum, (long)delay_us);
+    }
+
+    epoch_offset_us = offset_us;
+    synced = true;
+    return SNTP_OK;
+}
+
+/**
+ * @brief Espera pela resposta ao pedido enviado em `t1_us`.
+ */
+static sntp_status_t sntp_receive_reply(uint8_t sn, uint64_t request_tx, uint64_t t1_us) {
+    uint8_t reply[SNTP_RX_BUFFER_SIZE];
+    uint32_t start_ms = to_ms_since_boot(get_absolute_time());
+
+    while (1) {
+        // Limpa o evento antes de ler: um datagrama que chegue entretanto volta a sinalizá-lo.
+        setSn_IR(sn, Sn_IR_RECV);
+
+        uint8_t addr[4];
+        uint16_t port;
+        int32_t len = recvfrom(sn, reply, sizeof(reply), addr, &port);
+        uint64_t t4_us = time_us_64();
+
+        if (len > 0) {
+            if (memcmp(addr, server_ip, sizeof(addr)) == 0 && port == SNTP_SERVER_PORT &&
+                sntp_process_reply(reply, len, request_tx, t1_us, t4_us) == SNTP_OK) {
+                return SNTP_OK;
+            }
+            continue;
+        }
+        if (len < 0) {
+            return SNTP_ERROR_SOCKET;
+        }
+
+        uint32_t elapsed_ms = to_ms_since_boot(get_absolute_time()) - start_ms;
+        if (elapsed_ms >= SNTP_TIMEOUT_MS) {
+            return SNTP_ERROR_TIMEOUT;
+        }
+        // Só o socket do SNTP: os eventos dos outros ficam para depois da consulta.
+        ethernet_wait_socket_event(sn, SNTP_TIMEOUT_MS - elapsed_ms);
+    }
+}
+
+sntp_status_t sntp_client_sync(void) {
+    int sn = ethernet_socket_alloc();
+    if (sn < 0) {
+        LOG_ERROR("[ERRO] Nenhum socket do W5500 disponível para o SNTP.\n");
+        return SNTP_ERROR_SOCKET;
+    }
+
+    if (socket((uint8_t)sn, Sn_MR_UDP, 0, 0) != sn) {
+        LOG_ERROR("[ERRO] Falha ao criar socket UDP para o SNTP.\n");
+        ethernet_socket_free((uint8_t)sn);
+        return SNTP_ERROR_SOCKET;
+    }
+
+    uint8_t io_mode = SOCK_IO_NONBLOCK;
+    ctlsocket((uint8_t)sn, CS_SET_IOMODE, &io_mode);
+    ethernet_enable_socket_events((uint8_t)sn, Sn_IR_RECV);
+
+    // O servidor copia o Transmit do pedido para o Originate da resposta:
+    // basta que seja único, e o instante monotónico do envio é-o.
+    uint8_t request[SNTP_PACKET_SIZE] = { SNTP_REQUEST_FLAGS };
+    uint64_t t1_us = time_us_64();
+    uint64_t request_tx = t1_us;
+    sntp_write_u64(&request[SNTP_OFFSET_TRANSMIT], request_tx);
+
+    sntp_status_t status;
+    if (sendto((uint8_t)sn, request, sizeof(request), (uint8_t*)server_ip, SNTP_SERVER_PORT) != (int32_t)sizeof(request)) {
+        status = SNTP_ERROR_SEND_FAILED;
+    } else {
+        status = sntp_receive_reply((uint8_t)sn, request_tx, t1_us);
+    }
+
+    close((uint8_t)sn);
+    ethernet_socket_free((uint8_t)sn);
+    return status;
+}
+
+void sntp_client_poll(uint32_t now_ms) {
+    static bool started = false;
+
+    if (started && (int32_t)(now_ms - next_sync_ms) < 0) {
+        return;
+    }
+    started = true;
+
+    sntp_status_t status = sntp_client_sync();
+    if (status == SNTP_OK) {
+        next_sync_ms = now_ms + SNTP_SYNC_INTERVAL_MS;
+        return;
+    }
+
+    if (status == SNTP_ERROR_TIMEOUT) {
+        LOG_WARN("[AVISO] Servidor SNTP %d.%d.%d.%d sem resposta.\n",
+                 server_ip[0], server_ip[1], server_ip[2], server_ip[3]);
+    } else if (status != SNTP_ERROR_SOCKET) {
+        LOG_WARN("[AVISO] Falha na consulta SNTP (código %d).\n", status);
+    }
+    next_sync_ms = now_ms + SNTP_RETRY_MS;
+}
+
+bool sntp_client_is_synced(void) {
+    return synced;
+}
+
+bool sntp_client_to_epoch_ms(uint64_t monotonic_us, uint64_t* epoch_ms_out) {
+    if (!synced || epoch_ms_out == NULL) {
+        return false;
+    }
+    *epoch_ms_out = (uint64_t)((int64_t)monotonic_us + epoch_offset_us) / 1000u;
+    return true;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file sntp_client.h
+ * @brief Interface pública do cliente SNTP (RFC 4330) que dá hora de parede às leituras.
+ *
+ * As leituras são marcadas na aquisição com o relógio monotónico
+ * (time_us_64()). O cliente consulta periodicamente o servidor SNTP do
+ * config.cmake num socket UDP do W5500 e mantém a diferença entre esse
+ * relógio e o tempo Unix, o que converte qualquer instante monotónico
+ * deste arranque num instante de parede, mesmo de leituras feitas antes
+ * da primeira sincronização.
+ *
+ * Todas as funções devem ser chamadas da tarefa de rede.
+ */
+#ifndef SNTP_CLIENT_H
+#define SNTP_CLIENT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @enum sntp_status_t
+ * @brief Define os possíveis códigos de estado retornados pelo módulo sntp_client.
+ */
+typedef enum {
+    SNTP_OK,                    /**< O relógio foi sincronizado com a resposta do servidor. */
+    SNTP_ERROR_SOCKET,          /**< Sem socket livre do W5500, ou falha ao abri-lo. */
+    SNTP_ERROR_SEND_FAILED,     /**< O pedido não saiu (ex: ARP sem resposta). */
+    SNTP_ERROR_TIMEOUT,         /**< O servidor não respondeu em SNTP_TIMEOUT_MS. */
+    SNTP_ERROR_INVALID_REPLY    /**< Resposta de outro pedido, mal formada ou de um servidor não sincronizado. */
+} sntp_status_t;
+
+/**
+ * @brief Sincroniza o relógio se o intervalo de sincronização tiver expirado.
+ *
+ * Deve ser chamada a cada ciclo da tarefa de rede. Uma consulta bloqueia a
+ * tarefa até à resposta (no máximo SNTP_TIMEOUT_MS); depois de uma falha a
+ * consulta seguinte é feita ao fim de SNTP_RETRY_MS, e depois de um
+ * sucesso ao fim de SNTP_SYNC_INTERVAL_MS.
+ *
+ * @param now_ms O instante atual, em ms desde o arranque.
+ */
+void sntp_client_poll(uint32_t now_ms);
+
+/**
+ * @brief Consulta o servidor de imediato.
+ *
+ * @return SNTP_OK, ou um código de erro relevante; em caso de erro a
+ * sincronização anterior, se existir, mantém-se.
+ */
+sntp_status_t sntp_client_sync(void);
+
+/**
+ * @brief Indica se o relógio já foi sincronizado desde o arranque.
+ */
+bool sntp_client_is_synced(void);
+
+/**
+ * @brief Converte um instante monotónico deste arranque em tempo Unix.
+ *
+ * @param monotonic_us O instante, em time_us_64().
+ * @param epoch_ms_out Recebe os ms desde 1970-01-01T00:00:00Z.
+ * @return true se o relógio estiver sincronizado, false caso contrário
+ * (`epoch_ms_out` fica inalterado).
+ */
+bool sntp_client_to_epoch_ms(uint64_t monotonic_us, uint64_t* epoch_ms_out);
+
+#endif // SNTP_CLIENT_H
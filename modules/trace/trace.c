@@ -0,0 +1,125 @@
+/**
+ * @file trace.c
+ * @brief Implementação dos histogramas de latência por fase.
+ *
+ * Os buckets são log-lineares: cada potência de 2 é dividida em 4 buckets,
+ * pelo que o erro de um percentil é no máximo 25% do valor, de 1 µs até
+ * ~16 s, com 92 contadores por fase.
+ */
+
+#include "trace.h"
+#include "../logger/logger.h"
+#include <string.h>
+
+#if TRACE_ENABLED
+
+// Subdivisões de cada potência de 2 (2^TRACE_SUB_BITS)
+#define TRACE_SUB_BITS    2
+#define TRACE_SUB_BUCKETS (1u << TRACE_SUB_BITS)
+
+// Maior potência de 2 distinguida; durações acima ficam no último bucket
+#define TRACE_MAX_MSB     23
+#define TRACE_BUCKETS     ((TRACE_MAX_MSB - TRACE_SUB_BITS + 2) * TRACE_SUB_BUCKETS)
+
+/**
+ * @brief Histograma de uma fase desde o último resumo.
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t max_us;
+    uint32_t buckets[TRACE_BUCKETS];
+} trace_histogram_t;
+
+static trace_histogram_t histograms[TRACE_PHASE_COUNT];
+
+static const char* const phase_names[TRACE_PHASE_COUNT] = {
+    [TRACE_SENSOR_READ] = "sensor_read",
+    [TRACE_ENCODE]      = "encode",
+    [TRACE_CONNECT]     = "connect",
+    [TRACE_SEND]        = "send",
+    [TRACE_RECV]        = "recv",
+    [TRACE_UPLOAD]      = "upload",
+};
+
+/**
+ * @brief Índice do bucket de uma duração: a posição do bit mais
+ * significativo e os TRACE_SUB_BITS bits seguintes.
+ */
+static uint32_t trace_bucket(uint32_t us) {
+    if (us < TRACE_SUB_BUCKETS) {
+        return us;
+    }
+
+    uint32_t msb = 31u - (uint32_t)__builtin_clz(us);
+    if (msb > TRACE_MAX_MSB) {
+        return TRACE_BUCKETS - 1;
+    }
+
+    uint32_t sub = (us >> (msb - TRACE_SUB_BITS)) & (TRACE_SUB_BUCKETS - 1);
+    return (msb - TRACE_SUB_BITS + 1) * TRACE_SUB_BUCKETS + sub;
+}
+
+/**
+ * @brief Maior duração que cai no bucket `index`.
+ */
+static uint32_t trace_bucket_upper(uint32_t index) {
+    if (index < TRACE_SUB_BUCKETS) {
+        return index;
+    }
+
+    uint32_t msb = index / TRACE_SUB_BUCKETS + TRACE_SUB_BITS - 1;
+    uint32_t sub = index % TRACE_SUB_BUCKETS;
+    uint32_t width = 1u << (msb - TRACE_SUB_BITS);
+    return ((TRACE_SUB_BUCKETS + sub) << (msb - TRACE_SUB_BITS)) + width - 1;
+}
+
+/**
+ * @brief Estimativa de um percentil: o limite superior do bucket que o contém.
+ */
+static uint32_t trace_percentile(const trace_histogram_t* hist, uint32_t percent) {
+    // Posição (1..count) da amostra do percentil, arredondada para cima.
+    uint32_t rank = (uint32_t)(((uint64_t)hist->count * percent + 99) / 100);
+    uint32_t seen = 0;
+
+    for (uint32_t i = 0; i < TRACE_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen >= rank) {
+            uint32_t upper = trace_bucket_upper(i);
+            return (upper < hist->max_us) ? upper : hist->max_us;
+        }
+    }
+    return hist->max_us;
+}
+
+void trace_end(trace_phase_t phase, uint64_t start_us) {
+    uint64_t elapsed = time_us_64() - start_us;
+    uint32_t us = (elapsed > UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsed;
+    trace_histogram_t* hist = &histograms[phase];
+
+    hist->buckets[trace_bucket(us)]++;
+    hist->count++;
+    if (us > hist->max_us) {
+        hist->max_us = us;
+    }
+}
+
+void trace_print_summary(void) {
+    for (uint32_t phase = 0; phase < TRACE_PHASE_COUNT; phase++) {
+        trace_histogram_t* hist = &histograms[phase];
+        if (hist->count == 0) {
+            continue;
+        }
+
+        LOG_INFO("[TRACE] %-11s n=%lu p50=%lu us p99=%lu us max=%lu us\n", phase_names[phase],
+                 (unsigned long)hist->count,
+                 (unsigned long)trace_percentile(hist, 50),
+                 (unsigned long)trace_percentile(hist, 99),
+                 (unsigned long)hist->max_us);
+
+        // Uma amostra registada noutro núcleo durante a limpeza pode perder-se;
+        // é aceitável para uma estatística.
+        memset(hist, 0, sizeof(*hist));
+    }
+}
+
+#endif // TRACE_ENABLED
@@ -0,0 +1,76 @@
+/**
+ * @file trace.h
+ * @brief Interface pública da instrumentação das fases do ciclo.
+ *
+ * Cada fase (leitura dos sensores, codificação, conexão, envio, receção,
+ * envio completo do lote) é cronometrada com time_us_64() e a duração
+ * alimenta um histograma de buckets fixos em RAM. Um resumo periódico
+ * (trace_print_summary()) reporta, por fase, o número de amostras, p50,
+ * p99 e máximo, e reinicia os histogramas.
+ *
+ * Registar uma amostra custa duas leituras do temporizador e um incremento;
+ * nada é impresso no caminho crítico. Com TRACE_ENABLED a 0 as funções ficam
+ * vazias e são eliminadas pelo compilador.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include "pico/stdlib.h"
+
+/**
+ * @enum trace_phase_t
+ * @brief Fases cronometradas.
+ *
+ * Cada fase é registada por uma única tarefa: a leitura dos sensores pela
+ * tarefa de amostragem, as restantes pela tarefa de rede.
+ */
+typedef enum {
+    TRACE_SENSOR_READ, /**< sensors_read_all(). */
+    TRACE_ENCODE,      /**< Escrita da requisição (cabeçalhos e corpo) na memória TX. */
+    TRACE_CONNECT,     /**< Do início da conexão TCP até ao estabelecimento. */
+    TRACE_SEND,        /**< Do comando SEND até à confirmação SENDOK. */
+    TRACE_RECV,        /**< Do SENDOK até à resposta completa. */
+    TRACE_UPLOAD,      /**< batch_upload(): envio do lote e/ou drenagem da flash. */
+    TRACE_PHASE_COUNT
+} trace_phase_t;
+
+#if TRACE_ENABLED
+
+/**
+ * @brief Regista a duração de uma fase.
+ *
+ * @param phase A fase cronometrada.
+ * @param start_us O instante de início, obtido com trace_begin().
+ */
+void trace_end(trace_phase_t phase, uint64_t start_us);
+
+/**
+ * @brief Imprime o resumo dos histogramas e reinicia-os.
+ */
+void trace_print_summary(void);
+
+/**
+ * @brief Marca o início de uma fase.
+ */
+static inline uint64_t trace_begin(void) {
+    return time_us_64();
+}
+
+#else
+
+static inline void trace_end(trace_phase_t phase, uint64_t start_us) {
+    (void)phase;
+    (void)start_us;
+}
+
+static inline void trace_print_summary(void) {
+}
+
+static inline uint64_t trace_begin(void) {
+    return 0;
+}
+
+#endif // TRACE_ENABLED
+
+#endif // TRACE_H
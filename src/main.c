@@ -1,24 +1,160 @@
-#include <stdio.h>
 #include <string.h>
 #include "pico/stdlib.h"
 #include "FreeRTOS.h"
 #include "task.h"
+#include "queue.h"
 #include "hardware/gpio.h"
 #include "hardware/watchdog.h"
+#include "modules/adc_manager/adc_manager.h"
 #include "modules/ethernet_manager/ethernet_manager.h"
 #include "modules/http_client/http_client.h"
+#include "modules/sntp_client/sntp_client.h"
 #include "modules/sensor_manager/sensor_manager.h"
+#include "modules/batch_manager/batch_manager.h"
+#include "modules/flash_store/flash_store.h"
+#include "modules/config_store/config_store.h"
+#include "modules/report_filter/report_filter.h"
+#include "modules/trace/trace.h"
+#include "modules/logger/logger.h"
+
+// --- Configuração das tarefas ---
+#define SAMPLER_CORE_MASK   (1 << 0)
+#define NETWORK_CORE_MASK   (1 << 1)
+#define SAMPLER_PRIORITY    2
+#define NETWORK_PRIORITY    1
+#define LOGGER_CORE_MASK    (SAMPLER_CORE_MASK | NETWORK_CORE_MASK)
+#define LOGGER_PRIORITY     tskIDLE_PRIORITY
+#define SAMPLE_QUEUE_LENGTH 32
+// Maior pausa da tarefa de amostragem: mantém o watchdog alimentado e as
+// alterações de configuração aplicadas mesmo com sensores lentos.
+#define SAMPLER_MAX_WAIT_MS (WATCHDOG_TIMEOUT_MS / 4)
+
+/**
+ * @brief Fila que liga a tarefa de amostragem (produtora) à tarefa de rede (consumidora).
+ */
+static QueueHandle_t sample_queue;
+
+/**
+ * @brief Instante (ms desde o arranque) da última iteração da tarefa de rede.
+ *
+ * Permite à tarefa de amostragem alimentar o watchdog apenas enquanto a
+ * tarefa de rede continua a progredir.
+ */
+static volatile uint32_t network_heartbeat_ms;
+
+/**
+ * @brief Copia da configuração em vigor os períodos de amostragem e a política de envio por exceção.
+ */
+static void load_sampler_config(uint32_t interval_ms[SENSOR_COUNT], report_filter_t* filter) {
+    device_config_t config;
+    config_store_get(&config);
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        interval_ms[i] = config.sensors[i].sample_interval_ms;
+        report_filter_set(filter, i, q16_from_centi((int32_t)config.sensors[i].deadband_centi),
+                          config.sensors[i].heartbeat_ms);
+    }
+}
+
+/**
+ * @brief Tarefa de amostragem, fixada num núcleo.
+ *
+ * Lê cada sensor no seu período (config_store) e publica a leitura, com os
+ * sensores alterados (report_filter) e o instante de aquisição, na fila de
+ * amostras. A publicação nunca bloqueia: se a tarefa de rede estiver
+ * atrasada e a fila cheia, a leitura é descartada, mantendo o jitter de
+ * amostragem independente da rede.
+ */
+static void sampler_task(__unused void *params) {
+    if (sensors_init() != 0) {
+        LOG_ERROR("[ERRO] Falha na inicializacao dos sensores. Tarefa Interrompida.\n");
+        vTaskDelete(NULL);
+    }
+
+    LOG_INFO("[INFO] Iniciando amostragem por sensor (lotes de ate %d leituras).\n",
+             BATCH_MAX_READINGS);
+
+    batch_entry_t sample;
+    sensors_schedule_t schedule;
+    report_filter_t filter;
+    uint32_t interval_ms[SENSOR_COUNT];
+    uint32_t config_generation = config_store_generation();
+
+    report_filter_init(&filter);
+    load_sampler_config(interval_ms, &filter);
+    sensors_schedule_init(&schedule, interval_ms, to_ms_since_boot(get_absolute_time()));
+
+    while (1) {
+        uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+
+        // O watchdog só é alimentado enquanto a tarefa de rede der sinal de vida.
+        if ((now_ms - network_heartbeat_ms) < WATCHDOG_TIMEOUT_MS) {
+            watchdog_update();
+        }
+
+        // Uma nova configuração recomeça o calendário, com todos os sensores devidos.
+        if (config_store_generation() != config_generation) {
+            config_generation = config_store_generation();
+            load_sampler_config(interval_ms, &filter);
+            sensors_schedule_init(&schedule, interval_ms, now_ms);
+        }
+
+        // Passo 1: Ler os sensores devidos neste instante.
+        sensor_mask_t due = sensors_schedule_due(&schedule, now_ms);
+        if (due != 0) {
+            uint64_t read_start_us = trace_begin();
+            int read_result = sensors_read(&sample.reading, due);
+            trace_end(TRACE_SENSOR_READ, read_start_us);
+
+            if (read_result != 0) {
+                LOG_ERROR("[ERRO] Falha na leitura dos sensores. Pulando este ciclo.\n");
+            } else if (report_filter_apply(&filter, &sample.reading, now_ms) != 0) {
+                // Passo 2: Entregar os sensores alterados à tarefa de rede sem bloquear.
+                sample.timestamp_ms = (uint32_t)(sample.reading.timestamp_us / 1000u);
+                if (xQueueSend(sample_queue, &sample, 0) != pdTRUE) {
+                    LOG_WARN("[AVISO] Fila de amostras cheia. Leitura descartada.\n");
+                }
+            }
+        }
+
+        // Passo 3: Aguardar o próximo sensor devido; os prazos absolutos do
+        // calendário evitam a acumulação de desvio.
+        uint32_t wait_ms = sensors_schedule_wait_ms(&schedule, to_ms_since_boot(get_absolute_time()));
+        vTaskDelay(pdMS_TO_TICKS(wait_ms < SAMPLER_MAX_WAIT_MS ? wait_ms : SAMPLER_MAX_WAIT_MS));
+    }
+}
+
+/**
+ * @brief Passa ao lote os intervalos de envio da configuração em vigor.
+ */
+static void apply_report_intervals(void) {
+    device_config_t config;
+    config_store_get(&config);
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        batch_set_report_interval(i, config.sensors[i].report_interval_ms);
+    }
+}
+
+/**
+ * @brief Recebe os cabeçalhos das respostas do servidor não interpretados pelo cliente HTTP.
+ *
+ * O cabeçalho X-Config altera a configuração de amostragem (ver config_store.h).
+ */
+static void on_response_header(const char* name, const char* value, __unused void* context) {
+    if (strcmp(name, "x-config") == 0) {
+        config_store_apply(value);
+    }
+}
 
 /**
- * @brief Tarefa principal que encapsula a lógica de leitura e envio.
+ * @brief Tarefa de rede, fixada no outro núcleo.
  *
- * Esta tarefa executa um ciclo de leitura de sensores e envio de dados
- * com uma frequência fixa, controlada pelo FreeRTOS.
+ * Consome as leituras da fila, acumula-as no lote e envia-o quando atinge
+ * o limite de quantidade ou de idade. Os bloqueios do cliente HTTP
+ * (conexão, timeout de resposta) ficam confinados a esta tarefa.
  */
-void main_task(__unused void *params) {
-    // 1. Inicialização dos módulos
+static void network_task(__unused void *params) {
     ethernet_config_t eth_config = {
-        .mac = {ETHERNET_MAC_0, ETHERNET_MAC_1, ETHERNET_MAC_2, 
+        .mac = {ETHERNET_MAC_0, ETHERNET_MAC_1, ETHERNET_MAC_2,
                 ETHERNET_MAC_3, ETHERNET_MAC_4, ETHERNET_MAC_5},
         .ip = {DEVICE_IP_0, DEVICE_IP_1, DEVICE_IP_2, DEVICE_IP_3},
         .subnet = {SUBNET_MASK_0, SUBNET_MASK_1, SUBNET_MASK_2, SUBNET_MASK_3},
@@ -28,46 +164,108 @@ void main_task(__unused void *params) {
     };
 
     if (ethernet_init(&eth_config) != 0) {
-        printf("[ERRO] Falha na inicialização do Ethernet. Tarefa Interrompida.\n");
+        LOG_ERROR("[ERRO] Falha na inicialização do Ethernet. Tarefa Interrompida.\n");
         vTaskDelete(NULL);
     }
 
-    if (sensors_init() != 0) {
-        printf("[ERRO] Falha na inicializacao dos sensores. Tarefa Interrompida.\n");
-        vTaskDelete(NULL); 
+    if (flash_store_init(flash_io_rp2040()) != FLASH_STORE_OK) {
+        LOG_WARN("[AVISO] Armazenamento em flash indisponível. Leituras não enviadas serão perdidas.\n");
     }
+    http_set_response_header_handler(on_response_header, NULL);
 
-    printf("[INFO] Iniciando ciclos de envio a cada %d segundos.\n", CYCLE_INTERVAL_MS / 1000);
+    batch_entry_t sample;
+    bool link_ok = true;
+    uint32_t config_generation = 0;
+    uint32_t last_trace_summary_ms = to_ms_since_boot(get_absolute_time());
 
-    sensors_reading_t sensor_data;
-
-    // 2. Loop principal
     while (1) {
-        watchdog_update();
-
-        // Passo 1: Ler os dados.
-        if (sensors_read_all(&sensor_data) != 0) {
-            printf("[ERRO] Falha na leitura dos sensores. Pulando este ciclo.\n");
-        } else {
-            // Passo 2: Enviar os dados.
-            http_status_t status = http_send_sensor_data(
-                sensor_data.temperature,
-                sensor_data.conductivity,
-                sensor_data.flow
-            );
-
-            if (status != HTTP_OK) {
-                printf("[ERRO] Falha no ciclo de envio (status: %d).\n", status);
+        network_heartbeat_ms = to_ms_since_boot(get_absolute_time());
+
+        // Intervalos de envio da configuração em vigor (ex: após um X-Config).
+        if (config_store_generation() != config_generation) {
+            config_generation = config_store_generation();
+            apply_report_intervals();
+        }
+
+        // A espera é limitada a um ciclo para que o limite de idade do lote
+        // seja verificado mesmo que a amostragem pare de produzir leituras.
+        if (xQueueReceive(sample_queue, &sample, pdMS_TO_TICKS(CYCLE_INTERVAL_MS)) == pdTRUE) {
+            // Cada escrita na flash retém o núcleo da amostragem num ciclo na
+            // RAM que continua a aquisição do ADC (ver flash_write_begin()).
+            // Uma escrita adiada fica para o ciclo seguinte.
+            flash_store_sync();
+            config_store_sync();
+
+            if (batch_add(&sample.reading, sample.timestamp_ms) != BATCH_STATUS_OK) {
+                LOG_WARN("[AVISO] Lote cheio. Leitura descartada.\n");
             }
         }
-        
-        // Passo 3: Aguardar o próximo ciclo.
-        vTaskDelay(pdMS_TO_TICKS(CYCLE_INTERVAL_MS));
+
+        uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+
+        // O relógio é sincronizado antes do envio: o primeiro lote depois da
+        // sincronização já leva tempo Unix, também nas leituras anteriores.
+        sntp_client_poll(now_ms);
+
+        // Com a ligação restabelecida, um lote da flash é drenado por ciclo,
+        // em paralelo com o lote ao vivo e noutro socket.
+        bool drain = link_ok && flash_store_pending() > 0;
+        if (batch_should_flush(now_ms) || drain) {
+            uint64_t upload_start_us = trace_begin();
+            batch_status_t upload_status = batch_upload(now_ms, drain);
+            trace_end(TRACE_UPLOAD, upload_start_us);
+            link_ok = (upload_status == BATCH_STATUS_OK || upload_status == BATCH_STATUS_EMPTY);
+        }
+
+        // O resumo dos histogramas é o único registo da instrumentação.
+        if ((now_ms - last_trace_summary_ms) >= TRACE_SUMMARY_INTERVAL_MS) {
+            trace_print_summary();
+            last_trace_summary_ms = now_ms;
+        }
+    }
+}
+
+/**
+ * @brief Retém o núcleo da amostragem na RAM antes de cada escrita na flash.
+ *
+ * Durante a retenção a tarefa de aquisição continua a ler os conversores
+ * num ciclo na RAM, com o mesmo ritmo, e o resto do núcleo fica parado:
+ * ~1 ms por página programada e até ~400 ms por setor apagado. As amostras
+ * chegam aos filtros no fim, pela ordem e com os seus instantes. Se a
+ * aquisição não confirmar a retenção, a escrita é adiada; sem aquisição
+ * contínua, flash_safe_execute() bloqueia o núcleo como antes.
+ */
+static flash_io_write_mode_t flash_write_begin(void) {
+    switch (adc_module_hold()) {
+    case ADC_STATUS_OK:
+        return FLASH_IO_WRITE_HELD;
+    case ADC_STATUS_TIMEOUT:
+        return FLASH_IO_WRITE_POSTPONE;
+    default:
+        return FLASH_IO_WRITE_LOCKOUT;
     }
 }
 
+static void flash_write_end(void) {
+    adc_module_release();
+}
+
+/**
+ * @brief Cria uma tarefa fixada aos núcleos indicados, quando o kernel SMP o permite.
+ */
+static void create_pinned_task(TaskFunction_t task, const char *name, uint32_t stack_depth,
+                               UBaseType_t priority, UBaseType_t core_mask) {
+#if configUSE_CORE_AFFINITY && (configNUM_CORES > 1)
+    xTaskCreateAffinitySet(task, name, stack_depth, NULL, priority, core_mask, NULL);
+#else
+    (void)core_mask;
+    xTaskCreate(task, name, stack_depth, NULL, priority, NULL);
+#endif
+}
+
 int main() {
     stdio_init_all();
+    logger_init();
     sleep_ms(5000);
 
     const uint LED_PIN = 25;
@@ -77,12 +275,27 @@ int main() {
 
     watchdog_enable(WATCHDOG_TIMEOUT_MS, 1);
 
-    // Cria a tarefa principal que executará a lógica do dispositivo.
-    xTaskCreate(main_task, "MainTask", 2048, NULL, 1, NULL);
+    flash_io_rp2040_set_write_hooks(flash_write_begin, flash_write_end);
+
+    // Antes das tarefas: a amostragem arranca já com a configuração gravada.
+    if (config_store_init(flash_io_rp2040_config()) != CONFIG_STORE_OK) {
+        LOG_WARN("[AVISO] Região de configuração inválida. Alterações não serão persistidas.\n");
+        config_store_init(NULL);
+    }
+
+    sample_queue = xQueueCreate(SAMPLE_QUEUE_LENGTH, sizeof(batch_entry_t));
+    network_heartbeat_ms = to_ms_since_boot(get_absolute_time());
+
+    // Amostragem e rede correm em núcleos distintos, ligadas pela fila de amostras.
+    create_pinned_task(sampler_task, "SamplerTask", 1024, SAMPLER_PRIORITY, SAMPLER_CORE_MASK);
+    create_pinned_task(network_task, "NetworkTask", 2048, NETWORK_PRIORITY, NETWORK_CORE_MASK);
+    // Só a tarefa de registo escreve no stdio; um host que não lê o USB
+    // atrasa apenas esta tarefa.
+    create_pinned_task(logger_task, "LoggerTask", 1024, LOGGER_PRIORITY, LOGGER_CORE_MASK);
 
     // Inicia o escalonador do FreeRTOS.
     vTaskStartScheduler();
 
     while(1);
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+"""Descodifica os registos binários do firmware (LOG_OUTPUT BINARY).
+
+Uso:
+    log_decode.py build/main.elf captura.bin
+    stty -F /dev/ttyACM0 raw && cat /dev/ttyACM0 | log_decode.py build/main.elf -
+
+Cada registo traz o endereço do formato printf na flash; o texto (e o de
+argumentos %s) é lido do ELF do mesmo build. A trama está descrita em
+modules/logger/logger.c. Bytes fora de tramas (ex: mensagens do SDK) são
+repassados tal como chegam.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+FRAME_MAGIC = 0xA5
+MAX_ARGS = 6
+LEVELS = 4
+
+CONVERSION = re.compile(
+    r"%(?P<flags>[-+ #0]*)(?P<width>\d+)?(?:\.(?P<prec>\d+))?"
+    r"(?P<length>hh|h|ll|l|z|j|t)?(?P<conv>[diouxXcsp%])")
+
+
+class ElfImage:
+    """Segmentos carregáveis de um ELF32 little-endian, indexados pelo endereço."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF" or self.data[4] != 1 or self.data[5] != 1:
+            raise ValueError("%s não é um ELF32 little-endian" % path)
+
+        phoff, = struct.unpack_from("<I", self.data, 28)
+        phentsize, phnum = struct.unpack_from("<HH", self.data, 42)
+        self.segments = []
+        for i in range(phnum):
+            p_type, p_offset, p_vaddr, p_paddr, p_filesz = struct.unpack_from(
+                "<IIIII", self.data, phoff + i * phentsize)
+            if p_type == 1 and p_filesz > 0:  # PT_LOAD
+                # O formato está na flash: vale o endereço de carga (LMA).
+                self.segments.append((p_paddr, p_offset, p_filesz))
+                if p_vaddr != p_paddr:
+                    self.segments.append((p_vaddr, p_offset, p_filesz))
+
+    def string_at(self, address):
+        """Devolve a string terminada em NUL no endereço, ou None se não estiver no ELF."""
+        for base, offset, size in self.segments:
+            if base <= address < base + size:
+                start = offset + (address - base)
+                end = self.data.find(b"\0", start, offset + size)
+                if end < 0:
+                    return None
+                return self.data[start:end].decode("utf-8", errors="replace")
+        return None
+
+
+def format_record(elf, fmt, args):
+    """Aplica os argumentos de 32 bits ao formato printf, como a newlib no RP2040."""
+    values = iter(args)
+
+    def convert(match):
+        conv = match.group("conv")
+        if conv == "%":
+            return "%"
+        value = next(values, 0)
+        spec = "%" + match.group("flags") + (match.group("width") or "")
+        if match.group("prec") is not None:
+            spec += "." + match.group("prec")
+
+        if conv in "di":
+            return (spec + "d") % (value - (1 << 32) if value & 0x80000000 else value)
+        if conv == "u":
+            return (spec + "d") % value
+        if conv in "oxX":
+            return (spec + conv) % value
+        if conv == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        if conv == "p":
+            return "0x%08x" % value
+        text = elf.string_at(value)
+        return (spec + "s") % (text if text is not None else "<0x%08x>" % value)
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def decode(elf, data, out):
+    pos = 0
+    wraps = 0
+    last_us = None
+
+    while pos < len(data):
+        if data[pos] != FRAME_MAGIC or pos + 11 > len(data):
+            out.write(chr(data[pos]))
+            pos += 1
+            continue
+
+        level, argc = data[pos + 1], data[pos + 2]
+        fmt_addr, timestamp_us = struct.unpack_from("<II", data, pos + 3)
+        end = pos + 11 + 4 * argc
+        fmt = elf.string_at(fmt_addr) if level < LEVELS and argc <= MAX_ARGS else None
+        if fmt is None or end > len(data):
+            # Não é uma trama válida: o byte é texto comum.
+            out.write(chr(data[pos]))
+            pos += 1
+            continue
+
+        args = struct.unpack_from("<%dI" % argc, data, pos + 11)
+        pos = end
+
+        # O instante é time_us_32(), que dá a volta a cada ~71 minutos.
+        if last_us is not None and timestamp_us < last_us and last_us - timestamp_us > (1 << 31):
+            wraps += 1
+        last_us = timestamp_us
+        total_us = (wraps << 32) + timestamp_us
+
+        out.write("%5d.%03d %s" % (total_us // 1000000, (total_us // 1000) % 1000,
+                                    format_record(elf, fmt, args)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="ELF do firmware que gerou os registos")
+    parser.add_argument("capture", help="ficheiro com a saída binária, ou - para stdin")
+    args = parser.parse_args()
+
+    try:
+        elf = ElfImage(args.elf)
+    except (OSError, ValueError) as exc:
+        print("erro: %s" % exc, file=sys.stderr)
+        return 1
+
+    if args.capture == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.capture, "rb") as f:
+            data = f.read()
+
+    decode(elf, data, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""Descodifica o corpo de telemetria enviado pelo firmware (JSON ou CBOR).
+
+Uso:
+    payload_decode.py corpo.bin            # formato detetado pelo 1.o byte
+    payload_decode.py --hex "8a8419..."    # corpo em hexadecimal
+    cat corpo.bin | payload_decode.py -
+    payload_decode.py --sensors temperature,conductivity,flow,ph corpo.bin
+
+Imprime uma leitura por linha, com os valores na mesma escala do JSON.
+O layout CBOR está descrito em modules/payload_encoder/payload_encoder.h;
+--sensors indica a lista SENSORS do config.cmake com que o firmware foi
+compilado, pela mesma ordem.
+"""
+
+import argparse
+import json
+import sys
+
+DEFAULT_SENSORS = ("temperature", "conductivity", "flow")
+
+
+class CborError(ValueError):
+    pass
+
+
+def _cbor_item(data, pos):
+    """Lê um item CBOR (inteiros, arrays e null) a partir de `pos`; devolve (valor, nova posição)."""
+    if pos >= len(data):
+        raise CborError("corpo truncado")
+    initial = data[pos]
+    major, info = initial >> 5, initial & 0x1F
+    pos += 1
+
+    if initial == 0xF6:
+        return None, pos
+
+    if info < 24:
+        arg = info
+    elif info in (24, 25, 26, 27):
+        size = 1 << (info - 24)
+        if pos + size > len(data):
+            raise CborError("argumento truncado")
+        arg = int.from_bytes(data[pos:pos + size], "big")
+        pos += size
+    else:
+        raise CborError("argumento 0x%02x não suportado" % info)
+
+    if major == 0:
+        return arg, pos
+    if major == 1:
+        return -1 - arg, pos
+    if major == 4:
+        items = []
+        for _ in range(arg):
+            item, pos = _cbor_item(data, pos)
+            items.append(item)
+        return items, pos
+    raise CborError("tipo principal %d não suportado" % major)
+
+
+def decode_cbor(data, sensors=DEFAULT_SENSORS):
+    records, pos = _cbor_item(data, 0)
+    if pos != len(data):
+        raise CborError("%d bytes a mais no fim do corpo" % (len(data) - pos))
+    if not isinstance(records, list):
+        raise CborError("o corpo não é um array")
+
+    readings = []
+    for record in records:
+        if not isinstance(record, list) or len(record) != 1 + len(sensors):
+            raise CborError("leitura mal formada: %r" % (record,))
+        time, *centi = record
+        # Tempo Unix em ms, -1 - age_ms antes da sincronização SNTP, ou null
+        # numa leitura de um arranque anterior sem tempo Unix.
+        if time is None:
+            reading = {}
+        elif time >= 0:
+            reading = {"ts": time}
+        else:
+            reading = {"age_ms": -1 - time}
+        for name, value in zip(sensors, centi):
+            # Sensor fora do seu período de amostragem: ausente, como no JSON.
+            if value is not None:
+                reading[name] = value / 100.0
+        readings.append(reading)
+    return readings
+
+
+def decode(data, sensors=DEFAULT_SENSORS):
+    if data[:1] == b"[":
+        return json.loads(data.decode("ascii"))
+    return decode_cbor(data, sensors)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("path", nargs="?", help="ficheiro com o corpo, ou - para stdin")
+    parser.add_argument("--hex", help="corpo em hexadecimal")
+    parser.add_argument("--sensors", default=",".join(DEFAULT_SENSORS),
+                        help="sensores do firmware, pela ordem de SENSORS (padrão %(default)s)")
+    args = parser.parse_args()
+    sensors = tuple(name for name in args.sensors.split(",") if name)
+
+    if args.hex is not None:
+        data = bytes.fromhex(args.hex)
+    elif args.path in (None, "-"):
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.path, "rb") as f:
+            data = f.read()
+
+    fields = ("ts", "age_ms") + sensors
+    for reading in decode(data, sensors):
+        print(" ".join("%s=%s" % (k, reading[k]) for k in fields if k in reading))
+
+
+if __name__ == "__main__":
+    main()